@@ -2524,6 +2524,84 @@ CryptoServiceRsaPkcs1Verify (
   return CALL_BASECRYPTLIB (Rsa.Services.Pkcs1Verify, RsaPkcs1Verify, (RsaContext, MessageHash, HashSize, Signature, SigSize), FALSE);
 }
 
+/**
+  Verifies the RSA signature with RSASSA-PSS signature scheme defined in RFC 8017.
+  Implementation determines salt length automatically from the signature encoding.
+  Mask generation function is the same as the message digest algorithm.
+  Salt length should be equal to digest length.
+
+  @param[in]  RsaContext      Pointer to RSA context for signature verification.
+  @param[in]  Message         Pointer to octet message to be verified.
+  @param[in]  MsgSize         Size of the message in bytes.
+  @param[in]  Signature       Pointer to RSASSA-PSS signature to be verified.
+  @param[in]  SigSize         Size of signature in bytes.
+  @param[in]  DigestLen       Length of digest for RSA operation.
+  @param[in]  SaltLen         Salt length for PSS encoding.
+
+  @retval  TRUE   Valid signature encoded in RSASSA-PSS.
+  @retval  FALSE  Invalid signature or invalid RSA context.
+
+**/
+BOOLEAN
+EFIAPI
+CryptoServiceRsaPssVerify (
+  IN  VOID         *RsaContext,
+  IN  CONST UINT8  *Message,
+  IN  UINTN        MsgSize,
+  IN  CONST UINT8  *Signature,
+  IN  UINTN        SigSize,
+  IN  UINT16       DigestLen,
+  IN  UINT16       SaltLen
+  )
+{
+  return CALL_BASECRYPTLIB (Rsa.Services.PssVerify, RsaPssVerify, (RsaContext, Message, MsgSize, Signature, SigSize, DigestLen, SaltLen), FALSE);
+}
+
+/**
+  This function carries out the RSA-SSA signature generation with EMSA-PSS encoding scheme defined in
+  RFC 8017.
+  Mask generation function is the same as the message digest algorithm.
+  If the Signature buffer is too small to hold the contents of signature, FALSE
+  is returned and SigSize is set to the required buffer size to obtain the signature.
+
+  If RsaContext is NULL, then return FALSE.
+  If Message is NULL, then return FALSE.
+  If MsgSize is zero or > INT_MAX, then return FALSE.
+  If DigestLen is NOT 32, 48 or 64, return FALSE.
+  If SaltLen is not equal to DigestLen, then return FALSE.
+  If SigSize is large enough but Signature is NULL, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in]      RsaContext   Pointer to RSA context for signature generation.
+  @param[in]      Message      Pointer to octet message to be signed.
+  @param[in]      MsgSize      Size of the message in bytes.
+  @param[in]      DigestLen    Length of the digest in bytes to be used for RSA signature operation.
+  @param[in]      SaltLen      Length of the salt in bytes to be used for PSS encoding.
+  @param[out]     Signature    Pointer to buffer to receive RSA PSS signature.
+  @param[in, out] SigSize      On input, the size of Signature buffer in bytes.
+                               On output, the size of data returned in Signature buffer in bytes.
+
+  @retval  TRUE   Signature successfully generated in RSASSA-PSS.
+  @retval  FALSE  Signature generation failed.
+  @retval  FALSE  SigSize is too small.
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+CryptoServiceRsaPssSign (
+  IN      VOID         *RsaContext,
+  IN      CONST UINT8  *Message,
+  IN      UINTN        MsgSize,
+  IN      UINT16       DigestLen,
+  IN      UINT16       SaltLen,
+  OUT     UINT8        *Signature,
+  IN OUT  UINTN        *SigSize
+  )
+{
+  return CALL_BASECRYPTLIB (Rsa.Services.PssSign, RsaPssSign, (RsaContext, Message, MsgSize, DigestLen, SaltLen, Signature, SigSize), FALSE);
+}
+
 /**
   Retrieve the RSA Private Key from the password-protected PEM key data.
 
@@ -3632,6 +3710,24 @@ CryptoServiceTlsFree (
   CALL_VOID_BASECRYPTLIB (Tls.Services.Free, TlsFree, (Tls));
 }
 
+/**
+  Free a TLS/SSL session returned by TlsGetSession().
+
+  This function releases the reference to the TLS/SSL session pointed to by
+  Session. If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS/SSL session to be freed.
+
+**/
+VOID
+EFIAPI
+CryptoServiceTlsSessionFree (
+  IN     VOID  *Session
+  )
+{
+  CALL_VOID_BASECRYPTLIB (Tls.Services.SessionFree, TlsSessionFree, (Session));
+}
+
 /**
   Create a new TLS object for a connection.
 
@@ -4048,6 +4144,33 @@ CryptoServiceTlsSetSessionId (
   return CALL_BASECRYPTLIB (TlsSet.Services.SessionId, TlsSetSessionId, (Tls, SessionId, SessionIdLen), EFI_UNSUPPORTED);
 }
 
+/**
+  Sets a TLS/SSL session to be resumed by the TLS connection.
+
+  This function sets a session, which was returned by TlsGetSession() for an
+  earlier connection to the same server, to be offered for resumption when the
+  TLS/SSL connection is established. The TLS object takes its own reference to
+  the session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS/SSL session to be resumed.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session can't be used by the TLS object.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+CryptoServiceTlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  )
+{
+  return CALL_BASECRYPTLIB (TlsSet.Services.Session, TlsSetSession, (Tls, Session), EFI_UNSUPPORTED);
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -4297,6 +4420,32 @@ CryptoServiceTlsGetSessionId (
   return CALL_BASECRYPTLIB (TlsGet.Services.SessionId, TlsGetSessionId, (Tls, SessionId, SessionIdLen), EFI_UNSUPPORTED);
 }
 
+/**
+  Gets the TLS/SSL session negotiated by the specified TLS connection.
+
+  This function returns a reference to the session negotiated by the specified
+  TLS connection if later connections to the same server can resume it. The
+  caller is responsible for releasing the session with TlsSessionFree().
+
+  @param[in]   Tls            Pointer to the TLS object.
+  @param[out]  Session        Pointer to the returned TLS/SSL session.
+
+  @retval  EFI_SUCCESS           The session was returned successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_NOT_FOUND         No resumable session was negotiated.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+CryptoServiceTlsGetSession (
+  IN     VOID  *Tls,
+  OUT    VOID  **Session
+  )
+{
+  return CALL_BASECRYPTLIB (TlsGet.Services.Session, TlsGetSession, (Tls, Session), EFI_UNSUPPORTED);
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -4670,5 +4819,12 @@ const EDKII_CRYPTO_PROTOCOL  mEdkiiCrypto = {
   CryptoServiceTlsGetCaCertificate,
   CryptoServiceTlsGetHostPublicCert,
   CryptoServiceTlsGetHostPrivateKey,
-  CryptoServiceTlsGetCertRevocationList
+  CryptoServiceTlsGetCertRevocationList,
+  /// RSA PSS
+  CryptoServiceRsaPssSign,
+  CryptoServiceRsaPssVerify,
+  /// TLS (Continued)
+  CryptoServiceTlsSessionFree,
+  CryptoServiceTlsSetSession,
+  CryptoServiceTlsGetSession
 };
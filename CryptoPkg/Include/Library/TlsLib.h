@@ -71,6 +71,21 @@ TlsFree (
   IN     VOID  *Tls
   );
 
+/**
+  Free a TLS/SSL session returned by TlsGetSession().
+
+  This function releases the reference to the TLS/SSL session pointed to by
+  Session. If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS/SSL session to be freed.
+
+**/
+VOID
+EFIAPI
+TlsSessionFree (
+  IN     VOID  *Session
+  );
+
 /**
   Create a new TLS object for a connection.
 
@@ -439,6 +454,30 @@ TlsSetSessionId (
   IN     UINT16  SessionIdLen
   );
 
+/**
+  Sets a TLS/SSL session to be resumed by the TLS connection.
+
+  This function sets a session, which was returned by TlsGetSession() for an
+  earlier connection to the same server, to be offered for resumption when the
+  TLS/SSL connection is established. The TLS object takes its own reference to
+  the session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS/SSL session to be resumed.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session can't be used by the TLS object.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  );
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -658,6 +697,29 @@ TlsGetSessionId (
   IN OUT UINT16  *SessionIdLen
   );
 
+/**
+  Gets the TLS/SSL session negotiated by the specified TLS connection.
+
+  This function returns a reference to the session negotiated by the specified
+  TLS connection if later connections to the same server can resume it. The
+  caller is responsible for releasing the session with TlsSessionFree().
+
+  @param[in]   Tls            Pointer to the TLS object.
+  @param[out]  Session        Pointer to the returned TLS/SSL session.
+
+  @retval  EFI_SUCCESS           The session was returned successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_NOT_FOUND         No resumable session was negotiated.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetSession (
+  IN     VOID  *Tls,
+  OUT    VOID  **Session
+  );
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -125,6 +125,8 @@ typedef struct {
       UINT8    Pkcs1Verify          : 1;
       UINT8    GetPrivateKeyFromPem : 1;
       UINT8    GetPublicKeyFromX509 : 1;
+      UINT8    PssSign              : 1;
+      UINT8    PssVerify            : 1;
     } Services;
     UINT32    Family;
   } Rsa;
@@ -251,6 +253,7 @@ typedef struct {
       UINT8    CtrlTrafficIn  : 1;
       UINT8    Read           : 1;
       UINT8    Write          : 1;
+      UINT8    SessionFree    : 1;
     } Services;
     UINT32    Family;
   } Tls;
@@ -267,6 +270,7 @@ typedef struct {
       UINT8    HostPublicCert     : 1;
       UINT8    HostPrivateKey     : 1;
       UINT8    CertRevocationList : 1;
+      UINT8    Session            : 1;
     } Services;
     UINT32    Family;
   } TlsSet;
@@ -285,6 +289,7 @@ typedef struct {
       UINT8    HostPublicCert       : 1;
       UINT8    HostPrivateKey       : 1;
       UINT8    CertRevocationList   : 1;
+      UINT8    Session              : 1;
     } Services;
     UINT32    Family;
   } TlsGet;
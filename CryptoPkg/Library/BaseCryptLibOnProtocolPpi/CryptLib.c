@@ -2743,6 +2743,24 @@ TlsFree (
   CALL_VOID_CRYPTO_SERVICE (TlsFree, (Tls));
 }
 
+/**
+  Free a TLS/SSL session returned by TlsGetSession().
+
+  This function releases the reference to the TLS/SSL session pointed to by
+  Session. If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS/SSL session to be freed.
+
+**/
+VOID
+EFIAPI
+TlsSessionFree (
+  IN     VOID  *Session
+  )
+{
+  CALL_VOID_CRYPTO_SERVICE (TlsSessionFree, (Session));
+}
+
 /**
   Create a new TLS object for a connection.
 
@@ -3159,6 +3177,33 @@ TlsSetSessionId (
   CALL_CRYPTO_SERVICE (TlsSetSessionId, (Tls, SessionId, SessionIdLen), EFI_UNSUPPORTED);
 }
 
+/**
+  Sets a TLS/SSL session to be resumed by the TLS connection.
+
+  This function sets a session, which was returned by TlsGetSession() for an
+  earlier connection to the same server, to be offered for resumption when the
+  TLS/SSL connection is established. The TLS object takes its own reference to
+  the session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS/SSL session to be resumed.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session can't be used by the TLS object.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  )
+{
+  CALL_CRYPTO_SERVICE (TlsSetSession, (Tls, Session), EFI_UNSUPPORTED);
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -3408,6 +3453,32 @@ TlsGetSessionId (
   CALL_CRYPTO_SERVICE (TlsGetSessionId, (Tls, SessionId, SessionIdLen), EFI_UNSUPPORTED);
 }
 
+/**
+  Gets the TLS/SSL session negotiated by the specified TLS connection.
+
+  This function returns a reference to the session negotiated by the specified
+  TLS connection if later connections to the same server can resume it. The
+  caller is responsible for releasing the session with TlsSessionFree().
+
+  @param[in]   Tls            Pointer to the TLS object.
+  @param[out]  Session        Pointer to the returned TLS/SSL session.
+
+  @retval  EFI_SUCCESS           The session was returned successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_NOT_FOUND         No resumable session was negotiated.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetSession (
+  IN     VOID  *Tls,
+  OUT    VOID  **Session
+  )
+{
+  CALL_CRYPTO_SERVICE (TlsGetSession, (Tls, Session), EFI_UNSUPPORTED);
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -637,6 +637,45 @@ TlsSetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Sets a TLS/SSL session to be resumed by the TLS connection.
+
+  This function sets a session, which was returned by TlsGetSession() for an
+  earlier connection to the same server, to be offered for resumption when the
+  TLS/SSL connection is established. The TLS object takes its own reference to
+  the session.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS/SSL session to be resumed.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session can't be used by the TLS object.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL) || (Session == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (SSL_set_session (TlsConn->Ssl, (SSL_SESSION *)Session) != 1) {
+    return EFI_ABORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -1075,6 +1114,57 @@ TlsGetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Gets the TLS/SSL session negotiated by the specified TLS connection.
+
+  This function returns a reference to the session negotiated by the specified
+  TLS connection if later connections to the same server can resume it. The
+  caller is responsible for releasing the session with TlsSessionFree().
+
+  @param[in]   Tls            Pointer to the TLS object.
+  @param[out]  Session        Pointer to the returned TLS/SSL session.
+
+  @retval  EFI_SUCCESS           The session was returned successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_NOT_FOUND         No resumable session was negotiated.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetSession (
+  IN     VOID  *Tls,
+  OUT    VOID  **Session
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+  SSL_SESSION     *SslSession;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL) || (Session == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // A TLS 1.3 session only becomes resumable once the server has sent a
+  // NewSessionTicket message after the handshake.
+  //
+  SslSession = SSL_get1_session (TlsConn->Ssl);
+  if (SslSession == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (SSL_SESSION_is_resumable (SslSession) != 1) {
+    SSL_SESSION_free (SslSession);
+    return EFI_NOT_FOUND;
+  }
+
+  *Session = (VOID *)SslSession;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
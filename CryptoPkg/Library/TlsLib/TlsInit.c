@@ -141,6 +141,28 @@ TlsFree (
   OPENSSL_free (Tls);
 }
 
+/**
+  Free a TLS/SSL session returned by TlsGetSession().
+
+  This function releases the reference to the TLS/SSL session pointed to by
+  Session. If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS/SSL session to be freed.
+
+**/
+VOID
+EFIAPI
+TlsSessionFree (
+  IN     VOID  *Session
+  )
+{
+  if (Session == NULL) {
+    return;
+  }
+
+  SSL_SESSION_free ((SSL_SESSION *)Session);
+}
+
 /**
   Create a new TLS object for a connection.
 
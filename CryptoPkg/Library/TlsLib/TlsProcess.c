@@ -115,6 +115,16 @@ TlsDoHandshake (
       BIO_write (TlsConn->InBio, BufferIn, (UINT32)BufferInSize);
       Ret               = SSL_do_handshake (TlsConn->Ssl);
       PendingBufferSize = (UINTN)BIO_ctrl_pending (TlsConn->OutBio);
+      if (Ret == 1) {
+        DEBUG ((
+          DEBUG_INFO,
+          "%a: %a %a handshake completed with %a\n",
+          __FUNCTION__,
+          SSL_session_reused (TlsConn->Ssl) ? "Abbreviated" : "Full",
+          SSL_get_version (TlsConn->Ssl),
+          SSL_get_cipher_name (TlsConn->Ssl)
+          ));
+      }
     }
   }
 
@@ -86,6 +86,24 @@ TlsFree (
   ASSERT (FALSE);
 }
 
+/**
+  Free a TLS/SSL session returned by TlsGetSession().
+
+  This function releases the reference to the TLS/SSL session pointed to by
+  Session. If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS/SSL session to be freed.
+
+**/
+VOID
+EFIAPI
+TlsSessionFree (
+  IN     VOID  *Session
+  )
+{
+  ASSERT (FALSE);
+}
+
 /**
   Create a new TLS object for a connection.
 
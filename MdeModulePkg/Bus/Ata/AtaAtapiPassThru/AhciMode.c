@@ -601,6 +601,90 @@ AhciBuildCommandFis (
   CmdFis->AhciCFisDevHead = (UINT8)(AtaCommandBlock->AtaDeviceHead | 0xE0);
 }
 
+/**
+  Build a queued command in its command slot.
+
+  The command uses the command table of the slot, so commands in different
+  slots can be outstanding at the same time.
+
+  @param    AhciRegisters         The pointer to the EFI_AHCI_REGISTERS.
+  @param    PortMultiplier        The multiplier of port.
+  @param    CommandSlotNumber     The command slot will be used for the transfer.
+  @param    AtaCommandBlock       The READ/WRITE FPDMA QUEUED command block.
+  @param    Read                  The transfer direction.
+  @param    DataPhysicalAddr      The pci bus master address of the data buffer.
+  @param    DataLength            The data count to be transferred.
+
+  @retval EFI_SUCCESS             The command is built.
+  @retval EFI_BAD_BUFFER_SIZE     The transfer doesn't fit in the command table.
+
+**/
+EFI_STATUS
+AhciBuildQueuedCommand (
+  IN EFI_AHCI_REGISTERS     *AhciRegisters,
+  IN UINT8                  PortMultiplier,
+  IN UINT8                  CommandSlotNumber,
+  IN EFI_ATA_COMMAND_BLOCK  *AtaCommandBlock,
+  IN BOOLEAN                Read,
+  IN EFI_PHYSICAL_ADDRESS   DataPhysicalAddr,
+  IN UINT32                 DataLength
+  )
+{
+  EFI_AHCI_QUEUED_COMMAND_TABLE  *CommandTable;
+  EFI_AHCI_COMMAND_LIST          *CommandList;
+  UINT32                         PrdtNumber;
+  UINT32                         PrdtIndex;
+  UINTN                          RemainedData;
+  UINT64                         MemAddr;
+  DATA_64                        Data64;
+
+  PrdtNumber = (UINT32)DivU64x32 (((UINT64)DataLength + EFI_AHCI_MAX_DATA_PER_PRDT - 1), EFI_AHCI_MAX_DATA_PER_PRDT);
+  if ((PrdtNumber == 0) || (PrdtNumber > EFI_AHCI_QUEUED_PRDT_NUMBER)) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  CommandTable = &AhciRegisters->AhciQueuedCommandTable[CommandSlotNumber];
+  ZeroMem (CommandTable, sizeof (EFI_AHCI_QUEUED_COMMAND_TABLE));
+
+  AhciBuildCommandFis (&CommandTable->CommandFis, AtaCommandBlock);
+  //
+  // The tag of a queued command is carried in the sector count field. The
+  // device field is used as is, its bit 7 is the FUA bit of the command.
+  //
+  CommandTable->CommandFis.AhciCFisSecCount = (UINT8)(CommandSlotNumber << 3);
+  CommandTable->CommandFis.AhciCFisDevHead  = AtaCommandBlock->AtaDeviceHead;
+  CommandTable->CommandFis.AhciCFisPmNum    = PortMultiplier;
+
+  RemainedData = (UINTN)DataLength;
+  MemAddr      = DataPhysicalAddr;
+  for (PrdtIndex = 0; PrdtIndex < PrdtNumber; PrdtIndex++) {
+    if (RemainedData < EFI_AHCI_MAX_DATA_PER_PRDT) {
+      CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbc = (UINT32)RemainedData - 1;
+    } else {
+      CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbc = EFI_AHCI_MAX_DATA_PER_PRDT - 1;
+    }
+
+    Data64.Uint64                                   = MemAddr;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDba  = Data64.Uint32.Lower32;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbau = Data64.Uint32.Upper32;
+    RemainedData                                   -= EFI_AHCI_MAX_DATA_PER_PRDT;
+    MemAddr                                        += EFI_AHCI_MAX_DATA_PER_PRDT;
+  }
+
+  CommandList = &AhciRegisters->AhciCmdList[CommandSlotNumber];
+  ZeroMem (CommandList, sizeof (EFI_AHCI_COMMAND_LIST));
+
+  Data64.Uint64             = (UINT64)(UINTN)&AhciRegisters->AhciQueuedCommandTablePciAddr[CommandSlotNumber];
+  CommandList->AhciCmdCfl   = EFI_AHCI_FIS_REGISTER_H2D_LENGTH / 4;
+  CommandList->AhciCmdW     = Read ? 0 : 1;
+  CommandList->AhciCmdPmp   = PortMultiplier;
+  CommandList->AhciCmdPrdtl = PrdtNumber;
+  CommandList->AhciCmdCtba  = Data64.Uint32.Lower32;
+  CommandList->AhciCmdCtbau = Data64.Uint32.Upper32;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Wait until SATA device reports it is ready for operation.
 
@@ -1497,28 +1581,25 @@ AhciStopCommand (
 }
 
 /**
-  Start command for give slot on specific port.
+  Start the command list DMA engine of specific port.
 
   @param  PciIo              The PCI IO protocol instance.
   @param  Port               The number of port.
-  @param  CommandSlot        The number of Command Slot.
   @param  Timeout            The timeout value of start, uses 100ns as a unit.
 
-  @retval EFI_DEVICE_ERROR   The command start unsuccessfully.
+  @retval EFI_DEVICE_ERROR   The command engine start unsuccessfully.
   @retval EFI_TIMEOUT        The operation is time out.
-  @retval EFI_SUCCESS        The command start successfully.
+  @retval EFI_SUCCESS        The command engine start successfully.
 
 **/
 EFI_STATUS
 EFIAPI
-AhciStartCommand (
+AhciStartCommandEngine (
   IN  EFI_PCI_IO_PROTOCOL  *PciIo,
   IN  UINT8                Port,
-  IN  UINT8                CommandSlot,
   IN  UINT64               Timeout
   )
 {
-  UINT32      CmdSlotBit;
   EFI_STATUS  Status;
   UINT32      PortStatus;
   UINT32      StartCmd;
@@ -1531,8 +1612,6 @@ AhciStartCommand (
   //
   Capability = AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET);
 
-  CmdSlotBit = (UINT32)(1 << CommandSlot);
-
   AhciClearPortStatus (
     PciIo,
     Port
@@ -1579,6 +1658,42 @@ AhciStartCommand (
   Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
   AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_ST | StartCmd);
 
+  return EFI_SUCCESS;
+}
+
+/**
+  Start command for give slot on specific port.
+
+  @param  PciIo              The PCI IO protocol instance.
+  @param  Port               The number of port.
+  @param  CommandSlot        The number of Command Slot.
+  @param  Timeout            The timeout value of start, uses 100ns as a unit.
+
+  @retval EFI_DEVICE_ERROR   The command start unsuccessfully.
+  @retval EFI_TIMEOUT        The operation is time out.
+  @retval EFI_SUCCESS        The command start successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciStartCommand (
+  IN  EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN  UINT8                Port,
+  IN  UINT8                CommandSlot,
+  IN  UINT64               Timeout
+  )
+{
+  UINT32      CmdSlotBit;
+  EFI_STATUS  Status;
+  UINT32      Offset;
+
+  CmdSlotBit = (UINT32)(1 << CommandSlot);
+
+  Status = AhciStartCommandEngine (PciIo, Port, Timeout);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   //
   // Setting the command
   //
@@ -2385,6 +2500,83 @@ Error6:
   return Status;
 }
 
+/**
+  Allocate the command tables used by the queued commands, one for each
+  command slot of the HBA.
+
+  @param  PciIo                 The PCI IO protocol instance.
+  @param  AhciRegisters         The pointer to the EFI_AHCI_REGISTERS.
+
+  @retval EFI_SUCCESS           The command tables are allocated.
+  @retval EFI_OUT_OF_RESOURCES  The command tables can't be allocated.
+  @retval EFI_DEVICE_ERROR      The command tables are above 4GB and the HBA
+                                doesn't support 64bit addressing.
+
+**/
+EFI_STATUS
+AhciCreateQueuedCommandTables (
+  IN     EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN OUT EFI_AHCI_REGISTERS   *AhciRegisters
+  )
+{
+  EFI_STATUS            Status;
+  UINT32                Capability;
+  UINT8                 MaxCommandSlotNumber;
+  UINT64                MaxQueuedCommandTableSize;
+  UINTN                 Bytes;
+  VOID                  *Buffer;
+  EFI_PHYSICAL_ADDRESS  AhciQueuedCommandTablePciAddr;
+
+  Capability           = AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET);
+  MaxCommandSlotNumber = (UINT8)(((Capability & 0x1F00) >> 8) + 1);
+
+  MaxQueuedCommandTableSize = MaxCommandSlotNumber * sizeof (EFI_AHCI_QUEUED_COMMAND_TABLE);
+  Status                    = PciIo->AllocateBuffer (
+                                       PciIo,
+                                       AllocateAnyPages,
+                                       EfiBootServicesData,
+                                       EFI_SIZE_TO_PAGES ((UINTN)MaxQueuedCommandTableSize),
+                                       &Buffer,
+                                       0
+                                       );
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (Buffer, (UINTN)MaxQueuedCommandTableSize);
+
+  Bytes  = (UINTN)MaxQueuedCommandTableSize;
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Buffer,
+                    &Bytes,
+                    &AhciQueuedCommandTablePciAddr,
+                    &AhciRegisters->MapQueuedCommandTable
+                    );
+  if (EFI_ERROR (Status) || (Bytes != MaxQueuedCommandTableSize)) {
+    if (!EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, AhciRegisters->MapQueuedCommandTable);
+    }
+
+    PciIo->FreeBuffer (PciIo, EFI_SIZE_TO_PAGES ((UINTN)MaxQueuedCommandTableSize), Buffer);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (((Capability & EFI_AHCI_CAP_S64A) == 0) && (AhciQueuedCommandTablePciAddr > 0x100000000ULL)) {
+    PciIo->Unmap (PciIo, AhciRegisters->MapQueuedCommandTable);
+    PciIo->FreeBuffer (PciIo, EFI_SIZE_TO_PAGES ((UINTN)MaxQueuedCommandTableSize), Buffer);
+    return EFI_DEVICE_ERROR;
+  }
+
+  AhciRegisters->AhciQueuedCommandTable        = Buffer;
+  AhciRegisters->AhciQueuedCommandTablePciAddr = (EFI_AHCI_QUEUED_COMMAND_TABLE *)(UINTN)AhciQueuedCommandTablePciAddr;
+  AhciRegisters->MaxQueuedCommandTableSize     = MaxQueuedCommandTableSize;
+  AhciRegisters->MaxQueuedCommands             = MaxCommandSlotNumber;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Read logs from SATA device.
 
@@ -2784,6 +2976,432 @@ AhciPuisEnable (
   return Status;
 }
 
+/**
+  Check whether a non-blocking task is a queued command for specific port.
+
+  @param[in]  Task            The non-blocking task.
+  @param[in]  Port            The port number of the ATA device.
+  @param[in]  PortMultiplier  The port multiplier port number of the ATA device.
+
+  @retval TRUE                The task is a READ/WRITE FPDMA QUEUED command
+                              for the device.
+  @retval FALSE               The task is another command or for another device.
+
+**/
+BOOLEAN
+AhciIsQueuedTask (
+  IN ATA_NONBLOCK_TASK  *Task,
+  IN UINT16             Port,
+  IN UINT16             PortMultiplier
+  )
+{
+  return (BOOLEAN)((Task->Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) &&
+                   (Task->Port == Port) &&
+                   (Task->PortMultiplier == PortMultiplier));
+}
+
+/**
+  Complete a queued command, remove its task from the non-blocking task list
+  and signal the event of the task.
+
+  @param[in]  Instance        A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Task            The task of the queued command.
+  @param[in]  AtaStatus       The status reported for the command.
+  @param[in]  AtaError        The error reported for the command.
+
+**/
+VOID
+AhciCompleteQueuedTask (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN ATA_NONBLOCK_TASK             *Task,
+  IN UINT8                         AtaStatus,
+  IN UINT8                         AtaError
+  )
+{
+  if (Task->Map != NULL) {
+    Instance->PciIo->Unmap (Instance->PciIo, Task->Map);
+    Task->Map = NULL;
+  }
+
+  ZeroMem (Task->Packet->Asb, sizeof (EFI_ATA_STATUS_BLOCK));
+  Task->Packet->Asb->AtaStatus = AtaStatus;
+  Task->Packet->Asb->AtaError  = AtaError;
+
+  RemoveEntryList (&Task->Link);
+  gBS->SignalEvent (Task->Event);
+  FreePool (Task);
+}
+
+/**
+  Reset the port after its queued commands are aborted.
+
+  Stopping the command engine doesn't abort the commands the device still
+  has outstanding, and a queued command issued later with the same tag would
+  be rejected or confused with them. A COMRESET discards them in the device.
+  The command engine of the port must be stopped and the FIS receive must
+  still be enabled.
+
+  @param[in]  PciIo           The PCI IO protocol instance.
+  @param[in]  Port            The port number of the ATA device.
+
+**/
+VOID
+AhciResetQueuedPort (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN UINT8                Port
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = AhciResetPort (PciIo, Port);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "AHCI: Failed to reset port %d - %r\n", Port, Status));
+  }
+
+  AhciClearPortStatus (PciIo, Port);
+}
+
+/**
+  Recover the port from an error of the queued commands.
+
+  All the outstanding commands of the port are aborted. The NCQ Command Error
+  log tells which of them failed: that command completes with the error and
+  the other ones are issued again. If the failed command can't be told, all
+  the aborted commands complete with an error. If the log can't be read, the
+  port is reset before its command slots are used again.
+
+  @param[in]  Instance        A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Port            The port number of the ATA device.
+  @param[in]  PortMultiplier  The port multiplier port number of the ATA device.
+
+**/
+VOID
+AhciRecoverQueuedCommands (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN UINT16                        Port,
+  IN UINT16                        PortMultiplier
+  )
+{
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  LIST_ENTRY           *List;
+  LIST_ENTRY           *Entry;
+  LIST_ENTRY           *NextEntry;
+  ATA_NONBLOCK_TASK    *Task;
+  EFI_STATUS           Status;
+  UINT8                ErrorLog[512];
+  BOOLEAN              TagValid;
+
+  PciIo    = Instance->PciIo;
+  List     = &Instance->NonBlockingTaskList;
+  TagValid = FALSE;
+
+  AhciStopCommand (PciIo, (UINT8)Port, ATA_ATAPI_TIMEOUT);
+  Status = AhciRecoverPortError (PciIo, (UINT8)Port);
+  if (!EFI_ERROR (Status)) {
+    //
+    // Reading the log also takes the device out of its error state, so that
+    // it accepts queued commands again.
+    //
+    Status = AhciReadLogExt (
+               PciIo,
+               &Instance->AhciRegisters,
+               (UINT8)Port,
+               (UINT8)((PortMultiplier == 0xFFFF) ? 0 : PortMultiplier),
+               ErrorLog,
+               AHCI_NCQ_COMMAND_ERROR_LOG,
+               0
+               );
+    if (!EFI_ERROR (Status) && ((ErrorLog[0] & AHCI_NCQ_ERROR_LOG_NQ) == 0)) {
+      TagValid = TRUE;
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    AhciResetQueuedPort (PciIo, (UINT8)Port);
+  }
+
+  AhciDisableFisReceive (PciIo, (UINT8)Port, ATA_ATAPI_TIMEOUT);
+
+  for (Entry = GetFirstNode (List); !IsNull (List, Entry); Entry = NextEntry) {
+    NextEntry = GetNextNode (List, Entry);
+    Task      = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+    if (!AhciIsQueuedTask (Task, Port, PortMultiplier)) {
+      break;
+    }
+
+    if (!Task->IsStart) {
+      continue;
+    }
+
+    if (TagValid && (Task->Slot != (ErrorLog[0] & AHCI_NCQ_ERROR_LOG_TAG))) {
+      //
+      // The command was aborted because of the error of another one.
+      //
+      PciIo->Unmap (PciIo, Task->Map);
+      Task->Map     = NULL;
+      Task->IsStart = FALSE;
+      continue;
+    }
+
+    DEBUG ((DEBUG_ERROR, "AHCI: Queued command failed on port %d, slot %d\n", Port, Task->Slot));
+    AhciPrintCommandBlock (Task->Packet->Acb, DEBUG_ERROR);
+    if (TagValid) {
+      AhciCompleteQueuedTask (Instance, Task, (UINT8)(ErrorLog[2] | ATA_STSREG_ERR), ErrorLog[3]);
+    } else {
+      AhciCompleteQueuedTask (Instance, Task, ATA_STSREG_ERR, 0);
+    }
+  }
+}
+
+/**
+  Issue and complete the READ/WRITE FPDMA QUEUED commands at the head of the
+  non-blocking task list.
+
+  The queued commands at the head of the list that are for the same device are
+  issued together in the free command slots of its port, up to the queue depth
+  of the device, and complete in any order. The tasks of completed commands are
+  removed from the list and their events are signaled. The command engine of
+  the port keeps running until all of them are completed.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+  @retval EFI_SUCCESS           The queued commands at the head of the list are
+                                completed.
+  @retval EFI_NOT_READY         Queued commands are still outstanding.
+  @retval EFI_TIMEOUT           A queued command timed out. The outstanding
+                                commands of the port are aborted and the port
+                                is reset.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciQueuedTransfer (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  )
+{
+  EFI_PCI_IO_PROTOCOL               *PciIo;
+  EFI_AHCI_REGISTERS                *AhciRegisters;
+  LIST_ENTRY                        *List;
+  LIST_ENTRY                        *Entry;
+  LIST_ENTRY                        *NextEntry;
+  LIST_ENTRY                        *Node;
+  ATA_NONBLOCK_TASK                 *Task;
+  EFI_ATA_DEVICE_INFO               *DeviceInfo;
+  EFI_ATA_PASS_THRU_COMMAND_PACKET  *Packet;
+  UINT16                            Port;
+  UINT16                            PortMultiplier;
+  UINT32                            Offset;
+  UINT32                            PortInterrupt;
+  UINT32                            Active;
+  UINT32                            SlotMap;
+  UINT32                            SlotBit;
+  UINT32                            QueueDepth;
+  UINT8                             Slot;
+  BOOLEAN                           Running;
+  BOOLEAN                           Read;
+  VOID                              *Buffer;
+  UINT32                            Length;
+  UINTN                             MapLength;
+  EFI_PHYSICAL_ADDRESS              PhyAddr;
+  EFI_STATUS                        Status;
+
+  PciIo         = Instance->PciIo;
+  AhciRegisters = &Instance->AhciRegisters;
+  List          = &Instance->NonBlockingTaskList;
+
+  Task           = ATA_NON_BLOCK_TASK_FROM_ENTRY (GetFirstNode (List));
+  Port           = Task->Port;
+  PortMultiplier = Task->PortMultiplier;
+
+  //
+  // Collect the command slots of the outstanding commands. They all belong to
+  // the queued tasks at the head of the list.
+  //
+  SlotMap = 0;
+  for (Entry = GetFirstNode (List); !IsNull (List, Entry); Entry = GetNextNode (List, Entry)) {
+    Task = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+    if (!AhciIsQueuedTask (Task, Port, PortMultiplier)) {
+      break;
+    }
+
+    if (Task->IsStart) {
+      SlotMap |= ((UINT32)BIT0) << Task->Slot;
+    }
+  }
+
+  Running = (BOOLEAN)(SlotMap != 0);
+  if (Running) {
+    Offset        = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_IS;
+    PortInterrupt = AhciReadReg (PciIo, Offset);
+    if ((PortInterrupt & EFI_AHCI_PORT_IS_ERROR_MASK) != 0) {
+      DEBUG ((DEBUG_ERROR, "AHCI: Error interrupt reported PxIS: %X\n", PortInterrupt));
+      AhciRecoverQueuedCommands (Instance, Port, PortMultiplier);
+      SlotMap = 0;
+      Running = FALSE;
+    } else {
+      //
+      // A command is completed when the device has cleared its bit in PxSACT
+      // and the HBA has cleared it in PxCI.
+      //
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT;
+      Active = AhciReadReg (PciIo, Offset);
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI;
+      Active = Active | AhciReadReg (PciIo, Offset);
+
+      for (Entry = GetFirstNode (List); !IsNull (List, Entry); Entry = NextEntry) {
+        NextEntry = GetNextNode (List, Entry);
+        Task      = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+        if (!AhciIsQueuedTask (Task, Port, PortMultiplier)) {
+          break;
+        }
+
+        if (!Task->IsStart) {
+          continue;
+        }
+
+        SlotBit = ((UINT32)BIT0) << Task->Slot;
+        if ((Active & SlotBit) == 0) {
+          SlotMap &= ~SlotBit;
+          AhciCompleteQueuedTask (Instance, Task, ATA_STSREG_DRDY, 0);
+        } else if (!Task->InfiniteWait && (Task->RetryTimes == 0)) {
+          DEBUG ((DEBUG_ERROR, "AHCI: Queued command timeout on port %d, slot %d\n", Port, Task->Slot));
+          AhciStopCommand (PciIo, (UINT8)Port, ATA_ATAPI_TIMEOUT);
+          AhciResetQueuedPort (PciIo, (UINT8)Port);
+          AhciDisableFisReceive (PciIo, (UINT8)Port, ATA_ATAPI_TIMEOUT);
+          for (Entry = GetFirstNode (List); !IsNull (List, Entry); Entry = GetNextNode (List, Entry)) {
+            Task = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+            if (!AhciIsQueuedTask (Task, Port, PortMultiplier)) {
+              break;
+            }
+
+            if (Task->IsStart) {
+              PciIo->Unmap (PciIo, Task->Map);
+              Task->Map     = NULL;
+              Task->IsStart = FALSE;
+            }
+          }
+
+          return EFI_TIMEOUT;
+        } else {
+          Task->RetryTimes--;
+        }
+      }
+    }
+  }
+
+  //
+  // Issue the tasks that aren't started yet in the free command slots.
+  //
+  QueueDepth = AhciRegisters->MaxQueuedCommands;
+  Node       = SearchDeviceInfoList (Instance, Port, PortMultiplier, EfiIdeHarddisk);
+  if (Node != NULL) {
+    DeviceInfo = ATA_ATAPI_DEVICE_INFO_FROM_THIS (Node);
+    QueueDepth = MIN (QueueDepth, (UINT32)(DeviceInfo->IdentifyData->AtaData.queue_depth & 0x1F) + 1);
+  }
+
+  Slot = 0;
+  for (Entry = GetFirstNode (List); !IsNull (List, Entry); Entry = NextEntry) {
+    NextEntry = GetNextNode (List, Entry);
+    Task      = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+    if (!AhciIsQueuedTask (Task, Port, PortMultiplier)) {
+      break;
+    }
+
+    if (Task->IsStart) {
+      continue;
+    }
+
+    while ((Slot < QueueDepth) && ((SlotMap & (((UINT32)BIT0) << Slot)) != 0)) {
+      Slot++;
+    }
+
+    if (Slot >= QueueDepth) {
+      break;
+    }
+
+    Packet = Task->Packet;
+    Read   = (BOOLEAN)(Packet->InTransferLength != 0);
+    if (Read) {
+      Buffer = Packet->InDataBuffer;
+      Length = Packet->InTransferLength;
+    } else {
+      Buffer = Packet->OutDataBuffer;
+      Length = Packet->OutTransferLength;
+    }
+
+    MapLength = Length;
+    Status    = PciIo->Map (
+                         PciIo,
+                         Read ? EfiPciIoOperationBusMasterWrite : EfiPciIoOperationBusMasterRead,
+                         Buffer,
+                         &MapLength,
+                         &PhyAddr,
+                         &Task->Map
+                         );
+    if (EFI_ERROR (Status) || (MapLength != Length)) {
+      if (EFI_ERROR (Status)) {
+        Task->Map = NULL;
+      }
+
+      AhciCompleteQueuedTask (Instance, Task, ATA_STSREG_ERR, 0);
+      continue;
+    }
+
+    Status = AhciBuildQueuedCommand (
+               AhciRegisters,
+               (UINT8)((PortMultiplier == 0xFFFF) ? 0 : PortMultiplier),
+               Slot,
+               Packet->Acb,
+               Read,
+               PhyAddr,
+               Length
+               );
+    if (EFI_ERROR (Status)) {
+      AhciCompleteQueuedTask (Instance, Task, ATA_STSREG_ERR, 0);
+      continue;
+    }
+
+    if (!Running) {
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
+      AhciAndReg (PciIo, Offset, (UINT32) ~(EFI_AHCI_PORT_CMD_DLAE | EFI_AHCI_PORT_CMD_ATAPI));
+      Status = AhciStartCommandEngine (PciIo, (UINT8)Port, ATA_ATAPI_TIMEOUT);
+      if (EFI_ERROR (Status)) {
+        AhciCompleteQueuedTask (Instance, Task, ATA_STSREG_ERR, 0);
+        continue;
+      }
+
+      Running = TRUE;
+    }
+
+    DEBUG ((DEBUG_VERBOSE, "Starting queued command in slot %d:\n", Slot));
+    AhciPrintCommandBlock (Packet->Acb, DEBUG_VERBOSE);
+
+    //
+    // The bit of a queued command is set in PxSACT before it is set in PxCI.
+    //
+    SlotBit = ((UINT32)BIT0) << Slot;
+    Offset  = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT;
+    AhciWriteReg (PciIo, Offset, SlotBit);
+    Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI;
+    AhciWriteReg (PciIo, Offset, SlotBit);
+
+    Task->Slot    = Slot;
+    Task->IsStart = TRUE;
+    SlotMap      |= SlotBit;
+  }
+
+  if (SlotMap != 0) {
+    return EFI_NOT_READY;
+  }
+
+  if (Running) {
+    AhciStopCommand (PciIo, (UINT8)Port, ATA_ATAPI_TIMEOUT);
+    AhciDisableFisReceive (PciIo, (UINT8)Port, ATA_ATAPI_TIMEOUT);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Initialize ATA host controller at AHCI mode.
 
@@ -2883,6 +3501,17 @@ AhciModeInitialization (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  //
+  // Native command queuing is only used if the command tables of the queued
+  // commands can be allocated.
+  //
+  if ((Capability & EFI_AHCI_CAP_SNCQ) != 0) {
+    Status = AhciCreateQueuedCommandTables (PciIo, AhciRegisters);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "AhciModeInitialization: native command queuing isn't used (%r)\n", Status));
+    }
+  }
+
   for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
     if ((PortImplementBitMap & (((UINT32)BIT0) << Port)) != 0) {
       //
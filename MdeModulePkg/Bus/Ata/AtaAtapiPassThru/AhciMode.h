@@ -14,6 +14,7 @@
 #define EFI_AHCI_CAPABILITY_OFFSET  0x0000
 #define   EFI_AHCI_CAP_SAM          BIT18
 #define   EFI_AHCI_CAP_SSS          BIT27
+#define   EFI_AHCI_CAP_SNCQ         BIT30
 #define   EFI_AHCI_CAP_S64A         BIT31
 #define EFI_AHCI_GHC_OFFSET         0x0004
 #define   EFI_AHCI_GHC_RESET        BIT0
@@ -195,6 +196,13 @@ typedef union {
 
 #define AHCI_COMMAND_RETRIES  5
 
+//
+// NCQ Command Error log, read to find the queued command that failed.
+//
+#define AHCI_NCQ_COMMAND_ERROR_LOG  0x10
+#define   AHCI_NCQ_ERROR_LOG_NQ     BIT7
+#define   AHCI_NCQ_ERROR_LOG_TAG    0x1F
+
 #pragma pack(1)
 //
 // Command List structure includes total 32 entries.
@@ -285,6 +293,21 @@ typedef struct {
   EFI_AHCI_COMMAND_PRDT     PrdtTable[65535];     // The scatter/gather list for data transfer
 } EFI_AHCI_COMMAND_TABLE;
 
+//
+// Command table of the queued commands. Each command slot has its own table.
+// The PRD table is large enough for the longest READ/WRITE FPDMA QUEUED
+// transfer, 65536 sectors of 4KB mapped as one range, and keeps the size of
+// the table a multiple of 128 bytes as required for its alignment.
+//
+#define EFI_AHCI_QUEUED_PRDT_NUMBER  64
+
+typedef struct {
+  EFI_AHCI_COMMAND_FIS      CommandFis;       // A software constructed FIS.
+  EFI_AHCI_ATAPI_COMMAND    AtapiCmd;         // 12 or 16 bytes ATAPI cmd.
+  UINT8                     Reserved[0x30];
+  EFI_AHCI_COMMAND_PRDT     PrdtTable[EFI_AHCI_QUEUED_PRDT_NUMBER];
+} EFI_AHCI_QUEUED_COMMAND_TABLE;
+
 //
 // Received FIS structure
 //
@@ -312,18 +335,27 @@ typedef struct {
 #pragma pack()
 
 typedef struct {
-  EFI_AHCI_RECEIVED_FIS     *AhciRFis;
-  EFI_AHCI_COMMAND_LIST     *AhciCmdList;
-  EFI_AHCI_COMMAND_TABLE    *AhciCommandTable;
-  EFI_AHCI_RECEIVED_FIS     *AhciRFisPciAddr;
-  EFI_AHCI_COMMAND_LIST     *AhciCmdListPciAddr;
-  EFI_AHCI_COMMAND_TABLE    *AhciCommandTablePciAddr;
-  UINT64                    MaxCommandListSize;
-  UINT64                    MaxCommandTableSize;
-  UINT64                    MaxReceiveFisSize;
-  VOID                      *MapRFis;
-  VOID                      *MapCmdList;
-  VOID                      *MapCommandTable;
+  EFI_AHCI_RECEIVED_FIS            *AhciRFis;
+  EFI_AHCI_COMMAND_LIST            *AhciCmdList;
+  EFI_AHCI_COMMAND_TABLE           *AhciCommandTable;
+  EFI_AHCI_RECEIVED_FIS            *AhciRFisPciAddr;
+  EFI_AHCI_COMMAND_LIST            *AhciCmdListPciAddr;
+  EFI_AHCI_COMMAND_TABLE           *AhciCommandTablePciAddr;
+  UINT64                           MaxCommandListSize;
+  UINT64                           MaxCommandTableSize;
+  UINT64                           MaxReceiveFisSize;
+  VOID                             *MapRFis;
+  VOID                             *MapCmdList;
+  VOID                             *MapCommandTable;
+  //
+  // Command tables of the queued commands, NULL if native command queuing
+  // isn't used.
+  //
+  EFI_AHCI_QUEUED_COMMAND_TABLE    *AhciQueuedCommandTable;
+  EFI_AHCI_QUEUED_COMMAND_TABLE    *AhciQueuedCommandTablePciAddr;
+  UINT64                           MaxQueuedCommandTableSize;
+  VOID                             *MapQueuedCommandTable;
+  UINT8                            MaxQueuedCommands;
 } EFI_AHCI_REGISTERS;
 
 /**
@@ -351,6 +383,26 @@ AhciPacketCommandExecute (
   IN  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet
   );
 
+/**
+  Start the command list DMA engine of specific port.
+
+  @param  PciIo              The PCI IO protocol instance.
+  @param  Port               The number of port.
+  @param  Timeout            The timeout value of start, uses 100ns as a unit.
+
+  @retval EFI_DEVICE_ERROR   The command engine start unsuccessfully.
+  @retval EFI_TIMEOUT        The operation is time out.
+  @retval EFI_SUCCESS        The command engine start successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciStartCommandEngine (
+  IN  EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN  UINT8                Port,
+  IN  UINT64               Timeout
+  );
+
 /**
   Start command for give slot on specific port.
 
@@ -418,6 +418,23 @@ AsyncNonBlockingTransferRoutine (
       return;
     }
 
+    //
+    // The queued commands at the head of the list are issued together, they
+    // complete in any order and their tasks are removed as they complete.
+    //
+    if (Task->Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) {
+      Status = AhciQueuedTransfer (Instance);
+      if (Status == EFI_SUCCESS) {
+        continue;
+      }
+
+      if (Status != EFI_NOT_READY) {
+        DestroyAsynTaskList (Instance, TRUE);
+      }
+
+      break;
+    }
+
     Status = AtaPassThruPassThruExecute (
                Task->Port,
                Task->PortMultiplier,
@@ -952,6 +969,18 @@ AtaAtapiPassThruStop (
   //
   if (Instance->Mode == EfiAtaAhciMode) {
     AhciRegisters = &Instance->AhciRegisters;
+    if (AhciRegisters->AhciQueuedCommandTable != NULL) {
+      PciIo->Unmap (
+               PciIo,
+               AhciRegisters->MapQueuedCommandTable
+               );
+      PciIo->FreeBuffer (
+               PciIo,
+               EFI_SIZE_TO_PAGES ((UINTN)AhciRegisters->MaxQueuedCommandTableSize),
+               AhciRegisters->AhciQueuedCommandTable
+               );
+    }
+
     PciIo->Unmap (
              PciIo,
              AhciRegisters->MapCommandTable
@@ -1378,6 +1407,21 @@ AtaPassThruPassThru (
     return EFI_BAD_BUFFER_SIZE;
   }
 
+  //
+  // READ/WRITE FPDMA QUEUED commands are only supported in non-blocking mode
+  // in AHCI mode, for devices that support native command queuing (Word 76
+  // bit 8).
+  //
+  if (Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) {
+    if ((Event == NULL) ||
+        (Instance->Mode != EfiAtaAhciMode) ||
+        (Instance->AhciRegisters.MaxQueuedCommands == 0) ||
+        ((IdentifyData->AtaData.serial_ata_capabilities & BIT8) == 0))
+    {
+      return EFI_UNSUPPORTED;
+    }
+  }
+
   //
   // For non-blocking mode, queue the Task into the list.
   //
@@ -139,6 +139,7 @@ struct _ATA_NONBLOCK_TASK {
   VOID                                *TableMap;       // Pointer to PRD table map.
   EFI_ATA_DMA_PRD                     *MapBaseAddress; //  Pointer to range Base address for Map.
   UINTN                               PageCount;       //  The page numbers used by PCIO freebuffer.
+  UINT8                               Slot;            //  Command slot of a queued command.
 };
 
 //
@@ -1193,6 +1194,31 @@ AhciPioTransfer (
   IN     ATA_NONBLOCK_TASK       *Task
   );
 
+/**
+  Issue and complete the READ/WRITE FPDMA QUEUED commands at the head of the
+  non-blocking task list.
+
+  The queued commands at the head of the list that are for the same device are
+  issued together in the free command slots of its port, up to the queue depth
+  of the device, and complete in any order. The tasks of completed commands are
+  removed from the list and their events are signaled. The command engine of
+  the port keeps running until all of them are completed.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+  @retval EFI_SUCCESS           The queued commands at the head of the list are
+                                completed.
+  @retval EFI_NOT_READY         Queued commands are still outstanding.
+  @retval EFI_TIMEOUT           A queued command timed out. The outstanding
+                                commands of the port are aborted.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciQueuedTransfer (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  );
+
 /**
   Send ATA command into device with NON_DATA protocol
 
@@ -25,6 +25,9 @@
 #define ATA_CMD_TRUST_SEND         0x5E
 #define ATA_CMD_TRUST_SEND_DMA     0x5F
 
+#define ATA_CMD_READ_FPDMA_QUEUED   0x60
+#define ATA_CMD_WRITE_FPDMA_QUEUED  0x61
+
 //
 // Look up table (UdmaValid, IsWrite) for EFI_ATA_PASS_THRU_CMD_PROTOCOL
 //
@@ -65,6 +68,14 @@ UINT8  mAtaCommands[][2][2] = {
   }
 };
 
+//
+// Look up table (IsWrite) for the queued ATA_CMD
+//
+UINT8  mAtaQueuedCommands[2] = {
+  ATA_CMD_READ_FPDMA_QUEUED,           // 48-bit LBA; queued DMA read
+  ATA_CMD_WRITE_FPDMA_QUEUED           // 48-bit LBA; queued DMA write
+};
+
 //
 // Look up table (UdmaValid, IsTrustSend) for ATA_CMD
 //
@@ -319,6 +330,17 @@ IdentifyAtaDevice (
     }
   }
 
+  //
+  // Check whether native command queuing is supported (Word 76 bit 8). The
+  // queued commands are DMA transfers.
+  //
+  if (AtaDevice->UdmaValid &&
+      (IdentifyData->serial_ata_capabilities != 0xFFFF) &&
+      ((IdentifyData->serial_ata_capabilities & BIT8) != 0))
+  {
+    AtaDevice->NcqValid = TRUE;
+  }
+
   Capacity = GetAtapi6Capacity (AtaDevice);
   if (Capacity > MAX_28BIT_ADDRESSING_CAPACITY) {
     //
@@ -469,8 +491,10 @@ TransferAtaDevice (
   IN EFI_EVENT                             Event OPTIONAL
   )
 {
+  EFI_STATUS                        Status;
   EFI_ATA_COMMAND_BLOCK             *Acb;
   EFI_ATA_PASS_THRU_COMMAND_PACKET  *Packet;
+  BOOLEAN                           Queued;
 
   //
   // Ensure AtaDevice->UdmaValid, AtaDevice->Lba48Bit and IsWrite are valid boolean values
@@ -478,23 +502,47 @@ TransferAtaDevice (
   ASSERT ((UINTN)AtaDevice->UdmaValid < 2);
   ASSERT ((UINTN)AtaDevice->Lba48Bit < 2);
   ASSERT ((UINTN)IsWrite < 2);
+
+  //
+  // Non-blocking requests use the queued commands when the device supports
+  // native command queuing, so that several of them can be outstanding.
+  //
+  Queued = (BOOLEAN)(AtaDevice->NcqValid && (TaskPacket != NULL));
+
   //
   // Prepare for ATA command block.
   //
-  Acb                  = ZeroMem (&AtaDevice->Acb, sizeof (EFI_ATA_COMMAND_BLOCK));
-  Acb->AtaCommand      = mAtaCommands[AtaDevice->UdmaValid][AtaDevice->Lba48Bit][IsWrite];
-  Acb->AtaSectorNumber = (UINT8)StartLba;
-  Acb->AtaCylinderLow  = (UINT8)RShiftU64 (StartLba, 8);
-  Acb->AtaCylinderHigh = (UINT8)RShiftU64 (StartLba, 16);
-  Acb->AtaDeviceHead   = (UINT8)(BIT7 | BIT6 | BIT5 | (AtaDevice->PortMultiplierPort == 0xFFFF ? 0 : (AtaDevice->PortMultiplierPort << 4)));
-  Acb->AtaSectorCount  = (UINT8)TransferLength;
-  if (AtaDevice->Lba48Bit) {
+  Acb = ZeroMem (&AtaDevice->Acb, sizeof (EFI_ATA_COMMAND_BLOCK));
+  if (Queued) {
+    //
+    // The sector count of a queued command is in the features field. The tag
+    // in the sector count field is assigned by the ATA pass through.
+    //
+    Acb->AtaCommand         = mAtaQueuedCommands[IsWrite];
+    Acb->AtaFeatures        = (UINT8)TransferLength;
+    Acb->AtaFeaturesExp     = (UINT8)(TransferLength >> 8);
+    Acb->AtaSectorNumber    = (UINT8)StartLba;
+    Acb->AtaCylinderLow     = (UINT8)RShiftU64 (StartLba, 8);
+    Acb->AtaCylinderHigh    = (UINT8)RShiftU64 (StartLba, 16);
     Acb->AtaSectorNumberExp = (UINT8)RShiftU64 (StartLba, 24);
     Acb->AtaCylinderLowExp  = (UINT8)RShiftU64 (StartLba, 32);
     Acb->AtaCylinderHighExp = (UINT8)RShiftU64 (StartLba, 40);
-    Acb->AtaSectorCountExp  = (UINT8)(TransferLength >> 8);
+    Acb->AtaDeviceHead      = BIT6;
   } else {
-    Acb->AtaDeviceHead = (UINT8)(Acb->AtaDeviceHead | RShiftU64 (StartLba, 24));
+    Acb->AtaCommand      = mAtaCommands[AtaDevice->UdmaValid][AtaDevice->Lba48Bit][IsWrite];
+    Acb->AtaSectorNumber = (UINT8)StartLba;
+    Acb->AtaCylinderLow  = (UINT8)RShiftU64 (StartLba, 8);
+    Acb->AtaCylinderHigh = (UINT8)RShiftU64 (StartLba, 16);
+    Acb->AtaDeviceHead   = (UINT8)(BIT7 | BIT6 | BIT5 | (AtaDevice->PortMultiplierPort == 0xFFFF ? 0 : (AtaDevice->PortMultiplierPort << 4)));
+    Acb->AtaSectorCount  = (UINT8)TransferLength;
+    if (AtaDevice->Lba48Bit) {
+      Acb->AtaSectorNumberExp = (UINT8)RShiftU64 (StartLba, 24);
+      Acb->AtaCylinderLowExp  = (UINT8)RShiftU64 (StartLba, 32);
+      Acb->AtaCylinderHighExp = (UINT8)RShiftU64 (StartLba, 40);
+      Acb->AtaSectorCountExp  = (UINT8)(TransferLength >> 8);
+    } else {
+      Acb->AtaDeviceHead = (UINT8)(Acb->AtaDeviceHead | RShiftU64 (StartLba, 24));
+    }
   }
 
   //
@@ -514,8 +562,13 @@ TransferAtaDevice (
     Packet->InTransferLength = TransferLength;
   }
 
-  Packet->Protocol = mAtaPassThruCmdProtocols[AtaDevice->UdmaValid][IsWrite];
-  Packet->Length   = EFI_ATA_PASS_THRU_LENGTH_SECTOR_COUNT;
+  if (Queued) {
+    Packet->Protocol = EFI_ATA_PASS_THRU_PROTOCOL_FPDMA;
+  } else {
+    Packet->Protocol = mAtaPassThruCmdProtocols[AtaDevice->UdmaValid][IsWrite];
+  }
+
+  Packet->Length = EFI_ATA_PASS_THRU_LENGTH_SECTOR_COUNT;
   //
   // |------------------------|-----------------|------------------------|-----------------|
   // | ATA PIO Transfer Mode  |  Transfer Rate  | ATA DMA Transfer Mode  |  Transfer Rate  |
@@ -549,7 +602,27 @@ TransferAtaDevice (
     Packet->Timeout = EFI_TIMER_PERIOD_SECONDS (DivU64x32 (MultU64x32 (TransferLength, AtaDevice->BlockMedia.BlockSize), 3300000) + 31);
   }
 
-  return AtaDevicePassThru (AtaDevice, TaskPacket, Event);
+  Status = AtaDevicePassThru (AtaDevice, TaskPacket, Event);
+  if (Queued && (Status == EFI_UNSUPPORTED)) {
+    //
+    // The ATA pass through doesn't issue queued commands to the device, use
+    // the DMA commands from now on.
+    //
+    DEBUG ((DEBUG_INFO, "AtaBus - Native command queuing isn't used: Port %x PortMultiplierPort %x\n", AtaDevice->Port, AtaDevice->PortMultiplierPort));
+    AtaDevice->NcqValid = FALSE;
+
+    if (TaskPacket->Asb != NULL) {
+      FreeAlignedBuffer (TaskPacket->Asb, sizeof (EFI_ATA_STATUS_BLOCK));
+    }
+
+    if (TaskPacket->Acb != NULL) {
+      FreePool (TaskPacket->Acb);
+    }
+
+    return TransferAtaDevice (AtaDevice, TaskPacket, Buffer, StartLba, TransferLength, IsWrite, Event);
+  }
+
+  return Status;
 }
 
 /**
@@ -806,7 +879,11 @@ AccessAtaDevice (
   if ((Token != NULL) && (Token->Event != NULL)) {
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
 
-    if (!IsListEmpty (&AtaDevice->AtaSubTaskList)) {
+    //
+    // Without native command queuing, the request waits for the sub tasks of
+    // the previous requests to complete.
+    //
+    if (!AtaDevice->NcqValid && !IsListEmpty (&AtaDevice->AtaSubTaskList)) {
       AtaTask = AllocateZeroPool (sizeof (ATA_BUS_ASYN_TASK));
       if (AtaTask == NULL) {
         gBS->RestoreTPL (OldTpl);
@@ -27,12 +27,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/UsbHcMemLib.h>
 
 #include <IndustryStandard/Pci.h>
 
 typedef struct _USB2_HC_DEV USB2_HC_DEV;
 
-#include "UsbHcMem.h"
 #include "EhciReg.h"
 #include "EhciUrb.h"
 #include "EhciSched.h"
@@ -63,7 +63,7 @@ EhcCreateHelpQ (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  PciAddr           = UsbHcGetPciAddressForHostMem (Ehc->MemPool, Qh, sizeof (EHC_QH));
+  PciAddr           = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, Qh, sizeof (EHC_QH));
   QhHw              = &Qh->QhHw;
   QhHw->HorizonLink = QH_LINK (PciAddr + OFFSET_OF (EHC_QH, QhHw), EHC_TYPE_QH, FALSE);
   QhHw->Status      = QTD_STAT_HALTED;
@@ -195,7 +195,7 @@ EhcInitSched (
     goto ErrorExit;
   }
 
-  PciAddr = UsbHcGetPciAddressForHostMem (Ehc->MemPool, Ehc->PeriodOne, sizeof (EHC_QH));
+  PciAddr = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, Ehc->PeriodOne, sizeof (EHC_QH));
 
   for (Index = 0; Index < EHC_FRAME_LEN; Index++) {
     //
@@ -213,7 +213,7 @@ EhcInitSched (
   // Only need to set the AsynListAddr register to
   // the reclamation header
   //
-  PciAddr = UsbHcGetPciAddressForHostMem (Ehc->MemPool, Ehc->ReclaimHead, sizeof (EHC_QH));
+  PciAddr = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, Ehc->ReclaimHead, sizeof (EHC_QH));
   EhcWriteOpReg (Ehc, EHC_ASYNC_HEAD_OFFSET, EHC_LOW_32BIT (PciAddr));
   return EFI_SUCCESS;
 
@@ -327,9 +327,9 @@ EhcLinkQhToAsync (
   Qh->NextQh   = Head->NextQh;
   Head->NextQh = Qh;
 
-  PciAddr                = UsbHcGetPciAddressForHostMem (Ehc->MemPool, Qh->NextQh, sizeof (EHC_QH));
+  PciAddr                = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, Qh->NextQh, sizeof (EHC_QH));
   Qh->QhHw.HorizonLink   = QH_LINK (PciAddr, EHC_TYPE_QH, FALSE);
-  PciAddr                = UsbHcGetPciAddressForHostMem (Ehc->MemPool, Head->NextQh, sizeof (EHC_QH));
+  PciAddr                = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, Head->NextQh, sizeof (EHC_QH));
   Head->QhHw.HorizonLink = QH_LINK (PciAddr, EHC_TYPE_QH, FALSE);
 }
 
@@ -363,7 +363,7 @@ EhcUnlinkQhFromAsync (
   Head->NextQh = Qh->NextQh;
   Qh->NextQh   = NULL;
 
-  PciAddr                = UsbHcGetPciAddressForHostMem (Ehc->MemPool, Head->NextQh, sizeof (EHC_QH));
+  PciAddr                = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, Head->NextQh, sizeof (EHC_QH));
   Head->QhHw.HorizonLink = QH_LINK (PciAddr, EHC_TYPE_QH, FALSE);
 
   //
@@ -450,7 +450,7 @@ EhcLinkQhToPeriod (
       Prev->NextQh = Qh;
 
       Qh->QhHw.HorizonLink   = Prev->QhHw.HorizonLink;
-      PciAddr                = UsbHcGetPciAddressForHostMem (Ehc->MemPool, Qh, sizeof (EHC_QH));
+      PciAddr                = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, Qh, sizeof (EHC_QH));
       Prev->QhHw.HorizonLink = QH_LINK (PciAddr, EHC_TYPE_QH, FALSE);
       break;
     }
@@ -462,11 +462,11 @@ EhcLinkQhToPeriod (
     //
     if (Qh->NextQh == NULL) {
       Qh->NextQh           = Next;
-      PciAddr              = UsbHcGetPciAddressForHostMem (Ehc->MemPool, Next, sizeof (EHC_QH));
+      PciAddr              = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, Next, sizeof (EHC_QH));
       Qh->QhHw.HorizonLink = QH_LINK (PciAddr, EHC_TYPE_QH, FALSE);
     }
 
-    PciAddr = UsbHcGetPciAddressForHostMem (Ehc->MemPool, Qh, sizeof (EHC_QH));
+    PciAddr = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, Qh, sizeof (EHC_QH));
 
     if (Prev == NULL) {
       ((UINT32 *)Ehc->PeriodFrame)[Index]    = QH_LINK (PciAddr, EHC_TYPE_QH, FALSE);
@@ -624,7 +624,7 @@ EhcCheckUrbResult (
         // ShortReadStop. If it is a setup transfer, need to check the
         // Status Stage of the setup transfer to get the finial result
         //
-        PciAddr = UsbHcGetPciAddressForHostMem (Ehc->MemPool, Ehc->ShortReadStop, sizeof (EHC_QTD));
+        PciAddr = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, Ehc->ShortReadStop, sizeof (EHC_QTD));
         if (QtdHw->AltNext == QTD_LINK (PciAddr, FALSE)) {
           DEBUG ((DEBUG_VERBOSE, "EhcCheckUrbResult: Short packet read, break\n"));
 
@@ -893,12 +893,10 @@ EhcFlushAsyncIntMap (
   EFI_STATUS                     Status;
   EFI_PHYSICAL_ADDRESS           PhyAddr;
   EFI_PCI_IO_PROTOCOL_OPERATION  MapOp;
-  EFI_PCI_IO_PROTOCOL            *PciIo;
   UINTN                          Len;
   VOID                           *Map;
 
-  PciIo = Ehc->PciIo;
-  Len   = Urb->DataLen;
+  Len = Urb->DataLen;
 
   if (Urb->Ep.Direction == EfiUsbDataIn) {
     MapOp = EfiPciIoOperationBusMasterWrite;
@@ -906,14 +904,14 @@ EhcFlushAsyncIntMap (
     MapOp = EfiPciIoOperationBusMasterRead;
   }
 
-  Status = PciIo->Unmap (PciIo, Urb->DataMap);
+  Status = UsbHcUnmapBuffer (Ehc->MemPool, Urb->DataMap);
   if (EFI_ERROR (Status)) {
     goto ON_ERROR;
   }
 
   Urb->DataMap = NULL;
 
-  Status = PciIo->Map (PciIo, MapOp, Urb->Data, &Len, &PhyAddr, &Map);
+  Status = UsbHcMapBuffer (Ehc->MemPool, MapOp, Urb->Data, &Len, &PhyAddr, &Map);
   if (EFI_ERROR (Status) || (Len != Urb->DataLen)) {
     goto ON_ERROR;
   }
@@ -1002,7 +1000,7 @@ EhcUpdateAsyncRequest (
       QhHw->PageHigh[Index] = 0;
     }
 
-    PciAddr       = UsbHcGetPciAddressForHostMem (Ehc->MemPool, FirstQtd, sizeof (EHC_QTD));
+    PciAddr       = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, FirstQtd, sizeof (EHC_QTD));
     QhHw->NextQtd = QTD_LINK (PciAddr, FALSE);
   }
 
@@ -315,16 +315,12 @@ EhcFreeUrb (
   IN URB          *Urb
   )
 {
-  EFI_PCI_IO_PROTOCOL  *PciIo;
-
-  PciIo = Ehc->PciIo;
-
   if (Urb->RequestPhy != NULL) {
-    PciIo->Unmap (PciIo, Urb->RequestMap);
+    UsbHcUnmapBuffer (Ehc->MemPool, Urb->RequestMap);
   }
 
   if (Urb->DataMap != NULL) {
-    PciIo->Unmap (PciIo, Urb->DataMap);
+    UsbHcUnmapBuffer (Ehc->MemPool, Urb->DataMap);
   }
 
   if (Urb->Qh != NULL) {
@@ -381,7 +377,7 @@ EhcCreateQtds (
   StatusQtd = NULL;
   AlterNext = QTD_LINK (NULL, TRUE);
 
-  PhyAddr = UsbHcGetPciAddressForHostMem (Ehc->MemPool, Ehc->ShortReadStop, sizeof (EHC_QTD));
+  PhyAddr = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, Ehc->ShortReadStop, sizeof (EHC_QTD));
   if (Ep->Direction == EfiUsbDataIn) {
     AlterNext = QTD_LINK (PhyAddr, FALSE);
   }
@@ -418,7 +414,7 @@ EhcCreateQtds (
     }
 
     if (Ep->Direction == EfiUsbDataIn) {
-      PhyAddr   = UsbHcGetPciAddressForHostMem (Ehc->MemPool, StatusQtd, sizeof (EHC_QTD));
+      PhyAddr   = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, StatusQtd, sizeof (EHC_QTD));
       AlterNext = QTD_LINK (PhyAddr, FALSE);
     }
 
@@ -486,7 +482,7 @@ EhcCreateQtds (
     }
 
     NextQtd            = EFI_LIST_CONTAINER (Entry->ForwardLink, EHC_QTD, QtdList);
-    PhyAddr            = UsbHcGetPciAddressForHostMem (Ehc->MemPool, NextQtd, sizeof (EHC_QTD));
+    PhyAddr            = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, NextQtd, sizeof (EHC_QTD));
     Qtd->QtdHw.NextQtd = QTD_LINK (PhyAddr, FALSE);
   }
 
@@ -494,7 +490,7 @@ EhcCreateQtds (
   // Link the QTDs to the queue head
   //
   NextQtd          = EFI_LIST_CONTAINER (Qh->Qtds.ForwardLink, EHC_QTD, QtdList);
-  PhyAddr          = UsbHcGetPciAddressForHostMem (Ehc->MemPool, NextQtd, sizeof (EHC_QTD));
+  PhyAddr          = UsbHcGetPciAddrForHostAddr (Ehc->MemPool, NextQtd, sizeof (EHC_QTD));
   Qh->QhHw.NextQtd = QTD_LINK (PhyAddr, FALSE);
   return EFI_SUCCESS;
 
@@ -545,7 +541,6 @@ EhcCreateUrb (
   USB_ENDPOINT                   *Ep;
   EFI_PHYSICAL_ADDRESS           PhyAddr;
   EFI_PCI_IO_PROTOCOL_OPERATION  MapOp;
-  EFI_PCI_IO_PROTOCOL            *PciIo;
   EFI_STATUS                     Status;
   UINTN                          Len;
   URB                            *Urb;
@@ -587,7 +582,6 @@ EhcCreateUrb (
   Urb->Callback = Callback;
   Urb->Context  = Context;
 
-  PciIo   = Ehc->PciIo;
   Urb->Qh = EhcCreateQh (Ehc, &Urb->Ep);
 
   if (Urb->Qh == NULL) {
@@ -600,7 +594,7 @@ EhcCreateUrb (
   if (Request != NULL) {
     Len    = sizeof (EFI_USB_DEVICE_REQUEST);
     MapOp  = EfiPciIoOperationBusMasterRead;
-    Status = PciIo->Map (PciIo, MapOp, Request, &Len, &PhyAddr, &Map);
+    Status = UsbHcMapBuffer (Ehc->MemPool, MapOp, Request, &Len, &PhyAddr, &Map);
 
     if (EFI_ERROR (Status) || (Len != sizeof (EFI_USB_DEVICE_REQUEST))) {
       goto ON_ERROR;
@@ -619,7 +613,7 @@ EhcCreateUrb (
       MapOp = EfiPciIoOperationBusMasterRead;
     }
 
-    Status = PciIo->Map (PciIo, MapOp, Data, &Len, &PhyAddr, &Map);
+    Status = UsbHcMapBuffer (Ehc->MemPool, MapOp, Data, &Len, &PhyAddr, &Map);
 
     if (EFI_ERROR (Status) || (Len != DataLen)) {
       goto ON_ERROR;
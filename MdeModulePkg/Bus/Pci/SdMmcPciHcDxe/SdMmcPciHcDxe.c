@@ -209,6 +209,7 @@ Done:
       RemoveEntryList (Link);
       Trb->Packet->TransactionStatus = EFI_TIMEOUT;
       TrbEvent                       = Trb->Event;
+      SdMmcUpdateStatistics (Private, Trb, EFI_TIMEOUT);
       SdMmcFreeTrb (Trb);
       DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p EFI_TIMEOUT\n", TrbEvent));
       gBS->SignalEvent (TrbEvent);
@@ -221,6 +222,7 @@ Done:
     RemoveEntryList (Link);
     Trb->Packet->TransactionStatus = Status;
     TrbEvent                       = Trb->Event;
+    SdMmcUpdateStatistics (Private, Trb, Status);
     SdMmcFreeTrb (Trb);
     DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p with %r\n", TrbEvent, Status));
     gBS->SignalEvent (TrbEvent);
@@ -922,6 +924,8 @@ SdMmcPciHcDriverBindingStop (
   LIST_ENTRY                     *Link;
   LIST_ENTRY                     *NextLink;
   SD_MMC_HC_TRB                  *Trb;
+  SD_MMC_HC_STATISTICS           *Statistics;
+  UINT8                          Slot;
 
   DEBUG ((DEBUG_INFO, "SdMmcPciHcDriverBindingStop: Start\n"));
 
@@ -967,6 +971,24 @@ SdMmcPciHcDriverBindingStop (
     SdMmcFreeTrb (Trb);
   }
 
+  for (Slot = 0; Slot < SD_MMC_HC_MAX_SLOT; Slot++) {
+    Statistics = &Private->Statistics[Slot];
+    if (Statistics->Requests == 0) {
+      continue;
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "SdMmcPciHcDriverBindingStop: Slot %d %ld requests %ld errors %ld bytes, latency avg %ld us max %ld us\n",
+      Slot,
+      Statistics->Requests,
+      Statistics->Errors,
+      Statistics->Bytes,
+      DivU64x64Remainder (Statistics->TotalLatency, MultU64x32 (Statistics->Requests, 1000), NULL),
+      DivU64x32 (Statistics->MaxLatency, 1000)
+      ));
+  }
+
   //
   // Uninstall Block I/O protocol from the device handle
   //
@@ -1152,6 +1174,7 @@ SdMmcPassThruPassThru (
 
   Status = SdMmcPassThruExecSyncTrb (Private, Trb);
 
+  SdMmcUpdateStatistics (Private, Trb, Status);
   SdMmcFreeTrb (Trb);
 
   return Status;
@@ -24,6 +24,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiLib.h>
 #include <Library/DevicePathLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PcdLib.h>
 
 #include <Protocol/DevicePath.h>
 #include <Protocol/PciIo.h>
@@ -87,6 +89,19 @@ typedef struct {
   EDKII_SD_MMC_OPERATING_PARAMETERS    OperatingParameters;
 } SD_MMC_HC_SLOT;
 
+//
+// Per slot request statistics, kept for diagnosing boot time. The latency
+// of a request is the time from its submission to its completion, in
+// nanoseconds.
+//
+typedef struct {
+  UINT64    Requests;
+  UINT64    Errors;
+  UINT64    Bytes;
+  UINT64    TotalLatency;
+  UINT64    MaxLatency;
+} SD_MMC_HC_STATISTICS;
+
 typedef struct {
   UINTN                            Signature;
 
@@ -120,6 +135,8 @@ typedef struct {
   // value stored in Capabilities Register 1.
   //
   UINT32                           BaseClkFreq[SD_MMC_HC_MAX_SLOT];
+
+  SD_MMC_HC_STATISTICS             Statistics[SD_MMC_HC_MAX_SLOT];
 } SD_MMC_HC_PRIVATE_DATA;
 
 typedef struct {
@@ -151,6 +168,7 @@ typedef struct {
   VOID                                   *DataMap;
   SD_MMC_HC_TRANSFER_MODE                Mode;
   SD_MMC_HC_ADMA_LENGTH_MODE             AdmaLengthMode;
+  BOOLEAN                                Adma3;
 
   EFI_EVENT                              Event;
   BOOLEAN                                Started;
@@ -164,10 +182,13 @@ typedef struct {
   SD_MMC_HC_ADMA_32_DESC_LINE            *Adma32Desc;
   SD_MMC_HC_ADMA_64_V3_DESC_LINE         *Adma64V3Desc;
   SD_MMC_HC_ADMA_64_V4_DESC_LINE         *Adma64V4Desc;
+  SD_MMC_HC_ADMA3_DESC                   *Adma3Desc;
   EFI_PHYSICAL_ADDRESS                   AdmaDescPhy;
   VOID                                   *AdmaMap;
   UINT32                                 AdmaPages;
 
+  UINT64                                 SubmitTime;
+
   SD_MMC_HC_PRIVATE_DATA                 *Private;
 } SD_MMC_HC_TRB;
 
@@ -771,6 +792,21 @@ SdMmcWaitTrbResult (
   IN SD_MMC_HC_TRB           *Trb
   );
 
+/**
+  Account a completed TRB in the statistics of its slot.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the SD_MMC_HC_TRB instance.
+  @param[in] Status         The completion status of the TRB.
+
+**/
+VOID
+SdMmcUpdateStatistics (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN SD_MMC_HC_TRB           *Trb,
+  IN EFI_STATUS              Status
+  );
+
 /**
   Execute EMMC device identification procedure.
 
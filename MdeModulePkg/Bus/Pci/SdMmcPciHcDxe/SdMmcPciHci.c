@@ -72,6 +72,7 @@ DumpCapabilityReg (
   DEBUG ((DEBUG_INFO, "   SDR50 Tuning      %a\n", Capability->TuningSDR50 ? "TRUE" : "FALSE"));
   DEBUG ((DEBUG_INFO, "   Retuning Mode     Mode %d\n", Capability->RetuningMod + 1));
   DEBUG ((DEBUG_INFO, "   Clock Multiplier  M = %d\n", Capability->ClkMultiplier + 1));
+  DEBUG ((DEBUG_INFO, "   ADMA3 Support     %a\n", Capability->Adma3 ? "TRUE" : "FALSE"));
   DEBUG ((DEBUG_INFO, "   HS 400            %a\n", Capability->Hs400 ? "TRUE" : "FALSE"));
   return;
 }
@@ -1456,6 +1457,10 @@ SdMmcHcLedOnOff (
 
   Refer to SD Host Controller Simplified spec 4.2 Section 1.13 for details.
 
+  For ADMA3 the integrated descriptor and the command descriptors are put
+  in front of the ADMA2 descriptors in the same buffer. The command
+  descriptors are filled when the TRB is executed.
+
   @param[in] Trb            The pointer to the SD_MMC_HC_TRB instance.
   @param[in] ControllerVer  The version of host controller.
 
@@ -1482,10 +1487,14 @@ BuildAdmaDescTable (
   UINT32                AdmaMaxDataPerLine;
   UINT32                DescSize;
   VOID                  *AdmaDesc;
+  UINTN                 HeaderSize;
+  SD_MMC_HC_ADMA3_DESC  *Adma3Desc;
+  EFI_PHYSICAL_ADDRESS  CmdDescPhy;
 
   AdmaMaxDataPerLine = ADMA_MAX_DATA_PER_LINE_16B;
   DescSize           = sizeof (SD_MMC_HC_ADMA_32_DESC_LINE);
   AdmaDesc           = NULL;
+  HeaderSize         = 0;
 
   Data    = Trb->DataPhy;
   DataLen = Trb->DataLen;
@@ -1535,8 +1544,12 @@ BuildAdmaDescTable (
     AdmaMaxDataPerLine = ADMA_MAX_DATA_PER_LINE_26B;
   }
 
+  if (Trb->Adma3) {
+    HeaderSize = sizeof (SD_MMC_HC_ADMA3_DESC);
+  }
+
   Entries        = DivU64x32 ((DataLen + AdmaMaxDataPerLine - 1), AdmaMaxDataPerLine);
-  TableSize      = (UINTN)MultU64x32 (Entries, DescSize);
+  TableSize      = HeaderSize + (UINTN)MultU64x32 (Entries, DescSize);
   Trb->AdmaPages = (UINT32)EFI_SIZE_TO_PAGES (TableSize);
   Status         = PciIo->AllocateBuffer (
                             PciIo,
@@ -1593,6 +1606,24 @@ BuildAdmaDescTable (
     return EFI_DEVICE_ERROR;
   }
 
+  if (Trb->Adma3) {
+    Adma3Desc      = AdmaDesc;
+    Trb->Adma3Desc = Adma3Desc;
+    CmdDescPhy     = Trb->AdmaDescPhy + OFFSET_OF (SD_MMC_HC_ADMA3_DESC, CmdDesc);
+
+    Adma3Desc->IntegratedDesc.Valid        = 1;
+    Adma3Desc->IntegratedDesc.End          = 1;
+    Adma3Desc->IntegratedDesc.Act          = SD_MMC_HC_ADMA3_ACT_INTEGRATED;
+    Adma3Desc->IntegratedDesc.LowerAddress = (UINT32)CmdDescPhy;
+    Adma3Desc->IntegratedDesc.UpperAddress = (UINT32)RShiftU64 (CmdDescPhy, 32);
+    for (Index = 0; Index < SD_MMC_HC_ADMA3_CMD_DESC_NUMBER; Index++) {
+      Adma3Desc->CmdDesc[Index].Valid = 1;
+      Adma3Desc->CmdDesc[Index].Act   = SD_MMC_HC_ADMA3_ACT_CMD;
+    }
+
+    AdmaDesc = (UINT8 *)AdmaDesc + HeaderSize;
+  }
+
   Remaining = DataLen;
   Address   = Data;
   if (Trb->Mode == SdMmcAdma32bMode) {
@@ -1768,6 +1799,7 @@ SdMmcPrintTrb (
   DEBUG ((DebugLevel, "Adma32Desc: %p\n", Trb->Adma32Desc));
   DEBUG ((DebugLevel, "Adma64V3Desc: %p\n", Trb->Adma64V3Desc));
   DEBUG ((DebugLevel, "Adma64V4Desc: %p\n", Trb->Adma64V4Desc));
+  DEBUG ((DebugLevel, "Adma3Desc: %p\n", Trb->Adma3Desc));
   DEBUG ((DebugLevel, "AdmaMap: %p\n", Trb->AdmaMap));
   DEBUG ((DebugLevel, "AdmaPages: %X\n", Trb->AdmaPages));
 
@@ -1873,6 +1905,7 @@ SdMmcCreateTrb (
   Trb->PioModeTransferCompleted = FALSE;
   Trb->PioBlockIndex            = 0;
   Trb->Private                  = Private;
+  Trb->SubmitTime               = GetPerformanceCounter ();
 
   if ((Packet->InTransferLength != 0) && (Packet->InDataBuffer != NULL)) {
     Trb->Data    = Packet->InDataBuffer;
@@ -1919,6 +1952,15 @@ SdMmcCreateTrb (
 
       if (Private->ControllerVersion[Slot] >= SD_MMC_HC_CTRL_VER_410) {
         Trb->AdmaLengthMode = SdMmcAdmaLen26b;
+        //
+        // Let the host controller fetch the command registers with the
+        // descriptors if it supports ADMA3 and the platform enables it with
+        // PcdSdMmcAdma3Enable. The SD_MMC_OVERRIDE Capability hook can also
+        // clear the ADMA3 capability bit to opt out.
+        //
+        if (PcdGetBool (PcdSdMmcAdma3Enable) && (Private->Capability[Slot].Adma3 != 0)) {
+          Trb->Adma3 = TRUE;
+        }
       }
 
       Status = SdMmcSetupMemoryForDmaTransfer (Private, Slot, Trb);
@@ -1971,23 +2013,29 @@ SdMmcFreeTrb (
              );
   }
 
-  if (Trb->Adma32Desc != NULL) {
+  //
+  // With ADMA3 the ADMA2 descriptors are in the same buffer as the ADMA3
+  // descriptors.
+  //
+  if (Trb->Adma3Desc != NULL) {
+    PciIo->FreeBuffer (
+             PciIo,
+             Trb->AdmaPages,
+             Trb->Adma3Desc
+             );
+  } else if (Trb->Adma32Desc != NULL) {
     PciIo->FreeBuffer (
              PciIo,
              Trb->AdmaPages,
              Trb->Adma32Desc
              );
-  }
-
-  if (Trb->Adma64V3Desc != NULL) {
+  } else if (Trb->Adma64V3Desc != NULL) {
     PciIo->FreeBuffer (
              PciIo,
              Trb->AdmaPages,
              Trb->Adma64V3Desc
              );
-  }
-
-  if (Trb->Adma64V4Desc != NULL) {
+  } else if (Trb->Adma64V4Desc != NULL) {
     PciIo->FreeBuffer (
              PciIo,
              Trb->AdmaPages,
@@ -2113,6 +2161,64 @@ SdMmcWaitTrbEnv (
   return EFI_TIMEOUT;
 }
 
+/**
+  Start the ADMA3 transfer of the specified TRB.
+
+  The command register values are put in the command descriptors and the
+  host controller writes them itself once the integrated descriptor address
+  is written. This saves the register writes of every command.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the SD_MMC_HC_TRB instance.
+  @param[in] BlkCount       The value of the 32-bit Block Count register.
+  @param[in] BlkSize        The value of the Block Size register.
+  @param[in] Argument       The value of the Argument register.
+  @param[in] TransMode      The value of the Transfer Mode register.
+  @param[in] Cmd            The value of the Command register.
+
+  @retval EFI_SUCCESS       The ADMA3 transfer is started.
+  @retval Others            Some erros happen when starting the transfer.
+
+**/
+EFI_STATUS
+SdMmcExecAdma3 (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN SD_MMC_HC_TRB           *Trb,
+  IN UINT32                  BlkCount,
+  IN UINT16                  BlkSize,
+  IN UINT32                  Argument,
+  IN UINT16                  TransMode,
+  IN UINT16                  Cmd
+  )
+{
+  EFI_STATUS            Status;
+  SD_MMC_HC_ADMA3_DESC  *Adma3Desc;
+  UINT32                AdmaAddr;
+
+  Adma3Desc = Trb->Adma3Desc;
+  ASSERT (Adma3Desc != NULL);
+
+  Adma3Desc->CmdDesc[0].Data = BlkCount;
+  Adma3Desc->CmdDesc[1].Data = BlkSize;
+  Adma3Desc->CmdDesc[2].Data = Argument;
+  Adma3Desc->CmdDesc[3].Data = TransMode | ((UINT32)Cmd << 16);
+  MemoryFence ();
+
+  //
+  // Writing the lower 32 bits of the integrated descriptor address starts
+  // the transfer, so write the upper 32 bits first.
+  //
+  AdmaAddr = (UINT32)RShiftU64 (Trb->AdmaDescPhy, 32);
+  Status   = SdMmcHcRwMmio (Private->PciIo, Trb->Slot, SD_MMC_HC_ADMA3_ID_ADDR + 4, FALSE, sizeof (AdmaAddr), &AdmaAddr);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  AdmaAddr = (UINT32)Trb->AdmaDescPhy;
+  Status   = SdMmcHcRwMmio (Private->PciIo, Trb->Slot, SD_MMC_HC_ADMA3_ID_ADDR, FALSE, sizeof (AdmaAddr), &AdmaAddr);
+  return Status;
+}
+
 /**
   Execute the specified TRB.
 
@@ -2180,10 +2286,23 @@ SdMmcExecTrb (
   }
 
   //
-  // Set Host Control 1 register DMA Select field
+  // Set Host Control 1 register DMA Select field. Clear it first, it still
+  // holds the mode of the previous TRB.
   //
-  if ((Trb->Mode == SdMmcAdma32bMode) ||
-      (Trb->Mode == SdMmcAdma64bV4Mode))
+  HostCtrl1 = (UINT8) ~(BIT4 | BIT3);
+  Status    = SdMmcHcAndMmio (PciIo, Trb->Slot, SD_MMC_HC_HOST_CTRL1, sizeof (HostCtrl1), &HostCtrl1);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Trb->Adma3) {
+    HostCtrl1 = BIT4|BIT3;
+    Status    = SdMmcHcOrMmio (PciIo, Trb->Slot, SD_MMC_HC_HOST_CTRL1, sizeof (HostCtrl1), &HostCtrl1);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  } else if ((Trb->Mode == SdMmcAdma32bMode) ||
+             (Trb->Mode == SdMmcAdma64bV4Mode))
   {
     HostCtrl1 = BIT4;
     Status    = SdMmcHcOrMmio (PciIo, Trb->Slot, SD_MMC_HC_HOST_CTRL1, sizeof (HostCtrl1), &HostCtrl1);
@@ -2218,9 +2337,10 @@ SdMmcExecTrb (
     if (EFI_ERROR (Status)) {
       return Status;
     }
-  } else if ((Trb->Mode == SdMmcAdma32bMode) ||
-             (Trb->Mode == SdMmcAdma64bV3Mode) ||
-             (Trb->Mode == SdMmcAdma64bV4Mode))
+  } else if (((Trb->Mode == SdMmcAdma32bMode) ||
+              (Trb->Mode == SdMmcAdma64bV3Mode) ||
+              (Trb->Mode == SdMmcAdma64bV4Mode)) &&
+             !Trb->Adma3)
   {
     AdmaAddr = (UINT64)(UINTN)Trb->AdmaDescPhy;
     Status   = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_ADMA_SYS_ADDR, FALSE, sizeof (AdmaAddr), &AdmaAddr);
@@ -2237,11 +2357,6 @@ SdMmcExecTrb (
     BlkSize |= 0x7000;
   }
 
-  Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_BLK_SIZE, FALSE, sizeof (BlkSize), &BlkSize);
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
-
   BlkCount = 0;
   if (Trb->Mode != SdMmcNoData) {
     //
@@ -2250,21 +2365,7 @@ SdMmcExecTrb (
     BlkCount = (Trb->DataLen / Trb->BlockSize);
   }
 
-  if (Private->ControllerVersion[Trb->Slot] >= SD_MMC_HC_CTRL_VER_410) {
-    Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_SDMA_ADDR, FALSE, sizeof (UINT32), &BlkCount);
-  } else {
-    Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_BLK_COUNT, FALSE, sizeof (UINT16), &BlkCount);
-  }
-
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
-
   Argument = Packet->SdMmcCmdBlk->CommandArgument;
-  Status   = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_ARG1, FALSE, sizeof (Argument), &Argument);
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
 
   TransMode = 0;
   if (Trb->Mode != SdMmcNoData) {
@@ -2290,11 +2391,6 @@ SdMmcExecTrb (
     }
   }
 
-  Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_TRANS_MOD, FALSE, sizeof (TransMode), &TransMode);
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
-
   Cmd = (UINT16)LShiftU64 (Packet->SdMmcCmdBlk->CommandIndex, 8);
   if (Packet->SdMmcCmdBlk->CommandType == SdMmcCommandTypeAdtc) {
     Cmd |= BIT5;
@@ -2328,6 +2424,35 @@ SdMmcExecTrb (
     }
   }
 
+  if (Trb->Adma3) {
+    return SdMmcExecAdma3 (Private, Trb, BlkCount, BlkSize, Argument, TransMode, Cmd);
+  }
+
+  Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_BLK_SIZE, FALSE, sizeof (BlkSize), &BlkSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Private->ControllerVersion[Trb->Slot] >= SD_MMC_HC_CTRL_VER_410) {
+    Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_SDMA_ADDR, FALSE, sizeof (UINT32), &BlkCount);
+  } else {
+    Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_BLK_COUNT, FALSE, sizeof (UINT16), &BlkCount);
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_ARG1, FALSE, sizeof (Argument), &Argument);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_TRANS_MOD, FALSE, sizeof (TransMode), &TransMode);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   //
   // Execute cmd
   //
@@ -2925,3 +3050,42 @@ SdMmcWaitTrbResult (
 
   return EFI_TIMEOUT;
 }
+
+/**
+  Account a completed TRB in the statistics of its slot.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the SD_MMC_HC_TRB instance.
+  @param[in] Status         The completion status of the TRB.
+
+**/
+VOID
+SdMmcUpdateStatistics (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN SD_MMC_HC_TRB           *Trb,
+  IN EFI_STATUS              Status
+  )
+{
+  SD_MMC_HC_STATISTICS  *Statistics;
+  UINT64                EndTick;
+  UINT64                StartValue;
+  UINT64                EndValue;
+  UINT64                Latency;
+
+  EndTick = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  Latency = GetTimeInNanoSecond ((StartValue > EndValue) ? (Trb->SubmitTime - EndTick) : (EndTick - Trb->SubmitTime));
+
+  Statistics = &Private->Statistics[Trb->Slot];
+  Statistics->Requests++;
+  if (EFI_ERROR (Status)) {
+    Statistics->Errors++;
+  } else {
+    Statistics->Bytes += Trb->DataLen;
+  }
+
+  Statistics->TotalLatency += Latency;
+  if (Latency > Statistics->MaxLatency) {
+    Statistics->MaxLatency = Latency;
+  }
+}
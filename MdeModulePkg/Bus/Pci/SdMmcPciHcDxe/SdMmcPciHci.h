@@ -53,6 +53,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define SD_MMC_HC_ADMA_ERR_STS        0x54
 #define SD_MMC_HC_ADMA_SYS_ADDR       0x58
 #define SD_MMC_HC_PRESET_VAL          0x60
+#define SD_MMC_HC_ADMA3_ID_ADDR       0x78
 #define SD_MMC_HC_SHARED_BUS_CTRL     0xE0
 #define SD_MMC_HC_SLOT_INT_STS        0xFC
 #define SD_MMC_HC_CTRL_VER            0xFE
@@ -142,6 +143,52 @@ typedef struct {
   UINT32    Reserved1;
 } SD_MMC_HC_ADMA_64_V4_DESC_LINE;
 
+//
+// ADMA3 descriptors, refer to SD Host Controller Simplified spec 4.10
+// Section 1.13.5 for details.
+//
+#define SD_MMC_HC_ADMA3_ACT_CMD         1
+#define SD_MMC_HC_ADMA3_ACT_INTEGRATED  7
+
+//
+// The four command descriptors of a command set the 32-bit Block Count,
+// Block Size/16-bit Block Count, Argument and Transfer Mode/Command
+// registers in this order.
+//
+#define SD_MMC_HC_ADMA3_CMD_DESC_NUMBER  4
+
+typedef struct {
+  UINT32    Valid    : 1;
+  UINT32    End      : 1;
+  UINT32    Int      : 1;
+  UINT32    Act      : 3;
+  UINT32    Reserved : 26;
+  UINT32    Data;
+} SD_MMC_HC_ADMA3_CMD_DESC_LINE;
+
+//
+// With 32-bit addressing the integrated descriptor ends after LowerAddress.
+//
+typedef struct {
+  UINT32    Valid    : 1;
+  UINT32    End      : 1;
+  UINT32    Int      : 1;
+  UINT32    Act      : 3;
+  UINT32    Reserved : 26;
+  UINT32    LowerAddress;
+  UINT32    UpperAddress;
+  UINT32    Reserved1;
+} SD_MMC_HC_ADMA3_INTEGRATED_DESC_LINE;
+
+//
+// The ADMA3 descriptors of a single command. The ADMA2 descriptors of
+// the data transfer directly follow the command descriptors.
+//
+typedef struct {
+  SD_MMC_HC_ADMA3_INTEGRATED_DESC_LINE    IntegratedDesc;
+  SD_MMC_HC_ADMA3_CMD_DESC_LINE           CmdDesc[SD_MMC_HC_ADMA3_CMD_DESC_NUMBER];
+} SD_MMC_HC_ADMA3_DESC;
+
 #define SD_MMC_SDMA_BOUNDARY  512 * 1024
 #define SD_MMC_SDMA_ROUND_UP(x, n)  (((x) + n) & ~(n - 1))
 
@@ -184,7 +231,9 @@ typedef struct {
   UINT32    TuningSDR50   : 1; // bit 45
   UINT32    RetuningMod   : 2; // bit 46:47
   UINT32    ClkMultiplier : 8; // bit 48:55
-  UINT32    Reserved5     : 7; // bit 56:62
+  UINT32    Reserved5     : 3; // bit 56:58
+  UINT32    Adma3         : 1; // bit 59
+  UINT32    Reserved6     : 3; // bit 60:62
   UINT32    Hs400         : 1; // bit 63
 } SD_MMC_HC_SLOT_CAP;
 
@@ -697,7 +697,7 @@ Uhci2ControlTransfer (
   Status = UhciMapUserData (Uhc, TransferDirection, Data, DataLength, &PktId, &DataPhy, &DataMap);
 
   if (EFI_ERROR (Status)) {
-    Uhc->PciIo->Unmap (Uhc->PciIo, RequestMap);
+    UsbHcUnmapBuffer (Uhc->MemPool, RequestMap);
     goto ON_EXIT;
   }
 
@@ -739,8 +739,8 @@ Uhci2ControlTransfer (
   UhciDestoryTds (Uhc, TDs);
 
 UNMAP_DATA:
-  Uhc->PciIo->Unmap (Uhc->PciIo, DataMap);
-  Uhc->PciIo->Unmap (Uhc->PciIo, RequestMap);
+  UsbHcUnmapBuffer (Uhc->MemPool, DataMap);
+  UsbHcUnmapBuffer (Uhc->MemPool, RequestMap);
 
 ON_EXIT:
   gBS->RestoreTPL (OldTpl);
@@ -867,7 +867,7 @@ Uhci2BulkTransfer (
              );
 
   if (TDs == NULL) {
-    Uhc->PciIo->Unmap (Uhc->PciIo, DataMap);
+    UsbHcUnmapBuffer (Uhc->MemPool, DataMap);
     goto ON_EXIT;
   }
 
@@ -889,7 +889,7 @@ Uhci2BulkTransfer (
   *DataLength     = QhResult.Complete;
 
   UhciDestoryTds (Uhc, TDs);
-  Uhc->PciIo->Unmap (Uhc->PciIo, DataMap);
+  UsbHcUnmapBuffer (Uhc->MemPool, DataMap);
 
 ON_EXIT:
   gBS->RestoreTPL (OldTpl);
@@ -1007,7 +1007,7 @@ Uhci2AsyncInterruptTransfer (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  DataPhy = (UINT8 *)(UINTN)UsbHcGetPciAddressForHostMem (Uhc->MemPool, DataPtr, DataLength);
+  DataPhy = (UINT8 *)(UINTN)UsbHcGetPciAddrForHostAddr (Uhc->MemPool, DataPtr, DataLength);
 
   OldTpl = gBS->RaiseTPL (UHCI_TPL);
 
@@ -1197,7 +1197,7 @@ Uhci2SyncInterruptTransfer (
           );
 
   if (TDs == NULL) {
-    Uhc->PciIo->Unmap (Uhc->PciIo, DataMap);
+    UsbHcUnmapBuffer (Uhc->MemPool, DataMap);
 
     Status = EFI_OUT_OF_RESOURCES;
     goto ON_EXIT;
@@ -1215,7 +1215,7 @@ Uhci2SyncInterruptTransfer (
   *DataLength     = QhResult.Complete;
 
   UhciDestoryTds (Uhc, TDs);
-  Uhc->PciIo->Unmap (Uhc->PciIo, DataMap);
+  UsbHcUnmapBuffer (Uhc->MemPool, DataMap);
 
 ON_EXIT:
   gBS->RestoreTPL (OldTpl);
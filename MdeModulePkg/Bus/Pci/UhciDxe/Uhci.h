@@ -27,12 +27,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/UsbHcMemLib.h>
 
 #include <IndustryStandard/Pci.h>
 
 typedef struct _USB_HC_DEV USB_HC_DEV;
 
-#include "UsbHcMem.h"
 #include "UhciQueue.h"
 #include "UhciReg.h"
 #include "UhciSched.h"
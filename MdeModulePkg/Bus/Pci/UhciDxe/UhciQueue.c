@@ -34,14 +34,14 @@ UhciMapUserRequest (
   EFI_PHYSICAL_ADDRESS  PhyAddr;
 
   Len    = sizeof (EFI_USB_DEVICE_REQUEST);
-  Status = Uhc->PciIo->Map (
-                         Uhc->PciIo,
-                         EfiPciIoOperationBusMasterRead,
-                         Request,
-                         &Len,
-                         &PhyAddr,
-                         Map
-                         );
+  Status = UsbHcMapBuffer (
+             Uhc->MemPool,
+             EfiPciIoOperationBusMasterRead,
+             Request,
+             &Len,
+             &PhyAddr,
+             Map
+             );
 
   if (!EFI_ERROR (Status)) {
     *MappedAddr = (UINT8 *)(UINTN)PhyAddr;
@@ -87,14 +87,14 @@ UhciMapUserData (
       // BusMasterWrite means cpu read
       //
       *PktId = INPUT_PACKET_ID;
-      Status = Uhc->PciIo->Map (
-                             Uhc->PciIo,
-                             EfiPciIoOperationBusMasterWrite,
-                             Data,
-                             Len,
-                             &PhyAddr,
-                             Map
-                             );
+      Status = UsbHcMapBuffer (
+                 Uhc->MemPool,
+                 EfiPciIoOperationBusMasterWrite,
+                 Data,
+                 Len,
+                 &PhyAddr,
+                 Map
+                 );
 
       if (EFI_ERROR (Status)) {
         goto EXIT;
@@ -105,14 +105,14 @@ UhciMapUserData (
 
     case EfiUsbDataOut:
       *PktId = OUTPUT_PACKET_ID;
-      Status = Uhc->PciIo->Map (
-                             Uhc->PciIo,
-                             EfiPciIoOperationBusMasterRead,
-                             Data,
-                             Len,
-                             &PhyAddr,
-                             Map
-                             );
+      Status = UsbHcMapBuffer (
+                 Uhc->MemPool,
+                 EfiPciIoOperationBusMasterRead,
+                 Data,
+                 Len,
+                 &PhyAddr,
+                 Map
+                 );
 
       if (EFI_ERROR (Status)) {
         goto EXIT;
@@ -157,7 +157,7 @@ UhciLinkTdToQh (
 {
   EFI_PHYSICAL_ADDRESS  PhyAddr;
 
-  PhyAddr = UsbHcGetPciAddressForHostMem (Uhc->MemPool, Td, sizeof (UHCI_TD_HW));
+  PhyAddr = UsbHcGetPciAddrForHostAddr (Uhc->MemPool, Td, sizeof (UHCI_TD_HW));
 
   ASSERT ((Qh != NULL) && (Td != NULL));
 
@@ -201,7 +201,7 @@ UhciAppendTd (
 {
   EFI_PHYSICAL_ADDRESS  PhyAddr;
 
-  PhyAddr = UsbHcGetPciAddressForHostMem (Uhc->MemPool, ThisTd, sizeof (UHCI_TD_HW));
+  PhyAddr = UsbHcGetPciAddrForHostAddr (Uhc->MemPool, ThisTd, sizeof (UHCI_TD_HW));
 
   ASSERT ((PrevTd != NULL) && (ThisTd != NULL));
 
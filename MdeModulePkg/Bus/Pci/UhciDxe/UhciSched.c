@@ -101,11 +101,11 @@ UhciInitFrameList (
   // Each frame entry is linked to this sequence of QH. These QH
   // will remain on the schedul, never got removed
   //
-  PhyAddr                          = UsbHcGetPciAddressForHostMem (Uhc->MemPool, Uhc->CtrlQh, sizeof (UHCI_QH_HW));
+  PhyAddr                          = UsbHcGetPciAddrForHostAddr (Uhc->MemPool, Uhc->CtrlQh, sizeof (UHCI_QH_HW));
   Uhc->SyncIntQh->QhHw.HorizonLink = QH_HLINK (PhyAddr, FALSE);
   Uhc->SyncIntQh->NextQh           = Uhc->CtrlQh;
 
-  PhyAddr                       = UsbHcGetPciAddressForHostMem (Uhc->MemPool, Uhc->BulkQh, sizeof (UHCI_QH_HW));
+  PhyAddr                       = UsbHcGetPciAddrForHostAddr (Uhc->MemPool, Uhc->BulkQh, sizeof (UHCI_QH_HW));
   Uhc->CtrlQh->QhHw.HorizonLink = QH_HLINK (PhyAddr, FALSE);
   Uhc->CtrlQh->NextQh           = Uhc->BulkQh;
 
@@ -124,7 +124,7 @@ UhciInitFrameList (
     goto ON_ERROR;
   }
 
-  PhyAddr = UsbHcGetPciAddressForHostMem (Uhc->MemPool, Uhc->SyncIntQh, sizeof (UHCI_QH_HW));
+  PhyAddr = UsbHcGetPciAddrForHostAddr (Uhc->MemPool, Uhc->SyncIntQh, sizeof (UHCI_QH_HW));
   for (Index = 0; Index < UHCI_FRAME_NUM; Index++) {
     Uhc->FrameBase[Index]         = QH_HLINK (PhyAddr, FALSE);
     Uhc->FrameBaseHostAddr[Index] = (UINT32)(UINTN)Uhc->SyncIntQh;
@@ -249,7 +249,7 @@ UhciLinkQhToFrameList (
 
   ASSERT ((Uhc->FrameBase != NULL) && (Qh != NULL));
 
-  QhPciAddr = UsbHcGetPciAddressForHostMem (Uhc->MemPool, Qh, sizeof (UHCI_QH_HW));
+  QhPciAddr = UsbHcGetPciAddrForHostAddr (Uhc->MemPool, Qh, sizeof (UHCI_QH_HW));
 
   for (Index = 0; Index < UHCI_FRAME_NUM; Index += Qh->Interval) {
     //
@@ -320,7 +320,7 @@ UhciLinkQhToFrameList (
     //
     if (Qh->NextQh == NULL) {
       Qh->NextQh           = Next;
-      PhyAddr              = UsbHcGetPciAddressForHostMem (Uhc->MemPool, Next, sizeof (UHCI_QH_HW));
+      PhyAddr              = UsbHcGetPciAddrForHostAddr (Uhc->MemPool, Next, sizeof (UHCI_QH_HW));
       Qh->QhHw.HorizonLink = QH_HLINK (PhyAddr, FALSE);
     }
 
@@ -810,6 +810,100 @@ XhcTransfer (
   return Status;
 }
 
+/**
+  Queue several bulk transfers on the transfer rings of a device, then
+  execute them together.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  DeviceAddress         The target device address.
+  @param  DeviceSpeed           Target device speed.
+  @param  RequestCount          The number of transfers in Requests.
+  @param  Requests              The transfers.
+  @param  Timeout               Indicates the maximum time, in millisecond, which
+                                all the transfers are allowed to complete.
+
+  @retval EFI_SUCCESS           All the transfers were completed successfully.
+  @retval EFI_OUT_OF_RESOURCES  A transfer could not be queued due to a lack of
+                                resources, the transfers before it were run.
+  @retval EFI_TIMEOUT           The transfers failed due to timeout.
+  @retval EFI_DEVICE_ERROR      A transfer failed due to host controller or
+                                device error.
+
+**/
+EFI_STATUS
+XhcTransferQueue (
+  IN     USB_XHCI_INSTANCE       *Xhc,
+  IN     UINT8                   DeviceAddress,
+  IN     UINT8                   DeviceSpeed,
+  IN     UINTN                   RequestCount,
+  IN OUT EDKII_USB_BULK_REQUEST  *Requests,
+  IN     UINTN                   Timeout
+  )
+{
+  EFI_STATUS  Status;
+  EFI_STATUS  RecoveryStatus;
+  URB         *Urbs[XHC_BULK_QUEUE_MAX_REQUESTS];
+  UINTN       UrbNum;
+  UINTN       Index;
+
+  ASSERT (RequestCount <= XHC_BULK_QUEUE_MAX_REQUESTS);
+
+  for (UrbNum = 0; UrbNum < RequestCount; UrbNum++) {
+    Urbs[UrbNum] = XhcCreateUrb (
+                     Xhc,
+                     DeviceAddress,
+                     Requests[UrbNum].EndpointAddress,
+                     DeviceSpeed,
+                     Requests[UrbNum].MaximumPacketLength,
+                     XHC_BULK_TRANSFER,
+                     NULL,
+                     Requests[UrbNum].Data,
+                     Requests[UrbNum].DataLength,
+                     NULL,
+                     NULL
+                     );
+    if (Urbs[UrbNum] == NULL) {
+      DEBUG ((DEBUG_ERROR, "XhcTransferQueue: failed to create URB %d!\n", UrbNum));
+      break;
+    }
+  }
+
+  if (UrbNum == 0) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // The TDs of the URBs created are on the transfer rings already, so they
+  // are executed even if a later URB could not be created.
+  //
+  Status = XhcExecTransferQueue (Xhc, Urbs, UrbNum, Timeout);
+
+  for (Index = 0; Index < UrbNum; Index++) {
+    Requests[Index].TransferResult = Urbs[Index]->Result;
+    Requests[Index].DataLength     = Urbs[Index]->Completed;
+
+    if ((Urbs[Index]->Result == EFI_USB_ERR_STALL) || (Urbs[Index]->Result == EFI_USB_ERR_BABBLE)) {
+      ASSERT (Status == EFI_DEVICE_ERROR);
+      RecoveryStatus = XhcRecoverHaltedEndpoint (Xhc, Urbs[Index]);
+      if (EFI_ERROR (RecoveryStatus)) {
+        DEBUG ((DEBUG_ERROR, "XhcTransferQueue: XhcRecoverHaltedEndpoint failed!\n"));
+      }
+    }
+  }
+
+  Xhc->PciIo->Flush (Xhc->PciIo);
+
+  for (Index = 0; Index < UrbNum; Index++) {
+    XhcFreeUrb (Xhc, Urbs[Index]);
+  }
+
+  if (!EFI_ERROR (Status) && (UrbNum < RequestCount)) {
+    Status = EFI_OUT_OF_RESOURCES;
+  }
+
+  return Status;
+}
+
 /**
   Submits control transfer to a target USB device.
 
@@ -1305,6 +1399,125 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Submit several bulk transfers to a USB device.
+
+  The transfers are queued in order on their endpoints, so the transfers on
+  the same endpoint run in order. The function returns when all of them are
+  complete, or as soon as one fails or the timeout expires. The transfers not
+  complete then are aborted.
+
+  @param  This                  This EDKII_USB2_HC_BULK_QUEUE_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  DeviceSpeed           Device speed, Low speed device doesn't support
+                                bulk transfer.
+  @param  RequestCount          The number of transfers in Requests.
+  @param  Requests              The transfers.
+  @param  Timeout               Indicates the maximum time, in millisecond, which
+                                all the transfers are allowed to complete.
+  @param  Translator            A pointer to the transaction translator data.
+
+  @retval EFI_SUCCESS           All the transfers were completed successfully.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_UNSUPPORTED       The transfers can't be queued together, none of
+                                them was started.
+  @retval EFI_OUT_OF_RESOURCES  A transfer could not be queued due to a lack of
+                                resources, the transfers before it were run.
+  @retval EFI_TIMEOUT           The transfers failed due to timeout.
+  @retval EFI_DEVICE_ERROR      A transfer failed due to host controller or
+                                device error, see its TransferResult.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcBulkQueueTransfer (
+  IN     EDKII_USB2_HC_BULK_QUEUE_PROTOCOL   *This,
+  IN     UINT8                               DeviceAddress,
+  IN     UINT8                               DeviceSpeed,
+  IN     UINTN                               RequestCount,
+  IN OUT EDKII_USB_BULK_REQUEST              *Requests,
+  IN     UINTN                               Timeout,
+  IN     EFI_USB2_HC_TRANSACTION_TRANSLATOR  *Translator
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  UINT8              SlotId;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+  UINTN              Index;
+  UINTN              MaxPacket;
+  UINTN              TrbNum;
+
+  //
+  // Validate the parameters
+  //
+  if ((Requests == NULL) || (RequestCount == 0) || (DeviceSpeed == EFI_USB_SPEED_LOW)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  TrbNum = 0;
+  for (Index = 0; Index < RequestCount; Index++) {
+    MaxPacket = Requests[Index].MaximumPacketLength;
+    if ((Requests[Index].Data == NULL) || (Requests[Index].DataLength == 0) ||
+        ((DeviceSpeed == EFI_USB_SPEED_FULL) && (MaxPacket > 64)) ||
+        ((EFI_USB_SPEED_HIGH == DeviceSpeed) && (MaxPacket > 512)) ||
+        ((EFI_USB_SPEED_SUPER == DeviceSpeed) && (MaxPacket > 1024)))
+    {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    //
+    // XhcCreateTransferTrb() splits a bulk transfer in TRBs of 64 KB.
+    //
+    TrbNum += (Requests[Index].DataLength + SIZE_64KB - 1) / SIZE_64KB;
+  }
+
+  if ((RequestCount > XHC_BULK_QUEUE_MAX_REQUESTS) || (TrbNum > XHC_BULK_QUEUE_MAX_TRBS)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc = XHC_FROM_BULK_QUEUE (This);
+
+  for (Index = 0; Index < RequestCount; Index++) {
+    Requests[Index].TransferResult = EFI_USB_ERR_NOTEXECUTE;
+  }
+
+  Status = EFI_DEVICE_ERROR;
+
+  if (XhcIsHalt (Xhc) || XhcIsSysError (Xhc)) {
+    DEBUG ((DEBUG_ERROR, "XhcBulkQueueTransfer: HC is halted\n"));
+    goto ON_EXIT;
+  }
+
+  //
+  // Check if the device is still enabled before every transaction.
+  //
+  SlotId = XhcBusDevAddrToSlotId (Xhc, DeviceAddress);
+  if (SlotId == 0) {
+    goto ON_EXIT;
+  }
+
+  Status = XhcTransferQueue (
+             Xhc,
+             DeviceAddress,
+             DeviceSpeed,
+             RequestCount,
+             Requests,
+             Timeout
+             );
+
+ON_EXIT:
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "XhcBulkQueueTransfer: error - %r\n", Status));
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
+
 /**
   Submits an asynchronous interrupt transfer to an
   interrupt endpoint of a USB device.
@@ -1782,6 +1995,7 @@ XhcCreateUsbHc (
   Xhc->DevicePath            = DevicePath;
   Xhc->OriginalPciAttributes = OriginalPciAttributes;
   CopyMem (&Xhc->Usb2Hc, &gXhciUsb2HcTemplate, sizeof (EFI_USB2_HC_PROTOCOL));
+  Xhc->BulkQueue.BulkQueueTransfer = XhcBulkQueueTransfer;
 
   Status = PciIo->Pci.Read (
                         PciIo,
@@ -2092,11 +2306,13 @@ XhcDriverBindingStart (
     FALSE
     );
 
-  Status = gBS->InstallProtocolInterface (
+  Status = gBS->InstallMultipleProtocolInterfaces (
                   &Controller,
                   &gEfiUsb2HcProtocolGuid,
-                  EFI_NATIVE_INTERFACE,
-                  &Xhc->Usb2Hc
+                  &Xhc->Usb2Hc,
+                  &gEdkiiUsb2HcBulkQueueProtocolGuid,
+                  &Xhc->BulkQueue,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "XhcDriverBindingStart: failed to install USB2_HC Protocol\n"));
@@ -2193,6 +2409,12 @@ XhcDriverBindingStop (
   Xhc   = XHC_FROM_THIS (Usb2Hc);
   PciIo = Xhc->PciIo;
 
+  gBS->UninstallProtocolInterface (
+         Controller,
+         &gEdkiiUsb2HcBulkQueueProtocolGuid,
+         &Xhc->BulkQueue
+         );
+
   //
   // Stop AsyncRequest Polling timer then stop the XHCI driver
   // and uninstall the XHCI protocl.
@@ -14,6 +14,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 
 #include <Protocol/Usb2HostController.h>
+#include <Protocol/UsbBulkQueue.h>
 #include <Protocol/PciIo.h>
 
 #include <Guid/EventGroup.h>
@@ -26,6 +27,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiLib.h>
 #include <Library/DebugLib.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/UsbHcMemLib.h>
 
 #include <IndustryStandard/Pci.h>
 
@@ -35,7 +37,6 @@ typedef struct _USB_DEV_CONTEXT    USB_DEV_CONTEXT;
 #include "XhciReg.h"
 #include "XhciSched.h"
 #include "ComponentName.h"
-#include "UsbHcMem.h"
 
 //
 // The unit is microsecond, setting it as 1us.
@@ -77,6 +78,13 @@ typedef struct _USB_DEV_CONTEXT    USB_DEV_CONTEXT;
 #define ERST_NUMBER            0x01
 #define EVENT_RING_TRB_NUMBER  0x200
 
+//
+// Bulk transfers queued together by EDKII_USB2_HC_BULK_QUEUE_PROTOCOL must
+// not take more than half of a transfer ring.
+//
+#define XHC_BULK_QUEUE_MAX_REQUESTS  8
+#define XHC_BULK_QUEUE_MAX_TRBS      (TR_RING_TRB_NUMBER / 2)
+
 #define CMD_INTER        0
 #define CTRL_INTER       1
 #define BULK_INTER       2
@@ -96,6 +104,7 @@ typedef struct _USB_DEV_CONTEXT    USB_DEV_CONTEXT;
 
 #define XHCI_INSTANCE_SIG  SIGNATURE_32 ('x', 'h', 'c', 'i')
 #define XHC_FROM_THIS(a)  CR(a, USB_XHCI_INSTANCE, Usb2Hc, XHCI_INSTANCE_SIG)
+#define XHC_FROM_BULK_QUEUE(a)  CR(a, USB_XHCI_INSTANCE, BulkQueue, XHCI_INSTANCE_SIG)
 
 #define USB_DESC_TYPE_HUB              0x29
 #define USB_DESC_TYPE_HUB_SUPER_SPEED  0x2a
@@ -199,7 +208,8 @@ struct _USB_XHCI_INSTANCE {
   UINT64                      OriginalPciAttributes;
   USBHC_MEM_POOL              *MemPool;
 
-  EFI_USB2_HC_PROTOCOL        Usb2Hc;
+  EFI_USB2_HC_PROTOCOL                 Usb2Hc;
+  EDKII_USB2_HC_BULK_QUEUE_PROTOCOL    BulkQueue;
 
   EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
 
@@ -232,6 +242,11 @@ struct _USB_XHCI_INSTANCE {
   UINT32                      MaxSlotsEn;
   URB                         *PendingUrb;
   //
+  // The URBs of the queued bulk transfers in progress
+  //
+  URB                         **QueuedUrbs;
+  UINTN                       QueuedUrbNum;
+  //
   // Cmd Transfer Ring
   //
   TRANSFER_RING               CmdRing;
@@ -554,6 +569,47 @@ XhcBulkTransfer (
   OUT    UINT32                              *TransferResult
   );
 
+/**
+  Submit several bulk transfers to a USB device.
+
+  The transfers are queued in order on their endpoints, so the transfers on
+  the same endpoint run in order. The function returns when all of them are
+  complete, or as soon as one fails or the timeout expires. The transfers not
+  complete then are aborted.
+
+  @param  This                  This EDKII_USB2_HC_BULK_QUEUE_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  DeviceSpeed           Device speed, Low speed device doesn't support
+                                bulk transfer.
+  @param  RequestCount          The number of transfers in Requests.
+  @param  Requests              The transfers.
+  @param  Timeout               Indicates the maximum time, in millisecond, which
+                                all the transfers are allowed to complete.
+  @param  Translator            A pointer to the transaction translator data.
+
+  @retval EFI_SUCCESS           All the transfers were completed successfully.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_UNSUPPORTED       The transfers can't be queued together, none of
+                                them was started.
+  @retval EFI_OUT_OF_RESOURCES  A transfer could not be queued due to a lack of
+                                resources, the transfers before it were run.
+  @retval EFI_TIMEOUT           The transfers failed due to timeout.
+  @retval EFI_DEVICE_ERROR      A transfer failed due to host controller or
+                                device error, see its TransferResult.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcBulkQueueTransfer (
+  IN     EDKII_USB2_HC_BULK_QUEUE_PROTOCOL   *This,
+  IN     UINT8                               DeviceAddress,
+  IN     UINT8                               DeviceSpeed,
+  IN     UINTN                               RequestCount,
+  IN OUT EDKII_USB_BULK_REQUEST              *Requests,
+  IN     UINTN                               Timeout,
+  IN     EFI_USB2_HC_TRANSACTION_TRANSLATOR  *Translator
+  );
+
 /**
   Submits an asynchronous interrupt transfer to an
   interrupt endpoint of a USB device.
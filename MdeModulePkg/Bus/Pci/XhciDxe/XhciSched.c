@@ -198,7 +198,7 @@ XhcFreeUrb (
   }
 
   if (Urb->DataMap != NULL) {
-    Xhc->PciIo->Unmap (Xhc->PciIo, Urb->DataMap);
+    UsbHcUnmapBuffer (Xhc->MemPool, Urb->DataMap);
   }
 
   FreePool (Urb);
@@ -266,7 +266,7 @@ XhcCreateTransferTrb (
     }
 
     Len    = Urb->DataLen;
-    Status = Xhc->PciIo->Map (Xhc->PciIo, MapOp, Urb->Data, &Len, &PhyAddr, &Map);
+    Status = UsbHcMapBuffer (Xhc->MemPool, MapOp, Urb->Data, &Len, &PhyAddr, &Map);
 
     if (EFI_ERROR (Status) || (Len != Urb->DataLen)) {
       DEBUG ((DEBUG_ERROR, "XhcCreateTransferTrb: Fail to map Urb->Data.\n"));
@@ -488,7 +488,7 @@ XhcInitSched (
   //
   // Initialize memory management.
   //
-  Xhc->MemPool = UsbHcInitMemPool (Xhc->PciIo);
+  Xhc->MemPool = UsbHcInitMemPool (Xhc->PciIo, FALSE, 0);
   ASSERT (Xhc->MemPool != NULL);
 
   //
@@ -804,6 +804,7 @@ CreateEventRing (
   EventRing->TrbNumber        = EVENT_RING_TRB_NUMBER;
   EventRing->EventRingDequeue = (TRB_TEMPLATE *)EventRing->EventRingSeg0;
   EventRing->EventRingEnqueue = (TRB_TEMPLATE *)EventRing->EventRingSeg0;
+  EventRing->EventRingErdp    = (TRB_TEMPLATE *)EventRing->EventRingSeg0;
 
   DequeuePhy = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Buf, Size);
 
@@ -1082,6 +1083,37 @@ IsAsyncIntTrb (
   return FALSE;
 }
 
+/**
+  Check if the Trb is a transaction of the URBs of the queued bulk transfers
+  in progress.
+
+  @param Xhc    The XHCI Instance.
+  @param Trb    The TRB to be checked.
+  @param Urb    The pointer to the matched Urb.
+
+  @retval TRUE  The Trb is matched with a transaction of the queued URBs.
+  @retval FALSE The Trb is not matched with any of the queued URBs.
+
+**/
+BOOLEAN
+IsQueuedUrbTrb (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  TRB_TEMPLATE       *Trb,
+  OUT URB                **Urb
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Xhc->QueuedUrbNum; Index++) {
+    if (IsTransferRingTrb (Xhc, Trb, Xhc->QueuedUrbs[Index])) {
+      *Urb = Xhc->QueuedUrbs[Index];
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
 /**
   Check the URB's execution result and update the URB's
   result accordingly.
@@ -1104,16 +1136,15 @@ XhcCheckUrbResult (
   UINT8                 TRBType;
   EFI_STATUS            Status;
   URB                   *AsyncUrb;
+  URB                   *QueuedUrb;
   URB                   *CheckedUrb;
-  UINT64                XhcDequeue;
-  UINT32                High;
-  UINT32                Low;
   EFI_PHYSICAL_ADDRESS  PhyAddr;
 
   ASSERT ((Xhc != NULL) && (Urb != NULL));
 
-  Status   = EFI_SUCCESS;
-  AsyncUrb = NULL;
+  Status    = EFI_SUCCESS;
+  AsyncUrb  = NULL;
+  QueuedUrb = NULL;
 
   if (Urb->Finished) {
     goto EXIT;
@@ -1121,15 +1152,23 @@ XhcCheckUrbResult (
 
   EvtTrb = NULL;
 
-  if (XhcIsHalt (Xhc) || XhcIsSysError (Xhc)) {
-    Urb->Result |= EFI_USB_ERR_SYSTEM;
-    goto EXIT;
-  }
-
   //
   // Traverse the event ring to find out all new events from the previous check.
   //
   XhcSyncEventRing (Xhc, &Xhc->EventRing);
+
+  //
+  // The event ring lives in host memory, so polling it doesn't touch the
+  // controller. Only read USBSTS when there is nothing new to consume: a
+  // halted controller or a host system error stops event generation.
+  //
+  if ((Xhc->EventRing.EventRingDequeue == Xhc->EventRing.EventRingEnqueue) &&
+      ((XhcReadOpReg (Xhc, XHC_USBSTS_OFFSET) & (XHC_USBSTS_HALT | XHC_USBSTS_HSE)) != 0))
+  {
+    Urb->Result |= EFI_USB_ERR_SYSTEM;
+    goto EXIT;
+  }
+
   for (Index = 0; Index < Xhc->EventRing.TrbNumber; Index++) {
     Status = XhcCheckNewEvent (Xhc, &Xhc->EventRing, ((TRB_TEMPLATE **)&EvtTrb));
     if (Status == EFI_NOT_READY) {
@@ -1162,6 +1201,8 @@ XhcCheckUrbResult (
       CheckedUrb = Xhc->PendingUrb;
     } else if (IsTransferRingTrb (Xhc, TRBPtr, Urb)) {
       CheckedUrb = Urb;
+    } else if (IsQueuedUrbTrb (Xhc, TRBPtr, &QueuedUrb)) {
+      CheckedUrb = QueuedUrb;
     } else if (IsAsyncIntTrb (Xhc, TRBPtr, &AsyncUrb)) {
       CheckedUrb = AsyncUrb;
     } else {
@@ -1248,22 +1289,19 @@ EXIT:
   //
   // Advance event ring to last available entry
   //
-  // Some 3rd party XHCI external cards don't support single 64-bytes width register access,
-  // So divide it to two 32-bytes width register access.
+  // All events consumed by this check are released to the controller with a
+  // single ERDP update. The last written value is tracked in software so the
+  // register is neither read nor written while the ring is idle.
   //
-  Low        = XhcReadRuntimeReg (Xhc, XHC_ERDP_OFFSET);
-  High       = XhcReadRuntimeReg (Xhc, XHC_ERDP_OFFSET + 4);
-  XhcDequeue = (UINT64)(LShiftU64 ((UINT64)High, 32) | Low);
-
-  PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Xhc->EventRing.EventRingDequeue, sizeof (TRB_TEMPLATE));
-
-  if ((XhcDequeue & (~0x0F)) != (PhyAddr & (~0x0F))) {
+  if (Xhc->EventRing.EventRingErdp != Xhc->EventRing.EventRingDequeue) {
+    PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Xhc->EventRing.EventRingDequeue, sizeof (TRB_TEMPLATE));
     //
     // Some 3rd party XHCI external cards don't support single 64-bytes width register access,
     // So divide it to two 32-bytes width register access.
     //
     XhcWriteRuntimeReg (Xhc, XHC_ERDP_OFFSET, XHC_LOW_32BIT (PhyAddr) | BIT3);
     XhcWriteRuntimeReg (Xhc, XHC_ERDP_OFFSET + 4, XHC_HIGH_32BIT (PhyAddr));
+    Xhc->EventRing.EventRingErdp = Xhc->EventRing.EventRingDequeue;
   }
 
   return Urb->Finished;
@@ -1372,6 +1410,187 @@ DONE:
   return Status;
 }
 
+/**
+  Execute the transfers queued on the transfer rings of a device by polling
+  their URBs. This is a synchronous operation.
+
+  The doorbell of each endpoint is rung once for all the URBs queued on it,
+  and each check of the event ring updates all of them. The polling stops
+  when all the URBs are finished, when one of them fails, or when the timeout
+  expires. The URBs not finished then are removed from their transfer rings,
+  except from the ring of an endpoint halted by the failed URB.
+
+  @param  Xhc                    The XHCI Instance.
+  @param  Urbs                   The URBs to execute, in the order they were queued.
+  @param  UrbNum                 The number of URBs.
+  @param  Timeout                The time to wait before abort, in millisecond.
+
+  @return EFI_DEVICE_ERROR       A transfer failed due to transfer error.
+  @return EFI_TIMEOUT            The transfers failed due to time out.
+  @return EFI_SUCCESS            The transfers finished OK.
+  @retval EFI_OUT_OF_RESOURCES   Memory for the timer event could not be allocated.
+
+**/
+EFI_STATUS
+XhcExecTransferQueue (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  URB                **Urbs,
+  IN  UINTN              UrbNum,
+  IN  UINTN              Timeout
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       SlotId;
+  UINT8       Dci;
+  UINTN       Index;
+  UINTN       Other;
+  UINTN       Pending;
+  URB         *Urb;
+  URB         *FailedUrb;
+  BOOLEAN     Finished;
+  EFI_EVENT   TimeoutEvent;
+  BOOLEAN     IndefiniteTimeout;
+
+  ASSERT ((UrbNum != 0) && (Xhc->QueuedUrbs == NULL));
+
+  Status            = EFI_SUCCESS;
+  Finished          = FALSE;
+  FailedUrb         = NULL;
+  TimeoutEvent      = NULL;
+  IndefiniteTimeout = FALSE;
+
+  SlotId = XhcBusDevAddrToSlotId (Xhc, Urbs[0]->Ep.BusAddr);
+  if (SlotId == 0) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (Timeout == 0) {
+    IndefiniteTimeout = TRUE;
+    goto RINGDOORBELL;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER,
+                  TPL_CALLBACK,
+                  NULL,
+                  NULL,
+                  &TimeoutEvent
+                  );
+
+  if (EFI_ERROR (Status)) {
+    goto DONE;
+  }
+
+  Status = gBS->SetTimer (
+                  TimeoutEvent,
+                  TimerRelative,
+                  EFI_TIMER_PERIOD_MILLISECONDS (Timeout)
+                  );
+
+  if (EFI_ERROR (Status)) {
+    goto DONE;
+  }
+
+RINGDOORBELL:
+  Xhc->QueuedUrbs   = Urbs;
+  Xhc->QueuedUrbNum = UrbNum;
+
+  for (Index = 0; Index < UrbNum; Index++) {
+    for (Other = 0; Other < Index; Other++) {
+      if (Urbs[Other]->Ring == Urbs[Index]->Ring) {
+        break;
+      }
+    }
+
+    if (Other == Index) {
+      Dci = XhcEndpointToDci (Urbs[Index]->Ep.EpAddr, (UINT8)(Urbs[Index]->Ep.Direction));
+      ASSERT (Dci < 32);
+      XhcRingDoorBell (Xhc, SlotId, Dci);
+    }
+  }
+
+  Pending = 0;
+  do {
+    XhcCheckUrbResult (Xhc, Urbs[Pending]);
+
+    Finished = TRUE;
+    for (Index = 0; Index < UrbNum; Index++) {
+      if (!Urbs[Index]->Finished) {
+        Finished = FALSE;
+      } else if (Urbs[Index]->Result != EFI_USB_NOERROR) {
+        FailedUrb = Urbs[Index];
+        break;
+      }
+    }
+
+    if (Finished || (FailedUrb != NULL)) {
+      break;
+    }
+
+    while (Urbs[Pending]->Finished) {
+      Pending++;
+    }
+
+    gBS->Stall (XHC_1_MICROSECOND);
+  } while (IndefiniteTimeout || EFI_ERROR (gBS->CheckEvent (TimeoutEvent)));
+
+  if (!Finished) {
+    //
+    // Stop the endpoints of the URBs not finished, and move their dequeue
+    // pointers past the last URB queued on them. The transfer ring of a
+    // halted endpoint is dequeued when the endpoint is recovered.
+    //
+    for (Index = 0; Index < UrbNum; Index++) {
+      Urb = Urbs[Index];
+      if (Urb->Finished || ((FailedUrb != NULL) && (Urb->Ring == FailedUrb->Ring))) {
+        continue;
+      }
+
+      for (Other = Index + 1; Other < UrbNum; Other++) {
+        if (!Urbs[Other]->Finished && (Urbs[Other]->Ring == Urb->Ring)) {
+          break;
+        }
+      }
+
+      if (Other == UrbNum) {
+        XhcDequeueTrbFromEndpoint (Xhc, Urb);
+      }
+    }
+
+    Finished = TRUE;
+    for (Index = 0; Index < UrbNum; Index++) {
+      Urb = Urbs[Index];
+      if (!Urb->Finished) {
+        Urb->Result = (FailedUrb == NULL) ? EFI_USB_ERR_TIMEOUT : EFI_USB_ERR_NOTEXECUTE;
+      }
+
+      if (Urb->Result != EFI_USB_NOERROR) {
+        Finished = FALSE;
+      }
+    }
+  }
+
+  Xhc->QueuedUrbs   = NULL;
+  Xhc->QueuedUrbNum = 0;
+
+DONE:
+  if (EFI_ERROR (Status)) {
+    for (Index = 0; Index < UrbNum; Index++) {
+      Urbs[Index]->Result = EFI_USB_ERR_NOTEXECUTE;
+    }
+  } else if (FailedUrb != NULL) {
+    Status = EFI_DEVICE_ERROR;
+  } else if (!Finished) {
+    Status = EFI_TIMEOUT;
+  }
+
+  if (TimeoutEvent != NULL) {
+    gBS->CloseEvent (TimeoutEvent);
+  }
+
+  return Status;
+}
+
 /**
   Delete a single asynchronous interrupt transfer for
   the device and endpoint.
@@ -1574,12 +1793,10 @@ XhcFlushAsyncIntMap (
   EFI_STATUS                     Status;
   EFI_PHYSICAL_ADDRESS           PhyAddr;
   EFI_PCI_IO_PROTOCOL_OPERATION  MapOp;
-  EFI_PCI_IO_PROTOCOL            *PciIo;
   UINTN                          Len;
   VOID                           *Map;
 
-  PciIo = Xhc->PciIo;
-  Len   = Urb->DataLen;
+  Len = Urb->DataLen;
 
   if (Urb->Ep.Direction == EfiUsbDataIn) {
     MapOp = EfiPciIoOperationBusMasterWrite;
@@ -1588,7 +1805,7 @@ XhcFlushAsyncIntMap (
   }
 
   if (Urb->DataMap != NULL) {
-    Status = PciIo->Unmap (PciIo, Urb->DataMap);
+    Status = UsbHcUnmapBuffer (Xhc->MemPool, Urb->DataMap);
     if (EFI_ERROR (Status)) {
       goto ON_ERROR;
     }
@@ -1596,7 +1813,7 @@ XhcFlushAsyncIntMap (
 
   Urb->DataMap = NULL;
 
-  Status = PciIo->Map (PciIo, MapOp, Urb->Data, &Len, &PhyAddr, &Map);
+  Status = UsbHcMapBuffer (Xhc->MemPool, MapOp, Urb->Data, &Len, &PhyAddr, &Map);
   if (EFI_ERROR (Status) || (Len != Urb->DataLen)) {
     goto ON_ERROR;
   }
@@ -153,6 +153,11 @@ typedef struct _EVENT_RING {
   TRB_TEMPLATE    *EventRingEnqueue;
   TRB_TEMPLATE    *EventRingDequeue;
   UINT32          EventRingCCS;
+  //
+  // The dequeue pointer last written to the ERDP register, so that the
+  // register only needs to be written when software consumed new events.
+  //
+  TRB_TEMPLATE    *EventRingErdp;
 } EVENT_RING;
 
 //
@@ -812,6 +817,28 @@ XhcExecTransfer (
   IN  UINTN              Timeout
   );
 
+/**
+  Execute the transfers queued on the transfer rings of a device by polling
+  their URBs. This is a synchronous operation.
+
+  @param  Xhc               The XHCI Instance.
+  @param  Urbs              The URBs to execute, in the order they were queued.
+  @param  UrbNum            The number of URBs.
+  @param  Timeout           The time to wait before abort, in millisecond.
+
+  @return EFI_DEVICE_ERROR  A transfer failed due to transfer error.
+  @return EFI_TIMEOUT       The transfers failed due to time out.
+  @return EFI_SUCCESS       The transfers finished OK.
+
+**/
+EFI_STATUS
+XhcExecTransferQueue (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  URB                **Urbs,
+  IN  UINTN              UrbNum,
+  IN  UINTN              Timeout
+  );
+
 /**
   Delete a single asynchronous interrupt transfer for
   the device and endpoint.
@@ -245,6 +245,7 @@ ScsiDiskDriverBindingStart (
   ScsiDiskDevice->EraseBlock.EraseBlocks            = ScsiDiskEraseBlocks;
   ScsiDiskDevice->UnmapInfo.MaxBlkDespCnt           = 1;
   ScsiDiskDevice->BlockLimitsVpdSupported           = FALSE;
+  ScsiDiskDevice->MaxTransferBlocks                 = 0;
   ScsiDiskDevice->Handle                            = Controller;
   InitializeListHead (&ScsiDiskDevice->AsyncTaskQueue);
 
@@ -2621,6 +2622,12 @@ ScsiDiskInquiryDevice (
               (BlockLimits->OptimalTransferLengthGranularity2 << 8) |
               BlockLimits->OptimalTransferLengthGranularity1;
 
+            ScsiDiskDevice->MaxTransferBlocks =
+              (BlockLimits->MaximumTransferLength4 << 24) |
+              (BlockLimits->MaximumTransferLength3 << 16) |
+              (BlockLimits->MaximumTransferLength2 << 8)  |
+              BlockLimits->MaximumTransferLength1;
+
             ScsiDiskDevice->UnmapInfo.MaxLbaCnt =
               (BlockLimits->MaximumUnmapLbaCount4 << 24) |
               (BlockLimits->MaximumUnmapLbaCount3 << 16) |
@@ -3386,6 +3393,97 @@ ParseInquiryData (
   ScsiDiskDevice->BlkIoMedia.RemovableMedia = (BOOLEAN)(!ScsiDiskDevice->FixedDevice);
 }
 
+/**
+  Get the maximum number of blocks that can be transferred by one Read or
+  Write command.
+
+  @param  ScsiDiskDevice  The pointer of SCSI_DISK_DEV
+
+  @return The maximum number of blocks per command.
+
+**/
+UINT32
+ScsiDiskGetMaxBlocksPerCommand (
+  IN SCSI_DISK_DEV  *ScsiDiskDevice
+  )
+{
+  UINT32  MaxBlock;
+
+  if (!ScsiDiskDevice->Cdb16Byte) {
+    MaxBlock = 0xFFFF;
+  } else {
+    MaxBlock = 0xFFFFFFFF;
+  }
+
+  //
+  // Honor the MAXIMUM TRANSFER LENGTH reported in the Block Limits VPD page,
+  // a value of 0 indicates that there is no reported limit.
+  //
+  if (ScsiDiskDevice->MaxTransferBlocks != 0) {
+    MaxBlock = MIN (MaxBlock, ScsiDiskDevice->MaxTransferBlocks);
+  }
+
+  return MaxBlock;
+}
+
+/**
+  Read or write sectors of SCSI Disk with all the SCSI commands of the request
+  outstanding at the same time, and wait for their completion.
+
+  The request is submitted through the asynchronous path, so that a SCSI pass
+  thru that supports non-blocking I/O can work on the commands in parallel.
+
+  @param  ScsiDiskDevice  The pointer of SCSI_DISK_DEV
+  @param  Read            TRUE to read, FALSE to write.
+  @param  Buffer          The buffer of the data.
+  @param  Lba             Logic block address
+  @param  NumberOfBlocks  The number of blocks to transfer
+
+  @retval EFI_DEVICE_ERROR  Indicates a device error.
+  @retval EFI_SUCCESS       Operation is successful.
+  @return others            The event for the request could not be created.
+
+**/
+EFI_STATUS
+ScsiDiskQueuedReadWriteSectors (
+  IN     SCSI_DISK_DEV  *ScsiDiskDevice,
+  IN     BOOLEAN        Read,
+  IN OUT VOID           *Buffer,
+  IN     EFI_LBA        Lba,
+  IN     UINTN          NumberOfBlocks
+  )
+{
+  EFI_STATUS           Status;
+  EFI_BLOCK_IO2_TOKEN  Token;
+
+  Status = gBS->CreateEvent (0, TPL_NOTIFY, NULL, NULL, &Token.Event);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Token.TransactionStatus = EFI_SUCCESS;
+  if (Read) {
+    Status = ScsiDiskAsyncReadSectors (ScsiDiskDevice, Buffer, Lba, NumberOfBlocks, &Token);
+  } else {
+    Status = ScsiDiskAsyncWriteSectors (ScsiDiskDevice, Buffer, Lba, NumberOfBlocks, &Token);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    //
+    // The SCSI commands complete in ScsiDiskNotify() at TPL_NOTIFY, which
+    // signals the token event once the last one is done.
+    //
+    while (gBS->CheckEvent (Token.Event) == EFI_NOT_READY) {
+    }
+
+    Status = Token.TransactionStatus;
+  }
+
+  gBS->CloseEvent (Token.Event);
+
+  return EFI_ERROR (Status) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+}
+
 /**
   Read sector from SCSI Disk.
 
@@ -3419,6 +3517,30 @@ ScsiDiskReadSectors (
   UINT8       MaxRetry;
   BOOLEAN     NeedRetry;
 
+  //
+  // A request that needs more than one SCSI command is queued, so that all of
+  // its commands can be outstanding at the same time.
+  //
+  if (NumberOfBlocks > ScsiDiskGetMaxBlocksPerCommand (ScsiDiskDevice)) {
+    Status = ScsiDiskQueuedReadWriteSectors (
+               ScsiDiskDevice,
+               TRUE,
+               Buffer,
+               Lba,
+               NumberOfBlocks
+               );
+    if (!EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    //
+    // The SCSI pass thru may have refused some of the commands, for example
+    // with EFI_NOT_READY when its queue is full. All the submitted commands
+    // have completed at this point, so retry one command at a time.
+    //
+    DEBUG ((DEBUG_WARN, "ScsiDisk: Queued %a failed (%r), retrying synchronously\n", "read", Status));
+  }
+
   Status = EFI_SUCCESS;
 
   BlocksRemaining = NumberOfBlocks;
@@ -3427,11 +3549,7 @@ ScsiDiskReadSectors (
   //
   // limit the data bytes that can be transferred by one Read(10) or Read(16) Command
   //
-  if (!ScsiDiskDevice->Cdb16Byte) {
-    MaxBlock = 0xFFFF;
-  } else {
-    MaxBlock = 0xFFFFFFFF;
-  }
+  MaxBlock = ScsiDiskGetMaxBlocksPerCommand (ScsiDiskDevice);
 
   PtrBuffer = Buffer;
 
@@ -3584,6 +3702,30 @@ ScsiDiskWriteSectors (
   UINT8       MaxRetry;
   BOOLEAN     NeedRetry;
 
+  //
+  // A request that needs more than one SCSI command is queued, so that all of
+  // its commands can be outstanding at the same time.
+  //
+  if (NumberOfBlocks > ScsiDiskGetMaxBlocksPerCommand (ScsiDiskDevice)) {
+    Status = ScsiDiskQueuedReadWriteSectors (
+               ScsiDiskDevice,
+               FALSE,
+               Buffer,
+               Lba,
+               NumberOfBlocks
+               );
+    if (!EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    //
+    // The SCSI pass thru may have refused some of the commands, for example
+    // with EFI_NOT_READY when its queue is full. All the submitted commands
+    // have completed at this point, so retry one command at a time.
+    //
+    DEBUG ((DEBUG_WARN, "ScsiDisk: Queued %a failed (%r), retrying synchronously\n", "write", Status));
+  }
+
   Status = EFI_SUCCESS;
 
   BlocksRemaining = NumberOfBlocks;
@@ -3592,11 +3734,7 @@ ScsiDiskWriteSectors (
   //
   // limit the data bytes that can be transferred by one Read(10) or Read(16) Command
   //
-  if (!ScsiDiskDevice->Cdb16Byte) {
-    MaxBlock = 0xFFFF;
-  } else {
-    MaxBlock = 0xFFFFFFFF;
-  }
+  MaxBlock = ScsiDiskGetMaxBlocksPerCommand (ScsiDiskDevice);
 
   PtrBuffer = Buffer;
 
@@ -3776,11 +3914,7 @@ ScsiDiskAsyncReadSectors (
   // Limit the data bytes that can be transferred by one Read(10) or Read(16)
   // Command
   //
-  if (!ScsiDiskDevice->Cdb16Byte) {
-    MaxBlock = 0xFFFF;
-  } else {
-    MaxBlock = 0xFFFFFFFF;
-  }
+  MaxBlock = ScsiDiskGetMaxBlocksPerCommand (ScsiDiskDevice);
 
   PtrBuffer = Buffer;
 
@@ -3890,6 +4024,11 @@ ScsiDiskAsyncReadSectors (
         Status = EFI_DEVICE_ERROR;
         goto Done;
       } else {
+        //
+        // The remaining blocks will never be transferred, fail the request
+        // once the SCSI commands already submitted have completed.
+        //
+        Token->TransactionStatus = EFI_DEVICE_ERROR;
         gBS->RestoreTPL (OldTpl);
 
         //
@@ -3994,11 +4133,7 @@ ScsiDiskAsyncWriteSectors (
   // Limit the data bytes that can be transferred by one Read(10) or Read(16)
   // Command
   //
-  if (!ScsiDiskDevice->Cdb16Byte) {
-    MaxBlock = 0xFFFF;
-  } else {
-    MaxBlock = 0xFFFFFFFF;
-  }
+  MaxBlock = ScsiDiskGetMaxBlocksPerCommand (ScsiDiskDevice);
 
   PtrBuffer = Buffer;
 
@@ -4108,6 +4243,11 @@ ScsiDiskAsyncWriteSectors (
         Status = EFI_DEVICE_ERROR;
         goto Done;
       } else {
+        //
+        // The remaining blocks will never be transferred, fail the request
+        // once the SCSI commands already submitted have completed.
+        //
+        Token->TransactionStatus = EFI_DEVICE_ERROR;
         gBS->RestoreTPL (OldTpl);
 
         //
@@ -85,6 +85,11 @@ typedef struct {
   SCSI_UNMAP_PARAM_INFO                    UnmapInfo;
   BOOLEAN                                  BlockLimitsVpdSupported;
 
+  //
+  // The MAXIMUM TRANSFER LENGTH in the Block Limits VPD page, 0 if not reported
+  //
+  UINT32                                   MaxTransferBlocks;
+
   //
   // The flag indicates if 16-byte command can be used
   //
@@ -1043,6 +1048,44 @@ ParseInquiryData (
   IN OUT SCSI_DISK_DEV  *ScsiDiskDevice
   );
 
+/**
+  Get the maximum number of blocks that can be transferred by one Read or
+  Write command.
+
+  @param  ScsiDiskDevice  The pointer of SCSI_DISK_DEV
+
+  @return The maximum number of blocks per command.
+
+**/
+UINT32
+ScsiDiskGetMaxBlocksPerCommand (
+  IN SCSI_DISK_DEV  *ScsiDiskDevice
+  );
+
+/**
+  Read or write sectors of SCSI Disk with all the SCSI commands of the request
+  outstanding at the same time, and wait for their completion.
+
+  @param  ScsiDiskDevice  The pointer of SCSI_DISK_DEV
+  @param  Read            TRUE to read, FALSE to write.
+  @param  Buffer          The buffer of the data.
+  @param  Lba             Logic block address
+  @param  NumberOfBlocks  The number of blocks to transfer
+
+  @retval EFI_DEVICE_ERROR  Indicates a device error.
+  @retval EFI_SUCCESS       Operation is successful.
+  @return others            The event for the request could not be created.
+
+**/
+EFI_STATUS
+ScsiDiskQueuedReadWriteSectors (
+  IN     SCSI_DISK_DEV  *ScsiDiskDevice,
+  IN     BOOLEAN        Read,
+  IN OUT VOID           *Buffer,
+  IN     EFI_LBA        Lba,
+  IN     UINTN          NumberOfBlocks
+  );
+
 /**
   Read sector from SCSI Disk.
 
@@ -0,0 +1,598 @@
+/** @file
+  Host-based unit test of the multi-command read and write paths of
+  ScsiDiskDxe.
+
+  The SCSI device is simulated by an EFI_SCSI_IO_PROTOCOL that keeps a
+  limited number of non-blocking commands in flight and refuses further ones
+  with EFI_NOT_READY, like a SCSI pass thru whose queue is full. A command in
+  flight completes each time the disk driver polls an event.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Library/UnitTestLib.h>
+
+#include "../ScsiDisk.h"
+
+#define UNIT_TEST_APP_NAME     "ScsiDiskDxe Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_BLOCK_SIZE           512
+#define TEST_DISK_BLOCKS          64
+#define TEST_MAX_TRANSFER_BLOCKS  8
+#define TEST_MAX_QUEUE_DEPTH      16
+
+//
+// A simulated event. Events without a notification function are signaled by
+// setting Signaled, which CheckEvent() clears.
+//
+typedef struct {
+  EFI_EVENT_NOTIFY    NotifyFunction;
+  VOID                *NotifyContext;
+  BOOLEAN             Signaled;
+} FAKE_EVENT;
+
+//
+// A non-blocking SCSI command in flight.
+//
+typedef struct {
+  EFI_SCSI_IO_SCSI_REQUEST_PACKET    *Packet;
+  EFI_EVENT                          Event;
+} FAKE_SCSI_COMMAND;
+
+EFI_BOOT_SERVICES  mBootServices;
+
+SCSI_DISK_DEV       *mScsiDiskDevice;
+UINT8               mDisk[TEST_DISK_BLOCKS * TEST_BLOCK_SIZE];
+UINT8               mBuffer[TEST_DISK_BLOCKS * TEST_BLOCK_SIZE];
+UINT8               mExpected[TEST_DISK_BLOCKS * TEST_BLOCK_SIZE];
+FAKE_SCSI_COMMAND   mInFlight[TEST_MAX_QUEUE_DEPTH];
+UINTN               mInFlightCount;
+UINTN               mMaxInFlightCount;
+UINTN               mQueueDepth;
+UINTN               mBlockingCommands;
+UINTN               mOpenEvents;
+
+/**
+  Fake RaiseTPL(), the tests run in a single thread.
+
+  @param[in] NewTpl  New task priority level.
+
+  @return The previous task priority level.
+
+**/
+EFI_TPL
+EFIAPI
+FakeRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  return TPL_APPLICATION;
+}
+
+/**
+  Fake RestoreTPL(), the tests run in a single thread.
+
+  @param[in] OldTpl  Previous task priority level.
+
+**/
+VOID
+EFIAPI
+FakeRestoreTpl (
+  IN EFI_TPL  OldTpl
+  )
+{
+}
+
+/**
+  Fake CreateEvent().
+
+  @param[in]  Type            The type of event.
+  @param[in]  NotifyTpl       The task priority level of the notification.
+  @param[in]  NotifyFunction  The notification function.
+  @param[in]  NotifyContext   The context of the notification function.
+  @param[out] Event           The new event.
+
+  @retval EFI_SUCCESS           The event was created.
+  @retval EFI_OUT_OF_RESOURCES  The event could not be allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeCreateEvent (
+  IN  UINT32            Type,
+  IN  EFI_TPL           NotifyTpl,
+  IN  EFI_EVENT_NOTIFY  NotifyFunction  OPTIONAL,
+  IN  VOID              *NotifyContext  OPTIONAL,
+  OUT EFI_EVENT         *Event
+  )
+{
+  FAKE_EVENT  *FakeEvent;
+
+  FakeEvent = AllocateZeroPool (sizeof (FAKE_EVENT));
+  if (FakeEvent == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  FakeEvent->NotifyFunction = NotifyFunction;
+  FakeEvent->NotifyContext  = NotifyContext;
+  *Event                    = FakeEvent;
+  mOpenEvents++;
+  return EFI_SUCCESS;
+}
+
+/**
+  Fake CloseEvent().
+
+  @param[in] Event  The event to close.
+
+  @retval EFI_SUCCESS  The event was closed.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeCloseEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  ASSERT (mOpenEvents > 0);
+  mOpenEvents--;
+  FreePool (Event);
+  return EFI_SUCCESS;
+}
+
+/**
+  Fake SignalEvent(), the notification function runs right away.
+
+  @param[in] Event  The event to signal.
+
+  @retval EFI_SUCCESS  The event was signaled.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeSignalEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  FAKE_EVENT  *FakeEvent;
+
+  FakeEvent = (FAKE_EVENT *)Event;
+  if (FakeEvent->NotifyFunction != NULL) {
+    FakeEvent->NotifyFunction (Event, FakeEvent->NotifyContext);
+  } else {
+    FakeEvent->Signaled = TRUE;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Run a READ(10) or WRITE(10) command against the simulated disk.
+
+  @param[in, out] Packet  The SCSI request packet.
+
+**/
+VOID
+ExecuteReadWrite10 (
+  IN OUT EFI_SCSI_IO_SCSI_REQUEST_PACKET  *Packet
+  )
+{
+  UINT8   *Cdb;
+  UINT32  Lba;
+  UINT32  Length;
+
+  Cdb    = Packet->Cdb;
+  Lba    = SwapBytes32 (ReadUnaligned32 ((UINT32 *)&Cdb[2]));
+  Length = SwapBytes16 (ReadUnaligned16 ((UINT16 *)&Cdb[7])) * TEST_BLOCK_SIZE;
+
+  ASSERT (Lba * TEST_BLOCK_SIZE + Length <= sizeof (mDisk));
+  if (Cdb[0] == EFI_SCSI_OP_READ10) {
+    ASSERT (Length == Packet->InTransferLength);
+    CopyMem (Packet->InDataBuffer, &mDisk[Lba * TEST_BLOCK_SIZE], Length);
+  } else {
+    ASSERT (Cdb[0] == EFI_SCSI_OP_WRITE10);
+    ASSERT (Length == Packet->OutTransferLength);
+    CopyMem (&mDisk[Lba * TEST_BLOCK_SIZE], Packet->OutDataBuffer, Length);
+  }
+
+  Packet->HostAdapterStatus = EFI_SCSI_IO_STATUS_HOST_ADAPTER_OK;
+  Packet->TargetStatus      = EFI_SCSI_IO_STATUS_TARGET_GOOD;
+  Packet->SenseDataLength   = 0;
+}
+
+/**
+  Complete the oldest non-blocking command in flight, if any.
+
+**/
+VOID
+CompleteOldestCommand (
+  VOID
+  )
+{
+  FAKE_SCSI_COMMAND  Command;
+
+  if (mInFlightCount == 0) {
+    return;
+  }
+
+  Command = mInFlight[0];
+  mInFlightCount--;
+  CopyMem (&mInFlight[0], &mInFlight[1], mInFlightCount * sizeof (FAKE_SCSI_COMMAND));
+
+  ExecuteReadWrite10 (Command.Packet);
+  gBS->SignalEvent (Command.Event);
+}
+
+/**
+  Fake CheckEvent(), the simulated device completes one command each time
+  the driver polls.
+
+  @param[in] Event  The event to check.
+
+  @retval EFI_SUCCESS    The event was signaled.
+  @retval EFI_NOT_READY  The event is not signaled yet.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeCheckEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  FAKE_EVENT  *FakeEvent;
+
+  CompleteOldestCommand ();
+
+  FakeEvent = (FAKE_EVENT *)Event;
+  if (FakeEvent->Signaled) {
+    FakeEvent->Signaled = FALSE;
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_READY;
+}
+
+/**
+  Simulated ExecuteScsiCommand() with a limited queue of non-blocking
+  commands.
+
+  @param[in]      This    The SCSI I/O protocol.
+  @param[in, out] Packet  The SCSI request packet.
+  @param[in]      Event   The event to signal on completion, NULL for a
+                          blocking command.
+
+  @retval EFI_SUCCESS    The command was executed or queued.
+  @retval EFI_NOT_READY  The queue is full.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeExecuteScsiCommand (
+  IN     EFI_SCSI_IO_PROTOCOL             *This,
+  IN OUT EFI_SCSI_IO_SCSI_REQUEST_PACKET  *Packet,
+  IN     EFI_EVENT                        Event  OPTIONAL
+  )
+{
+  if (Event == NULL) {
+    mBlockingCommands++;
+    ExecuteReadWrite10 (Packet);
+    return EFI_SUCCESS;
+  }
+
+  if (mInFlightCount == mQueueDepth) {
+    return EFI_NOT_READY;
+  }
+
+  mInFlight[mInFlightCount].Packet = Packet;
+  mInFlight[mInFlightCount].Event  = Event;
+  mInFlightCount++;
+  mMaxInFlightCount = MAX (mMaxInFlightCount, mInFlightCount);
+  return EFI_SUCCESS;
+}
+
+EFI_SCSI_IO_PROTOCOL  mScsiIo = {
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  FakeExecuteScsiCommand,
+  1
+};
+
+/**
+  Set up a SCSI disk whose device keeps the given number of non-blocking
+  commands in flight.
+
+  @param[in] Context  The queue depth of the device.
+
+  @retval UNIT_TEST_PASSED  The disk is ready.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SetupDisk (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  //
+  // gBS comes from UefiBootServicesTableLib, which UefiScsiLib links in.
+  //
+  mBootServices.RaiseTPL    = FakeRaiseTpl;
+  mBootServices.RestoreTPL  = FakeRestoreTpl;
+  mBootServices.CreateEvent = FakeCreateEvent;
+  mBootServices.CloseEvent  = FakeCloseEvent;
+  mBootServices.SignalEvent = FakeSignalEvent;
+  mBootServices.CheckEvent  = FakeCheckEvent;
+  gBS                       = &mBootServices;
+
+  mQueueDepth = (UINTN)Context;
+  ASSERT (mQueueDepth <= TEST_MAX_QUEUE_DEPTH);
+  mInFlightCount    = 0;
+  mMaxInFlightCount = 0;
+  mBlockingCommands = 0;
+  mOpenEvents       = 0;
+
+  for (Index = 0; Index < sizeof (mDisk); Index++) {
+    mDisk[Index] = (UINT8)(Index / TEST_BLOCK_SIZE + Index);
+  }
+
+  ZeroMem (mBuffer, sizeof (mBuffer));
+
+  mScsiDiskDevice = AllocateZeroPool (sizeof (SCSI_DISK_DEV));
+  UT_ASSERT_NOT_NULL (mScsiDiskDevice);
+
+  mScsiDiskDevice->Signature                  = SCSI_DISK_DEV_SIGNATURE;
+  mScsiDiskDevice->ScsiIo                     = &mScsiIo;
+  mScsiDiskDevice->BlkIo.Media                = &mScsiDiskDevice->BlkIoMedia;
+  mScsiDiskDevice->BlkIoMedia.MediaPresent    = TRUE;
+  mScsiDiskDevice->BlkIoMedia.BlockSize       = TEST_BLOCK_SIZE;
+  mScsiDiskDevice->BlkIoMedia.LastBlock       = TEST_DISK_BLOCKS - 1;
+  mScsiDiskDevice->MaxTransferBlocks          = TEST_MAX_TRANSFER_BLOCKS;
+  mScsiDiskDevice->SenseDataNumber            = 6;
+  mScsiDiskDevice->SenseData                  = AllocateZeroPool (6 * sizeof (EFI_SCSI_SENSE_DATA));
+  UT_ASSERT_NOT_NULL (mScsiDiskDevice->SenseData);
+  InitializeListHead (&mScsiDiskDevice->AsyncTaskQueue);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Complete all the outstanding commands and release the disk.
+
+  @param[in] Context  The queue depth of the device.
+
+**/
+VOID
+EFIAPI
+CleanupDisk (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  while (mInFlightCount > 0) {
+    CompleteOldestCommand ();
+  }
+
+  FreePool (mScsiDiskDevice->SenseData);
+  FreePool (mScsiDiskDevice);
+  mScsiDiskDevice = NULL;
+}
+
+/**
+  A read that needs several SCSI commands has them all in flight at once
+  when the device queue is deep enough.
+
+  @param[in] Context  The queue depth of the device.
+
+  @retval UNIT_TEST_PASSED  The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+QueuedReadUsesDeviceQueue (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UT_ASSERT_NOT_EFI_ERROR (ScsiDiskReadSectors (mScsiDiskDevice, mBuffer, 0, TEST_DISK_BLOCKS));
+
+  UT_ASSERT_MEM_EQUAL (mBuffer, mDisk, sizeof (mDisk));
+  UT_ASSERT_EQUAL (mMaxInFlightCount, TEST_DISK_BLOCKS / TEST_MAX_TRANSFER_BLOCKS);
+  UT_ASSERT_EQUAL (mBlockingCommands, 0);
+  UT_ASSERT_EQUAL (mInFlightCount, 0);
+  UT_ASSERT_EQUAL (mOpenEvents, 0);
+  UT_ASSERT_TRUE (IsListEmpty (&mScsiDiskDevice->AsyncTaskQueue));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A read that needs more SCSI commands than the device queue holds waits for
+  the queued commands and transfers every block.
+
+  @param[in] Context  The queue depth of the device.
+
+  @retval UNIT_TEST_PASSED  The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+QueuedReadWithFullQueue (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UT_ASSERT_NOT_EFI_ERROR (ScsiDiskReadSectors (mScsiDiskDevice, mBuffer, 0, TEST_DISK_BLOCKS));
+
+  UT_ASSERT_MEM_EQUAL (mBuffer, mDisk, sizeof (mDisk));
+  UT_ASSERT_EQUAL (mMaxInFlightCount, mQueueDepth);
+  UT_ASSERT_EQUAL (mInFlightCount, 0);
+  UT_ASSERT_EQUAL (mOpenEvents, 0);
+  UT_ASSERT_TRUE (IsListEmpty (&mScsiDiskDevice->AsyncTaskQueue));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A write that needs more SCSI commands than the device queue holds writes
+  every block.
+
+  @param[in] Context  The queue depth of the device.
+
+  @retval UNIT_TEST_PASSED  The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+QueuedWriteWithFullQueue (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < sizeof (mExpected); Index++) {
+    mExpected[Index] = (UINT8)~Index;
+  }
+
+  UT_ASSERT_NOT_EFI_ERROR (ScsiDiskWriteSectors (mScsiDiskDevice, mExpected, 0, TEST_DISK_BLOCKS));
+
+  UT_ASSERT_MEM_EQUAL (mDisk, mExpected, sizeof (mDisk));
+  UT_ASSERT_EQUAL (mInFlightCount, 0);
+  UT_ASSERT_EQUAL (mOpenEvents, 0);
+  UT_ASSERT_TRUE (IsListEmpty (&mScsiDiskDevice->AsyncTaskQueue));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A non-blocking read whose SCSI commands don't all fit in the device queue
+  completes with an error once the queued commands are done.
+
+  @param[in] Context  The queue depth of the device.
+
+  @retval UNIT_TEST_PASSED  The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+AsyncReadWithFullQueueFails (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_BLOCK_IO2_TOKEN  Token;
+
+  UT_ASSERT_NOT_EFI_ERROR (gBS->CreateEvent (0, TPL_NOTIFY, NULL, NULL, &Token.Event));
+  Token.TransactionStatus = EFI_SUCCESS;
+
+  UT_ASSERT_NOT_EFI_ERROR (ScsiDiskAsyncReadSectors (mScsiDiskDevice, mBuffer, 0, TEST_DISK_BLOCKS, &Token));
+  UT_ASSERT_EQUAL (mInFlightCount, mQueueDepth);
+
+  while (gBS->CheckEvent (Token.Event) == EFI_NOT_READY) {
+  }
+
+  UT_ASSERT_STATUS_EQUAL (Token.TransactionStatus, EFI_DEVICE_ERROR);
+  UT_ASSERT_EQUAL (mInFlightCount, 0);
+  UT_ASSERT_TRUE (IsListEmpty (&mScsiDiskDevice->AsyncTaskQueue));
+
+  gBS->CloseEvent (Token.Event);
+  UT_ASSERT_EQUAL (mOpenEvents, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  multi-command read and write paths and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      QueueTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the SCSI command queue Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&QueueTests, Framework, "SCSI Disk Command Queue Tests", "ScsiDiskDxe.Queue", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for SCSI Disk Command Queue Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite----------Description----------------------Name-------------Function--------------------Pre--------Post---------Context----------------
+  //
+  AddTestCase (QueueTests, "Read uses the device queue", "QueuedRead", QueuedReadUsesDeviceQueue, SetupDisk, CleanupDisk, (UNIT_TEST_CONTEXT)16);
+  AddTestCase (QueueTests, "Read against a full queue", "FullQueueRead", QueuedReadWithFullQueue, SetupDisk, CleanupDisk, (UNIT_TEST_CONTEXT)4);
+  AddTestCase (QueueTests, "Read against a one command queue", "OneCommandRead", QueuedReadWithFullQueue, SetupDisk, CleanupDisk, (UNIT_TEST_CONTEXT)1);
+  AddTestCase (QueueTests, "Write against a full queue", "FullQueueWrite", QueuedWriteWithFullQueue, SetupDisk, CleanupDisk, (UNIT_TEST_CONTEXT)4);
+  AddTestCase (QueueTests, "Async read against a full queue", "FullQueueAsyncRead", AsyncReadWithFullQueueFails, SetupDisk, CleanupDisk, (UNIT_TEST_CONTEXT)4);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define ScsiDiskUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+ScsiDiskUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = UnitTestingEntry ();
+  return EFI_ERROR (Status) ? 1 : 0;
+}
@@ -42,6 +42,7 @@ UFS_PASS_THRU_PRIVATE_DATA  gUfsPassThruTemplate = {
   0,                                                                                                                                               // UtpTrlBase
   0,                                                                                                                                               // Nutrs
   0,                                                                                                                                               // TrlMapping
+  0,                                                                                                                                               // TrlSlotsInUse
   0,                                                                                                                                               // UtpTmrlBase
   0,                                                                                                                                               // Nutmrs
   0,                                                                                                                                               // TmrlMapping
@@ -64,6 +64,12 @@ typedef struct _UFS_PASS_THRU_PRIVATE_DATA {
   VOID                                  *UtpTrlBase;
   UINT8                                 Nutrs;
   VOID                                  *TrlMapping;
+  //
+  // Transfer request slots handed out by UfsFindAvailableSlotInTrl() and not
+  // released yet. The doorbell alone can't tell a slot whose descriptor is
+  // being filled from a free one.
+  //
+  UINT32                                TrlSlotsInUse;
   VOID                                  *UtpTmrlBase;
   UINT8                                 Nutmrs;
   VOID                                  *TmrlMapping;
@@ -83,8 +89,14 @@ typedef struct {
   UINT32                                        Signature;
   LIST_ENTRY                                    TransferList;
 
+  //
+  // Trd is NULL until the request got a slot in the transfer request list.
+  // The descriptor is built in PendingTrd and copied to the slot when the
+  // request is started.
+  //
   UINT8                                         Slot;
   UTP_TRD                                       *Trd;
+  UTP_TRD                                       PendingTrd;
   UINT32                                        CmdDescSize;
   VOID                                          *CmdDescHost;
   VOID                                          *CmdDescMapping;
@@ -707,6 +707,9 @@ UfsCreateNopCommandDesc (
 /**
   Find out available slot in transfer list of a UFS device.
 
+  The slot is reserved for the caller until it is released by UfsStopExecCmd(),
+  so several requests can be prepared and kept in flight at the same time.
+
   @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
   @param[out] Slot          The available slot.
 
@@ -723,25 +726,34 @@ UfsFindAvailableSlotInTrl (
   UINT8       Nutrs;
   UINT8       Index;
   UINT32      Data;
+  EFI_TPL     OldTpl;
   EFI_STATUS  Status;
 
   ASSERT ((Private != NULL) && (Slot != NULL));
 
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
   Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Data);
   if (EFI_ERROR (Status)) {
-    return Status;
+    goto Exit;
   }
 
-  Nutrs = (UINT8)((Private->UfsHcInfo.Capabilities & UFS_HC_CAP_NUTRS) + 1);
+  Data  |= Private->TrlSlotsInUse;
+  Nutrs  = (UINT8)((Private->UfsHcInfo.Capabilities & UFS_HC_CAP_NUTRS) + 1);
+  Status = EFI_NOT_READY;
 
   for (Index = 0; Index < Nutrs; Index++) {
     if ((Data & (BIT0 << Index)) == 0) {
-      *Slot = Index;
-      return EFI_SUCCESS;
+      Private->TrlSlotsInUse |= BIT0 << Index;
+      *Slot                   = Index;
+      Status                  = EFI_SUCCESS;
+      break;
     }
   }
 
-  return EFI_NOT_READY;
+Exit:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
 }
 
 /**
@@ -781,7 +793,7 @@ UfsStartExecCmd (
 }
 
 /**
-  Stop specified slot in transfer list of a UFS device.
+  Stop specified slot in transfer list of a UFS device and release it.
 
   @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
   @param[in]  Slot          The slot to be stop.
@@ -794,20 +806,24 @@ UfsStopExecCmd (
   )
 {
   UINT32      Data;
+  EFI_TPL     OldTpl;
   EFI_STATUS  Status;
 
+  OldTpl                  = gBS->RaiseTPL (TPL_NOTIFY);
+  Private->TrlSlotsInUse &= ~(BIT0 << Slot);
+  gBS->RestoreTPL (OldTpl);
+
   Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Data);
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
   if ((Data & (BIT0 << Slot)) != 0) {
-    Status = UfsMmioRead32 (Private, UFS_HC_UTRLCLR_OFFSET, &Data);
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
-
-    Status = UfsMmioWrite32 (Private, UFS_HC_UTRLCLR_OFFSET, Data & ~(BIT0 << Slot));
+    //
+    // Writing 0 clears the slot, the bits written with 1 are ignored so the
+    // other requests in flight are not affected.
+    //
+    Status = UfsMmioWrite32 (Private, UFS_HC_UTRLCLR_OFFSET, ~(BIT0 << Slot));
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -924,6 +940,7 @@ UfsSendDmRequestRetry (
   Status = UfsCreateDMCommandDesc (Private, Packet, Trd, &CmdDescHost, &CmdDescMapping);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Failed to create DM command descriptor\n"));
+    UfsStopExecCmd (Private, Slot);
     return Status;
   }
 
@@ -940,7 +957,7 @@ UfsSendDmRequestRetry (
   //
   // Wait for the completion of the transfer request.
   //
-  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0, 0, Packet->Timeout);
+  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0 << Slot, 0, Packet->Timeout);
   if (EFI_ERROR (Status)) {
     goto Exit;
   }
@@ -1275,6 +1292,7 @@ UfsExecNopCmds (
   Trd    = ((UTP_TRD *)Private->UtpTrlBase) + Slot;
   Status = UfsCreateNopCommandDesc (Private, Trd, &CmdDescHost, &CmdDescMapping);
   if (EFI_ERROR (Status)) {
+    UfsStopExecCmd (Private, Slot);
     return Status;
   }
 
@@ -1464,9 +1482,43 @@ UfsPrepareDataTransferBuffer (
   return EFI_SUCCESS;
 }
 
+/**
+  Start a SCSI transfer request in a free slot of the transfer request list.
+
+  @param[in]      Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+  @param[in, out] TransReq      The transfer request whose descriptor is built in PendingTrd.
+
+  @retval EFI_SUCCESS           The transfer request was started.
+  @retval EFI_NOT_READY         No slot is available at this moment.
+  @retval Others                The doorbell couldn't be rung.
+
+**/
+EFI_STATUS
+UfsStartTransReq (
+  IN     UFS_PASS_THRU_PRIVATE_DATA  *Private,
+  IN OUT UFS_PASS_THRU_TRANS_REQ     *TransReq
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = UfsFindAvailableSlotInTrl (Private, &TransReq->Slot);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  TransReq->Trd = ((UTP_TRD *)Private->UtpTrlBase) + TransReq->Slot;
+  CopyMem (TransReq->Trd, &TransReq->PendingTrd, sizeof (UTP_TRD));
+
+  return UfsStartExecCmd (Private, TransReq->Slot);
+}
+
 /**
   Sends a UFS-supported SCSI Request Packet to a UFS device that is attached to the UFS host controller.
 
+  Non-blocking requests are queued when all the slots of the transfer request
+  list are busy and started by ProcessAsyncTaskList() as soon as one is freed,
+  so a caller can keep more requests outstanding than the controller has slots.
+
   @param[in]      Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
   @param[in]      Lun           The LUN of the UFS device to send the SCSI Request Packet.
   @param[in, out] Packet        A pointer to the SCSI Request Packet to send to a specified Lun of the
@@ -1482,6 +1534,7 @@ UfsPrepareDataTransferBuffer (
                                 InDataBuffer. For write and bi-directional commands,
                                 OutTransferLength bytes were transferred by
                                 OutDataBuffer.
+  @retval EFI_NOT_READY         No slot is available for a blocking request at this moment.
   @retval EFI_DEVICE_ERROR      A device error occurred while attempting to send the SCSI Request
                                 Packet.
   @retval EFI_OUT_OF_RESOURCES  The resource for transfer is not available.
@@ -1514,32 +1567,24 @@ UfsExecScsiCmds (
   TransReq->Packet        = Packet;
 
   UfsHc = Private->UfsHostController;
-  //
-  // Find out which slot of transfer request list is available.
-  //
-  Status = UfsFindAvailableSlotInTrl (Private, &TransReq->Slot);
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
-
-  TransReq->Trd = ((UTP_TRD *)Private->UtpTrlBase) + TransReq->Slot;
 
   //
-  // Fill transfer request descriptor to this slot.
+  // Fill transfer request descriptor. It is copied to a slot of the transfer
+  // request list when the request is started.
   //
   Status = UfsCreateScsiCommandDesc (
              Private,
              Lun,
              Packet,
-             TransReq->Trd,
+             &TransReq->PendingTrd,
              &TransReq->CmdDescHost,
              &TransReq->CmdDescMapping
              );
   if (EFI_ERROR (Status)) {
-    return Status;
+    goto Exit1;
   }
 
-  TransReq->CmdDescSize = TransReq->Trd->PrdtO * sizeof (UINT32) + TransReq->Trd->PrdtL * sizeof (UTP_TR_PRD);
+  TransReq->CmdDescSize = TransReq->PendingTrd.PrdtO * sizeof (UINT32) + TransReq->PendingTrd.PrdtL * sizeof (UTP_TR_PRD);
 
   Status = UfsPrepareDataTransferBuffer (Private, TransReq);
   if (EFI_ERROR (Status)) {
@@ -1547,25 +1592,26 @@ UfsExecScsiCmds (
   }
 
   //
-  // Insert the async SCSI cmd to the Async I/O list
+  // Insert the async SCSI cmd to the Async I/O list and start it if a slot
+  // is free. Otherwise it waits in the list until ProcessAsyncTaskList()
+  // finds a free slot for it.
   //
   if (Event != NULL) {
     OldTpl                = gBS->RaiseTPL (TPL_NOTIFY);
     TransReq->CallerEvent = Event;
     InsertTailList (&Private->Queue, &TransReq->TransferList);
+    UfsStartTransReq (Private, TransReq);
     gBS->RestoreTPL (OldTpl);
+    return EFI_SUCCESS;
   }
 
   //
   // Start to execute the transfer request.
   //
-  UfsStartExecCmd (Private, TransReq->Slot);
-
-  //
-  // Immediately return for async I/O.
-  //
-  if (Event != NULL) {
-    return EFI_SUCCESS;
+  Status = UfsStartTransReq (Private, TransReq);
+  if (TransReq->Trd == NULL) {
+    UfsReconcileDataTransferBuffer (Private, TransReq);
+    goto Exit1;
   }
 
   //
@@ -2253,7 +2299,9 @@ SignalCallerEvent (
 
   UfsHc->Flush (UfsHc);
 
-  UfsStopExecCmd (Private, TransReq->Slot);
+  if (TransReq->Trd != NULL) {
+    UfsStopExecCmd (Private, TransReq->Slot);
+  }
 
   UfsReconcileDataTransferBuffer (Private, TransReq);
 
@@ -2297,28 +2345,24 @@ ProcessAsyncTaskList (
   UTP_RESPONSE_UPIU                           *Response;
   UINT16                                      SenseDataLen;
   UINT32                                      ResTranCount;
-  UINT32                                      SlotsMap;
   UINT32                                      Value;
   EFI_STATUS                                  Status;
 
-  Private  = (UFS_PASS_THRU_PRIVATE_DATA *)Context;
-  SlotsMap = 0;
+  Private = (UFS_PASS_THRU_PRIVATE_DATA *)Context;
 
   //
-  // Check the entries in the async I/O queue are done or not.
+  // Check the entries in the async I/O queue are done or not. The doorbell
+  // is read once for all of them, a request is done when its bit is cleared.
+  // Requests still waiting for a slot are started as soon as the completed
+  // ones before them in the queue have released theirs.
   //
   if (!IsListEmpty (&Private->Queue)) {
+    Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Value);
+
     BASE_LIST_FOR_EACH_SAFE (Entry, NextEntry, &Private->Queue) {
       TransReq = UFS_PASS_THRU_TRANS_REQ_FROM_THIS (Entry);
       Packet   = TransReq->Packet;
 
-      if ((SlotsMap & (BIT0 << TransReq->Slot)) != 0) {
-        return;
-      }
-
-      SlotsMap |= BIT0 << TransReq->Slot;
-
-      Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Value);
       if (EFI_ERROR (Status)) {
         //
         // TODO: Should find/add a proper host adapter return status for this
@@ -2330,9 +2374,19 @@ ProcessAsyncTaskList (
         continue;
       }
 
-      if ((Value & (BIT0 << TransReq->Slot)) != 0) {
+      if (TransReq->Trd == NULL) {
+        //
+        // The doorbell value read above doesn't cover a request started now.
+        //
+        UfsStartTransReq (Private, TransReq);
+        if (TransReq->Trd != NULL) {
+          continue;
+        }
+      }
+
+      if ((TransReq->Trd == NULL) || ((Value & (BIT0 << TransReq->Slot)) != 0)) {
         //
-        // Scsi cmd not finished yet.
+        // Scsi cmd not started or not finished yet.
         //
         if (TransReq->TimeoutRemain > UFS_HC_ASYNC_TIMER) {
           TransReq->TimeoutRemain -= UFS_HC_ASYNC_TIMER;
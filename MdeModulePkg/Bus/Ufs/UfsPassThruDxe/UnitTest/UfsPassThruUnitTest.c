@@ -0,0 +1,747 @@
+/** @file
+  Host-based unit test of the transfer request list handling of UfsPassThruDxe.
+
+  The UFS host controller is simulated by its transfer request list doorbell:
+  ringing a slot sets its bit, and the test completes a request by clearing
+  the bit like the controller does when the response is received.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <IndustryStandard/Scsi.h>
+#include <Library/UnitTestLib.h>
+
+#include "../UfsPassThru.h"
+
+#define UNIT_TEST_APP_NAME     "UfsPassThruDxe Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_REQUEST_NUMBER  32
+#define TEST_BLOCK_SIZE      512
+
+#define SLOTS_MASK(Nutrs)  ((UINT32)(LShiftU64 (1, (Nutrs)) - 1))
+
+EFI_BOOT_SERVICES                *gBS;
+EDKII_UFS_HC_PLATFORM_PROTOCOL  *mUfsHcPlatform = NULL;
+
+//
+// Simulated transfer request list registers.
+//
+UINT32  mUtrlDbr;
+UINT32  mUtrlRsr;
+
+UFS_PASS_THRU_PRIVATE_DATA                  *mPrivate;
+EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  mPackets[TEST_REQUEST_NUMBER];
+UINT8                                       mCdbs[TEST_REQUEST_NUMBER][10];
+UINT8                                       mEvents[TEST_REQUEST_NUMBER];
+BOOLEAN                                     mSignaled[TEST_REQUEST_NUMBER];
+UINT32                                      mBuffer[TEST_BLOCK_SIZE / sizeof (UINT32)];
+
+/**
+  Fake RaiseTPL(), the tests run in a single thread.
+
+  @param[in] NewTpl  New task priority level.
+
+  @return The previous task priority level.
+
+**/
+EFI_TPL
+EFIAPI
+FakeRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  return TPL_APPLICATION;
+}
+
+/**
+  Fake RestoreTPL(), the tests run in a single thread.
+
+  @param[in] OldTpl  Previous task priority level.
+
+**/
+VOID
+EFIAPI
+FakeRestoreTpl (
+  IN EFI_TPL  OldTpl
+  )
+{
+}
+
+/**
+  Fake SignalEvent(), records which request has been completed.
+
+  @param[in] Event  The event to signal.
+
+  @retval EFI_SUCCESS  The event was signaled.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeSignalEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  UINTN  Index;
+
+  Index = (UINT8 *)Event - mEvents;
+  ASSERT (Index < TEST_REQUEST_NUMBER);
+  ASSERT (!mSignaled[Index]);
+
+  mSignaled[Index] = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Read the simulated UFS host controller registers.
+
+  @param[in]      This    The UFS host controller protocol.
+  @param[in]      Width   The width of the access.
+  @param[in]      Offset  The register offset.
+  @param[in]      Count   The number of accesses.
+  @param[in, out] Buffer  The value read.
+
+  @retval EFI_SUCCESS  The register was read.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeUfsHcRead (
+  IN     EDKII_UFS_HOST_CONTROLLER_PROTOCOL        *This,
+  IN     EDKII_UFS_HOST_CONTROLLER_PROTOCOL_WIDTH  Width,
+  IN     UINT64                                    Offset,
+  IN     UINTN                                     Count,
+  IN OUT VOID                                      *Buffer
+  )
+{
+  switch (Offset) {
+    case UFS_HC_UTRLDBR_OFFSET:
+      *(UINT32 *)Buffer = mUtrlDbr;
+      break;
+    case UFS_HC_UTRLRSR_OFFSET:
+      *(UINT32 *)Buffer = mUtrlRsr;
+      break;
+    default:
+      ASSERT (FALSE);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Write the simulated UFS host controller registers.
+
+  @param[in]      This    The UFS host controller protocol.
+  @param[in]      Width   The width of the access.
+  @param[in]      Offset  The register offset.
+  @param[in]      Count   The number of accesses.
+  @param[in, out] Buffer  The value to write.
+
+  @retval EFI_SUCCESS  The register was written.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeUfsHcWrite (
+  IN     EDKII_UFS_HOST_CONTROLLER_PROTOCOL        *This,
+  IN     EDKII_UFS_HOST_CONTROLLER_PROTOCOL_WIDTH  Width,
+  IN     UINT64                                    Offset,
+  IN     UINTN                                     Count,
+  IN OUT VOID                                      *Buffer
+  )
+{
+  UINT32  Value;
+
+  Value = *(UINT32 *)Buffer;
+  switch (Offset) {
+    case UFS_HC_UTRLDBR_OFFSET:
+      //
+      // Ringing a slot that is still in flight corrupts its request.
+      //
+      ASSERT ((mUtrlDbr & Value) == 0);
+      mUtrlDbr |= Value;
+      break;
+    case UFS_HC_UTRLRSR_OFFSET:
+      mUtrlRsr = Value;
+      break;
+    case UFS_HC_UTRLCLR_OFFSET:
+      mUtrlDbr &= Value;
+      break;
+    default:
+      ASSERT (FALSE);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Allocate pages for the simulated UFS host controller.
+
+  @param[in]  This         The UFS host controller protocol.
+  @param[in]  Type         The type of allocation.
+  @param[in]  MemoryType   The type of memory to allocate.
+  @param[in]  Pages        The number of pages to allocate.
+  @param[out] HostAddress  The allocated range.
+  @param[in]  Attributes   The requested bit mask of attributes.
+
+  @retval EFI_SUCCESS           The memory was allocated.
+  @retval EFI_OUT_OF_RESOURCES  The memory could not be allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeUfsHcAllocateBuffer (
+  IN     EDKII_UFS_HOST_CONTROLLER_PROTOCOL  *This,
+  IN     EFI_ALLOCATE_TYPE                   Type,
+  IN     EFI_MEMORY_TYPE                     MemoryType,
+  IN     UINTN                               Pages,
+  OUT VOID                                   **HostAddress,
+  IN     UINT64                              Attributes
+  )
+{
+  *HostAddress = AllocatePages (Pages);
+  if (*HostAddress == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (*HostAddress, EFI_PAGES_TO_SIZE (Pages));
+  return EFI_SUCCESS;
+}
+
+/**
+  Free pages allocated with FakeUfsHcAllocateBuffer().
+
+  @param[in] This         The UFS host controller protocol.
+  @param[in] Pages        The number of pages to free.
+  @param[in] HostAddress  The range to free.
+
+  @retval EFI_SUCCESS  The memory was freed.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeUfsHcFreeBuffer (
+  IN  EDKII_UFS_HOST_CONTROLLER_PROTOCOL  *This,
+  IN  UINTN                               Pages,
+  IN  VOID                                *HostAddress
+  )
+{
+  FreePages (HostAddress, Pages);
+  return EFI_SUCCESS;
+}
+
+/**
+  Map a buffer one to one for the simulated UFS host controller.
+
+  @param[in]      This           The UFS host controller protocol.
+  @param[in]      Operation      The bus master operation.
+  @param[in]      HostAddress    The buffer to map.
+  @param[in, out] NumberOfBytes  The number of bytes to map.
+  @param[out]     DeviceAddress  The device address of the buffer.
+  @param[out]     Mapping        The mapping value.
+
+  @retval EFI_SUCCESS  The buffer was mapped.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeUfsHcMap (
+  IN     EDKII_UFS_HOST_CONTROLLER_PROTOCOL   *This,
+  IN     EDKII_UFS_HOST_CONTROLLER_OPERATION  Operation,
+  IN     VOID                                 *HostAddress,
+  IN OUT UINTN                                *NumberOfBytes,
+  OUT EFI_PHYSICAL_ADDRESS                    *DeviceAddress,
+  OUT VOID                                    **Mapping
+  )
+{
+  *DeviceAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)HostAddress;
+  *Mapping       = HostAddress;
+  return EFI_SUCCESS;
+}
+
+/**
+  Unmap a buffer mapped with FakeUfsHcMap().
+
+  @param[in] This     The UFS host controller protocol.
+  @param[in] Mapping  The mapping value.
+
+  @retval EFI_SUCCESS  The buffer was unmapped.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeUfsHcUnmap (
+  IN  EDKII_UFS_HOST_CONTROLLER_PROTOCOL  *This,
+  IN  VOID                                *Mapping
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Flush the posted writes of the simulated UFS host controller.
+
+  @param[in] This  The UFS host controller protocol.
+
+  @retval EFI_SUCCESS  The writes were flushed.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeUfsHcFlush (
+  IN  EDKII_UFS_HOST_CONTROLLER_PROTOCOL  *This
+  )
+{
+  return EFI_SUCCESS;
+}
+
+EFI_BOOT_SERVICES  mBootServices;
+
+EDKII_UFS_HOST_CONTROLLER_PROTOCOL  mUfsHc = {
+  NULL,
+  FakeUfsHcAllocateBuffer,
+  FakeUfsHcFreeBuffer,
+  FakeUfsHcMap,
+  FakeUfsHcUnmap,
+  FakeUfsHcFlush,
+  FakeUfsHcRead,
+  FakeUfsHcWrite
+};
+
+/**
+  Complete the request of a slot like the UFS host controller does.
+
+  @param[in] Slot  The slot of the transfer request list.
+
+**/
+VOID
+CompleteSlot (
+  IN UINT8  Slot
+  )
+{
+  UTP_TRD  *Trd;
+
+  ASSERT ((mUtrlDbr & (BIT0 << Slot)) != 0);
+
+  Trd      = ((UTP_TRD *)mPrivate->UtpTrlBase) + Slot;
+  Trd->Ocs = 0;
+  mUtrlDbr = mUtrlDbr & ~(BIT0 << Slot);
+}
+
+/**
+  Get the queued transfer request of a non-blocking request.
+
+  @param[in] Index  The index of the request.
+
+  @return The transfer request, or NULL if the request has completed.
+
+**/
+UFS_PASS_THRU_TRANS_REQ *
+GetRequest (
+  IN UINTN  Index
+  )
+{
+  LIST_ENTRY               *Entry;
+  UFS_PASS_THRU_TRANS_REQ  *TransReq;
+
+  BASE_LIST_FOR_EACH (Entry, &mPrivate->Queue) {
+    TransReq = UFS_PASS_THRU_TRANS_REQ_FROM_THIS (Entry);
+    if (TransReq->Packet == &mPackets[Index]) {
+      return TransReq;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Get the slot used by a request.
+
+  @param[in] Index  The index of the request.
+
+  @return The slot, or MAX_UINT8 if the request isn't in flight.
+
+**/
+UINT8
+GetRequestSlot (
+  IN UINTN  Index
+  )
+{
+  UFS_PASS_THRU_TRANS_REQ  *TransReq;
+
+  TransReq = GetRequest (Index);
+  if ((TransReq == NULL) || (TransReq->Trd == NULL)) {
+    return MAX_UINT8;
+  }
+
+  return TransReq->Slot;
+}
+
+/**
+  Send a READ(10) request.
+
+  @param[in] Index  The index of the request.
+  @param[in] Async  Whether the request is non-blocking.
+
+  @return The status returned by UfsExecScsiCmds().
+
+**/
+EFI_STATUS
+SendRead (
+  IN UINTN    Index,
+  IN BOOLEAN  Async
+  )
+{
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet;
+
+  Packet = &mPackets[Index];
+  ZeroMem (Packet, sizeof (*Packet));
+  ZeroMem (mCdbs[Index], sizeof (mCdbs[Index]));
+
+  mCdbs[Index][0]          = EFI_SCSI_OP_READ10;
+  mCdbs[Index][5]          = (UINT8)Index;
+  mCdbs[Index][8]          = 1;
+  Packet->Timeout          = EFI_TIMER_PERIOD_MILLISECONDS (10);
+  Packet->Cdb              = mCdbs[Index];
+  Packet->CdbLength        = sizeof (mCdbs[Index]);
+  Packet->InDataBuffer     = mBuffer;
+  Packet->InTransferLength = sizeof (mBuffer);
+  Packet->DataDirection    = EFI_EXT_SCSI_DATA_DIRECTION_READ;
+
+  return UfsExecScsiCmds (mPrivate, 0, Packet, Async ? (EFI_EVENT)&mEvents[Index] : NULL);
+}
+
+/**
+  Set up a UFS host controller with the given number of transfer request slots.
+
+  @param[in] Context  The number of slots.
+
+  @retval UNIT_TEST_PASSED  The controller is ready.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SetupController (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Nutrs;
+
+  Nutrs = (UINT8)(UINTN)Context;
+
+  mBootServices.RaiseTPL    = FakeRaiseTpl;
+  mBootServices.RestoreTPL  = FakeRestoreTpl;
+  mBootServices.SignalEvent = FakeSignalEvent;
+  gBS                       = &mBootServices;
+
+  mUtrlDbr = 0;
+  mUtrlRsr = 0;
+  ZeroMem (mSignaled, sizeof (mSignaled));
+
+  mPrivate = AllocateZeroPool (sizeof (UFS_PASS_THRU_PRIVATE_DATA));
+  UT_ASSERT_NOT_NULL (mPrivate);
+
+  mPrivate->Signature              = UFS_PASS_THRU_SIG;
+  mPrivate->UfsHostController      = &mUfsHc;
+  mPrivate->UfsHcInfo.Capabilities = UFS_HC_CAP_64ADDR | (Nutrs - 1);
+  mPrivate->Nutrs                  = Nutrs;
+  mPrivate->UtpTrlBase             = AllocateZeroPool (Nutrs * sizeof (UTP_TRD));
+  UT_ASSERT_NOT_NULL (mPrivate->UtpTrlBase);
+  InitializeListHead (&mPrivate->Queue);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Complete all the outstanding requests and release the controller.
+
+  @param[in] Context  The number of slots.
+
+**/
+VOID
+EFIAPI
+CleanupController (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Slot;
+
+  while (!IsListEmpty (&mPrivate->Queue)) {
+    for (Slot = 0; Slot < mPrivate->Nutrs; Slot++) {
+      if ((mUtrlDbr & (BIT0 << Slot)) != 0) {
+        CompleteSlot (Slot);
+      }
+    }
+
+    ProcessAsyncTaskList (NULL, mPrivate);
+  }
+
+  FreePool (mPrivate->UtpTrlBase);
+  FreePool (mPrivate);
+  mPrivate = NULL;
+}
+
+/**
+  Non-blocking requests are started in distinct slots at once.
+
+  @param[in] Context  The number of slots.
+
+  @retval UNIT_TEST_PASSED  The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+AsyncRequestsUseAllSlots (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < mPrivate->Nutrs; Index++) {
+    UT_ASSERT_NOT_EFI_ERROR (SendRead (Index, TRUE));
+  }
+
+  UT_ASSERT_EQUAL (mUtrlDbr, SLOTS_MASK (mPrivate->Nutrs));
+  UT_ASSERT_EQUAL (mPrivate->TrlSlotsInUse, SLOTS_MASK (mPrivate->Nutrs));
+
+  //
+  // Nothing completes while the doorbell is still set.
+  //
+  ProcessAsyncTaskList (NULL, mPrivate);
+  for (Index = 0; Index < mPrivate->Nutrs; Index++) {
+    UT_ASSERT_FALSE (mSignaled[Index]);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Requests completing out of order signal their own events only.
+
+  @param[in] Context  The number of slots.
+
+  @retval UNIT_TEST_PASSED  The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+OutOfOrderCompletion (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINT8  Slot;
+
+  for (Index = 0; Index < 3; Index++) {
+    UT_ASSERT_NOT_EFI_ERROR (SendRead (Index, TRUE));
+  }
+
+  Slot = GetRequestSlot (2);
+  UT_ASSERT_NOT_EQUAL (Slot, MAX_UINT8);
+  CompleteSlot (Slot);
+  ProcessAsyncTaskList (NULL, mPrivate);
+
+  UT_ASSERT_FALSE (mSignaled[0]);
+  UT_ASSERT_FALSE (mSignaled[1]);
+  UT_ASSERT_TRUE (mSignaled[2]);
+  UT_ASSERT_EQUAL (mPackets[2].HostAdapterStatus, EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OK);
+  UT_ASSERT_EQUAL (mPrivate->TrlSlotsInUse & (BIT0 << Slot), 0);
+
+  Slot = GetRequestSlot (0);
+  UT_ASSERT_NOT_EQUAL (Slot, MAX_UINT8);
+  CompleteSlot (Slot);
+  ProcessAsyncTaskList (NULL, mPrivate);
+
+  UT_ASSERT_TRUE (mSignaled[0]);
+  UT_ASSERT_FALSE (mSignaled[1]);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Non-blocking requests beyond the number of slots wait in the queue and are
+  started in order as slots are freed.
+
+  @param[in] Context  The number of slots.
+
+  @retval UNIT_TEST_PASSED  The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RequestsWaitForFreeSlot (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN                    Index;
+  UINT8                    Slot;
+  UFS_PASS_THRU_TRANS_REQ  *TransReq;
+
+  for (Index = 0; Index < TEST_REQUEST_NUMBER; Index++) {
+    UT_ASSERT_NOT_EFI_ERROR (SendRead (Index, TRUE));
+  }
+
+  UT_ASSERT_EQUAL (mUtrlDbr, SLOTS_MASK (mPrivate->Nutrs));
+  for (Index = mPrivate->Nutrs; Index < TEST_REQUEST_NUMBER; Index++) {
+    UT_ASSERT_EQUAL (GetRequestSlot (Index), MAX_UINT8);
+  }
+
+  //
+  // Free the slot of the second request, the first waiting request takes it
+  // and the other ones keep waiting.
+  //
+  Slot = GetRequestSlot (1);
+  CompleteSlot (Slot);
+  ProcessAsyncTaskList (NULL, mPrivate);
+
+  UT_ASSERT_TRUE (mSignaled[1]);
+  UT_ASSERT_EQUAL (GetRequestSlot (mPrivate->Nutrs), Slot);
+  UT_ASSERT_EQUAL (mUtrlDbr, SLOTS_MASK (mPrivate->Nutrs));
+  UT_ASSERT_EQUAL (GetRequestSlot (mPrivate->Nutrs + 1), MAX_UINT8);
+
+  //
+  // The descriptor built while the request was waiting is in the slot.
+  //
+  TransReq = GetRequest (mPrivate->Nutrs);
+  UT_ASSERT_EQUAL (TransReq->Trd->UcdBa, TransReq->PendingTrd.UcdBa);
+  UT_ASSERT_EQUAL (TransReq->Trd->UcdBaU, TransReq->PendingTrd.UcdBaU);
+  UT_ASSERT_EQUAL (TransReq->Trd->PrdtL, TransReq->PendingTrd.PrdtL);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A request waiting for a slot times out like one in flight, and a blocking
+  request is not queued when all the slots are busy.
+
+  @param[in] Context  The number of slots.
+
+  @retval UNIT_TEST_PASSED  The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+WaitingRequestTimesOut (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Tick;
+
+  UT_ASSERT_NOT_EFI_ERROR (SendRead (0, TRUE));
+  UT_ASSERT_NOT_EFI_ERROR (SendRead (1, TRUE));
+  UT_ASSERT_STATUS_EQUAL (SendRead (2, FALSE), EFI_NOT_READY);
+
+  //
+  // Keep the request in flight from timing out.
+  //
+  GetRequest (0)->TimeoutRemain = MAX_UINT64;
+
+  for (Tick = 0; Tick < 10; Tick++) {
+    ProcessAsyncTaskList (NULL, mPrivate);
+  }
+
+  UT_ASSERT_FALSE (mSignaled[0]);
+  UT_ASSERT_TRUE (mSignaled[1]);
+  UT_ASSERT_EQUAL (mPackets[1].HostAdapterStatus, EFI_EXT_SCSI_STATUS_HOST_ADAPTER_TIMEOUT_COMMAND);
+  UT_ASSERT_EQUAL (GetRequestSlot (0), 0);
+  UT_ASSERT_EQUAL (mUtrlDbr, BIT0);
+  UT_ASSERT_EQUAL (mPrivate->TrlSlotsInUse, BIT0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  transfer request list handling and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      TrlTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the transfer request list Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&TrlTests, Framework, "UFS Transfer Request List Tests", "UfsPassThruDxe.Trl", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for UFS Transfer Request List Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite--------Description------------Name--------------Function----------------Pre---Post---Context-----------
+  //
+  AddTestCase (TrlTests, "Async requests use all slots", "AllSlots", AsyncRequestsUseAllSlots, SetupController, CleanupController, (UNIT_TEST_CONTEXT)32);
+  AddTestCase (TrlTests, "Out of order completion", "OutOfOrder", OutOfOrderCompletion, SetupController, CleanupController, (UNIT_TEST_CONTEXT)4);
+  AddTestCase (TrlTests, "Requests wait for a free slot", "WaitSlot", RequestsWaitForFreeSlot, SetupController, CleanupController, (UNIT_TEST_CONTEXT)2);
+  AddTestCase (TrlTests, "Waiting request times out", "WaitTimeout", WaitingRequestTimesOut, SetupController, CleanupController, (UNIT_TEST_CONTEXT)1);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define UfsPassThruUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+UfsPassThruUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = UnitTestingEntry ();
+  return EFI_ERROR (Status) ? 1 : 0;
+}
@@ -313,6 +313,109 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Execute several bulk transfers to the device endpoints, queued together on
+  the host controller.
+
+  @param  This                   The USB IO bulk queue instance.
+  @param  RequestCount           The number of transfers in Requests.
+  @param  Requests               The transfers.
+  @param  Timeout                Time to wait before timeout.
+
+  @retval EFI_SUCCESS            The bulk transfers are OK.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval EFI_UNSUPPORTED        The host controller doesn't queue the transfers.
+  @retval Others                 Failed to execute the transfers, reason returned
+                                 in their TransferResult.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoBulkQueueTransfer (
+  IN     EDKII_USB_IO_BULK_QUEUE_PROTOCOL  *This,
+  IN     UINTN                             RequestCount,
+  IN OUT EDKII_USB_BULK_REQUEST            *Requests,
+  IN     UINTN                             Timeout
+  )
+{
+  USB_DEVICE         *Dev;
+  USB_INTERFACE      *UsbIf;
+  USB_ENDPOINT_DESC  *EpDesc;
+  EFI_TPL            OldTpl;
+  EFI_STATUS         Status;
+  UINTN              Index;
+
+  if ((Requests == NULL) || (RequestCount == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < RequestCount; Index++) {
+    if ((USB_ENDPOINT_ADDR (Requests[Index].EndpointAddress) == 0) ||
+        (USB_ENDPOINT_ADDR (Requests[Index].EndpointAddress) > 15))
+    {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf = USB_INTERFACE_FROM_BULK_QUEUE (This);
+  Dev   = UsbIf->Device;
+
+  if (Dev->Bus->BulkQueue == NULL) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_EXIT;
+  }
+
+  for (Index = 0; Index < RequestCount; Index++) {
+    EpDesc = UsbGetEndpointDesc (UsbIf, Requests[Index].EndpointAddress);
+
+    if ((EpDesc == NULL) || (USB_ENDPOINT_TYPE (&EpDesc->Desc) != USB_ENDPOINT_BULK)) {
+      Status = EFI_INVALID_PARAMETER;
+      goto ON_EXIT;
+    }
+
+    Requests[Index].MaximumPacketLength = EpDesc->Desc.MaxPacketSize;
+    Requests[Index].DataToggle          = EpDesc->Toggle;
+  }
+
+  Status = Dev->Bus->BulkQueue->BulkQueueTransfer (
+                                  Dev->Bus->BulkQueue,
+                                  Dev->Address,
+                                  Dev->Speed,
+                                  RequestCount,
+                                  Requests,
+                                  Timeout,
+                                  &Dev->Translator
+                                  );
+
+  for (Index = 0; Index < RequestCount; Index++) {
+    EpDesc         = UsbGetEndpointDesc (UsbIf, Requests[Index].EndpointAddress);
+    EpDesc->Toggle = Requests[Index].DataToggle;
+  }
+
+  if (EFI_ERROR (Status) && (Status != EFI_UNSUPPORTED)) {
+    //
+    // Clear TT buffer when CTRL/BULK split transaction failes.
+    // Clear the TRANSLATOR TT buffer, not parent's buffer
+    //
+    ASSERT (Dev->Translator.TranslatorHubAddress < Dev->Bus->MaxDevices);
+    if (Dev->Translator.TranslatorHubAddress != 0) {
+      UsbHubCtrlClearTTBuffer (
+        Dev->Bus->Devices[Dev->Translator.TranslatorHubAddress],
+        Dev->Translator.TranslatorPortNumber,
+        Dev->Address,
+        0,
+        USB_ENDPOINT_BULK
+        );
+    }
+  }
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
 /**
   Execute a synchronous interrupt transfer.
 
@@ -993,6 +1096,21 @@ UsbBusBuildProtocol (
     if (UsbBus->Usb2Hc->MajorRevision == 0x3) {
       UsbBus->MaxDevices = 256;
     }
+
+    //
+    // The host controller may also queue several bulk transfers together.
+    //
+    Status = gBS->OpenProtocol (
+                    Controller,
+                    &gEdkiiUsb2HcBulkQueueProtocolGuid,
+                    (VOID **)&(UsbBus->BulkQueue),
+                    This->DriverBindingHandle,
+                    Controller,
+                    EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                    );
+    if (EFI_ERROR (Status)) {
+      UsbBus->BulkQueue = NULL;
+    }
   }
 
   //
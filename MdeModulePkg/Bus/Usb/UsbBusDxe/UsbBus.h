@@ -15,6 +15,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/Usb2HostController.h>
 #include <Protocol/UsbHostController.h>
 #include <Protocol/UsbIo.h>
+#include <Protocol/UsbBulkQueue.h>
 #include <Protocol/DevicePath.h>
 
 #include <Library/BaseLib.h>
@@ -26,6 +27,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DevicePathLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/TimerLib.h>
 
 #include <IndustryStandard/Usb.h>
 
@@ -141,6 +143,9 @@ typedef struct _USB_HUB_API    USB_HUB_API;
 #define USB_INTERFACE_FROM_USBIO(a) \
           CR(a, USB_INTERFACE, UsbIo, USB_INTERFACE_SIGNATURE)
 
+#define USB_INTERFACE_FROM_BULK_QUEUE(a) \
+          CR(a, USB_INTERFACE, BulkQueue, USB_INTERFACE_SIGNATURE)
+
 #define USB_BUS_FROM_THIS(a) \
           CR(a, USB_BUS, BusId, USB_BUS_SIGNATURE)
 
@@ -195,67 +200,80 @@ struct _USB_DEVICE {
 // Stands for different functions of USB device
 //
 struct _USB_INTERFACE {
-  UINTN                       Signature;
-  USB_DEVICE                  *Device;
-  USB_INTERFACE_DESC          *IfDesc;
-  USB_INTERFACE_SETTING       *IfSetting;
+  UINTN                               Signature;
+  USB_DEVICE                          *Device;
+  USB_INTERFACE_DESC                  *IfDesc;
+  USB_INTERFACE_SETTING               *IfSetting;
 
   //
   // Handles and protocols
   //
-  EFI_HANDLE                  Handle;
-  EFI_USB_IO_PROTOCOL         UsbIo;
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
-  BOOLEAN                     IsManaged;
+  EFI_HANDLE                          Handle;
+  EFI_USB_IO_PROTOCOL                 UsbIo;
+  EDKII_USB_IO_BULK_QUEUE_PROTOCOL    BulkQueue;
+  EFI_DEVICE_PATH_PROTOCOL            *DevicePath;
+  BOOLEAN                             IsManaged;
 
   //
   // Hub device special data
   //
-  BOOLEAN                     IsHub;
-  USB_HUB_API                 *HubApi;
-  UINT8                       NumOfPort;
-  EFI_EVENT                   HubNotify;
+  BOOLEAN                             IsHub;
+  USB_HUB_API                         *HubApi;
+  UINT8                               NumOfPort;
+  EFI_EVENT                           HubNotify;
+  USB_HUB_PORT                        *Ports;
+  BOOLEAN                             PortsBusy;
 
   //
   // Data used only by normal hub devices
   //
-  USB_ENDPOINT_DESC           *HubEp;
-  UINT8                       *ChangeMap;
+  USB_ENDPOINT_DESC                   *HubEp;
+  UINT8                               *ChangeMap;
 
   //
   // Data used only by root hub to hand over device to
   // companion UHCI driver if low/full speed devices are
   // connected to EHCI.
   //
-  UINT8                       MaxSpeed;
+  UINT8                               MaxSpeed;
 };
 
 //
 // Stands for the current USB Bus
 //
 struct _USB_BUS {
-  UINTN                       Signature;
-  EFI_USB_BUS_PROTOCOL        BusId;
+  UINTN                                Signature;
+  EFI_USB_BUS_PROTOCOL                 BusId;
 
   //
   // Managed USB host controller
   //
-  EFI_HANDLE                  HostHandle;
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
-  EFI_USB2_HC_PROTOCOL        *Usb2Hc;
-  EFI_USB_HC_PROTOCOL         *UsbHc;
+  EFI_HANDLE                           HostHandle;
+  EFI_DEVICE_PATH_PROTOCOL             *DevicePath;
+  EFI_USB2_HC_PROTOCOL                 *Usb2Hc;
+  EFI_USB_HC_PROTOCOL                  *UsbHc;
+  //
+  // Optional, NULL if the host controller doesn't queue bulk transfers.
+  //
+  EDKII_USB2_HC_BULK_QUEUE_PROTOCOL    *BulkQueue;
 
   //
   // Recorded the max supported usb devices.
   // XHCI can support up to 255 devices.
   // EHCI/UHCI/OHCI supports up to 127 devices.
   //
-  UINT32                      MaxDevices;
+  UINT32                               MaxDevices;
   //
   // An array of device that is on the bus. Devices[0] is
   // for root hub. Device with address i is at Devices[i].
   //
-  USB_DEVICE                  *Devices[256];
+  USB_DEVICE                           *Devices[256];
+
+  //
+  // The number of hub ports from the start of their reset to the addressing
+  // of their device. A device answers at the default address in between.
+  //
+  UINT32                               ResettingPorts;
 
   //
   // USB Bus driver need to control the recursive connect policy of the bus, only those wanted
@@ -278,6 +296,7 @@ struct _USB_HUB_API {
   USB_HUB_SET_PORT_FEATURE      SetPortFeature;
   USB_HUB_CLEAR_PORT_FEATURE    ClearPortFeature;
   USB_HUB_RESET_PORT            ResetPort;
+  USB_HUB_RESET_PORT_STEP       ResetPortStep;
   USB_HUB_RELEASE               Release;
 };
 
@@ -419,6 +438,31 @@ UsbIoBulkTransfer (
   OUT UINT32               *UsbStatus
   );
 
+/**
+  Execute several bulk transfers to the device endpoints, queued together on
+  the host controller.
+
+  @param  This                   The USB IO bulk queue instance.
+  @param  RequestCount           The number of transfers in Requests.
+  @param  Requests               The transfers.
+  @param  Timeout                Time to wait before timeout.
+
+  @retval EFI_SUCCESS            The bulk transfers are OK.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval EFI_UNSUPPORTED        The host controller doesn't queue the transfers.
+  @retval Others                 Failed to execute the transfers, reason returned
+                                 in their TransferResult.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoBulkQueueTransfer (
+  IN     EDKII_USB_IO_BULK_QUEUE_PROTOCOL  *This,
+  IN     UINTN                             RequestCount,
+  IN OUT EDKII_USB_BULK_REQUEST            *Requests,
+  IN     UINTN                             Timeout
+  );
+
 /**
   Execute a synchronous interrupt transfer.
 
@@ -64,6 +64,8 @@ UsbFreeInterface (
                   UsbIf->DevicePath,
                   &gEfiUsbIoProtocolGuid,
                   &UsbIf->UsbIo,
+                  &gEdkiiUsbIoBulkQueueProtocolGuid,
+                  &UsbIf->BulkQueue,
                   NULL
                   );
   if (!EFI_ERROR (Status)) {
@@ -117,6 +119,7 @@ UsbCreateInterface (
     &mUsbIoProtocol,
     sizeof (EFI_USB_IO_PROTOCOL)
     );
+  UsbIf->BulkQueue.BulkQueueTransfer = UsbIoBulkQueueTransfer;
 
   //
   // Install protocols for USBIO and device path
@@ -146,6 +149,8 @@ UsbCreateInterface (
                   UsbIf->DevicePath,
                   &gEfiUsbIoProtocolGuid,
                   &UsbIf->UsbIo,
+                  &gEdkiiUsbIoBulkQueueProtocolGuid,
+                  &UsbIf->BulkQueue,
                   NULL
                   );
 
@@ -166,6 +171,8 @@ UsbCreateInterface (
            UsbIf->DevicePath,
            &gEfiUsbIoProtocolGuid,
            &UsbIf->UsbIo,
+           &gEdkiiUsbIoBulkQueueProtocolGuid,
+           &UsbIf->BulkQueue,
            NULL
            );
 
@@ -649,6 +656,9 @@ UsbFindChild (
 /**
   Enumerate and configure the new device on the port of this HUB interface.
 
+  The caller must have waited USB_WAIT_PORT_STABLE_STALL for the connection
+  of the device to settle.
+
   @param  HubIf                 The HUB that has the device connected.
   @param  Port                  The port index of the hub (started with zero).
   @param  ResetIsNeeded         The boolean to control whether skip the reset of the port.
@@ -679,8 +689,6 @@ UsbEnumerateNewDev (
   HubApi  = HubIf->HubApi;
   Address = Bus->MaxDevices;
 
-  gBS->Stall (USB_WAIT_PORT_STABLE_STALL);
-
   //
   // Hub resets the device for at least 10 milliseconds.
   // Host learns device speed. If device is of low/full speed
@@ -878,18 +886,24 @@ ON_ERROR:
 /**
   Process the events on the port.
 
+  The device previously attached to the port is removed. A newly connected
+  device is not enumerated here: it is reported through Action, and the port
+  change is acknowledged by the caller.
+
   @param  HubIf                 The HUB that has the device connected.
   @param  Port                  The port index of the hub (started with zero).
+  @param  Action                Returns how the new device connected to the
+                                port must be enumerated.
 
-  @retval EFI_SUCCESS           The device is enumerated (added or removed).
-  @retval EFI_OUT_OF_RESOURCES  Failed to allocate resource for the device.
-  @retval Others                Failed to enumerate the device.
+  @retval EFI_SUCCESS           The port events are processed.
+  @retval Others                Failed to process the port events.
 
 **/
 EFI_STATUS
 UsbEnumeratePort (
-  IN USB_INTERFACE  *HubIf,
-  IN UINT8          Port
+  IN  USB_INTERFACE  *HubIf,
+  IN  UINT8          Port,
+  OUT UINT8          *Action
   )
 {
   USB_HUB_API          *HubApi;
@@ -897,8 +911,9 @@ UsbEnumeratePort (
   EFI_USB_PORT_STATUS  PortState;
   EFI_STATUS           Status;
 
-  Child  = NULL;
-  HubApi = HubIf->HubApi;
+  Child   = NULL;
+  HubApi  = HubIf->HubApi;
+  *Action = USB_PORT_ACTION_NONE;
 
   //
   // Host learns of the new device by polling the hub for port changes.
@@ -984,22 +999,333 @@ UsbEnumeratePort (
 
   if (USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_CONNECTION)) {
     //
-    // Now, new device connected, enumerate and configure the device
+    // Now, new device connected. Let the caller enumerate and configure
+    // the device once its connection is stable.
     //
     DEBUG ((DEBUG_INFO, "UsbEnumeratePort: new device connected at port %d\n", Port));
     if (USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_RESET)) {
-      Status = UsbEnumerateNewDev (HubIf, Port, FALSE);
+      *Action = USB_PORT_ACTION_ENUMERATE;
     } else {
-      Status = UsbEnumerateNewDev (HubIf, Port, TRUE);
+      *Action = USB_PORT_ACTION_RESET_ENUMERATE;
     }
-  } else {
-    DEBUG ((DEBUG_INFO, "UsbEnumeratePort: device disconnected event on port %d\n", Port));
+
+    return EFI_SUCCESS;
   }
 
+  DEBUG ((DEBUG_INFO, "UsbEnumeratePort: device disconnected event on port %d\n", Port));
+
   HubApi->ClearPortChange (HubIf, Port);
   return Status;
 }
 
+/**
+  Return the time elapsed since a performance counter value.
+
+  @param  StartTick             The performance counter value.
+
+  @return The time elapsed, in microseconds.
+
+**/
+UINT64
+UsbGetElapsedTime (
+  IN UINT64  StartTick
+  )
+{
+  UINT64  StartValue;
+  UINT64  EndValue;
+  UINT64  Tick;
+
+  Tick = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+
+  return DivU64x32 (GetTimeInNanoSecond ((StartValue > EndValue) ? (StartTick - Tick) : (Tick - StartTick)), 1000);
+}
+
+/**
+  Move the hub port to a new state.
+
+  @param  HubPort               The hub port.
+  @param  State                 The new state.
+  @param  Wait                  The time to wait before the state is advanced,
+                                in microseconds.
+
+**/
+VOID
+UsbSetPortState (
+  IN USB_HUB_PORT  *HubPort,
+  IN UINT8         State,
+  IN UINT64        Wait
+  )
+{
+  HubPort->State     = State;
+  HubPort->StateTick = GetPerformanceCounter ();
+  HubPort->Wait      = Wait;
+}
+
+/**
+  Whether the resets of several ports of the bus may overlap.
+
+  After reset a device answers at the default address 0 until it is
+  addressed, so EHCI/UHCI and their hubs reset one port at a time. The XHCI
+  controller addresses each device itself when its port reset completes.
+
+  @param  Bus                   The USB bus.
+
+  @retval TRUE                  Several ports may be reset at the same time.
+  @retval FALSE                 One port is reset at a time.
+
+**/
+BOOLEAN
+UsbBusOverlapsPortReset (
+  IN USB_BUS  *Bus
+  )
+{
+  return (BOOLEAN)((Bus->Usb2Hc != NULL) && (Bus->Usb2Hc->MajorRevision == 0x3));
+}
+
+/**
+  Finish the enumeration of the device connected to the hub port.
+
+  @param  HubIf                 The hub interface.
+  @param  Port                  The port index of the hub (started with zero).
+
+**/
+VOID
+UsbFinishPort (
+  IN USB_INTERFACE  *HubIf,
+  IN UINT8          Port
+  )
+{
+  USB_HUB_PORT  *HubPort;
+  USB_BUS       *Bus;
+
+  HubPort = &HubIf->Ports[Port];
+  Bus     = HubIf->Device->Bus;
+
+  if (HubPort->State >= USB_PORT_STATE_RESET) {
+    ASSERT (Bus->ResettingPorts > 0);
+    Bus->ResettingPorts--;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "UsbFinishPort: port %d of hub %p done in %ld ms\n",
+    Port,
+    HubIf,
+    DivU64x32 (UsbGetElapsedTime (HubPort->ConnectTick), 1000)
+    ));
+
+  HubIf->HubApi->ClearPortChange (HubIf, Port);
+  UsbSetPortState (HubPort, USB_PORT_STATE_IDLE, 0);
+}
+
+/**
+  Advance the enumeration of the device connected to the hub port, as far
+  as possible without waiting.
+
+  @param  HubIf                 The hub interface.
+  @param  Port                  The port index of the hub (started with zero).
+
+**/
+VOID
+UsbAdvancePort (
+  IN USB_INTERFACE  *HubIf,
+  IN UINT8          Port
+  )
+{
+  USB_HUB_PORT         *HubPort;
+  USB_BUS              *Bus;
+  EFI_USB_PORT_STATUS  PortState;
+  UINTN                Stall;
+  EFI_STATUS           Status;
+
+  HubPort = &HubIf->Ports[Port];
+  Bus     = HubIf->Device->Bus;
+
+  while ((HubPort->State != USB_PORT_STATE_IDLE) &&
+         (UsbGetElapsedTime (HubPort->StateTick) >= HubPort->Wait))
+  {
+    switch (HubPort->State) {
+      case USB_PORT_STATE_SETTLE:
+        Status = HubIf->HubApi->GetPortStatus (HubIf, Port, &PortState);
+
+        if (EFI_ERROR (Status) || !USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_CONNECTION)) {
+          DEBUG ((DEBUG_INFO, "UsbAdvancePort: device at port %d is gone\n", Port));
+          UsbFinishPort (HubIf, Port);
+          break;
+        }
+
+        //
+        // Wait for the other device at the default address to be addressed.
+        //
+        if (!UsbBusOverlapsPortReset (Bus) && (Bus->ResettingPorts != 0)) {
+          return;
+        }
+
+        Bus->ResettingPorts++;
+
+        if (HubPort->ResetIsNeeded) {
+          HubPort->ResetStep = 0;
+          UsbSetPortState (HubPort, USB_PORT_STATE_RESET, 0);
+        } else {
+          DEBUG ((DEBUG_INFO, "UsbAdvancePort: hub port %d reset is skipped\n", Port));
+          UsbSetPortState (HubPort, USB_PORT_STATE_ENUMERATE, 0);
+        }
+
+        break;
+
+      case USB_PORT_STATE_RESET:
+        //
+        // Hub resets the device for at least 10 milliseconds.
+        // Host learns device speed. If device is of low/full speed
+        // and the hub is a EHCI root hub, ResetPortStep will release
+        // the device to its companion UHCI and return an error.
+        //
+        Status = HubIf->HubApi->ResetPortStep (HubIf, Port, &HubPort->ResetStep, &Stall);
+
+        if (Status == EFI_NOT_READY) {
+          if (UsbGetElapsedTime (HubPort->StateTick) < USB_PORT_RESET_TIMEOUT) {
+            HubPort->Wait = UsbGetElapsedTime (HubPort->StateTick) + Stall;
+            break;
+          }
+
+          Status = EFI_TIMEOUT;
+        }
+
+        if (EFI_ERROR (Status)) {
+          DEBUG ((DEBUG_ERROR, "UsbAdvancePort: failed to reset port %d - %r\n", Port, Status));
+          UsbFinishPort (HubIf, Port);
+          break;
+        }
+
+        DEBUG ((DEBUG_INFO, "UsbAdvancePort: hub port %d is reset\n", Port));
+        UsbSetPortState (HubPort, USB_PORT_STATE_ENUMERATE, 0);
+        break;
+
+      case USB_PORT_STATE_ENUMERATE:
+        Status = UsbEnumerateNewDev (HubIf, Port, FALSE);
+
+        if (EFI_ERROR (Status)) {
+          DEBUG ((DEBUG_ERROR, "UsbAdvancePort: failed to enumerate device at port %d - %r\n", Port, Status));
+        }
+
+        UsbFinishPort (HubIf, Port);
+        break;
+
+      default:
+        ASSERT (FALSE);
+        UsbFinishPort (HubIf, Port);
+        break;
+    }
+  }
+}
+
+/**
+  Advance the enumeration of the devices connected to the hub ports.
+
+  The hub's notify event is signaled by its timer at a short interval while
+  a port isn't idle, so that the waits of the ports overlap instead of
+  stalling the callback.
+
+  @param  HubIf                 The hub interface.
+
+**/
+VOID
+UsbAdvancePorts (
+  IN USB_INTERFACE  *HubIf
+  )
+{
+  UINT8    Index;
+  BOOLEAN  Busy;
+
+  Busy = FALSE;
+
+  for (Index = 0; Index < HubIf->NumOfPort; Index++) {
+    UsbAdvancePort (HubIf, Index);
+
+    if (HubIf->Ports[Index].State != USB_PORT_STATE_IDLE) {
+      Busy = TRUE;
+    }
+  }
+
+  if (Busy == HubIf->PortsBusy) {
+    return;
+  }
+
+  HubIf->PortsBusy = Busy;
+
+  if (Busy) {
+    gBS->SetTimer (HubIf->HubNotify, TimerPeriodic, USB_PORT_STATE_POLL_INTERVAL);
+  } else if (HubIf->HubApi == &mUsbRootHubApi) {
+    gBS->SetTimer (HubIf->HubNotify, TimerPeriodic, USB_ROOTHUB_POLL_INTERVAL);
+  } else {
+    gBS->SetTimer (HubIf->HubNotify, TimerCancel, 0);
+  }
+}
+
+/**
+  Enumerate the changed ports of a hub.
+
+  A newly connected device is given USB_WAIT_PORT_STABLE_STALL for its
+  connection to settle, then its port is reset, and the device is addressed
+  and configured. Each port moves through these steps on its own, so the
+  waits of several ports overlap. The ports being enumerated are not checked
+  for changes, except while their connection settles.
+
+  @param  HubIf                 The hub interface.
+  @param  ChangeMap             The hub change bitmap, bit N + 1 for port N.
+                                All the ports are checked if it is NULL.
+
+**/
+VOID
+UsbEnumeratePorts (
+  IN USB_INTERFACE  *HubIf,
+  IN UINT8          *ChangeMap OPTIONAL
+  )
+{
+  USB_HUB_PORT  *HubPort;
+  UINT8         Action;
+  UINT8         Byte;
+  UINT8         Bit;
+  UINT8         Index;
+  EFI_STATUS    Status;
+
+  //
+  // HUB starts its port index with 1.
+  //
+  Byte = 0;
+  Bit  = 1;
+
+  for (Index = 0; Index < HubIf->NumOfPort; Index++) {
+    HubPort = &HubIf->Ports[Index];
+
+    if ((HubPort->State <= USB_PORT_STATE_SETTLE) &&
+        ((ChangeMap == NULL) || USB_BIT_IS_SET (ChangeMap[Byte], USB_BIT (Bit))))
+    {
+      Status = UsbEnumeratePort (HubIf, Index, &Action);
+
+      if (!EFI_ERROR (Status) && (Action != USB_PORT_ACTION_NONE)) {
+        //
+        // Acknowledge the change now, so that a new connection while the
+        // device settles restarts the settle time.
+        //
+        HubIf->HubApi->ClearPortChange (HubIf, Index);
+
+        if (HubPort->State == USB_PORT_STATE_IDLE) {
+          HubPort->ConnectTick = GetPerformanceCounter ();
+        }
+
+        HubPort->ResetIsNeeded = (BOOLEAN)(Action == USB_PORT_ACTION_RESET_ENUMERATE);
+        UsbSetPortState (HubPort, USB_PORT_STATE_SETTLE, USB_WAIT_PORT_STABLE_STALL);
+      }
+    }
+
+    USB_NEXT_BIT (Byte, Bit);
+  }
+
+  UsbAdvancePorts (HubIf);
+}
+
 /**
   Enumerate all the changed hub ports.
 
@@ -1015,8 +1341,6 @@ UsbHubEnumeration (
   )
 {
   USB_INTERFACE  *HubIf;
-  UINT8          Byte;
-  UINT8          Bit;
   UINT8          Index;
   USB_DEVICE     *Child;
 
@@ -1033,22 +1357,14 @@ UsbHubEnumeration (
   }
 
   if (HubIf->ChangeMap == NULL) {
+    //
+    // Signaled by the timer, advance the ports being enumerated.
+    //
+    UsbAdvancePorts (HubIf);
     return;
   }
 
-  //
-  // HUB starts its port index with 1.
-  //
-  Byte = 0;
-  Bit  = 1;
-
-  for (Index = 0; Index < HubIf->NumOfPort; Index++) {
-    if (USB_BIT_IS_SET (HubIf->ChangeMap[Byte], USB_BIT (Bit))) {
-      UsbEnumeratePort (HubIf, Index);
-    }
-
-    USB_NEXT_BIT (Byte, Bit);
-  }
+  UsbEnumeratePorts (HubIf, HubIf->ChangeMap);
 
   UsbHubAckHubStatus (HubIf->Device);
 
@@ -1083,7 +1399,35 @@ UsbRootHubEnumeration (
       DEBUG ((DEBUG_INFO, "UsbEnumeratePort: The device disconnect fails at port %d from root hub %p, try again\n", Index, RootHub));
       UsbRemoveDevice (Child);
     }
+  }
+
+  UsbEnumeratePorts (RootHub, NULL);
+}
+
+/**
+  Enumerate the devices connected to the root hub before returning.
 
-    UsbEnumeratePort (RootHub, Index);
+  The devices present when the bus is started must be enumerated before
+  the bus driver returns, or they would be missed by a boot that follows.
+
+  @param  RootHub               The root hub interface.
+
+**/
+VOID
+UsbRootHubEnumerateNow (
+  IN USB_INTERFACE  *RootHub
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  UsbEnumeratePorts (RootHub, NULL);
+
+  while (RootHub->PortsBusy) {
+    gBS->Stall (USB_PORT_STATE_POLL_INTERVAL / 10);
+    UsbAdvancePorts (RootHub);
   }
+
+  gBS->RestoreTPL (OldTpl);
 }
@@ -22,6 +22,50 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
             }                 \
           } while (0)
 
+//
+// How the device newly connected to a hub port is enumerated.
+//
+#define USB_PORT_ACTION_NONE             0
+#define USB_PORT_ACTION_ENUMERATE        1
+#define USB_PORT_ACTION_RESET_ENUMERATE  2
+
+//
+// A hub reports its port number in one byte.
+//
+#define USB_MAX_HUB_PORT  256
+
+//
+// The states of a hub port while the device newly connected to it is
+// enumerated. UsbEnumeratePorts() advances them from the hub's notify event.
+//
+#define USB_PORT_STATE_IDLE       0   ///< No device to enumerate
+#define USB_PORT_STATE_SETTLE     1   ///< Waiting for the connection to settle
+#define USB_PORT_STATE_RESET      2   ///< The port is being reset
+#define USB_PORT_STATE_ENUMERATE  3   ///< The device is ready to be addressed
+
+//
+// The hub's notify event is signaled at this interval while a port isn't
+// idle. The unit is 100ns, means 10ms.
+//
+#define USB_PORT_STATE_POLL_INTERVAL  (10 * 10000U)
+
+//
+// Give up a port reset that isn't finished in time, set by experience.
+//
+#define USB_PORT_RESET_TIMEOUT  (1000 * USB_BUS_1_MILLISECOND)
+
+//
+// The enumeration state of a hub port.
+//
+typedef struct {
+  UINT8      State;
+  BOOLEAN    ResetIsNeeded;
+  UINT8      ResetStep;   ///< The next step of USB_HUB_API.ResetPortStep
+  UINT64     ConnectTick; ///< Performance counter when the device connected
+  UINT64     StateTick;   ///< Performance counter when State was entered
+  UINT64     Wait;        ///< Time to wait from StateTick, in microseconds
+} USB_HUB_PORT;
+
 //
 // Common interface used by usb bus enumeration process.
 // This interface is defined to mask the difference between
@@ -78,6 +122,21 @@ EFI_STATUS
   IN UINT8          Port
   );
 
+//
+// Advance the reset of the port by one step, without waiting. Step is zero
+// to start the reset, and is updated for the next call. EFI_NOT_READY is
+// returned until the reset is done, with the time to wait before the next
+// call in Stall.
+//
+typedef
+EFI_STATUS
+(*USB_HUB_RESET_PORT_STEP) (
+  IN     USB_INTERFACE  *UsbIf,
+  IN     UINT8          Port,
+  IN OUT UINT8          *Step,
+  OUT    UINTN          *Stall
+  );
+
 typedef
 EFI_STATUS
 (*USB_HUB_RELEASE) (
@@ -194,4 +253,15 @@ UsbRootHubEnumeration (
   IN VOID       *Context
   );
 
+/**
+  Enumerate the devices connected to the root hub before returning.
+
+  @param  RootHub               The root hub interface.
+
+**/
+VOID
+UsbRootHubEnumerateNow (
+  IN USB_INTERFACE  *RootHub
+  );
+
 #endif
@@ -550,6 +550,40 @@ UsbOnHubInterrupt (
   return EFI_SUCCESS;
 }
 
+/**
+  Free the enumeration state of the hub's ports.
+
+  The ports being reset no longer hold a device at the default address.
+
+  @param  HubIf                 The hub interface.
+
+**/
+VOID
+UsbHubFreePorts (
+  IN USB_INTERFACE  *HubIf
+  )
+{
+  USB_BUS  *Bus;
+  UINT8    Index;
+
+  if (HubIf->Ports == NULL) {
+    return;
+  }
+
+  Bus = HubIf->Device->Bus;
+
+  for (Index = 0; Index < HubIf->NumOfPort; Index++) {
+    if (HubIf->Ports[Index].State >= USB_PORT_STATE_RESET) {
+      ASSERT (Bus->ResettingPorts > 0);
+      Bus->ResettingPorts--;
+    }
+  }
+
+  FreePool (HubIf->Ports);
+  HubIf->Ports     = NULL;
+  HubIf->PortsBusy = FALSE;
+}
+
 /**
   Initialize the device for a non-root hub.
 
@@ -654,11 +688,19 @@ UsbHubInit (
     UsbHubAckHubStatus (HubIf->Device);
   }
 
+  HubIf->Ports = AllocateZeroPool (HubIf->NumOfPort * sizeof (USB_HUB_PORT));
+
+  if (HubIf->Ports == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
   //
-  // Create an event to enumerate the hub's port. On
+  // Create an event to enumerate the hub's port. It is signaled when
+  // the hub reports a port change, and by its timer while the devices
+  // newly connected to the ports are enumerated.
   //
   Status = gBS->CreateEvent (
-                  EVT_NOTIFY_SIGNAL,
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
                   TPL_CALLBACK,
                   UsbHubEnumeration,
                   HubIf,
@@ -673,6 +715,7 @@ UsbHubInit (
       Status
       ));
 
+    UsbHubFreePorts (HubIf);
     return Status;
   }
 
@@ -704,6 +747,7 @@ UsbHubInit (
 
     gBS->CloseEvent (HubIf->HubNotify);
     HubIf->HubNotify = NULL;
+    UsbHubFreePorts (HubIf);
 
     return Status;
   }
@@ -830,58 +874,105 @@ UsbHubClearPortFeature (
 }
 
 /**
-  Interface function to reset the port.
+  Interface function to advance the reset of the port by one step.
 
   @param  HubIf                 The hub interface.
   @param  Port                  The port to reset.
+  @param  Step                  The step to run, zero to start the reset. It is
+                                updated for the next call.
+  @param  Stall                 Returns the time to wait before the next call,
+                                in microseconds.
 
   @retval EFI_SUCCESS           The hub port is reset.
-  @retval EFI_TIMEOUT           Failed to reset the port in time.
+  @retval EFI_NOT_READY         The reset is in progress.
   @retval Others                Failed to reset the port.
 
 **/
 EFI_STATUS
-UsbHubResetPort (
-  IN USB_INTERFACE  *HubIf,
-  IN UINT8          Port
+UsbHubResetPortStep (
+  IN     USB_INTERFACE  *HubIf,
+  IN     UINT8          Port,
+  IN OUT UINT8          *Step,
+  OUT    UINTN          *Stall
   )
 {
   EFI_USB_PORT_STATUS  PortState;
-  UINTN                Index;
   EFI_STATUS           Status;
 
-  Status = UsbHubSetPortFeature (HubIf, Port, (EFI_USB_PORT_FEATURE)USB_HUB_PORT_RESET);
+  switch (*Step) {
+    case 0:
+      Status = UsbHubSetPortFeature (HubIf, Port, (EFI_USB_PORT_FEATURE)USB_HUB_PORT_RESET);
 
-  if (EFI_ERROR (Status)) {
-    return Status;
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      //
+      // Drive the reset signal for worst 20ms. Check USB 2.0 Spec
+      // section 7.1.7.5 for timing requirements.
+      //
+      *Stall = USB_SET_PORT_RESET_STALL;
+      break;
+
+    case 1:
+      //
+      // Check USB_PORT_STAT_C_RESET bit to see if the resetting state is done.
+      //
+      ZeroMem (&PortState, sizeof (EFI_USB_PORT_STATUS));
+      Status = UsbHubGetPortStatus (HubIf, Port, &PortState);
+
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      if (!USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_RESET)) {
+        *Stall = USB_WAIT_PORT_STS_CHANGE_STALL;
+        return EFI_NOT_READY;
+      }
+
+      *Stall = USB_SET_PORT_RECOVERY_STALL;
+      break;
+
+    default:
+      return EFI_SUCCESS;
   }
 
-  //
-  // Drive the reset signal for worst 20ms. Check USB 2.0 Spec
-  // section 7.1.7.5 for timing requirements.
-  //
-  gBS->Stall (USB_SET_PORT_RESET_STALL);
+  (*Step)++;
+  return EFI_NOT_READY;
+}
 
-  //
-  // Check USB_PORT_STAT_C_RESET bit to see if the resetting state is done.
-  //
-  ZeroMem (&PortState, sizeof (EFI_USB_PORT_STATUS));
+/**
+  Interface function to reset the port.
+
+  @param  HubIf                 The hub interface.
+  @param  Port                  The port to reset.
+
+  @retval EFI_SUCCESS           The hub port is reset.
+  @retval EFI_TIMEOUT           Failed to reset the port in time.
+  @retval Others                Failed to reset the port.
+
+**/
+EFI_STATUS
+UsbHubResetPort (
+  IN USB_INTERFACE  *HubIf,
+  IN UINT8          Port
+  )
+{
+  UINTN       Index;
+  UINTN       Stall;
+  UINT8       Step;
+  EFI_STATUS  Status;
+
+  Step = 0;
 
   for (Index = 0; Index < USB_WAIT_PORT_STS_CHANGE_LOOP; Index++) {
-    Status = UsbHubGetPortStatus (HubIf, Port, &PortState);
+    Status = UsbHubResetPortStep (HubIf, Port, &Step, &Stall);
 
-    if (EFI_ERROR (Status)) {
+    if (Status != EFI_NOT_READY) {
       return Status;
     }
 
-    if (!EFI_ERROR (Status) &&
-        USB_BIT_IS_SET (PortState.PortChangeStatus, USB_PORT_STAT_C_RESET))
-    {
-      gBS->Stall (USB_SET_PORT_RECOVERY_STALL);
-      return EFI_SUCCESS;
-    }
-
-    gBS->Stall (USB_WAIT_PORT_STS_CHANGE_STALL);
+    gBS->Stall (Stall);
   }
 
   return EFI_TIMEOUT;
@@ -919,6 +1010,7 @@ UsbHubRelease (
   }
 
   gBS->CloseEvent (HubIf->HubNotify);
+  UsbHubFreePorts (HubIf);
 
   HubIf->IsHub     = FALSE;
   HubIf->HubApi    = NULL;
@@ -968,6 +1060,11 @@ UsbRootHubInit (
   HubIf->MaxSpeed  = MaxSpeed;
   HubIf->NumOfPort = NumOfPort;
   HubIf->HubNotify = NULL;
+  HubIf->Ports     = AllocateZeroPool (NumOfPort * sizeof (USB_HUB_PORT));
+
+  if (HubIf->Ports == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
 
   //
   // Create a timer to poll root hub ports periodically
@@ -981,15 +1078,10 @@ UsbRootHubInit (
                   );
 
   if (EFI_ERROR (Status)) {
+    UsbHubFreePorts (HubIf);
     return Status;
   }
 
-  //
-  // It should signal the event immediately here, or device detection
-  // by bus enumeration might be delayed by the timer interval.
-  //
-  gBS->SignalEvent (HubIf->HubNotify);
-
   Status = gBS->SetTimer (
                   HubIf->HubNotify,
                   TimerPeriodic,
@@ -998,9 +1090,17 @@ UsbRootHubInit (
 
   if (EFI_ERROR (Status)) {
     gBS->CloseEvent (HubIf->HubNotify);
+    UsbHubFreePorts (HubIf);
+    return Status;
   }
 
-  return Status;
+  //
+  // It should enumerate the connected devices immediately here, or device
+  // detection by bus enumeration might be delayed by the timer interval.
+  //
+  UsbRootHubEnumerateNow (HubIf);
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -1123,108 +1223,158 @@ UsbRootHubClearPortFeature (
 }
 
 /**
-  Interface function to reset the root hub port.
+  Interface function to advance the reset of the root hub port by one step.
 
   @param  RootIf                The root hub interface.
   @param  Port                  The port to reset.
+  @param  Step                  The step to run, zero to start the reset. It is
+                                updated for the next call.
+  @param  Stall                 Returns the time to wait before the next call,
+                                in microseconds.
 
   @retval EFI_SUCCESS           The hub port is reset.
-  @retval EFI_TIMEOUT           Failed to reset the port in time.
+  @retval EFI_NOT_READY         The reset is in progress.
   @retval EFI_NOT_FOUND         The low/full speed device connected to high  speed.
                                 root hub is released to the companion UHCI.
   @retval Others                Failed to reset the port.
 
 **/
 EFI_STATUS
-UsbRootHubResetPort (
-  IN USB_INTERFACE  *RootIf,
-  IN UINT8          Port
+UsbRootHubResetPortStep (
+  IN     USB_INTERFACE  *RootIf,
+  IN     UINT8          Port,
+  IN OUT UINT8          *Step,
+  OUT    UINTN          *Stall
   )
 {
   USB_BUS              *Bus;
   EFI_STATUS           Status;
   EFI_USB_PORT_STATUS  PortState;
-  UINTN                Index;
 
-  //
-  // Notice: although EHCI requires that ENABLED bit be cleared
-  // when reset the port, we don't need to care that here. It
-  // should be handled in the EHCI driver.
-  //
   Bus = RootIf->Device->Bus;
 
-  Status = UsbHcSetRootHubPortFeature (Bus, Port, EfiUsbPortReset);
-
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "UsbRootHubResetPort: failed to start reset on port %d\n", Port));
-    return Status;
-  }
-
-  //
-  // Drive the reset signal for at least 50ms. Check USB 2.0 Spec
-  // section 7.1.7.5 for timing requirements.
-  //
-  gBS->Stall (USB_SET_ROOT_PORT_RESET_STALL);
+  switch (*Step) {
+    case 0:
+      //
+      // Notice: although EHCI requires that ENABLED bit be cleared
+      // when reset the port, we don't need to care that here. It
+      // should be handled in the EHCI driver.
+      //
+      Status = UsbHcSetRootHubPortFeature (Bus, Port, EfiUsbPortReset);
 
-  Status = UsbHcClearRootHubPortFeature (Bus, Port, EfiUsbPortReset);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "UsbRootHubResetPortStep: failed to start reset on port %d\n", Port));
+        return Status;
+      }
 
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "UsbRootHubResetPort: failed to clear reset on port %d\n", Port));
-    return Status;
-  }
+      //
+      // Drive the reset signal for at least 50ms. Check USB 2.0 Spec
+      // section 7.1.7.5 for timing requirements.
+      //
+      *Stall = USB_SET_ROOT_PORT_RESET_STALL;
+      break;
 
-  gBS->Stall (USB_CLR_ROOT_PORT_RESET_STALL);
+    case 1:
+      Status = UsbHcClearRootHubPortFeature (Bus, Port, EfiUsbPortReset);
 
-  //
-  // USB host controller won't clear the RESET bit until
-  // reset is actually finished.
-  //
-  ZeroMem (&PortState, sizeof (EFI_USB_PORT_STATUS));
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "UsbRootHubResetPortStep: failed to clear reset on port %d\n", Port));
+        return Status;
+      }
 
-  for (Index = 0; Index < USB_WAIT_PORT_STS_CHANGE_LOOP; Index++) {
-    Status = UsbHcGetRootHubPortStatus (Bus, Port, &PortState);
+      *Stall = USB_CLR_ROOT_PORT_RESET_STALL;
+      break;
 
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
+    case 2:
+      //
+      // USB host controller won't clear the RESET bit until
+      // reset is actually finished.
+      //
+      ZeroMem (&PortState, sizeof (EFI_USB_PORT_STATUS));
+      Status = UsbHcGetRootHubPortStatus (Bus, Port, &PortState);
 
-    if (!USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_RESET)) {
-      break;
-    }
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
 
-    gBS->Stall (USB_WAIT_PORT_STS_CHANGE_STALL);
-  }
+      if (USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_RESET)) {
+        *Stall = USB_WAIT_PORT_STS_CHANGE_STALL;
+        return EFI_NOT_READY;
+      }
 
-  if (Index == USB_WAIT_PORT_STS_CHANGE_LOOP) {
-    DEBUG ((DEBUG_ERROR, "UsbRootHubResetPort: reset not finished in time on port %d\n", Port));
-    return EFI_TIMEOUT;
-  }
+      if (USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_ENABLE)) {
+        return EFI_SUCCESS;
+      }
 
-  if (!USB_BIT_IS_SET (PortState.PortStatus, USB_PORT_STAT_ENABLE)) {
-    //
-    // OK, the port is reset. If root hub is of high speed and
-    // the device is of low/full speed, release the ownership to
-    // companion UHCI. If root hub is of full speed, it won't
-    // automatically enable the port, we need to enable it manually.
-    //
-    if (RootIf->MaxSpeed == EFI_USB_SPEED_HIGH) {
-      DEBUG ((DEBUG_ERROR, "UsbRootHubResetPort: release low/full speed device (%d) to UHCI\n", Port));
+      //
+      // OK, the port is reset. If root hub is of high speed and
+      // the device is of low/full speed, release the ownership to
+      // companion UHCI. If root hub is of full speed, it won't
+      // automatically enable the port, we need to enable it manually.
+      //
+      if (RootIf->MaxSpeed == EFI_USB_SPEED_HIGH) {
+        DEBUG ((DEBUG_ERROR, "UsbRootHubResetPortStep: release low/full speed device (%d) to UHCI\n", Port));
+
+        UsbRootHubSetPortFeature (RootIf, Port, EfiUsbPortOwner);
+        return EFI_NOT_FOUND;
+      }
 
-      UsbRootHubSetPortFeature (RootIf, Port, EfiUsbPortOwner);
-      return EFI_NOT_FOUND;
-    } else {
       Status = UsbRootHubSetPortFeature (RootIf, Port, EfiUsbPortEnable);
 
       if (EFI_ERROR (Status)) {
-        DEBUG ((DEBUG_ERROR, "UsbRootHubResetPort: failed to enable port %d for UHCI\n", Port));
+        DEBUG ((DEBUG_ERROR, "UsbRootHubResetPortStep: failed to enable port %d for UHCI\n", Port));
         return Status;
       }
 
-      gBS->Stall (USB_SET_ROOT_PORT_ENABLE_STALL);
+      *Stall = USB_SET_ROOT_PORT_ENABLE_STALL;
+      break;
+
+    default:
+      return EFI_SUCCESS;
+  }
+
+  (*Step)++;
+  return EFI_NOT_READY;
+}
+
+/**
+  Interface function to reset the root hub port.
+
+  @param  RootIf                The root hub interface.
+  @param  Port                  The port to reset.
+
+  @retval EFI_SUCCESS           The hub port is reset.
+  @retval EFI_TIMEOUT           Failed to reset the port in time.
+  @retval EFI_NOT_FOUND         The low/full speed device connected to high  speed.
+                                root hub is released to the companion UHCI.
+  @retval Others                Failed to reset the port.
+
+**/
+EFI_STATUS
+UsbRootHubResetPort (
+  IN USB_INTERFACE  *RootIf,
+  IN UINT8          Port
+  )
+{
+  UINTN       Index;
+  UINTN       Stall;
+  UINT8       Step;
+  EFI_STATUS  Status;
+
+  Step = 0;
+
+  for (Index = 0; Index < USB_WAIT_PORT_STS_CHANGE_LOOP; Index++) {
+    Status = UsbRootHubResetPortStep (RootIf, Port, &Step, &Stall);
+
+    if (Status != EFI_NOT_READY) {
+      return Status;
     }
+
+    gBS->Stall (Stall);
   }
 
-  return EFI_SUCCESS;
+  DEBUG ((DEBUG_ERROR, "UsbRootHubResetPort: reset not finished in time on port %d\n", Port));
+  return EFI_TIMEOUT;
 }
 
 /**
@@ -1245,6 +1395,7 @@ UsbRootHubRelease (
 
   gBS->SetTimer (HubIf->HubNotify, TimerCancel, USB_ROOTHUB_POLL_INTERVAL);
   gBS->CloseEvent (HubIf->HubNotify);
+  UsbHubFreePorts (HubIf);
 
   return EFI_SUCCESS;
 }
@@ -1256,6 +1407,7 @@ USB_HUB_API  mUsbHubApi = {
   UsbHubSetPortFeature,
   UsbHubClearPortFeature,
   UsbHubResetPort,
+  UsbHubResetPortStep,
   UsbHubRelease
 };
 
@@ -1266,5 +1418,6 @@ USB_HUB_API  mUsbRootHubApi = {
   UsbRootHubSetPortFeature,
   UsbRootHubClearPortFeature,
   UsbRootHubResetPort,
+  UsbRootHubResetPortStep,
   UsbRootHubRelease
 };
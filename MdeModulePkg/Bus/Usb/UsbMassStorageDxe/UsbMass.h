@@ -14,6 +14,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <IndustryStandard/Scsi.h>
 #include <Protocol/BlockIo.h>
 #include <Protocol/UsbIo.h>
+#include <Protocol/UsbBulkQueue.h>
 #include <Protocol/DevicePath.h>
 #include <Protocol/DiskInfo.h>
 #include <Library/BaseLib.h>
@@ -181,6 +182,9 @@ struct _USB_MASS_DEVICE {
   EFI_DISK_INFO_PROTOCOL      DiskInfo;
   USB_BOOT_INQUIRY_DATA       InquiryData;
   BOOLEAN                     Cdb16Byte;
+  BOOLEAN                     BlockLimitsVpd;    ///< Block Limits VPD page is reported
+  UINT32                      MaxTransferBlocks; ///< Maximum transfer length of the page
+  UINT32                      OptTransferBlocks; ///< Optimal transfer length of the page
 };
 
 #endif
@@ -396,6 +396,168 @@ UsbBootInquiry (
   return Status;
 }
 
+/**
+  Execute INQUIRY Command to request a Vital Product Data page of the device.
+
+  @param  UsbMass                The device to inquire.
+  @param  PageCode               The VPD page to request.
+  @param  Data                   The buffer to hold the VPD page.
+  @param  DataLen                The length of the buffer.
+
+  @retval EFI_SUCCESS            The VPD page is returned in Data.
+  @retval Others                 INQUIRY Command is not executed successfully.
+
+**/
+EFI_STATUS
+UsbBootInquiryVpd (
+  IN  USB_MASS_DEVICE  *UsbMass,
+  IN  UINT8            PageCode,
+  OUT VOID             *Data,
+  IN  UINT8            DataLen
+  )
+{
+  USB_BOOT_INQUIRY_CMD  InquiryCmd;
+
+  ZeroMem (&InquiryCmd, sizeof (USB_BOOT_INQUIRY_CMD));
+  ZeroMem (Data, DataLen);
+
+  InquiryCmd.OpCode   = USB_BOOT_INQUIRY_OPCODE;
+  InquiryCmd.Lun      = (UINT8)(USB_BOOT_LUN (UsbMass->Lun) | USB_BOOT_INQUIRY_EVPD);
+  InquiryCmd.PageCode = PageCode;
+  InquiryCmd.AllocLen = DataLen;
+
+  //
+  // Devices that don't support the page fail the command with
+  // ILLEGAL REQUEST, so don't retry it.
+  //
+  return UsbBootExecCmd (
+           UsbMass,
+           &InquiryCmd,
+           (UINT8)sizeof (USB_BOOT_INQUIRY_CMD),
+           EfiUsbDataIn,
+           Data,
+           DataLen,
+           USB_BOOT_GENERAL_CMD_TIMEOUT
+           );
+}
+
+/**
+  Retrieve the transfer lengths of the Block Limits VPD page.
+
+  The page is only requested if the device claims SPC-3 or later and lists
+  it among its supported VPD pages. If it isn't available, the READ/WRITE
+  commands keep the default USB_BOOT_MAX_CARRY_SIZE.
+
+  @param  UsbMass                The device to inquire.
+
+**/
+VOID
+UsbBootGetBlockLimits (
+  IN USB_MASS_DEVICE  *UsbMass
+  )
+{
+  EFI_SCSI_SUPPORTED_VPD_PAGES_VPD_PAGE  SupportedVpdPages;
+  EFI_SCSI_BLOCK_LIMITS_VPD_PAGE         BlockLimits;
+  UINTN                                  PageLength;
+  UINTN                                  Index;
+  EFI_STATUS                             Status;
+
+  UsbMass->BlockLimitsVpd    = FALSE;
+  UsbMass->MaxTransferBlocks = 0;
+  UsbMass->OptTransferBlocks = 0;
+
+  if (UsbMass->InquiryData.Version < USB_BOOT_INQUIRY_VERSION_SPC3) {
+    return;
+  }
+
+  Status = UsbBootInquiryVpd (
+             UsbMass,
+             EFI_SCSI_PAGE_CODE_SUPPORTED_VPD,
+             &SupportedVpdPages,
+             MAX_UINT8
+             );
+  if (EFI_ERROR (Status) || (SupportedVpdPages.PageCode != EFI_SCSI_PAGE_CODE_SUPPORTED_VPD)) {
+    return;
+  }
+
+  PageLength = (SupportedVpdPages.PageLength2 << 8) | SupportedVpdPages.PageLength1;
+  PageLength = MIN (PageLength, MAX_UINT8 - OFFSET_OF (EFI_SCSI_SUPPORTED_VPD_PAGES_VPD_PAGE, SupportedVpdPageList));
+  for (Index = 0; Index < PageLength; Index++) {
+    if (SupportedVpdPages.SupportedVpdPageList[Index] == EFI_SCSI_PAGE_CODE_BLOCK_LIMITS_VPD) {
+      break;
+    }
+  }
+
+  if (Index == PageLength) {
+    return;
+  }
+
+  Status = UsbBootInquiryVpd (
+             UsbMass,
+             EFI_SCSI_PAGE_CODE_BLOCK_LIMITS_VPD,
+             &BlockLimits,
+             (UINT8)sizeof (EFI_SCSI_BLOCK_LIMITS_VPD_PAGE)
+             );
+  if (EFI_ERROR (Status) || (BlockLimits.PageCode != EFI_SCSI_PAGE_CODE_BLOCK_LIMITS_VPD)) {
+    return;
+  }
+
+  UsbMass->MaxTransferBlocks = (BlockLimits.MaximumTransferLength4 << 24) |
+                               (BlockLimits.MaximumTransferLength3 << 16) |
+                               (BlockLimits.MaximumTransferLength2 << 8)  |
+                               BlockLimits.MaximumTransferLength1;
+  UsbMass->OptTransferBlocks = (BlockLimits.OptimalTransferLength4 << 24) |
+                               (BlockLimits.OptimalTransferLength3 << 16) |
+                               (BlockLimits.OptimalTransferLength2 << 8)  |
+                               BlockLimits.OptimalTransferLength1;
+  UsbMass->BlockLimitsVpd = TRUE;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "UsbBootGetBlockLimits: MaxTransferLength (0x%x), OptimalTransferLength (0x%x)\n",
+    UsbMass->MaxTransferBlocks,
+    UsbMass->OptTransferBlocks
+    ));
+}
+
+/**
+  Get the number of blocks carried by one READ/WRITE command.
+
+  Without the Block Limits VPD page, a command carries USB_BOOT_MAX_CARRY_SIZE
+  bytes at most. Otherwise it carries up to USB_BOOT_MAX_VPD_CARRY_SIZE bytes,
+  within the maximum transfer length of the device. The optimal transfer length
+  only bounds transfers larger than USB_BOOT_MAX_CARRY_SIZE.
+
+  @param  UsbMass                The USB mass storage device to access.
+
+  @return The maximum number of blocks of one command.
+
+**/
+UINT32
+UsbBootGetCarryBlocks (
+  IN USB_MASS_DEVICE  *UsbMass
+  )
+{
+  UINT32  BlockSize;
+  UINT32  CountMax;
+
+  BlockSize = UsbMass->BlockIoMedia.BlockSize;
+  if (!UsbMass->BlockLimitsVpd) {
+    return USB_BOOT_MAX_CARRY_SIZE / BlockSize;
+  }
+
+  CountMax = USB_BOOT_MAX_VPD_CARRY_SIZE / BlockSize;
+  if (UsbMass->OptTransferBlocks != 0) {
+    CountMax = MIN (CountMax, MAX (UsbMass->OptTransferBlocks, USB_BOOT_MAX_CARRY_SIZE / BlockSize));
+  }
+
+  if (UsbMass->MaxTransferBlocks != 0) {
+    CountMax = MIN (CountMax, UsbMass->MaxTransferBlocks);
+  }
+
+  return CountMax;
+}
+
 /**
   Execute READ CAPACITY 16 bytes command to request information regarding
   the capacity of the installed medium of the device.
@@ -662,6 +824,12 @@ UsbBootGetParams (
     // Default value 2048 Bytes, in case no media present at first time
     //
     Media->BlockSize = 0x0800;
+  } else if (((EFI_USB_INTERFACE_DESCRIPTOR *)(UsbMass->Context))->InterfaceSubClass == USB_MASS_STORE_SCSI) {
+    //
+    // Larger READ/WRITE commands cut the per-command overhead of the
+    // Bulk-Only transport, size them from the Block Limits VPD page.
+    //
+    UsbBootGetBlockLimits (UsbMass);
   }
 
   Status = UsbBootDetectMedia (UsbMass);
@@ -824,7 +992,7 @@ UsbBootReadWriteBlocks (
   UINT32                      Timeout;
 
   BlockSize = UsbMass->BlockIoMedia.BlockSize;
-  CountMax  = USB_BOOT_MAX_CARRY_SIZE / BlockSize;
+  CountMax  = UsbBootGetCarryBlocks (UsbMass);
   Status    = EFI_SUCCESS;
 
   while (TotalBlock > 0) {
@@ -861,6 +1029,24 @@ UsbBootReadWriteBlocks (
                ByteSize,
                Timeout
                );
+    if (EFI_ERROR (Status) && (Status != EFI_NO_MEDIA) && (ByteSize > USB_BOOT_MAX_CARRY_SIZE)) {
+      //
+      // Don't trust the Block Limits VPD page of a device that fails
+      // the larger commands, fall back to the default carried size.
+      //
+      DEBUG ((
+        DEBUG_WARN,
+        "UsbBoot%sBlocks: %r to carry 0x%x bytes, fall back to 0x%x\n",
+        Write ? L"Write" : L"Read",
+        Status,
+        ByteSize,
+        USB_BOOT_MAX_CARRY_SIZE
+        ));
+      UsbMass->BlockLimitsVpd = FALSE;
+      CountMax                = UsbBootGetCarryBlocks (UsbMass);
+      continue;
+    }
+
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -910,7 +1096,7 @@ UsbBootReadWriteBlocks16 (
   UINT32      Timeout;
 
   BlockSize = UsbMass->BlockIoMedia.BlockSize;
-  CountMax  = USB_BOOT_MAX_CARRY_SIZE / BlockSize;
+  CountMax  = UsbBootGetCarryBlocks (UsbMass);
   Status    = EFI_SUCCESS;
 
   while (TotalBlock > 0) {
@@ -944,6 +1130,24 @@ UsbBootReadWriteBlocks16 (
                ByteSize,
                Timeout
                );
+    if (EFI_ERROR (Status) && (Status != EFI_NO_MEDIA) && (ByteSize > USB_BOOT_MAX_CARRY_SIZE)) {
+      //
+      // Don't trust the Block Limits VPD page of a device that fails
+      // the larger commands, fall back to the default carried size.
+      //
+      DEBUG ((
+        DEBUG_WARN,
+        "UsbBoot%sBlocks16: %r to carry 0x%x bytes, fall back to 0x%x\n",
+        Write ? L"Write" : L"Read",
+        Status,
+        ByteSize,
+        USB_BOOT_MAX_CARRY_SIZE
+        ));
+      UsbMass->BlockLimitsVpd = FALSE;
+      CountMax                = UsbBootGetCarryBlocks (UsbMass);
+      continue;
+    }
+
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -63,6 +63,17 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #define USB_BOOT_MAX_CARRY_SIZE  SIZE_64KB
 
+//
+// Devices that report the Block Limits VPD page are sent up to
+// USB_BOOT_MAX_VPD_CARRY_SIZE per command, within the transfer
+// lengths of the page. The VPD pages are only requested from
+// devices claiming SPC-3 or later, as older flash disks are known
+// to hang on them.
+//
+#define USB_BOOT_MAX_VPD_CARRY_SIZE    SIZE_1MB
+#define USB_BOOT_INQUIRY_EVPD          BIT0
+#define USB_BOOT_INQUIRY_VERSION_SPC3  0x05
+
 //
 // Retry mass command times, set by experience
 //
@@ -91,8 +102,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #pragma pack(1)
 typedef struct {
   UINT8    OpCode;
-  UINT8    Lun;                     ///< Lun (high 3 bits)
-  UINT8    Reserved0[2];
+  UINT8    Lun;                     ///< Lun (high 3 bits), EVPD (bit 0)
+  UINT8    PageCode;                ///< VPD page to return if EVPD is set
+  UINT8    Reserved0;
   UINT8    AllocLen;
   UINT8    Reserved1;
   UINT8    Pad[6];
@@ -101,7 +113,8 @@ typedef struct {
 typedef struct {
   UINT8    Pdt;                     ///< Peripheral Device Type (low 5 bits)
   UINT8    Removable;               ///< Removable Media (highest bit)
-  UINT8    Reserved0[2];
+  UINT8    Version;                 ///< Version of the command standard
+  UINT8    Reserved0;
   UINT8    AddLen;                  ///< Additional length
   UINT8    Reserved1[3];
   UINT8    VendorID[8];
@@ -370,6 +370,167 @@ UsbBotGetStatus (
   return Status;
 }
 
+/**
+  Execute a command with its Command, Data and Status phases queued together.
+
+  The CBW, the data and the CSW are queued on the bulk endpoints before the
+  first of them is started, so the host controller runs the three phases back
+  to back instead of returning to the driver after each of them. A phase that
+  fails is recovered as UsbBotSendCommand(), UsbBotDataTransfer() and
+  UsbBotGetStatus() do, and the status is then read with UsbBotGetStatus().
+
+  @param  UsbBot                The USB BOT device
+  @param  Cmd                   The command to transfer to device
+  @param  CmdLen                The length of the command
+  @param  DataDir               The direction of the data
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The expected length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait the data to transfer
+  @param  CmdStatus             The result of the command execution
+
+  @retval EFI_SUCCESS           Command execute result is retrieved and in CmdStatus.
+  @retval EFI_UNSUPPORTED       The phases can't be queued, none of them was
+                                started.
+  @retval EFI_NOT_READY         The device return NAK to the command
+  @retval Others                Failed to execute the command
+
+**/
+EFI_STATUS
+UsbBotExecQueuedCommand (
+  IN  USB_BOT_PROTOCOL        *UsbBot,
+  IN  UINT8                   *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  VOID                    *Data,
+  IN  UINT32                  DataLen,
+  IN  UINT8                   Lun,
+  IN  UINT32                  Timeout,
+  OUT UINT8                   *CmdStatus
+  )
+{
+  USB_BOT_CBW             Cbw;
+  USB_BOT_CSW             Csw;
+  EDKII_USB_BULK_REQUEST  Requests[3];
+  EDKII_USB_BULK_REQUEST  *CbwRequest;
+  EDKII_USB_BULK_REQUEST  *DataRequest;
+  EDKII_USB_BULK_REQUEST  *CswRequest;
+  UINTN                   RequestCount;
+  EFI_STATUS              Status;
+
+  ASSERT ((CmdLen > 0) && (CmdLen <= USB_BOT_MAX_CMDLEN));
+
+  //
+  // XhciDxe splits the data in TDs of 64 KB. After a short packet the next TD
+  // of the data would receive the CSW, so the data must fit in a single TD.
+  //
+  if ((UsbBot->BulkQueue == NULL) || (DataLen > USB_BOT_QUEUE_MAX_DATA)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Fill in the Command Block Wrapper.
+  //
+  Cbw.Signature = USB_BOT_CBW_SIGNATURE;
+  Cbw.Tag       = UsbBot->CbwTag;
+  Cbw.DataLen   = DataLen;
+  Cbw.Flag      = (UINT8)((DataDir == EfiUsbDataIn) ? BIT7 : 0);
+  Cbw.Lun       = Lun;
+  Cbw.CmdLen    = CmdLen;
+
+  ZeroMem (Cbw.CmdBlock, USB_BOT_MAX_CMDLEN);
+  CopyMem (Cbw.CmdBlock, Cmd, CmdLen);
+  ZeroMem (&Csw, sizeof (USB_BOT_CSW));
+
+  ZeroMem (Requests, sizeof (Requests));
+  RequestCount = 0;
+
+  CbwRequest                  = &Requests[RequestCount++];
+  CbwRequest->EndpointAddress = UsbBot->BulkOutEndpoint->EndpointAddress;
+  CbwRequest->Data            = &Cbw;
+  CbwRequest->DataLength      = sizeof (USB_BOT_CBW);
+
+  DataRequest = NULL;
+  if ((DataDir != EfiUsbNoData) && (DataLen != 0)) {
+    DataRequest                  = &Requests[RequestCount++];
+    DataRequest->EndpointAddress = (DataDir == EfiUsbDataIn) ?
+                                   UsbBot->BulkInEndpoint->EndpointAddress :
+                                   UsbBot->BulkOutEndpoint->EndpointAddress;
+    DataRequest->Data       = Data;
+    DataRequest->DataLength = DataLen;
+  }
+
+  CswRequest                  = &Requests[RequestCount++];
+  CswRequest->EndpointAddress = UsbBot->BulkInEndpoint->EndpointAddress;
+  CswRequest->Data            = &Csw;
+  CswRequest->DataLength      = sizeof (USB_BOT_CSW);
+
+  Status = UsbBot->BulkQueue->BulkQueueTransfer (
+                                UsbBot->BulkQueue,
+                                RequestCount,
+                                Requests,
+                                (USB_BOT_SEND_CBW_TIMEOUT + Timeout + USB_BOT_RECV_CSW_TIMEOUT) / USB_MASS_1_MILLISECOND
+                                );
+  if (Status == EFI_UNSUPPORTED) {
+    return Status;
+  }
+
+  //
+  // Command phase.
+  //
+  if (CbwRequest->TransferResult != EFI_USB_NOERROR) {
+    if (USB_IS_ERROR (CbwRequest->TransferResult, EFI_USB_ERR_STALL) && (DataDir == EfiUsbDataOut)) {
+      //
+      // Respond to Bulk-Out endpoint stall with a Reset Recovery,
+      // according to section 5.3.1 of USB Mass Storage Class Bulk-Only Transport Spec, v1.0.
+      //
+      UsbBotResetDevice (UsbBot, FALSE);
+    } else if (USB_IS_ERROR (CbwRequest->TransferResult, EFI_USB_ERR_NAK)) {
+      Status = EFI_NOT_READY;
+    }
+
+    return EFI_ERROR (Status) ? Status : EFI_DEVICE_ERROR;
+  }
+
+  //
+  // Data phase. The CSW is received even if the data transfer failed.
+  //
+  if ((DataRequest != NULL) && (DataRequest->TransferResult != EFI_USB_NOERROR)) {
+    if (USB_IS_ERROR (DataRequest->TransferResult, EFI_USB_ERR_STALL)) {
+      DEBUG ((DEBUG_INFO, "UsbBotExecQueuedCommand: Data Stall\n"));
+      UsbClearEndpointStall (UsbBot->UsbIo, DataRequest->EndpointAddress);
+    } else if (USB_IS_ERROR (DataRequest->TransferResult, EFI_USB_ERR_TIMEOUT)) {
+      UsbBotResetDevice (UsbBot, FALSE);
+    }
+
+    return UsbBotGetStatus (UsbBot, DataLen, CmdStatus);
+  }
+
+  //
+  // Status phase.
+  //
+  if (CswRequest->TransferResult != EFI_USB_NOERROR) {
+    if (USB_IS_ERROR (CswRequest->TransferResult, EFI_USB_ERR_STALL)) {
+      UsbClearEndpointStall (UsbBot->UsbIo, CswRequest->EndpointAddress);
+    }
+
+    return UsbBotGetStatus (UsbBot, DataLen, CmdStatus);
+  }
+
+  if ((Csw.Signature != USB_BOT_CSW_SIGNATURE) || (Csw.CmdStatus == USB_BOT_COMMAND_ERROR)) {
+    //
+    // CSW is invalid or reports a phase error, so perform reset recovery
+    //
+    UsbBotResetDevice (UsbBot, FALSE);
+    return UsbBotGetStatus (UsbBot, DataLen, CmdStatus);
+  }
+
+  *CmdStatus = Csw.CmdStatus;
+  UsbBot->CbwTag++;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Call the USB Mass Storage Class BOT protocol to issue
   the command/data/status circle to execute the commands.
@@ -410,6 +571,25 @@ UsbBotExecCommand (
   *CmdStatus = USB_MASS_CMD_FAIL;
   UsbBot     = (USB_BOT_PROTOCOL *)Context;
 
+  //
+  // Queue the three phases together when the host controller supports it.
+  // Commands are not queued after each other: the host shall not send the
+  // next CBW before it received the CSW of the previous command.
+  //
+  Status = UsbBotExecQueuedCommand (UsbBot, Cmd, CmdLen, DataDir, Data, DataLen, Lun, Timeout, &Result);
+  if (Status != EFI_UNSUPPORTED) {
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "UsbBotExecCommand: UsbBotExecQueuedCommand (%r)\n", Status));
+      return Status;
+    }
+
+    if (Result == 0) {
+      *CmdStatus = USB_MASS_CMD_SUCCESS;
+    }
+
+    return EFI_SUCCESS;
+  }
+
   //
   // Send the command to the device. Return immediately if device
   // rejects the command.
@@ -47,6 +47,12 @@ extern USB_MASS_TRANSPORT  mUsbBotTransport;
 #define USB_BOT_RECV_CSW_TIMEOUT      (3 * USB_MASS_1_SECOND)
 #define USB_BOT_RESET_DEVICE_TIMEOUT  (3 * USB_MASS_1_SECOND)
 
+//
+// The CBW, the data and the CSW of a command are queued together on the host
+// controller when the data fits in a single TD, see UsbBotExecQueuedCommand().
+//
+#define USB_BOT_QUEUE_MAX_DATA  SIZE_64KB
+
 #pragma pack(1)
 ///
 /// The CBW (Command Block Wrapper) structures used by the USB BOT protocol.
@@ -76,11 +82,15 @@ typedef struct {
   //
   // Put Interface at the first field to make it easy to distinguish BOT/CBI Protocol instance
   //
-  EFI_USB_INTERFACE_DESCRIPTOR    Interface;
-  EFI_USB_ENDPOINT_DESCRIPTOR     *BulkInEndpoint;
-  EFI_USB_ENDPOINT_DESCRIPTOR     *BulkOutEndpoint;
-  UINT32                          CbwTag;
-  EFI_USB_IO_PROTOCOL             *UsbIo;
+  EFI_USB_INTERFACE_DESCRIPTOR        Interface;
+  EFI_USB_ENDPOINT_DESCRIPTOR         *BulkInEndpoint;
+  EFI_USB_ENDPOINT_DESCRIPTOR         *BulkOutEndpoint;
+  UINT32                              CbwTag;
+  EFI_USB_IO_PROTOCOL                 *UsbIo;
+  //
+  // Optional, NULL if the USB bus driver doesn't queue bulk transfers.
+  //
+  EDKII_USB_IO_BULK_QUEUE_PROTOCOL    *BulkQueue;
 } USB_BOT_PROTOCOL;
 
 /**
@@ -443,6 +443,22 @@ UsbMassInitTransport (
   //
   if ((*Transport)->Protocol == USB_MASS_STORE_BOT) {
     (*Transport)->GetMaxLun (*Context, MaxLun);
+
+    //
+    // The USB bus driver may also queue the phases of a BOT command together.
+    //
+    Status = gBS->OpenProtocol (
+                    Controller,
+                    &gEdkiiUsbIoBulkQueueProtocolGuid,
+                    (VOID **)&((USB_BOT_PROTOCOL *)*Context)->BulkQueue,
+                    This->DriverBindingHandle,
+                    Controller,
+                    EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                    );
+    if (EFI_ERROR (Status)) {
+      ((USB_BOT_PROTOCOL *)*Context)->BulkQueue = NULL;
+      Status                                    = EFI_SUCCESS;
+    }
   }
 
 ON_EXIT:
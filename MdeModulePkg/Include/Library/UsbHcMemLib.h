@@ -0,0 +1,228 @@
+/** @file
+  USB host controller DMA memory library.
+
+  The library manages the common buffer memory that USB host controller
+  drivers share with their controllers, and maps the transfer buffers of
+  USB requests for bus master access.
+
+  Memory is handed out in power of two size classes from pages that are
+  mapped once for the life of the pool, so allocating and freeing schedule
+  structures doesn't scan any allocation bitmap. When an IOMMU is present,
+  transfer buffers are staged in common buffers that stay mapped across
+  transfers instead of mapping every request with PciIo->Map().
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __USB_HC_MEM_LIB_H__
+#define __USB_HC_MEM_LIB_H__
+
+#include <Protocol/PciIo.h>
+
+typedef struct _USBHC_MEM_POOL USBHC_MEM_POOL;
+
+/**
+  Initialize the memory management pool for the host controller.
+
+  @param  PciIo                The PciIo that can be used to access the host controller.
+  @param  Check4G              Whether the host controller requires allocated memory
+                               from one 4G address space.
+  @param  Which4G              The 4G memory area each memory allocated should be from.
+
+  @return The initialized memory pool, or NULL if there are not enough resources.
+
+**/
+USBHC_MEM_POOL *
+EFIAPI
+UsbHcInitMemPool (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN BOOLEAN              Check4G,
+  IN UINT32               Which4G
+  );
+
+/**
+  Release the memory management pool.
+
+  @param  Pool              The USB memory pool to free.
+
+  @retval EFI_SUCCESS       The memory pool is freed.
+  @retval EFI_DEVICE_ERROR  Failed to free the memory pool.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbHcFreeMemPool (
+  IN USBHC_MEM_POOL  *Pool
+  );
+
+/**
+  Allocate some memory from the host controller's memory pool
+  which can be used to communicate with host controller.
+
+  The memory is zeroed and aligned on 64 bytes. Allocations of up to
+  one page never cross a page boundary.
+
+  @param  Pool           The host controller's memory pool.
+  @param  Size           Size of the memory to allocate.
+
+  @return The allocated memory or NULL.
+
+**/
+VOID *
+EFIAPI
+UsbHcAllocateMem (
+  IN  USBHC_MEM_POOL  *Pool,
+  IN  UINTN           Size
+  );
+
+/**
+  Free the allocated memory back to the memory pool.
+
+  @param  Pool           The memory pool of the host controller.
+  @param  Mem            The memory to free.
+  @param  Size           The size of the memory to free, it must be the
+                         size passed to UsbHcAllocateMem().
+
+**/
+VOID
+EFIAPI
+UsbHcFreeMem (
+  IN USBHC_MEM_POOL  *Pool,
+  IN VOID            *Mem,
+  IN UINTN           Size
+  );
+
+/**
+  Calculate the corresponding pci bus address according to the Mem parameter.
+
+  @param  Pool           The memory pool of the host controller.
+  @param  Mem            The pointer to host memory.
+  @param  Size           The size of the memory region.
+
+  @return                The pci memory address
+
+**/
+EFI_PHYSICAL_ADDRESS
+EFIAPI
+UsbHcGetPciAddrForHostAddr (
+  IN USBHC_MEM_POOL  *Pool,
+  IN VOID            *Mem,
+  IN UINTN           Size
+  );
+
+/**
+  Calculate the corresponding host address according to the pci address.
+
+  @param  Pool           The memory pool of the host controller.
+  @param  Mem            The pointer to pci memory.
+  @param  Size           The size of the memory region.
+
+  @return                The host memory address
+
+**/
+EFI_PHYSICAL_ADDRESS
+EFIAPI
+UsbHcGetHostAddrForPciAddr (
+  IN USBHC_MEM_POOL  *Pool,
+  IN VOID            *Mem,
+  IN UINTN           Size
+  );
+
+/**
+  Map the buffer of a USB transfer for bus master access.
+
+  The function has the same semantics as PciIo->Map(). Bus master read and
+  write buffers may be staged in a common buffer of the pool that stays
+  mapped across transfers, in which case the data is copied in here and
+  copied back by UsbHcUnmapBuffer().
+
+  @param  Pool                  The memory pool of the host controller.
+  @param  Operation             Indicates if the bus master is going to read or write to system memory.
+  @param  HostAddress           The system memory address to map to the PCI controller.
+  @param  NumberOfBytes         On input the number of bytes to map. On output the number of bytes
+                                that were mapped.
+  @param  DeviceAddress         The resulting map address for the bus master PCI controller to use to
+                                access the hosts HostAddress.
+  @param  Mapping               A resulting value to pass to UsbHcUnmapBuffer().
+
+  @retval EFI_SUCCESS           The range was mapped for the returned NumberOfBytes.
+  @retval Others                The range could not be mapped, see PciIo->Map().
+
+**/
+EFI_STATUS
+EFIAPI
+UsbHcMapBuffer (
+  IN     USBHC_MEM_POOL                 *Pool,
+  IN     EFI_PCI_IO_PROTOCOL_OPERATION  Operation,
+  IN     VOID                           *HostAddress,
+  IN OUT UINTN                          *NumberOfBytes,
+  OUT    EFI_PHYSICAL_ADDRESS           *DeviceAddress,
+  OUT    VOID                           **Mapping
+  );
+
+/**
+  Complete a mapping done by UsbHcMapBuffer().
+
+  @param  Pool                  The memory pool of the host controller.
+  @param  Mapping               The mapping value returned from UsbHcMapBuffer().
+
+  @retval EFI_SUCCESS           The range was unmapped.
+  @retval Others                The range could not be unmapped, see PciIo->Unmap().
+
+**/
+EFI_STATUS
+EFIAPI
+UsbHcUnmapBuffer (
+  IN USBHC_MEM_POOL  *Pool,
+  IN VOID            *Mapping
+  );
+
+/**
+  Allocates pages at a specified alignment that are suitable for an EfiPciIoOperationBusMasterCommonBuffer mapping.
+
+  If Alignment is not a power of two and Alignment is not zero, then ASSERT().
+
+  @param  PciIo                 The PciIo that can be used to access the host controller.
+  @param  Pages                 The number of pages to allocate.
+  @param  Alignment             The requested alignment of the allocation.  Must be a power of two.
+  @param  HostAddress           The system memory address to map to the PCI controller.
+  @param  DeviceAddress         The resulting map address for the bus master PCI controller to
+                                use to access the hosts HostAddress.
+  @param  Mapping               A resulting value to pass to Unmap().
+
+  @retval EFI_SUCCESS           Success to allocate aligned pages.
+  @retval EFI_INVALID_PARAMETER Pages or Alignment is not valid.
+  @retval EFI_OUT_OF_RESOURCES  Do not have enough resources to allocate memory.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbHcAllocateAlignedPages (
+  IN EFI_PCI_IO_PROTOCOL    *PciIo,
+  IN UINTN                  Pages,
+  IN UINTN                  Alignment,
+  OUT VOID                  **HostAddress,
+  OUT EFI_PHYSICAL_ADDRESS  *DeviceAddress,
+  OUT VOID                  **Mapping
+  );
+
+/**
+  Frees memory that was allocated with UsbHcAllocateAlignedPages().
+
+  @param  PciIo                 The PciIo that can be used to access the host controller.
+  @param  HostAddress           The system memory address to map to the PCI controller.
+  @param  Pages                 The number of pages to free.
+  @param  Mapping               The mapping value returned from Map().
+
+**/
+VOID
+EFIAPI
+UsbHcFreeAlignedPages (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN VOID                 *HostAddress,
+  IN UINTN                Pages,
+  IN VOID                 *Mapping
+  );
+
+#endif
@@ -0,0 +1,158 @@
+/** @file
+  EDKII Sparse RAM Disk Protocol.
+
+  The protocol registers RAM disks that are not backed by one contiguous
+  memory range. The content is kept in fixed size chunks: chunks that only
+  contain zeros are not allocated, and chunks whose content has not been
+  supplied yet can be fetched on demand through a producer callback, so a
+  RAM disk can be used while its image is still being downloaded.
+
+  A sparse RAM disk is only visible to UEFI. It is never described to the OS
+  through the NVDIMM Firmware Interface Table (NFIT).
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_SPARSE_RAM_DISK_PROTOCOL_H__
+#define __EDKII_SPARSE_RAM_DISK_PROTOCOL_H__
+
+#include <Protocol/RamDisk.h>
+
+#define EDKII_SPARSE_RAM_DISK_PROTOCOL_GUID \
+  { 0xcc82140f, 0xbb1c, 0x4742, { 0x8d, 0x7a, 0x54, 0xdc, 0x30, 0xbe, 0x52, 0x57 } }
+
+typedef struct _EDKII_SPARSE_RAM_DISK_PROTOCOL EDKII_SPARSE_RAM_DISK_PROTOCOL;
+
+/**
+  Fetch the content of a RAM disk chunk that has not been supplied yet.
+
+  The function is called from the Block I/O services of the RAM disk and
+  must not return before the data is available. It may also call Supply() for
+  other chunks fetched along with the requested one.
+
+  @param[in]  Context       The context passed to Register().
+  @param[in]  Offset        The byte offset of the chunk in the RAM disk.
+  @param[in]  Length        The number of bytes to fetch.
+  @param[out] Buffer        The buffer to receive the content.
+
+  @retval EFI_SUCCESS       The content was fetched.
+  @retval Others            The content could not be fetched, the read of the
+                            RAM disk fails with EFI_DEVICE_ERROR.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SPARSE_RAM_DISK_FILL)(
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  IN  UINTN   Length,
+  OUT VOID    *Buffer
+  );
+
+/**
+  Register a sparse RAM disk with specified size and type.
+
+  All chunks of the new RAM disk are initially empty. Empty chunks read as
+  zeros if Fill is NULL, otherwise Fill is called to fetch them the first
+  time they are accessed.
+
+  @param[in]  RamDiskSize    The size of registered RAM disk.
+  @param[in]  RamDiskType    The type of registered RAM disk. The GUID can be
+                             any of the values defined in section 9.3.6.9, or a
+                             vendor defined GUID.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path. If there is no
+                             parent device path then ParentDevicePath is NULL.
+  @param[in]  Fill           Optional function to fetch chunks that have not
+                             been supplied.
+  @param[in]  FillContext    The context passed to Fill.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device. This function is
+                             responsible for allocating the buffer DevicePath
+                             with the boot service AllocatePool().
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_INVALID_PARAMETER   DevicePath or RamDiskType is NULL.
+                                  RamDiskSize is 0.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SPARSE_RAM_DISK_REGISTER)(
+  IN  UINT64                      RamDiskSize,
+  IN  EFI_GUID                    *RamDiskType,
+  IN  EFI_DEVICE_PATH             *ParentDevicePath     OPTIONAL,
+  IN  EDKII_SPARSE_RAM_DISK_FILL  Fill                  OPTIONAL,
+  IN  VOID                        *FillContext          OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL    **DevicePath
+  );
+
+/**
+  Supply the content of a sparse RAM disk.
+
+  Offset must be aligned to the chunk size, and Length must be a multiple of
+  the chunk size unless the range ends at the end of the RAM disk. Chunks
+  that were already supplied, fetched or written are left unchanged.
+
+  @param[in] DevicePath      A pointer to the device path that describes a
+                             sparse RAM disk device.
+  @param[in] Offset          The byte offset in the RAM disk.
+  @param[in] Length          The number of bytes in Buffer.
+  @param[in] Buffer          The content.
+
+  @retval EFI_SUCCESS             The content is supplied.
+  @retval EFI_INVALID_PARAMETER   The range is not chunk aligned or is out of
+                                  the RAM disk.
+  @retval EFI_NOT_FOUND           The sparse RAM disk pointed by DevicePath
+                                  doesn't exist.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to hold the
+                                  content.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SPARSE_RAM_DISK_SUPPLY)(
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN UINT64                    Offset,
+  IN UINTN                     Length,
+  IN VOID                      *Buffer
+  );
+
+/**
+  Unregister a sparse RAM disk specified by DevicePath, and free the memory
+  that holds its content.
+
+  @param[in] DevicePath      A pointer to the device path that describes a
+                             sparse RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is unregistered successfully.
+  @retval EFI_INVALID_PARAMETER   DevicePath is NULL.
+  @retval EFI_NOT_FOUND           The sparse RAM disk pointed by DevicePath
+                                  doesn't exist. RAM disks registered through
+                                  EFI_RAM_DISK_PROTOCOL are not unregistered.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SPARSE_RAM_DISK_UNREGISTER)(
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  );
+
+///
+/// EDKII Sparse RAM Disk Protocol structure.
+///
+struct _EDKII_SPARSE_RAM_DISK_PROTOCOL {
+  UINT32                              ChunkSize;
+  EDKII_SPARSE_RAM_DISK_REGISTER      Register;
+  EDKII_SPARSE_RAM_DISK_SUPPLY        Supply;
+  EDKII_SPARSE_RAM_DISK_UNREGISTER    Unregister;
+};
+
+extern EFI_GUID  gEdkiiSparseRamDiskProtocolGuid;
+
+#endif
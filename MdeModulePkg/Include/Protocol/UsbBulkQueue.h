@@ -0,0 +1,159 @@
+/** @file
+  EDKII USB Bulk Queue Protocols.
+
+  The protocols submit several bulk transfers to a USB device at once. All the
+  transfers are queued on their endpoints before the first one is started, so
+  that the host controller runs them back to back without a round trip to the
+  caller between them. A USB mass storage class driver uses them to submit the
+  command, data and status transports of a Bulk-Only command together.
+
+  EDKII_USB2_HC_BULK_QUEUE_PROTOCOL is produced by a host controller driver on
+  the handle of its EFI_USB2_HC_PROTOCOL. EDKII_USB_IO_BULK_QUEUE_PROTOCOL is
+  produced by the USB bus driver on the handle of each EFI_USB_IO_PROTOCOL.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_USB_BULK_QUEUE_PROTOCOL_H__
+#define __EDKII_USB_BULK_QUEUE_PROTOCOL_H__
+
+#include <Protocol/Usb2HostController.h>
+
+#define EDKII_USB2_HC_BULK_QUEUE_PROTOCOL_GUID \
+  { 0x7dbd2954, 0x28e4, 0x4cb0, { 0xa2, 0x72, 0xaa, 0xb6, 0x14, 0x33, 0xba, 0x9a } }
+
+#define EDKII_USB_IO_BULK_QUEUE_PROTOCOL_GUID \
+  { 0x68540502, 0x0217, 0x44ec, { 0x90, 0x6b, 0x67, 0x91, 0x5f, 0xa4, 0x83, 0x74 } }
+
+typedef struct _EDKII_USB2_HC_BULK_QUEUE_PROTOCOL  EDKII_USB2_HC_BULK_QUEUE_PROTOCOL;
+typedef struct _EDKII_USB_IO_BULK_QUEUE_PROTOCOL   EDKII_USB_IO_BULK_QUEUE_PROTOCOL;
+
+///
+/// A bulk transfer in a queue.
+///
+typedef struct {
+  ///
+  /// The endpoint address, with the direction in bit 7.
+  ///
+  UINT8     EndpointAddress;
+  ///
+  /// The data toggle of the endpoint, updated on return. Set by the USB bus
+  /// driver, ignored by EDKII_USB_IO_BULK_QUEUE_PROTOCOL.
+  ///
+  UINT8     DataToggle;
+  ///
+  /// The maximum packet size of the endpoint. Set by the USB bus driver,
+  /// ignored by EDKII_USB_IO_BULK_QUEUE_PROTOCOL.
+  ///
+  UINTN     MaximumPacketLength;
+  ///
+  /// The data buffer.
+  ///
+  VOID      *Data;
+  ///
+  /// On input the size of Data in bytes, on output the number of bytes
+  /// transferred.
+  ///
+  UINTN     DataLength;
+  ///
+  /// The result of the transfer, EFI_USB_ERR_NOTEXECUTE if it was aborted
+  /// before it was started.
+  ///
+  UINT32    TransferResult;
+} EDKII_USB_BULK_REQUEST;
+
+/**
+  Submit several bulk transfers to a USB device.
+
+  The transfers are queued in order on their endpoints, so the transfers on
+  the same endpoint run in order. The function returns when all of them are
+  complete, or as soon as one fails or the timeout expires. The transfers not
+  complete then are aborted.
+
+  @param  This                  This EDKII_USB2_HC_BULK_QUEUE_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  DeviceSpeed           Device speed, Low speed device doesn't support
+                                bulk transfer.
+  @param  RequestCount          The number of transfers in Requests.
+  @param  Requests              The transfers.
+  @param  Timeout               Indicates the maximum time, in millisecond, which
+                                all the transfers are allowed to complete.
+  @param  Translator            A pointer to the transaction translator data.
+
+  @retval EFI_SUCCESS           All the transfers were completed successfully.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_UNSUPPORTED       The transfers can't be queued together, none of
+                                them was started.
+  @retval EFI_OUT_OF_RESOURCES  A transfer could not be queued due to a lack of
+                                resources, the transfers before it were run.
+  @retval EFI_TIMEOUT           The transfers failed due to timeout.
+  @retval EFI_DEVICE_ERROR      A transfer failed due to host controller or
+                                device error, see its TransferResult.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB2_HC_BULK_QUEUE_TRANSFER)(
+  IN     EDKII_USB2_HC_BULK_QUEUE_PROTOCOL   *This,
+  IN     UINT8                               DeviceAddress,
+  IN     UINT8                               DeviceSpeed,
+  IN     UINTN                               RequestCount,
+  IN OUT EDKII_USB_BULK_REQUEST              *Requests,
+  IN     UINTN                               Timeout,
+  IN     EFI_USB2_HC_TRANSACTION_TRANSLATOR  *Translator
+  );
+
+/**
+  Submit several bulk transfers to the USB device of the interface.
+
+  The transfers are queued in order on their endpoints, so the transfers on
+  the same endpoint run in order. The function returns when all of them are
+  complete, or as soon as one fails or the timeout expires. The transfers not
+  complete then are aborted. A halted endpoint is not cleared.
+
+  @param  This                  This EDKII_USB_IO_BULK_QUEUE_PROTOCOL instance.
+  @param  RequestCount          The number of transfers in Requests.
+  @param  Requests              The transfers.
+  @param  Timeout               Indicates the maximum time, in millisecond, which
+                                all the transfers are allowed to complete.
+
+  @retval EFI_SUCCESS           All the transfers were completed successfully.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_UNSUPPORTED       The host controller doesn't queue bulk transfers,
+                                or the transfers can't be queued together. None
+                                of them was started.
+  @retval EFI_OUT_OF_RESOURCES  A transfer could not be queued due to a lack of
+                                resources, the transfers before it were run.
+  @retval EFI_TIMEOUT           The transfers failed due to timeout.
+  @retval EFI_DEVICE_ERROR      A transfer failed due to host controller or
+                                device error, see its TransferResult.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_BULK_QUEUE_TRANSFER)(
+  IN     EDKII_USB_IO_BULK_QUEUE_PROTOCOL  *This,
+  IN     UINTN                             RequestCount,
+  IN OUT EDKII_USB_BULK_REQUEST            *Requests,
+  IN     UINTN                             Timeout
+  );
+
+///
+/// EDKII USB2 Host Controller Bulk Queue Protocol structure.
+///
+struct _EDKII_USB2_HC_BULK_QUEUE_PROTOCOL {
+  EDKII_USB2_HC_BULK_QUEUE_TRANSFER    BulkQueueTransfer;
+};
+
+///
+/// EDKII USB I/O Bulk Queue Protocol structure.
+///
+struct _EDKII_USB_IO_BULK_QUEUE_PROTOCOL {
+  EDKII_USB_IO_BULK_QUEUE_TRANSFER    BulkQueueTransfer;
+};
+
+extern EFI_GUID  gEdkiiUsb2HcBulkQueueProtocolGuid;
+extern EFI_GUID  gEdkiiUsbIoBulkQueueProtocolGuid;
+
+#endif
@@ -1351,6 +1351,9 @@ BmGetRamDiskMemoryInfo (
   unregister the RAM DISK from RAM DISK driver, free the memory
   allocated for the RAM Disk.
 
+  A sparse RAM disk registered by the LoadFile instance itself is not
+  backed by a buffer allocated here, the RAM disk driver frees its memory.
+
   @param RamDiskDevicePath    RAM Disk device path.
 **/
 VOID
@@ -1358,12 +1361,21 @@ BmDestroyRamDisk (
   IN EFI_DEVICE_PATH_PROTOCOL  *RamDiskDevicePath
   )
 {
-  EFI_STATUS  Status;
-  VOID        *RamDiskBuffer;
-  UINTN       RamDiskSizeInPages;
+  EFI_STATUS                      Status;
+  VOID                            *RamDiskBuffer;
+  UINTN                           RamDiskSizeInPages;
+  EDKII_SPARSE_RAM_DISK_PROTOCOL  *SparseRamDisk;
 
   ASSERT (RamDiskDevicePath != NULL);
 
+  Status = gBS->LocateProtocol (&gEdkiiSparseRamDiskProtocolGuid, NULL, (VOID **)&SparseRamDisk);
+  if (!EFI_ERROR (Status)) {
+    Status = SparseRamDisk->Unregister (RamDiskDevicePath);
+    if (!EFI_ERROR (Status)) {
+      return;
+    }
+  }
+
   RamDiskBuffer = BmGetRamDiskMemoryInfo (RamDiskDevicePath, &RamDiskSizeInPages);
 
   //
@@ -1424,6 +1436,19 @@ BmExpandLoadFile (
     return DuplicateDevicePath (DevicePathFromHandle (LoadFileHandle));
   }
 
+  if (BufferSize == 0) {
+    //
+    // The load option resides in a sparse RAM disk that LoadFile already
+    // registered, its content is fetched on demand.
+    //
+    FullPath = BmExpandNetworkFileSystem (LoadFileHandle, &RamDiskHandle);
+    if ((FullPath == NULL) && (RamDiskHandle != NULL)) {
+      BmDestroyRamDisk (DevicePathFromHandle (RamDiskHandle));
+    }
+
+    return FullPath;
+  }
+
   //
   // The load option resides in a RAM disk.
   //
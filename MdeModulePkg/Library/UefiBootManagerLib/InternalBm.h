@@ -40,6 +40,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/DriverHealth.h>
 #include <Protocol/FormBrowser2.h>
 #include <Protocol/RamDisk.h>
+#include <Protocol/SparseRamDisk.h>
 #include <Protocol/DeferredImageLoad.h>
 #include <Protocol/PlatformBootManager.h>
 
@@ -413,6 +414,9 @@ BmGetRamDiskDevicePath (
   unregister the RAM DISK from RAM DISK driver, free the memory
   allocated for the RAM Disk.
 
+  A sparse RAM disk registered by the LoadFile instance itself is not
+  backed by a buffer allocated here, the RAM disk driver frees its memory.
+
   @param RamDiskDevicePath    RAM Disk device path.
 **/
 VOID
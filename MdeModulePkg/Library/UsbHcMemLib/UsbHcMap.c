@@ -0,0 +1,248 @@
+/** @file
+
+  Map the transfer buffers of USB requests for bus master access.
+
+  Behind an IOMMU, PciIo->Map() may bounce every transfer through a newly
+  allocated and mapped buffer (for example, the shared memory used with
+  AMD SEV). The pool keeps a small cache of common buffers that stay mapped
+  and stages the transfer data in them instead.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "UsbHcMemInternal.h"
+
+/**
+  Release the common buffer of a bounce buffer.
+
+  @param  Pool           The memory pool of the host controller.
+  @param  Bounce         The bounce buffer.
+
+**/
+VOID
+UsbHcReleaseBounceBuffer (
+  IN USBHC_MEM_POOL       *Pool,
+  IN USBHC_BOUNCE_BUFFER  *Bounce
+  )
+{
+  if (Bounce->Pages != 0) {
+    Pool->PciIo->Unmap (Pool->PciIo, Bounce->Mapping);
+    Pool->PciIo->FreeBuffer (Pool->PciIo, Bounce->Pages, Bounce->HostAddress);
+  }
+
+  ZeroMem (Bounce, sizeof (USBHC_BOUNCE_BUFFER));
+}
+
+/**
+  Release the bounce buffers of the pool.
+
+  @param  Pool           The memory pool of the host controller.
+
+**/
+VOID
+UsbHcFreeBounceBuffers (
+  IN USBHC_MEM_POOL  *Pool
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < USBHC_BOUNCE_BUFFER_NUMBER; Index++) {
+    ASSERT (!Pool->Bounce[Index].InUse);
+    UsbHcReleaseBounceBuffer (Pool, &Pool->Bounce[Index]);
+  }
+}
+
+/**
+  Get a free bounce buffer of at least the given size.
+
+  A free buffer that is large enough is reused. Otherwise the smallest
+  free buffer is released and allocated again with the requested size.
+
+  @param  Pool           The memory pool of the host controller.
+  @param  Pages          The number of pages needed.
+
+  @return The bounce buffer or NULL if there is none available.
+
+**/
+USBHC_BOUNCE_BUFFER *
+UsbHcGetBounceBuffer (
+  IN USBHC_MEM_POOL  *Pool,
+  IN UINTN           Pages
+  )
+{
+  USBHC_BOUNCE_BUFFER  *Bounce;
+  USBHC_BOUNCE_BUFFER  *Victim;
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  UINTN                Index;
+  UINTN                Bytes;
+  EFI_STATUS           Status;
+
+  Victim = NULL;
+
+  for (Index = 0; Index < USBHC_BOUNCE_BUFFER_NUMBER; Index++) {
+    Bounce = &Pool->Bounce[Index];
+    if (Bounce->InUse) {
+      continue;
+    }
+
+    if (Bounce->Pages >= Pages) {
+      return Bounce;
+    }
+
+    if ((Victim == NULL) || (Bounce->Pages < Victim->Pages)) {
+      Victim = Bounce;
+    }
+  }
+
+  if (Victim == NULL) {
+    return NULL;
+  }
+
+  UsbHcReleaseBounceBuffer (Pool, Victim);
+
+  PciIo  = Pool->PciIo;
+  Status = PciIo->AllocateBuffer (
+                    PciIo,
+                    AllocateAnyPages,
+                    EfiBootServicesData,
+                    Pages,
+                    &Victim->HostAddress,
+                    0
+                    );
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  Bytes  = EFI_PAGES_TO_SIZE (Pages);
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Victim->HostAddress,
+                    &Bytes,
+                    &Victim->DeviceAddress,
+                    &Victim->Mapping
+                    );
+  if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (Pages))) {
+    if (!EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, Victim->Mapping);
+    }
+
+    PciIo->FreeBuffer (PciIo, Pages, Victim->HostAddress);
+    ZeroMem (Victim, sizeof (USBHC_BOUNCE_BUFFER));
+    return NULL;
+  }
+
+  Victim->Pages = Pages;
+  return Victim;
+}
+
+/**
+  Map the buffer of a USB transfer for bus master access.
+
+  The function has the same semantics as PciIo->Map(). Bus master read and
+  write buffers may be staged in a common buffer of the pool that stays
+  mapped across transfers, in which case the data is copied in here and
+  copied back by UsbHcUnmapBuffer().
+
+  @param  Pool                  The memory pool of the host controller.
+  @param  Operation             Indicates if the bus master is going to read or write to system memory.
+  @param  HostAddress           The system memory address to map to the PCI controller.
+  @param  NumberOfBytes         On input the number of bytes to map. On output the number of bytes
+                                that were mapped.
+  @param  DeviceAddress         The resulting map address for the bus master PCI controller to use to
+                                access the hosts HostAddress.
+  @param  Mapping               A resulting value to pass to UsbHcUnmapBuffer().
+
+  @retval EFI_SUCCESS           The range was mapped for the returned NumberOfBytes.
+  @retval Others                The range could not be mapped, see PciIo->Map().
+
+**/
+EFI_STATUS
+EFIAPI
+UsbHcMapBuffer (
+  IN     USBHC_MEM_POOL                 *Pool,
+  IN     EFI_PCI_IO_PROTOCOL_OPERATION  Operation,
+  IN     VOID                           *HostAddress,
+  IN OUT UINTN                          *NumberOfBytes,
+  OUT    EFI_PHYSICAL_ADDRESS           *DeviceAddress,
+  OUT    VOID                           **Mapping
+  )
+{
+  USBHC_BOUNCE_BUFFER  *Bounce;
+  UINTN                Pages;
+
+  Bounce = NULL;
+
+  if (Pool->BounceCache &&
+      ((Operation == EfiPciIoOperationBusMasterRead) || (Operation == EfiPciIoOperationBusMasterWrite)) &&
+      (*NumberOfBytes != 0) && (*NumberOfBytes <= EFI_PAGES_TO_SIZE (USBHC_BOUNCE_MAX_PAGES)))
+  {
+    Pages  = EFI_SIZE_TO_PAGES (*NumberOfBytes);
+    Bounce = UsbHcGetBounceBuffer (Pool, Pages);
+  }
+
+  if (Bounce == NULL) {
+    Pool->Stats.DirectMaps++;
+    return Pool->PciIo->Map (Pool->PciIo, Operation, HostAddress, NumberOfBytes, DeviceAddress, Mapping);
+  }
+
+  if (Operation == EfiPciIoOperationBusMasterRead) {
+    CopyMem (Bounce->HostAddress, HostAddress, *NumberOfBytes);
+  }
+
+  Bounce->InUse       = TRUE;
+  Bounce->Operation   = Operation;
+  Bounce->UserAddress = HostAddress;
+  Bounce->Length      = *NumberOfBytes;
+
+  Pool->Stats.BounceMaps++;
+  Pool->Stats.BounceBytes += *NumberOfBytes;
+
+  *DeviceAddress = Bounce->DeviceAddress;
+  *Mapping       = Bounce;
+  return EFI_SUCCESS;
+}
+
+/**
+  Complete a mapping done by UsbHcMapBuffer().
+
+  @param  Pool                  The memory pool of the host controller.
+  @param  Mapping               The mapping value returned from UsbHcMapBuffer().
+
+  @retval EFI_SUCCESS           The range was unmapped.
+  @retval Others                The range could not be unmapped, see PciIo->Unmap().
+
+**/
+EFI_STATUS
+EFIAPI
+UsbHcUnmapBuffer (
+  IN USBHC_MEM_POOL  *Pool,
+  IN VOID            *Mapping
+  )
+{
+  USBHC_BOUNCE_BUFFER  *Bounce;
+
+  if (((UINTN)Mapping < (UINTN)&Pool->Bounce[0]) ||
+      ((UINTN)Mapping >= (UINTN)&Pool->Bounce[USBHC_BOUNCE_BUFFER_NUMBER]))
+  {
+    return Pool->PciIo->Unmap (Pool->PciIo, Mapping);
+  }
+
+  Bounce = (USBHC_BOUNCE_BUFFER *)Mapping;
+  ASSERT (Bounce->InUse);
+
+  if (Bounce->Operation == EfiPciIoOperationBusMasterWrite) {
+    CopyMem (Bounce->UserAddress, Bounce->HostAddress, Bounce->Length);
+  }
+
+  //
+  // The bounce buffer stays mapped, and under SEV it is shared with the
+  // host. Clear the transfer data like the IOMMU driver does when it
+  // releases its own bounce buffers.
+  //
+  ZeroMem (Bounce->HostAddress, Bounce->Length);
+
+  Bounce->InUse = FALSE;
+  return EFI_SUCCESS;
+}
@@ -2,12 +2,17 @@
 
   Routine procedures for memory allocate/free.
 
-Copyright (c) 2013 - 2018, Intel Corporation. All rights reserved.<BR>
+  The pool is made of blocks of pages that are allocated and mapped as
+  common buffer once. Pages are handed out one at a time to power of two
+  size classes, and each class keeps a free list of its units, so both
+  allocation and free are done in constant time.
+
+Copyright (c) 2007 - 2018, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
-#include "Xhci.h"
+#include "UsbHcMemInternal.h"
 
 /**
   Allocate a block of memory to be used by the buffer pool.
@@ -39,20 +44,7 @@ UsbHcAllocMemBlock (
     return NULL;
   }
 
-  //
-  // each bit in the bit array represents USBHC_MEM_UNIT
-  // bytes of memory in the memory block.
-  //
-  ASSERT (USBHC_MEM_UNIT * 8 <= EFI_PAGE_SIZE);
-
-  Block->BufLen  = EFI_PAGES_TO_SIZE (Pages);
-  Block->BitsLen = Block->BufLen / (USBHC_MEM_UNIT * 8);
-  Block->Bits    = AllocateZeroPool (Block->BitsLen);
-
-  if (Block->Bits == NULL) {
-    gBS->FreePool (Block);
-    return NULL;
-  }
+  Block->BufLen = EFI_PAGES_TO_SIZE (Pages);
 
   //
   // Allocate the number of Pages of memory, then map it for
@@ -68,7 +60,7 @@ UsbHcAllocMemBlock (
                     );
 
   if (EFI_ERROR (Status)) {
-    goto FREE_BITARRAY;
+    goto FREE_BLOCK;
   }
 
   Bytes  = EFI_PAGES_TO_SIZE (Pages);
@@ -85,17 +77,29 @@ UsbHcAllocMemBlock (
     goto FREE_BUFFER;
   }
 
+  //
+  // Check whether the data structure used by the host controller
+  // should be restricted into the same 4G
+  //
+  if (Pool->Check4G &&
+      ((Pool->Which4G != USBHC_HIGH_32BIT (MappedAddr)) ||
+       (Pool->Which4G != USBHC_HIGH_32BIT (MappedAddr + Bytes - 1))))
+  {
+    PciIo->Unmap (PciIo, Mapping);
+    goto FREE_BUFFER;
+  }
+
   Block->BufHost = BufHost;
   Block->Buf     = (UINT8 *)((UINTN)MappedAddr);
   Block->Mapping = Mapping;
 
+  Pool->Stats.Blocks++;
   return Block;
 
 FREE_BUFFER:
   PciIo->FreeBuffer (PciIo, Pages, BufHost);
 
-FREE_BITARRAY:
-  gBS->FreePool (Block->Bits);
+FREE_BLOCK:
   gBS->FreePool (Block);
   return NULL;
 }
@@ -125,80 +129,158 @@ UsbHcFreeMemBlock (
   PciIo->Unmap (PciIo, Block->Mapping);
   PciIo->FreeBuffer (PciIo, EFI_SIZE_TO_PAGES (Block->BufLen), Block->BufHost);
 
-  gBS->FreePool (Block->Bits);
   gBS->FreePool (Block);
 }
 
 /**
-  Alloc some memory from the block.
+  Insert the memory block to the pool's list of the blocks.
 
-  @param  Block          The memory block to allocate memory from.
-  @param  Units          Number of memory units to allocate.
+  @param  Head           The head of the memory pool's block list.
+  @param  Block          The memory block to insert.
+
+**/
+VOID
+UsbHcInsertMemBlockToPool (
+  IN USBHC_MEM_BLOCK  *Head,
+  IN USBHC_MEM_BLOCK  *Block
+  )
+{
+  ASSERT ((Head != NULL) && (Block != NULL));
+  Block->Next = Head->Next;
+  Head->Next  = Block;
+}
+
+/**
+  Unlink the memory block from the pool's list.
 
-  @return The pointer to the allocated memory. If couldn't allocate the needed memory,
-          the return value is NULL.
+  @param  Head           The block list head of the memory's pool.
+  @param  BlockToUnlink  The memory block to unlink.
 
 **/
-VOID *
-UsbHcAllocMemFromBlock (
-  IN  USBHC_MEM_BLOCK  *Block,
-  IN  UINTN            Units
+VOID
+UsbHcUnlinkMemBlock (
+  IN USBHC_MEM_BLOCK  *Head,
+  IN USBHC_MEM_BLOCK  *BlockToUnlink
   )
 {
-  UINTN  Byte;
-  UINT8  Bit;
-  UINTN  StartByte;
-  UINT8  StartBit;
-  UINTN  Available;
-  UINTN  Count;
+  USBHC_MEM_BLOCK  *Block;
 
-  ASSERT ((Block != 0) && (Units != 0));
+  ASSERT ((Head != NULL) && (BlockToUnlink != NULL));
 
-  StartByte = 0;
-  StartBit  = 0;
-  Available = 0;
+  for (Block = Head; Block != NULL; Block = Block->Next) {
+    if (Block->Next == BlockToUnlink) {
+      Block->Next         = BlockToUnlink->Next;
+      BlockToUnlink->Next = NULL;
+      break;
+    }
+  }
+}
 
-  for (Byte = 0, Bit = 0; Byte < Block->BitsLen;) {
-    //
-    // If current bit is zero, the corresponding memory unit is
-    // available, otherwise we need to restart our searching.
-    // Available counts the consective number of zero bit.
-    //
-    if (!USB_HC_BIT_IS_SET (Block->Bits[Byte], Bit)) {
-      Available++;
+/**
+  Find the memory block that completely contains a memory region.
 
-      if (Available >= Units) {
-        break;
-      }
+  @param  Pool           The memory pool of the host controller.
+  @param  Mem            The start of the memory region.
+  @param  Size           The size of the memory region.
+  @param  PciAddress     TRUE if Mem is a pci address, FALSE if it is a host address.
 
-      NEXT_BIT (Byte, Bit);
-    } else {
-      NEXT_BIT (Byte, Bit);
+  @return The memory block or NULL if the region isn't in the pool.
 
-      Available = 0;
-      StartByte = Byte;
-      StartBit  = Bit;
+**/
+USBHC_MEM_BLOCK *
+UsbHcFindMemBlock (
+  IN USBHC_MEM_POOL  *Pool,
+  IN VOID            *Mem,
+  IN UINTN           Size,
+  IN BOOLEAN         PciAddress
+  )
+{
+  USBHC_MEM_BLOCK  *Block;
+  UINT8            *Buf;
+
+  for (Block = Pool->Head; Block != NULL; Block = Block->Next) {
+    Buf = PciAddress ? Block->Buf : Block->BufHost;
+    if ((Buf <= (UINT8 *)Mem) && (((UINT8 *)Mem + Size) <= (Buf + Block->BufLen))) {
+      return Block;
     }
   }
 
-  if (Available < Units) {
-    return NULL;
+  return NULL;
+}
+
+/**
+  Return the size class of an allocation.
+
+  @param  Size           The size of the allocation, at most one page.
+
+  @return The index of the smallest size class that can hold Size bytes.
+
+**/
+UINTN
+UsbHcSizeToClass (
+  IN UINTN  Size
+  )
+{
+  UINTN  Class;
+
+  ASSERT (Size <= EFI_PAGE_SIZE);
+
+  for (Class = 0; (UINTN)(USBHC_MEM_UNIT << Class) < Size; Class++) {
   }
 
-  //
-  // Mark the memory as allocated
-  //
-  Byte = StartByte;
-  Bit  = StartBit;
+  return Class;
+}
+
+/**
+  Give one more page to a size class and split it into free units.
+
+  @param  Pool           The memory pool of the host controller.
+  @param  Class          The size class to refill.
 
-  for (Count = 0; Count < Units; Count++) {
-    ASSERT (!USB_HC_BIT_IS_SET (Block->Bits[Byte], Bit));
+  @retval EFI_SUCCESS           The free list of the class is refilled.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate a new memory block.
+
+**/
+EFI_STATUS
+UsbHcRefillClass (
+  IN USBHC_MEM_POOL  *Pool,
+  IN UINTN           Class
+  )
+{
+  USBHC_MEM_BLOCK  *Block;
+  USBHC_MEM_CHUNK  *Chunk;
+  UINT8            *Page;
+  UINTN            UnitSize;
+  UINTN            Offset;
 
-    Block->Bits[Byte] = (UINT8)(Block->Bits[Byte] | USB_HC_BIT (Bit));
-    NEXT_BIT (Byte, Bit);
+  Block = Pool->Current;
+
+  if (Block->Used >= Block->BufLen) {
+    Block = UsbHcAllocMemBlock (Pool, USBHC_MEM_DEFAULT_PAGES);
+    if (Block == NULL) {
+      DEBUG ((DEBUG_ERROR, "UsbHcAllocateMem: failed to allocate block\n"));
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    UsbHcInsertMemBlockToPool (Pool->Head, Block);
+    Pool->Current = Block;
+  }
+
+  Page         = Block->BufHost + Block->Used;
+  Block->Used += EFI_PAGE_SIZE;
+  UnitSize     = USBHC_MEM_UNIT << Class;
+
+  //
+  // Link the units in address order, so that consecutive allocations
+  // are handed out from ascending addresses.
+  //
+  for (Offset = EFI_PAGE_SIZE; Offset > 0; Offset -= UnitSize) {
+    Chunk                 = (USBHC_MEM_CHUNK *)(Page + Offset - UnitSize);
+    Chunk->Next           = Pool->FreeList[Class];
+    Pool->FreeList[Class] = Chunk;
   }
 
-  return Block->BufHost + (StartByte * 8 + StartBit) * USBHC_MEM_UNIT;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -212,42 +294,31 @@ UsbHcAllocMemFromBlock (
 
 **/
 EFI_PHYSICAL_ADDRESS
+EFIAPI
 UsbHcGetPciAddrForHostAddr (
   IN USBHC_MEM_POOL  *Pool,
   IN VOID            *Mem,
   IN UINTN           Size
   )
 {
-  USBHC_MEM_BLOCK       *Head;
-  USBHC_MEM_BLOCK       *Block;
-  UINTN                 AllocSize;
-  EFI_PHYSICAL_ADDRESS  PhyAddr;
-  UINTN                 Offset;
-
-  Head      = Pool->Head;
-  AllocSize = USBHC_MEM_ROUND (Size);
+  USBHC_MEM_BLOCK  *Block;
+  UINTN            Offset;
 
   if (Mem == NULL) {
     return 0;
   }
 
-  for (Block = Head; Block != NULL; Block = Block->Next) {
-    //
-    // scan the memory block list for the memory block that
-    // completely contains the allocated memory.
-    //
-    if ((Block->BufHost <= (UINT8 *)Mem) && (((UINT8 *)Mem + AllocSize) <= (Block->BufHost + Block->BufLen))) {
-      break;
-    }
+  Block = UsbHcFindMemBlock (Pool, Mem, Size, FALSE);
+  ASSERT ((Block != NULL));
+  if (Block == NULL) {
+    return 0;
   }
 
-  ASSERT ((Block != NULL));
   //
   // calculate the pci memory address for host memory address.
   //
-  Offset  = (UINT8 *)Mem - Block->BufHost;
-  PhyAddr = (EFI_PHYSICAL_ADDRESS)(UINTN)(Block->Buf + Offset);
-  return PhyAddr;
+  Offset = (UINT8 *)Mem - Block->BufHost;
+  return (EFI_PHYSICAL_ADDRESS)(UINTN)(Block->Buf + Offset);
 }
 
 /**
@@ -261,143 +332,82 @@ UsbHcGetPciAddrForHostAddr (
 
 **/
 EFI_PHYSICAL_ADDRESS
+EFIAPI
 UsbHcGetHostAddrForPciAddr (
   IN USBHC_MEM_POOL  *Pool,
   IN VOID            *Mem,
   IN UINTN           Size
   )
 {
-  USBHC_MEM_BLOCK       *Head;
-  USBHC_MEM_BLOCK       *Block;
-  UINTN                 AllocSize;
-  EFI_PHYSICAL_ADDRESS  HostAddr;
-  UINTN                 Offset;
-
-  Head      = Pool->Head;
-  AllocSize = USBHC_MEM_ROUND (Size);
+  USBHC_MEM_BLOCK  *Block;
+  UINTN            Offset;
 
   if (Mem == NULL) {
     return 0;
   }
 
-  for (Block = Head; Block != NULL; Block = Block->Next) {
-    //
-    // scan the memory block list for the memory block that
-    // completely contains the allocated memory.
-    //
-    if ((Block->Buf <= (UINT8 *)Mem) && (((UINT8 *)Mem + AllocSize) <= (Block->Buf + Block->BufLen))) {
-      break;
-    }
+  Block = UsbHcFindMemBlock (Pool, Mem, Size, TRUE);
+  ASSERT ((Block != NULL));
+  if (Block == NULL) {
+    return 0;
   }
 
-  ASSERT ((Block != NULL));
   //
-  // calculate the pci memory address for host memory address.
+  // calculate the host memory address for pci memory address.
   //
-  Offset   = (UINT8 *)Mem - Block->Buf;
-  HostAddr = (EFI_PHYSICAL_ADDRESS)(UINTN)(Block->BufHost + Offset);
-  return HostAddr;
-}
-
-/**
-  Insert the memory block to the pool's list of the blocks.
-
-  @param  Head           The head of the memory pool's block list.
-  @param  Block          The memory block to insert.
-
-**/
-VOID
-UsbHcInsertMemBlockToPool (
-  IN USBHC_MEM_BLOCK  *Head,
-  IN USBHC_MEM_BLOCK  *Block
-  )
-{
-  ASSERT ((Head != NULL) && (Block != NULL));
-  Block->Next = Head->Next;
-  Head->Next  = Block;
-}
-
-/**
-  Is the memory block empty?
-
-  @param  Block   The memory block to check.
-
-  @retval TRUE    The memory block is empty.
-  @retval FALSE   The memory block isn't empty.
-
-**/
-BOOLEAN
-UsbHcIsMemBlockEmpty (
-  IN USBHC_MEM_BLOCK  *Block
-  )
-{
-  UINTN  Index;
-
-  for (Index = 0; Index < Block->BitsLen; Index++) {
-    if (Block->Bits[Index] != 0) {
-      return FALSE;
-    }
-  }
-
-  return TRUE;
-}
-
-/**
-  Unlink the memory block from the pool's list.
-
-  @param  Head           The block list head of the memory's pool.
-  @param  BlockToUnlink  The memory block to unlink.
-
-**/
-VOID
-UsbHcUnlinkMemBlock (
-  IN USBHC_MEM_BLOCK  *Head,
-  IN USBHC_MEM_BLOCK  *BlockToUnlink
-  )
-{
-  USBHC_MEM_BLOCK  *Block;
-
-  ASSERT ((Head != NULL) && (BlockToUnlink != NULL));
-
-  for (Block = Head; Block != NULL; Block = Block->Next) {
-    if (Block->Next == BlockToUnlink) {
-      Block->Next         = BlockToUnlink->Next;
-      BlockToUnlink->Next = NULL;
-      break;
-    }
-  }
+  Offset = (UINT8 *)Mem - Block->Buf;
+  return (EFI_PHYSICAL_ADDRESS)(UINTN)(Block->BufHost + Offset);
 }
 
 /**
   Initialize the memory management pool for the host controller.
 
   @param  PciIo                The PciIo that can be used to access the host controller.
+  @param  Check4G              Whether the host controller requires allocated memory
+                               from one 4G address space.
+  @param  Which4G              The 4G memory area each memory allocated should be from.
 
-  @retval EFI_SUCCESS          The memory pool is initialized.
-  @retval EFI_OUT_OF_RESOURCE  Fail to init the memory pool.
+  @return The initialized memory pool, or NULL if there are not enough resources.
 
 **/
 USBHC_MEM_POOL *
+EFIAPI
 UsbHcInitMemPool (
-  IN EFI_PCI_IO_PROTOCOL  *PciIo
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN BOOLEAN              Check4G,
+  IN UINT32               Which4G
   )
 {
-  USBHC_MEM_POOL  *Pool;
+  USBHC_MEM_POOL        *Pool;
+  EDKII_IOMMU_PROTOCOL  *IoMmu;
+  EFI_STATUS            Status;
 
-  Pool = AllocatePool (sizeof (USBHC_MEM_POOL));
+  Pool = AllocateZeroPool (sizeof (USBHC_MEM_POOL));
 
   if (Pool == NULL) {
     return Pool;
   }
 
-  Pool->PciIo = PciIo;
-  Pool->Head  = UsbHcAllocMemBlock (Pool, USBHC_MEM_DEFAULT_PAGES);
+  Pool->PciIo   = PciIo;
+  Pool->Check4G = Check4G;
+  Pool->Which4G = Which4G;
+  Pool->Head    = UsbHcAllocMemBlock (Pool, USBHC_MEM_DEFAULT_PAGES);
 
   if (Pool->Head == NULL) {
     gBS->FreePool (Pool);
-    Pool = NULL;
+    return NULL;
   }
 
+  Pool->Current = Pool->Head;
+
+  //
+  // Behind an IOMMU every PciIo->Map() of a transfer buffer may set up
+  // a new translation or bounce the data through a freshly allocated
+  // buffer. Stage transfer data in buffers that stay mapped instead.
+  //
+  Status            = gBS->LocateProtocol (&gEdkiiIoMmuProtocolGuid, NULL, (VOID **)&IoMmu);
+  Pool->BounceCache = (BOOLEAN)(!EFI_ERROR (Status));
+
   return Pool;
 }
 
@@ -411,6 +421,7 @@ UsbHcInitMemPool (
 
 **/
 EFI_STATUS
+EFIAPI
 UsbHcFreeMemPool (
   IN USBHC_MEM_POOL  *Pool
   )
@@ -419,6 +430,24 @@ UsbHcFreeMemPool (
 
   ASSERT (Pool->Head != NULL);
 
+  DEBUG ((
+    DEBUG_INFO,
+    "UsbHcFreeMemPool: %d allocations, %d frees, %d blocks, peak %d bytes in use\n",
+    Pool->Stats.Allocations,
+    Pool->Stats.Frees,
+    Pool->Stats.Blocks,
+    Pool->Stats.PeakBytesInUse
+    ));
+  DEBUG ((
+    DEBUG_INFO,
+    "UsbHcFreeMemPool: %d transfers (%d bytes) bounced, %d transfers mapped\n",
+    Pool->Stats.BounceMaps,
+    Pool->Stats.BounceBytes,
+    Pool->Stats.DirectMaps
+    ));
+
+  UsbHcFreeBounceBuffers (Pool);
+
   //
   // Unlink all the memory blocks from the pool, then free them.
   // UsbHcUnlinkMemBlock can't be used to unlink and free the
@@ -438,6 +467,9 @@ UsbHcFreeMemPool (
   Allocate some memory from the host controller's memory pool
   which can be used to communicate with host controller.
 
+  The memory is zeroed and aligned on 64 bytes. Allocations of up to
+  one page never cross a page boundary.
+
   @param  Pool           The host controller's memory pool.
   @param  Size           Size of the memory to allocate.
 
@@ -445,69 +477,60 @@ UsbHcFreeMemPool (
 
 **/
 VOID *
+EFIAPI
 UsbHcAllocateMem (
   IN  USBHC_MEM_POOL  *Pool,
   IN  UINTN           Size
   )
 {
-  USBHC_MEM_BLOCK  *Head;
   USBHC_MEM_BLOCK  *Block;
-  USBHC_MEM_BLOCK  *NewBlock;
-  VOID             *Mem;
+  USBHC_MEM_CHUNK  *Chunk;
+  UINTN            Class;
   UINTN            AllocSize;
-  UINTN            Pages;
 
-  Mem       = NULL;
-  AllocSize = USBHC_MEM_ROUND (Size);
-  Head      = Pool->Head;
-  ASSERT (Head != NULL);
+  ASSERT (Pool->Head != NULL);
 
-  //
-  // First check whether current memory blocks can satisfy the allocation.
-  //
-  for (Block = Head; Block != NULL; Block = Block->Next) {
-    Mem = UsbHcAllocMemFromBlock (Block, AllocSize / USBHC_MEM_UNIT);
+  if (Size == 0) {
+    return NULL;
+  }
 
-    if (Mem != NULL) {
-      ZeroMem (Mem, Size);
-      break;
+  if (Size > EFI_PAGE_SIZE) {
+    //
+    // Large allocations get a memory block of their own, which is
+    // released as soon as the memory is freed.
+    //
+    Block = UsbHcAllocMemBlock (Pool, EFI_SIZE_TO_PAGES (Size));
+    if (Block == NULL) {
+      DEBUG ((DEBUG_ERROR, "UsbHcAllocateMem: failed to allocate block\n"));
+      return NULL;
     }
-  }
 
-  if (Mem != NULL) {
-    return Mem;
-  }
+    Block->Large = TRUE;
+    Block->Used  = Block->BufLen;
+    UsbHcInsertMemBlockToPool (Pool->Head, Block);
 
-  //
-  // Create a new memory block if there is not enough memory
-  // in the pool. If the allocation size is larger than the
-  // default page number, just allocate a large enough memory
-  // block. Otherwise allocate default pages.
-  //
-  if (AllocSize > EFI_PAGES_TO_SIZE (USBHC_MEM_DEFAULT_PAGES)) {
-    Pages = EFI_SIZE_TO_PAGES (AllocSize) + 1;
+    Chunk     = (USBHC_MEM_CHUNK *)Block->BufHost;
+    AllocSize = Block->BufLen;
   } else {
-    Pages = USBHC_MEM_DEFAULT_PAGES;
-  }
+    Class = UsbHcSizeToClass (Size);
 
-  NewBlock = UsbHcAllocMemBlock (Pool, Pages);
+    if ((Pool->FreeList[Class] == NULL) && EFI_ERROR (UsbHcRefillClass (Pool, Class))) {
+      return NULL;
+    }
 
-  if (NewBlock == NULL) {
-    DEBUG ((DEBUG_ERROR, "UsbHcAllocateMem: failed to allocate block\n"));
-    return NULL;
+    Chunk                 = Pool->FreeList[Class];
+    Pool->FreeList[Class] = Chunk->Next;
+    AllocSize             = USBHC_MEM_UNIT << Class;
   }
 
-  //
-  // Add the new memory block to the pool, then allocate memory from it
-  //
-  UsbHcInsertMemBlockToPool (Head, NewBlock);
-  Mem = UsbHcAllocMemFromBlock (NewBlock, AllocSize / USBHC_MEM_UNIT);
-
-  if (Mem != NULL) {
-    ZeroMem (Mem, Size);
+  Pool->Stats.Allocations++;
+  Pool->Stats.BytesInUse += AllocSize;
+  if (Pool->Stats.BytesInUse > Pool->Stats.PeakBytesInUse) {
+    Pool->Stats.PeakBytesInUse = Pool->Stats.BytesInUse;
   }
 
-  return Mem;
+  ZeroMem (Chunk, Size);
+  return Chunk;
 }
 
 /**
@@ -515,70 +538,54 @@ UsbHcAllocateMem (
 
   @param  Pool           The memory pool of the host controller.
   @param  Mem            The memory to free.
-  @param  Size           The size of the memory to free.
+  @param  Size           The size of the memory to free, it must be the
+                         size passed to UsbHcAllocateMem().
 
 **/
 VOID
+EFIAPI
 UsbHcFreeMem (
   IN USBHC_MEM_POOL  *Pool,
   IN VOID            *Mem,
   IN UINTN           Size
   )
 {
-  USBHC_MEM_BLOCK  *Head;
   USBHC_MEM_BLOCK  *Block;
-  UINT8            *ToFree;
-  UINTN            AllocSize;
-  UINTN            Byte;
-  UINTN            Bit;
-  UINTN            Count;
+  USBHC_MEM_CHUNK  *Chunk;
+  UINTN            Class;
 
-  Head      = Pool->Head;
-  AllocSize = USBHC_MEM_ROUND (Size);
-  ToFree    = (UINT8 *)Mem;
-
-  for (Block = Head; Block != NULL; Block = Block->Next) {
-    //
-    // scan the memory block list for the memory block that
-    // completely contains the memory to free.
-    //
-    if ((Block->BufHost <= ToFree) && ((ToFree + AllocSize) <= (Block->BufHost + Block->BufLen))) {
-      //
-      // compute the start byte and bit in the bit array
-      //
-      Byte = ((ToFree - Block->BufHost) / USBHC_MEM_UNIT) / 8;
-      Bit  = ((ToFree - Block->BufHost) / USBHC_MEM_UNIT) % 8;
+  if ((Mem == NULL) || (Size == 0)) {
+    return;
+  }
 
-      //
-      // reset associated bits in bit array
-      //
-      for (Count = 0; Count < (AllocSize / USBHC_MEM_UNIT); Count++) {
-        ASSERT (USB_HC_BIT_IS_SET (Block->Bits[Byte], Bit));
+  Pool->Stats.Frees++;
 
-        Block->Bits[Byte] = (UINT8)(Block->Bits[Byte] ^ USB_HC_BIT (Bit));
-        NEXT_BIT (Byte, Bit);
-      }
+  if (Size > EFI_PAGE_SIZE) {
+    Block = UsbHcFindMemBlock (Pool, Mem, Size, FALSE);
 
-      break;
+    //
+    // If Block == NULL, it means that the current memory isn't
+    // in the host controller's pool. This is critical because
+    // the caller has passed in a wrong memory point
+    //
+    ASSERT ((Block != NULL) && Block->Large && (Block->BufHost == Mem));
+    if ((Block == NULL) || !Block->Large) {
+      return;
     }
-  }
-
-  //
-  // If Block == NULL, it means that the current memory isn't
-  // in the host controller's pool. This is critical because
-  // the caller has passed in a wrong memory point
-  //
-  ASSERT (Block != NULL);
 
-  //
-  // Release the current memory block if it is empty and not the head
-  //
-  if ((Block != Head) && UsbHcIsMemBlockEmpty (Block)) {
-    UsbHcUnlinkMemBlock (Head, Block);
+    Pool->Stats.BytesInUse -= Block->BufLen;
+    UsbHcUnlinkMemBlock (Pool->Head, Block);
     UsbHcFreeMemBlock (Pool, Block);
+    return;
   }
 
-  return;
+  ASSERT (UsbHcFindMemBlock (Pool, Mem, Size, FALSE) != NULL);
+
+  Class                   = UsbHcSizeToClass (Size);
+  Chunk                   = (USBHC_MEM_CHUNK *)Mem;
+  Chunk->Next             = Pool->FreeList[Class];
+  Pool->FreeList[Class]   = Chunk;
+  Pool->Stats.BytesInUse -= USBHC_MEM_UNIT << Class;
 }
 
 /**
@@ -598,9 +605,9 @@ UsbHcFreeMem (
   @retval EFI_INVALID_PARAMETER Pages or Alignment is not valid.
   @retval EFI_OUT_OF_RESOURCES  Do not have enough resources to allocate memory.
 
-
 **/
 EFI_STATUS
+EFIAPI
 UsbHcAllocateAlignedPages (
   IN EFI_PCI_IO_PROTOCOL    *PciIo,
   IN UINTN                  Pages,
@@ -722,11 +729,12 @@ UsbHcAllocateAlignedPages (
 
 **/
 VOID
+EFIAPI
 UsbHcFreeAlignedPages (
   IN EFI_PCI_IO_PROTOCOL  *PciIo,
   IN VOID                 *HostAddress,
   IN UINTN                Pages,
-  VOID                    *Mapping
+  IN VOID                 *Mapping
   )
 {
   EFI_STATUS  Status;
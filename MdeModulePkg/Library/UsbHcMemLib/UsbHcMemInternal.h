@@ -0,0 +1,112 @@
+/** @file
+
+  Internal definitions of the USB host controller DMA memory library.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _USB_HC_MEM_INTERNAL_H_
+#define _USB_HC_MEM_INTERNAL_H_
+
+#include <Uefi.h>
+
+#include <Protocol/IoMmu.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UsbHcMemLib.h>
+
+//
+// Memory is handed out in power of two size classes, from the
+// smallest one USBHC_MEM_UNIT up to one page. The allocation unit
+// also gives the alignment of all the allocations.
+//
+#define USBHC_MEM_UNIT_SHIFT     6
+#define USBHC_MEM_UNIT           (1 << USBHC_MEM_UNIT_SHIFT)
+#define USBHC_MEM_CLASS_NUMBER   (EFI_PAGE_SHIFT - USBHC_MEM_UNIT_SHIFT + 1)
+#define USBHC_MEM_DEFAULT_PAGES  16
+
+#define USBHC_HIGH_32BIT(Addr64)  ((UINT32)(RShiftU64((UINTN)(Addr64), 32) & 0XFFFFFFFF))
+
+//
+// Transfer buffers larger than USBHC_BOUNCE_MAX_PAGES are mapped
+// with PciIo->Map() even when the bounce buffer cache is enabled.
+//
+#define USBHC_BOUNCE_BUFFER_NUMBER  8
+#define USBHC_BOUNCE_MAX_PAGES      16
+
+//
+// A free memory unit is linked to the free list of its size class
+// through its first bytes.
+//
+typedef struct _USBHC_MEM_CHUNK USBHC_MEM_CHUNK;
+struct _USBHC_MEM_CHUNK {
+  USBHC_MEM_CHUNK    *Next;
+};
+
+typedef struct _USBHC_MEM_BLOCK USBHC_MEM_BLOCK;
+struct _USBHC_MEM_BLOCK {
+  UINT8              *Buf;
+  UINT8              *BufHost;
+  UINTN              BufLen;        // Memory size in bytes
+  UINTN              Used;          // Bytes handed to the size classes
+  BOOLEAN            Large;         // Block holds one large allocation
+  VOID               *Mapping;
+  USBHC_MEM_BLOCK    *Next;
+};
+
+typedef struct {
+  VOID                             *HostAddress;
+  EFI_PHYSICAL_ADDRESS             DeviceAddress;
+  UINTN                            Pages;
+  VOID                             *Mapping;
+  BOOLEAN                          InUse;
+  EFI_PCI_IO_PROTOCOL_OPERATION    Operation;
+  VOID                             *UserAddress;
+  UINTN                            Length;
+} USBHC_BOUNCE_BUFFER;
+
+typedef struct {
+  UINTN    Allocations;
+  UINTN    Frees;
+  UINTN    Blocks;
+  UINTN    BytesInUse;
+  UINTN    PeakBytesInUse;
+  UINTN    BounceMaps;
+  UINTN    BounceBytes;
+  UINTN    DirectMaps;
+} USBHC_MEM_STATISTICS;
+
+//
+// USBHC_MEM_POOL is used to manage the memory used by USB
+// host controller. EHCI requires the control memory and transfer
+// data to be on the same 4G memory.
+//
+struct _USBHC_MEM_POOL {
+  EFI_PCI_IO_PROTOCOL     *PciIo;
+  BOOLEAN                 Check4G;
+  UINT32                  Which4G;
+  USBHC_MEM_BLOCK         *Head;
+  USBHC_MEM_BLOCK         *Current;   // Block that new class pages come from
+  USBHC_MEM_CHUNK         *FreeList[USBHC_MEM_CLASS_NUMBER];
+  BOOLEAN                 BounceCache;
+  USBHC_BOUNCE_BUFFER     Bounce[USBHC_BOUNCE_BUFFER_NUMBER];
+  USBHC_MEM_STATISTICS    Stats;
+};
+
+/**
+  Release the bounce buffers of the pool.
+
+  @param  Pool           The memory pool of the host controller.
+
+**/
+VOID
+UsbHcFreeBounceBuffers (
+  IN USBHC_MEM_POOL  *Pool
+  );
+
+#endif
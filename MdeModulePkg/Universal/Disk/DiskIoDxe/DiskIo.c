@@ -48,6 +48,11 @@ DISK_IO_PRIVATE_DATA  gDiskIoPrivateDataTemplate = {
   }
 };
 
+//
+// TRUE if the performance counter counts down.
+//
+BOOLEAN  mDiskIoPerformanceCounterDown;
+
 /**
   Test to see if this driver supports ControllerHandle.
 
@@ -325,6 +330,8 @@ DiskIoDriverBindingStop (
       EfiReleaseLock (&Instance->TaskQueueLock);
     } while (!AllTaskDone);
 
+    DiskIoDumpStatistics (Instance);
+
     FreeAlignedPages (
       Instance->SharedWorkingBuffer,
       EFI_SIZE_TO_PAGES (PcdGet32 (PcdDiskIoDataBufferBlockNum) * Instance->BlockIo->Media->BlockSize)
@@ -353,6 +360,101 @@ DiskIoDriverBindingStop (
   return Status;
 }
 
+/**
+  Get the time elapsed since the performance counter read StartTick.
+
+  @param StartTick   The performance counter value at the start of the interval.
+
+  @return The elapsed time in nanoseconds.
+**/
+UINT64
+DiskIoGetElapsedTime (
+  IN UINT64  StartTick
+  )
+{
+  UINT64  EndTick;
+
+  EndTick = GetPerformanceCounter ();
+  return GetTimeInNanoSecond (mDiskIoPerformanceCounterDown ? StartTick - EndTick : EndTick - StartTick);
+}
+
+/**
+  Account one completed caller request in the device statistics.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param StartTick   The performance counter value when the request was submitted.
+  @param Status      The final status of the request.
+**/
+VOID
+DiskIoRecordRequest (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                StartTick,
+  IN EFI_STATUS            Status
+  )
+{
+  UINT64  Latency;
+
+  Latency = DiskIoGetElapsedTime (StartTick);
+
+  Instance->Statistics.Requests++;
+  if (EFI_ERROR (Status)) {
+    Instance->Statistics.FailedRequests++;
+  }
+
+  Instance->Statistics.TotalLatencyNs += Latency;
+  if (Latency > Instance->Statistics.MaxLatencyNs) {
+    Instance->Statistics.MaxLatencyNs = Latency;
+  }
+}
+
+/**
+  Account one subtask about to be submitted to BlockIo2 in the device statistics.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoRecordSubtaskSubmit (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  UINT32  InFlight;
+
+  InFlight = InterlockedIncrement (&Instance->Statistics.InFlight);
+  if (InFlight > Instance->Statistics.MaxInFlight) {
+    Instance->Statistics.MaxInFlight = InFlight;
+  }
+}
+
+/**
+  Dump the device statistics.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoDumpStatistics (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  DISK_IO_STATISTICS  *Statistics;
+
+  Statistics = &Instance->Statistics;
+  if (Statistics->Requests == 0) {
+    return;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "DiskIo: Requests/Failed/Pipelined/Subtasks = %ld/%ld/%ld/%ld, MaxQueueDepth = %d, Latency(us) Avg/Max = %ld/%ld\n",
+    Statistics->Requests,
+    Statistics->FailedRequests,
+    Statistics->PipelinedRequests,
+    Statistics->SubmittedSubtasks,
+    Statistics->MaxInFlight,
+    DivU64x64Remainder (Statistics->TotalLatencyNs, Statistics->Requests, NULL) / 1000,
+    Statistics->MaxLatencyNs / 1000
+    ));
+}
+
 /**
   Destroy the sub task.
 
@@ -425,6 +527,8 @@ DiskIo2OnReadWriteComplete (
   ASSERT (Instance->Signature == DISK_IO_PRIVATE_DATA_SIGNATURE);
   ASSERT (Task->Signature     == DISK_IO2_TASK_SIGNATURE);
 
+  InterlockedDecrement (&Instance->Statistics.InFlight);
+
   if ((Subtask->WorkingBuffer != NULL) && !EFI_ERROR (TransactionStatus) &&
       (Task->Token != NULL) && !Subtask->Write
       )
@@ -442,6 +546,9 @@ DiskIo2OnReadWriteComplete (
       //
       Task->Token->TransactionStatus = TransactionStatus;
       gBS->SignalEvent (Task->Token->Event);
+      if (Task->Record) {
+        DiskIoRecordRequest (Instance, Task->StartTick, TransactionStatus);
+      }
 
       //
       // Mark token to NULL indicating the Task is a dead task.
@@ -814,7 +921,160 @@ DiskIo2RemoveCompletedTask (
 }
 
 /**
-  Common routine to access the disk.
+  Check whether a blocking request should be split into several BlockIo2
+  requests that are kept in flight simultaneously.
+
+  A blocking request whose buffer does not satisfy IoAlign is bounced through
+  SharedWorkingBuffer, PcdDiskIoDataBufferBlockNum blocks at a time, with the
+  device idle while each chunk is copied. Pipelining such requests keeps up to
+  PcdDiskIoPipelineDepth chunks queued on the device instead.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param BufferSize  The size in bytes of Buffer.
+  @param Buffer      A pointer to the buffer for the data.
+
+  @retval TRUE       The request should be pipelined.
+  @retval FALSE      The request should be processed by the regular blocking path.
+**/
+BOOLEAN
+DiskIoCanPipeline (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINTN                 BufferSize,
+  IN UINT8                 *Buffer
+  )
+{
+  UINT32  IoAlign;
+
+  if ((Instance->BlockIo2 == NULL) || (PcdGet32 (PcdDiskIoPipelineDepth) < 2)) {
+    return FALSE;
+  }
+
+  IoAlign = Instance->BlockIo->Media->IoAlign;
+  if ((IoAlign <= 1) || (ALIGN_POINTER (Buffer, IoAlign) == Buffer)) {
+    return FALSE;
+  }
+
+  if (BufferSize <= PcdGet32 (PcdDiskIoDataBufferBlockNum) * Instance->BlockIo->Media->BlockSize) {
+    return FALSE;
+  }
+
+  //
+  // BlockIo2 completions are signaled from timer events at TPL_CALLBACK or
+  // TPL_NOTIFY, so only poll for them when running below TPL_CALLBACK.
+  //
+  return (BOOLEAN)(EfiGetCurrentTpl () < TPL_CALLBACK);
+}
+
+/**
+  Access the disk by splitting a blocking request into chunks and keeping
+  several of them in flight through the BlockIo2 interface.
+
+  Each chunk ends on a block boundary so that no two outstanding chunks touch
+  the same block, which keeps the read-modify-write of unaligned writes safe.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Write       TRUE: Write operation; FALSE: Read operation.
+  @param MediaId     ID of the medium to access.
+  @param Offset      The starting byte offset on the logical block I/O device to access.
+  @param BufferSize  The size in bytes of Buffer.
+  @param Buffer      A pointer to the buffer for the data.
+
+  @retval EFI_SUCCESS           The data was transferred correctly.
+  @retval EFI_OUT_OF_RESOURCES  The request could not be completed due to a lack of resources.
+  @retval Others                The status of the first failed chunk.
+**/
+EFI_STATUS
+DiskIo2PipelinedReadWriteDisk (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN BOOLEAN               Write,
+  IN UINT32                MediaId,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize,
+  IN UINT8                 *Buffer
+  )
+{
+  EFI_STATUS             Status;
+  EFI_STATUS             SubmitStatus;
+  DISK_IO_PIPELINE_SLOT  *Slots;
+  UINT32                 Depth;
+  UINT32                 Index;
+  UINT32                 Busy;
+  UINT32                 BlockSize;
+  UINTN                  ChunkSize;
+  UINTN                  Length;
+
+  BlockSize = Instance->BlockIo->Media->BlockSize;
+  ChunkSize = PcdGet32 (PcdDiskIoDataBufferBlockNum) * BlockSize;
+  Depth     = PcdGet32 (PcdDiskIoPipelineDepth);
+
+  Slots = AllocateZeroPool (Depth * sizeof (DISK_IO_PIPELINE_SLOT));
+  if (Slots == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < Depth; Index++) {
+    Status = gBS->CreateEvent (0, TPL_NOTIFY, NULL, NULL, &Slots[Index].Token.Event);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
+  }
+
+  Instance->Statistics.PipelinedRequests++;
+  DEBUG ((DEBUG_BLKIO, "DiskIo: Pipeline request: Offset/BufferSize/Buffer = %016lx/%08x/%08x\n", Offset, BufferSize, Buffer));
+
+  Busy = 0;
+  do {
+    for (Index = 0; Index < Depth; Index++) {
+      if (Slots[Index].Busy) {
+        if (gBS->CheckEvent (Slots[Index].Token.Event) == EFI_NOT_READY) {
+          continue;
+        }
+
+        Slots[Index].Busy = FALSE;
+        Busy--;
+        if (!EFI_ERROR (Status)) {
+          Status = Slots[Index].Token.TransactionStatus;
+        }
+      }
+
+      //
+      // Stop feeding the pipeline once a chunk has failed, but still drain
+      // the outstanding chunks because their buffers belong to the caller.
+      //
+      if ((BufferSize == 0) || EFI_ERROR (Status)) {
+        continue;
+      }
+
+      Length       = MIN (BufferSize, ChunkSize - (UINTN)ModU64x32 (Offset, BlockSize));
+      SubmitStatus = DiskIo2ReadWriteDiskWorker (Instance, Write, MediaId, Offset, &Slots[Index].Token, Length, Buffer, FALSE);
+      if (EFI_ERROR (SubmitStatus)) {
+        Status = SubmitStatus;
+        continue;
+      }
+
+      Slots[Index].Busy = TRUE;
+      Busy++;
+      Offset     += Length;
+      Buffer     += Length;
+      BufferSize -= Length;
+    }
+  } while ((Busy != 0) || ((BufferSize != 0) && !EFI_ERROR (Status)));
+
+Exit:
+  for (Index = 0; Index < Depth; Index++) {
+    if (Slots[Index].Token.Event != NULL) {
+      gBS->CloseEvent (Slots[Index].Token.Event);
+    }
+  }
+
+  FreePool (Slots);
+  return Status;
+}
+
+/**
+  Submit a request to access the disk, without the pipelining of large
+  blocking requests done by DiskIo2ReadWriteDisk().
 
   @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
   @param Write       TRUE: Write operation; FALSE: Read operation.
@@ -825,16 +1085,19 @@ DiskIo2RemoveCompletedTask (
   @param  BufferSize            The size in bytes of Buffer. The number of bytes to read from the device.
   @param  Buffer                A pointer to the destination buffer for the data.
                                 The caller is responsible either having implicit or explicit ownership of the buffer.
+  @param Record      TRUE to account a successfully submitted non-blocking
+                     request in the device statistics when it completes.
 **/
 EFI_STATUS
-DiskIo2ReadWriteDisk (
+DiskIo2ReadWriteDiskWorker (
   IN DISK_IO_PRIVATE_DATA  *Instance,
   IN BOOLEAN               Write,
   IN UINT32                MediaId,
   IN UINT64                Offset,
   IN EFI_DISK_IO2_TOKEN    *Token,
   IN UINTN                 BufferSize,
-  IN UINT8                 *Buffer
+  IN UINT8                 *Buffer,
+  IN BOOLEAN               Record
   )
 {
   EFI_STATUS              Status;
@@ -850,13 +1113,15 @@ DiskIo2ReadWriteDisk (
   BOOLEAN                 Blocking;
   BOOLEAN                 SubtaskBlocking;
   LIST_ENTRY              *SubtasksPtr;
+  UINT64                  StartTick;
 
-  Task     = NULL;
-  BlockIo  = Instance->BlockIo;
-  BlockIo2 = Instance->BlockIo2;
-  Media    = BlockIo->Media;
-  Status   = EFI_SUCCESS;
-  Blocking = (BOOLEAN)((Token == NULL) || (Token->Event == NULL));
+  Task      = NULL;
+  BlockIo   = Instance->BlockIo;
+  BlockIo2  = Instance->BlockIo2;
+  Media     = BlockIo->Media;
+  Status    = EFI_SUCCESS;
+  Blocking  = (BOOLEAN)((Token == NULL) || (Token->Event == NULL));
+  StartTick = GetPerformanceCounter ();
 
   if (Blocking) {
     //
@@ -880,6 +1145,8 @@ DiskIo2ReadWriteDisk (
     Task->Signature = DISK_IO2_TASK_SIGNATURE;
     Task->Instance  = Instance;
     Task->Token     = Token;
+    Task->StartTick = StartTick;
+    Task->Record    = FALSE;
     EfiInitializeLock (&Task->SubtasksLock, TPL_NOTIFY);
 
     SubtasksPtr = &Task->Subtasks;
@@ -928,6 +1195,7 @@ DiskIo2ReadWriteDisk (
                             (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
                             );
       } else {
+        DiskIoRecordSubtaskSubmit (Instance);
         Status = BlockIo2->WriteBlocksEx (
                              BlockIo2,
                              MediaId,
@@ -953,6 +1221,7 @@ DiskIo2ReadWriteDisk (
           CopyMem (Subtask->Buffer, Subtask->WorkingBuffer + Subtask->Offset, Subtask->Length);
         }
       } else {
+        DiskIoRecordSubtaskSubmit (Instance);
         Status = BlockIo2->ReadBlocksEx (
                              BlockIo2,
                              MediaId,
@@ -964,6 +1233,11 @@ DiskIo2ReadWriteDisk (
       }
     }
 
+    Instance->Statistics.SubmittedSubtasks++;
+    if (!SubtaskBlocking && EFI_ERROR (Status)) {
+      InterlockedDecrement (&Instance->Statistics.InFlight);
+    }
+
     if (SubtaskBlocking || EFI_ERROR (Status)) {
       //
       // Make sure the subtask list only contains non-blocking subtasks.
@@ -990,6 +1264,19 @@ DiskIo2ReadWriteDisk (
     }
   }
 
+  //
+  // A non-blocking request that failed to be submitted is accounted by the
+  // caller. Otherwise account it when the last subtask completes, or now if
+  // that already happened before the TPL was raised.
+  //
+  if ((Task != NULL) && Record && !EFI_ERROR (Status)) {
+    if (Task->Token != NULL) {
+      Task->Record = TRUE;
+    } else {
+      DiskIoRecordRequest (Instance, StartTick, Token->TransactionStatus);
+    }
+  }
+
   //
   // It's possible that the non-blocking subtasks finish before raising TPL to NOTIFY,
   // so the subtasks list might be empty at this point.
@@ -1007,6 +1294,9 @@ DiskIo2ReadWriteDisk (
       DEBUG ((DEBUG_VERBOSE, "DiskIo: Non-blocking request was downgraded to blocking request, signal event directly.\n"));
       Task->Token->TransactionStatus = Status;
       gBS->SignalEvent (Task->Token->Event);
+      if (Task->Record) {
+        DiskIoRecordRequest (Instance, StartTick, Status);
+      }
     }
 
     FreePool (Task);
@@ -1017,6 +1307,57 @@ DiskIo2ReadWriteDisk (
   return Status;
 }
 
+/**
+  Common routine to access the disk.
+
+  Large blocking requests with an unaligned buffer are pipelined when
+  possible. Every call is accounted once in the device statistics.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Write       TRUE: Write operation; FALSE: Read operation.
+  @param MediaId     ID of the medium to access.
+  @param Offset      The starting byte offset on the logical block I/O device to access.
+  @param Token       A pointer to the token associated with the transaction.
+                     If this field is NULL, synchronous/blocking IO is performed.
+  @param  BufferSize            The size in bytes of Buffer. The number of bytes to read from the device.
+  @param  Buffer                A pointer to the destination buffer for the data.
+                                The caller is responsible either having implicit or explicit ownership of the buffer.
+**/
+EFI_STATUS
+DiskIo2ReadWriteDisk (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN BOOLEAN               Write,
+  IN UINT32                MediaId,
+  IN UINT64                Offset,
+  IN EFI_DISK_IO2_TOKEN    *Token,
+  IN UINTN                 BufferSize,
+  IN UINT8                 *Buffer
+  )
+{
+  EFI_STATUS  Status;
+  BOOLEAN     Blocking;
+  UINT64      StartTick;
+
+  Blocking  = (BOOLEAN)((Token == NULL) || (Token->Event == NULL));
+  StartTick = GetPerformanceCounter ();
+
+  if (Blocking && DiskIoCanPipeline (Instance, BufferSize, Buffer)) {
+    Status = DiskIo2PipelinedReadWriteDisk (Instance, Write, MediaId, Offset, BufferSize, Buffer);
+  } else {
+    Status = DiskIo2ReadWriteDiskWorker (Instance, Write, MediaId, Offset, Token, BufferSize, Buffer, TRUE);
+  }
+
+  //
+  // Successfully submitted non-blocking requests are accounted when they
+  // complete.
+  //
+  if (Blocking || EFI_ERROR (Status)) {
+    DiskIoRecordRequest (Instance, StartTick, Status);
+  }
+
+  return Status;
+}
+
 /**
   Reads a specified number of bytes from a device.
 
@@ -1298,6 +1639,11 @@ InitializeDiskIo (
   )
 {
   EFI_STATUS  Status;
+  UINT64      StartValue;
+  UINT64      EndValue;
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  mDiskIoPerformanceCounterDown = (BOOLEAN)(StartValue > EndValue);
 
   //
   // Install driver model protocol(s).
@@ -23,6 +23,23 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/BaseMemoryLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PcdLib.h>
+
+//
+// Per-device I/O statistics, dumped when the driver is stopped.
+//
+typedef struct {
+  UINT64    Requests;
+  UINT64    FailedRequests;
+  UINT64    PipelinedRequests;
+  UINT64    SubmittedSubtasks;
+  UINT64    TotalLatencyNs;
+  UINT64    MaxLatencyNs;
+  UINT32    InFlight;                       /// < Outstanding BlockIo2 subtasks
+  UINT32    MaxInFlight;
+} DISK_IO_STATISTICS;
 
 #define DISK_IO_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('d', 's', 'k', 'I')
 typedef struct {
@@ -37,6 +54,8 @@ typedef struct {
 
   EFI_LOCK                  TaskQueueLock;
   LIST_ENTRY                TaskQueue;
+
+  DISK_IO_STATISTICS        Statistics;
 } DISK_IO_PRIVATE_DATA;
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO(a)   CR (a, DISK_IO_PRIVATE_DATA, DiskIo,  DISK_IO_PRIVATE_DATA_SIGNATURE)
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO2(a)  CR (a, DISK_IO_PRIVATE_DATA, DiskIo2, DISK_IO_PRIVATE_DATA_SIGNATURE)
@@ -49,6 +68,8 @@ typedef struct {
   LIST_ENTRY              Subtasks;         /// < header of subtasks
   EFI_DISK_IO2_TOKEN      *Token;
   DISK_IO_PRIVATE_DATA    *Instance;
+  UINT64                  StartTick;        /// < Performance counter at submission
+  BOOLEAN                 Record;           /// < Account the request on completion
 } DISK_IO2_TASK;
 
 #define DISK_IO2_FLUSH_TASK_SIGNATURE  SIGNATURE_32 ('d', 'i', 'f', 't')
@@ -82,6 +103,15 @@ typedef struct {
   EFI_BLOCK_IO2_TOKEN    BlockIo2Token;
 } DISK_IO_SUBTASK;
 
+//
+// One slot of the pipeline used to split large blocking requests into
+// several concurrent BlockIo2 requests.
+//
+typedef struct {
+  EFI_DISK_IO2_TOKEN    Token;
+  BOOLEAN               Busy;
+} DISK_IO_PIPELINE_SLOT;
+
 //
 // Global Variables
 //
@@ -335,6 +365,67 @@ DiskIo2FlushDiskEx (
   IN OUT EFI_DISK_IO2_TOKEN  *Token
   );
 
+/**
+  Common routine to access the disk.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Write       TRUE: Write operation; FALSE: Read operation.
+  @param MediaId     ID of the medium to access.
+  @param Offset      The starting byte offset on the logical block I/O device to access.
+  @param Token       A pointer to the token associated with the transaction.
+                     If this field is NULL, synchronous/blocking IO is performed.
+  @param  BufferSize            The size in bytes of Buffer. The number of bytes to read from the device.
+  @param  Buffer                A pointer to the destination buffer for the data.
+                                The caller is responsible either having implicit or explicit ownership of the buffer.
+**/
+EFI_STATUS
+DiskIo2ReadWriteDisk (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN BOOLEAN               Write,
+  IN UINT32                MediaId,
+  IN UINT64                Offset,
+  IN EFI_DISK_IO2_TOKEN    *Token,
+  IN UINTN                 BufferSize,
+  IN UINT8                 *Buffer
+  );
+
+/**
+  Submit a request to access the disk, without the pipelining of large
+  blocking requests done by DiskIo2ReadWriteDisk().
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Write       TRUE: Write operation; FALSE: Read operation.
+  @param MediaId     ID of the medium to access.
+  @param Offset      The starting byte offset on the logical block I/O device to access.
+  @param Token       A pointer to the token associated with the transaction.
+                     If this field is NULL, synchronous/blocking IO is performed.
+  @param BufferSize  The size in bytes of Buffer.
+  @param Buffer      A pointer to the buffer for the data.
+  @param Record      TRUE to account a successfully submitted non-blocking
+                     request in the device statistics when it completes.
+**/
+EFI_STATUS
+DiskIo2ReadWriteDiskWorker (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN BOOLEAN               Write,
+  IN UINT32                MediaId,
+  IN UINT64                Offset,
+  IN EFI_DISK_IO2_TOKEN    *Token,
+  IN UINTN                 BufferSize,
+  IN UINT8                 *Buffer,
+  IN BOOLEAN               Record
+  );
+
+/**
+  Dump the device statistics.
+
+  @param Instance    Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoDumpStatistics (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  );
+
 //
 // EFI Component Name Functions
 //
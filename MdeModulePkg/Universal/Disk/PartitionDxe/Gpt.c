@@ -10,8 +10,9 @@
   PartitionInstallGptChildHandles() routine will read disk partition content and
   do basic validation before PartitionInstallChildHandle().
 
-  PartitionValidGptTable(), PartitionCheckGptEntry() routine will accept disk
-  partition content and validate the GPT table and GPT entry.
+  PartitionValidGptTable(), PartitionReadGptHeader(), PartitionCheckGptEntry()
+  routine will accept disk partition content and validate the GPT table and
+  GPT entry.
 
 Copyright (c) 2018 Qualcomm Datacenter Technologies, Inc.
 Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
@@ -21,6 +22,38 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Partition.h"
 
+//
+// Validated GPTs seen by this driver, most recently used first.
+//
+LIST_ENTRY  mPartitionGptCache = INITIALIZE_LIST_HEAD_VARIABLE (mPartitionGptCache);
+UINTN       mPartitionGptCacheCount;
+UINT64      mPartitionGptCacheSavedBytes;
+
+/**
+  This routine will read GPT partition table header and validate it without
+  checking the partition entry array.
+
+  Caution: This function may receive untrusted input.
+  The GPT partition table header is external input, so this routine
+  will do basic validation for GPT partition table header before return.
+
+  @param[in]  BlockIo     Parent BlockIo interface.
+  @param[in]  DiskIo      Disk Io protocol.
+  @param[in]  Lba         The starting Lba of the Partition Table
+  @param[out] PartHeader  Stores the partition table that is read
+
+  @retval TRUE      The partition table header is valid
+  @retval FALSE     The partition table header is not valid
+
+**/
+BOOLEAN
+PartitionReadGptHeader (
+  IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
+  IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
+  IN  EFI_LBA                     Lba,
+  OUT EFI_PARTITION_TABLE_HEADER  *PartHeader
+  );
+
 /**
   Install child handles if the Handle supports GPT partition structure.
 
@@ -161,6 +194,116 @@ PartitionSetCrc (
   IN OUT EFI_TABLE_HEADER  *Hdr
   );
 
+/**
+  Look up the GPT scan cache.
+
+  @param[in]  Handle      Parent Handle.
+  @param[in]  Media       Parent media.
+  @param[in]  PartHeader  The validated primary partition table header just read from the media.
+
+  @return The matching cache entry, or NULL if the GPT was not seen before or has changed.
+
+**/
+PARTITION_GPT_CACHE_ENTRY *
+PartitionFindGptCache (
+  IN  EFI_HANDLE                  Handle,
+  IN  EFI_BLOCK_IO_MEDIA          *Media,
+  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader
+  )
+{
+  LIST_ENTRY                 *Link;
+  PARTITION_GPT_CACHE_ENTRY  *CacheEntry;
+
+  for (Link = GetFirstNode (&mPartitionGptCache); !IsNull (&mPartitionGptCache, Link); Link = GetNextNode (&mPartitionGptCache, Link)) {
+    CacheEntry = BASE_CR (Link, PARTITION_GPT_CACHE_ENTRY, Link);
+    if ((CacheEntry->Handle == Handle) &&
+        (CacheEntry->MediaId == Media->MediaId) &&
+        (CacheEntry->BlockSize == Media->BlockSize) &&
+        (CacheEntry->LastBlock == Media->LastBlock) &&
+        (CompareMem (&CacheEntry->Header, PartHeader, sizeof (EFI_PARTITION_TABLE_HEADER)) == 0)
+        )
+    {
+      return CacheEntry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Remove an entry from the GPT scan cache and free it.
+
+  @param[in]  CacheEntry  The cache entry to remove.
+
+**/
+VOID
+PartitionRemoveGptCache (
+  IN  PARTITION_GPT_CACHE_ENTRY  *CacheEntry
+  )
+{
+  RemoveEntryList (&CacheEntry->Link);
+  mPartitionGptCacheCount--;
+  FreePool (CacheEntry->PartEntry);
+  FreePool (CacheEntry);
+}
+
+/**
+  Remember a validated GPT in the GPT scan cache.
+
+  Any stale entry for the same parent handle is replaced, and the least
+  recently used entry is evicted when the cache is full.
+
+  @param[in]  Handle      Parent Handle.
+  @param[in]  Media       Parent media.
+  @param[in]  PartHeader  The validated primary partition table header.
+  @param[in]  PartEntry   The validated partition entry array.
+
+**/
+VOID
+PartitionAddGptCache (
+  IN  EFI_HANDLE                  Handle,
+  IN  EFI_BLOCK_IO_MEDIA          *Media,
+  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  IN  EFI_PARTITION_ENTRY         *PartEntry
+  )
+{
+  LIST_ENTRY                 *Link;
+  PARTITION_GPT_CACHE_ENTRY  *CacheEntry;
+
+  for (Link = GetFirstNode (&mPartitionGptCache); !IsNull (&mPartitionGptCache, Link); ) {
+    CacheEntry = BASE_CR (Link, PARTITION_GPT_CACHE_ENTRY, Link);
+    Link       = GetNextNode (&mPartitionGptCache, Link);
+    if (CacheEntry->Handle == Handle) {
+      PartitionRemoveGptCache (CacheEntry);
+    }
+  }
+
+  if (mPartitionGptCacheCount >= PARTITION_GPT_CACHE_MAX_ENTRIES) {
+    CacheEntry = BASE_CR (GetPreviousNode (&mPartitionGptCache, &mPartitionGptCache), PARTITION_GPT_CACHE_ENTRY, Link);
+    PartitionRemoveGptCache (CacheEntry);
+  }
+
+  CacheEntry = AllocatePool (sizeof (PARTITION_GPT_CACHE_ENTRY));
+  if (CacheEntry == NULL) {
+    return;
+  }
+
+  CacheEntry->PartEntry = AllocateCopyPool (PartHeader->NumberOfPartitionEntries * PartHeader->SizeOfPartitionEntry, PartEntry);
+  if (CacheEntry->PartEntry == NULL) {
+    FreePool (CacheEntry);
+    return;
+  }
+
+  CacheEntry->Handle    = Handle;
+  CacheEntry->MediaId   = Media->MediaId;
+  CacheEntry->BlockSize = Media->BlockSize;
+  CacheEntry->LastBlock = Media->LastBlock;
+  CopyMem (&CacheEntry->Header, PartHeader, sizeof (EFI_PARTITION_TABLE_HEADER));
+
+  InsertHeadList (&mPartitionGptCache, &CacheEntry->Link);
+  mPartitionGptCacheCount++;
+}
+
 /**
   Install child handles if the Handle supports GPT partition structure.
 
@@ -207,12 +350,16 @@ PartitionInstallGptChildHandles (
   HARDDRIVE_DEVICE_PATH        HdDev;
   UINT32                       MediaId;
   EFI_PARTITION_INFO_PROTOCOL  PartitionInfo;
+  BOOLEAN                      PrimaryValid;
+  PARTITION_GPT_CACHE_ENTRY    *CacheEntry;
+  UINTN                        PartEntrySize;
 
   ProtectiveMbr = NULL;
   PrimaryHeader = NULL;
   BackupHeader  = NULL;
   PartEntry     = NULL;
   PEntryStatus  = NULL;
+  CacheEntry    = NULL;
 
   BlockSize = BlockIo->Media->BlockSize;
   LastBlock = BlockIo->Media->LastBlock;
@@ -241,13 +388,13 @@ PartitionInstallGptChildHandles (
   //
   // Read the Protective MBR from LBA #0
   //
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     MediaId,
-                     0,
-                     BlockSize,
-                     ProtectiveMbr
-                     );
+  Status = PartitionProbeReadDisk (
+             DiskIo,
+             MediaId,
+             0,
+             BlockSize,
+             ProtectiveMbr
+             );
   if (EFI_ERROR (Status)) {
     GptValidStatus = Status;
     goto Done;
@@ -283,59 +430,104 @@ PartitionInstallGptChildHandles (
   }
 
   //
-  // Check primary and backup partition tables
+  // The primary header is read on every scan. If it matches a GPT validated
+  // before on the same media, the partition entries are taken from the scan
+  // cache and the backup GPT is not probed again.
   //
-  if (!PartitionValidGptTable (BlockIo, DiskIo, PRIMARY_PART_HEADER_LBA, PrimaryHeader)) {
-    DEBUG ((DEBUG_INFO, " Not Valid primary partition table\n"));
+  PrimaryValid = PartitionReadGptHeader (BlockIo, DiskIo, PRIMARY_PART_HEADER_LBA, PrimaryHeader);
+  if (PrimaryValid) {
+    CacheEntry = PartitionFindGptCache (Handle, BlockIo->Media, PrimaryHeader);
+  }
 
-    if (!PartitionValidGptTable (BlockIo, DiskIo, LastBlock, BackupHeader)) {
-      DEBUG ((DEBUG_INFO, " Not Valid backup partition table\n"));
+  if (CacheEntry != NULL) {
+    PartEntrySize = PrimaryHeader->NumberOfPartitionEntries * PrimaryHeader->SizeOfPartitionEntry;
+    PartEntry     = AllocateCopyPool (PartEntrySize, CacheEntry->PartEntry);
+    if (PartEntry == NULL) {
+      DEBUG ((DEBUG_ERROR, "Allocate pool error\n"));
       goto Done;
-    } else {
-      DEBUG ((DEBUG_INFO, " Valid backup partition table\n"));
-      DEBUG ((DEBUG_INFO, " Restore primary partition table by the backup\n"));
-      if (!PartitionRestoreGptTable (BlockIo, DiskIo, BackupHeader)) {
-        DEBUG ((DEBUG_INFO, " Restore primary partition table error\n"));
+    }
+
+    //
+    // Keep the cache in most recently used order.
+    //
+    RemoveEntryList (&CacheEntry->Link);
+    InsertHeadList (&mPartitionGptCache, &CacheEntry->Link);
+
+    //
+    // Saved the entry array CRC check read, the backup header and entry array
+    // reads, and the entry array read below.
+    //
+    mPartitionGptCacheSavedBytes += MultU64x32 (PartEntrySize, 3) + BlockSize;
+    DEBUG ((DEBUG_INFO, " GPT scan cache hit, %ld bytes of I/O saved so far\n", mPartitionGptCacheSavedBytes));
+  } else {
+    //
+    // Check primary and backup partition tables
+    //
+    if (PrimaryValid) {
+      PrimaryValid = PartitionCheckGptEntryArrayCRC (BlockIo, DiskIo, PrimaryHeader);
+    }
+
+    if (!PrimaryValid) {
+      DEBUG ((DEBUG_INFO, " Not Valid primary partition table\n"));
+
+      if (!PartitionValidGptTable (BlockIo, DiskIo, LastBlock, BackupHeader)) {
+        DEBUG ((DEBUG_INFO, " Not Valid backup partition table\n"));
+        goto Done;
+      } else {
+        DEBUG ((DEBUG_INFO, " Valid backup partition table\n"));
+        DEBUG ((DEBUG_INFO, " Restore primary partition table by the backup\n"));
+        if (!PartitionRestoreGptTable (BlockIo, DiskIo, BackupHeader)) {
+          DEBUG ((DEBUG_INFO, " Restore primary partition table error\n"));
+        }
+
+        if (PartitionValidGptTable (BlockIo, DiskIo, BackupHeader->AlternateLBA, PrimaryHeader)) {
+          DEBUG ((DEBUG_INFO, " Restore backup partition table success\n"));
+          PrimaryValid = TRUE;
+        }
+      }
+    } else if (!PartitionValidGptTable (BlockIo, DiskIo, PrimaryHeader->AlternateLBA, BackupHeader)) {
+      DEBUG ((DEBUG_INFO, " Valid primary and !Valid backup partition table\n"));
+      DEBUG ((DEBUG_INFO, " Restore backup partition table by the primary\n"));
+      if (!PartitionRestoreGptTable (BlockIo, DiskIo, PrimaryHeader)) {
+        DEBUG ((DEBUG_INFO, " Restore backup partition table error\n"));
       }
 
-      if (PartitionValidGptTable (BlockIo, DiskIo, BackupHeader->AlternateLBA, PrimaryHeader)) {
+      if (PartitionValidGptTable (BlockIo, DiskIo, PrimaryHeader->AlternateLBA, BackupHeader)) {
         DEBUG ((DEBUG_INFO, " Restore backup partition table success\n"));
       }
     }
-  } else if (!PartitionValidGptTable (BlockIo, DiskIo, PrimaryHeader->AlternateLBA, BackupHeader)) {
-    DEBUG ((DEBUG_INFO, " Valid primary and !Valid backup partition table\n"));
-    DEBUG ((DEBUG_INFO, " Restore backup partition table by the primary\n"));
-    if (!PartitionRestoreGptTable (BlockIo, DiskIo, PrimaryHeader)) {
-      DEBUG ((DEBUG_INFO, " Restore backup partition table error\n"));
-    }
 
-    if (PartitionValidGptTable (BlockIo, DiskIo, PrimaryHeader->AlternateLBA, BackupHeader)) {
-      DEBUG ((DEBUG_INFO, " Restore backup partition table success\n"));
-    }
-  }
+    DEBUG ((DEBUG_INFO, " Valid primary and Valid backup partition table\n"));
 
-  DEBUG ((DEBUG_INFO, " Valid primary and Valid backup partition table\n"));
+    //
+    // Read the EFI Partition Entries
+    //
+    PartEntry = AllocatePool (PrimaryHeader->NumberOfPartitionEntries * PrimaryHeader->SizeOfPartitionEntry);
+    if (PartEntry == NULL) {
+      DEBUG ((DEBUG_ERROR, "Allocate pool error\n"));
+      goto Done;
+    }
 
-  //
-  // Read the EFI Partition Entries
-  //
-  PartEntry = AllocatePool (PrimaryHeader->NumberOfPartitionEntries * PrimaryHeader->SizeOfPartitionEntry);
-  if (PartEntry == NULL) {
-    DEBUG ((DEBUG_ERROR, "Allocate pool error\n"));
-    goto Done;
-  }
+    Status = PartitionProbeReadDisk (
+               DiskIo,
+               MediaId,
+               MultU64x32 (PrimaryHeader->PartitionEntryLBA, BlockSize),
+               PrimaryHeader->NumberOfPartitionEntries * (PrimaryHeader->SizeOfPartitionEntry),
+               PartEntry
+               );
+    if (EFI_ERROR (Status)) {
+      GptValidStatus = Status;
+      DEBUG ((DEBUG_ERROR, " Partition Entry ReadDisk error\n"));
+      goto Done;
+    }
 
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     MediaId,
-                     MultU64x32 (PrimaryHeader->PartitionEntryLBA, BlockSize),
-                     PrimaryHeader->NumberOfPartitionEntries * (PrimaryHeader->SizeOfPartitionEntry),
-                     PartEntry
-                     );
-  if (EFI_ERROR (Status)) {
-    GptValidStatus = Status;
-    DEBUG ((DEBUG_ERROR, " Partition Entry ReadDisk error\n"));
-    goto Done;
+    //
+    // Only remember a GPT whose primary header is valid on the media, since
+    // that is what the next scan compares against.
+    //
+    if (PrimaryValid) {
+      PartitionAddGptCache (Handle, BlockIo->Media, PrimaryHeader, PartEntry);
+    }
   }
 
   DEBUG ((DEBUG_INFO, " Partition entries read block success\n"));
@@ -470,6 +662,43 @@ PartitionValidGptTable (
   IN  EFI_LBA                     Lba,
   OUT EFI_PARTITION_TABLE_HEADER  *PartHeader
   )
+{
+  if (!PartitionReadGptHeader (BlockIo, DiskIo, Lba, PartHeader)) {
+    return FALSE;
+  }
+
+  if (!PartitionCheckGptEntryArrayCRC (BlockIo, DiskIo, PartHeader)) {
+    return FALSE;
+  }
+
+  DEBUG ((DEBUG_INFO, " Valid efi partition table header\n"));
+  return TRUE;
+}
+
+/**
+  This routine will read GPT partition table header and validate it without
+  checking the partition entry array.
+
+  Caution: This function may receive untrusted input.
+  The GPT partition table header is external input, so this routine
+  will do basic validation for GPT partition table header before return.
+
+  @param[in]  BlockIo     Parent BlockIo interface.
+  @param[in]  DiskIo      Disk Io protocol.
+  @param[in]  Lba         The starting Lba of the Partition Table
+  @param[out] PartHeader  Stores the partition table that is read
+
+  @retval TRUE      The partition table header is valid
+  @retval FALSE     The partition table header is not valid
+
+**/
+BOOLEAN
+PartitionReadGptHeader (
+  IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
+  IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
+  IN  EFI_LBA                     Lba,
+  OUT EFI_PARTITION_TABLE_HEADER  *PartHeader
+  )
 {
   EFI_STATUS                  Status;
   UINT32                      BlockSize;
@@ -488,13 +717,13 @@ PartitionValidGptTable (
   //
   // Read the EFI Partition Table Header
   //
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     MediaId,
-                     MultU64x32 (Lba, BlockSize),
-                     BlockSize,
-                     PartHdr
-                     );
+  Status = PartitionProbeReadDisk (
+             DiskIo,
+             MediaId,
+             MultU64x32 (Lba, BlockSize),
+             BlockSize,
+             PartHdr
+             );
   if (EFI_ERROR (Status)) {
     FreePool (PartHdr);
     return FALSE;
@@ -520,12 +749,6 @@ PartitionValidGptTable (
   }
 
   CopyMem (PartHeader, PartHdr, sizeof (EFI_PARTITION_TABLE_HEADER));
-  if (!PartitionCheckGptEntryArrayCRC (BlockIo, DiskIo, PartHeader)) {
-    FreePool (PartHdr);
-    return FALSE;
-  }
-
-  DEBUG ((DEBUG_INFO, " Valid efi partition table header\n"));
   FreePool (PartHdr);
   return TRUE;
 }
@@ -563,13 +786,13 @@ PartitionCheckGptEntryArrayCRC (
     return FALSE;
   }
 
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     BlockIo->Media->MediaId,
-                     MultU64x32 (PartHeader->PartitionEntryLBA, BlockIo->Media->BlockSize),
-                     PartHeader->NumberOfPartitionEntries * PartHeader->SizeOfPartitionEntry,
-                     Ptr
-                     );
+  Status = PartitionProbeReadDisk (
+             DiskIo,
+             BlockIo->Media->MediaId,
+             MultU64x32 (PartHeader->PartitionEntryLBA, BlockIo->Media->BlockSize),
+             PartHeader->NumberOfPartitionEntries * PartHeader->SizeOfPartitionEntry,
+             Ptr
+             );
   if (EFI_ERROR (Status)) {
     FreePool (Ptr);
     return FALSE;
@@ -639,13 +862,13 @@ PartitionRestoreGptTable (
   PartHdr->PartitionEntryLBA = PEntryLBA;
   PartitionSetCrc ((EFI_TABLE_HEADER *)PartHdr);
 
-  Status = DiskIo->WriteDisk (
-                     DiskIo,
-                     MediaId,
-                     MultU64x32 (PartHdr->MyLBA, (UINT32)BlockSize),
-                     BlockSize,
-                     PartHdr
-                     );
+  Status = PartitionProbeWriteDisk (
+             DiskIo,
+             MediaId,
+             MultU64x32 (PartHdr->MyLBA, (UINT32)BlockSize),
+             BlockSize,
+             PartHdr
+             );
   if (EFI_ERROR (Status)) {
     goto Done;
   }
@@ -657,24 +880,24 @@ PartitionRestoreGptTable (
     goto Done;
   }
 
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     MediaId,
-                     MultU64x32 (PartHeader->PartitionEntryLBA, (UINT32)BlockSize),
-                     PartHeader->NumberOfPartitionEntries * PartHeader->SizeOfPartitionEntry,
-                     Ptr
-                     );
+  Status = PartitionProbeReadDisk (
+             DiskIo,
+             MediaId,
+             MultU64x32 (PartHeader->PartitionEntryLBA, (UINT32)BlockSize),
+             PartHeader->NumberOfPartitionEntries * PartHeader->SizeOfPartitionEntry,
+             Ptr
+             );
   if (EFI_ERROR (Status)) {
     goto Done;
   }
 
-  Status = DiskIo->WriteDisk (
-                     DiskIo,
-                     MediaId,
-                     MultU64x32 (PEntryLBA, (UINT32)BlockSize),
-                     PartHeader->NumberOfPartitionEntries * PartHeader->SizeOfPartitionEntry,
-                     Ptr
-                     );
+  Status = PartitionProbeWriteDisk (
+             DiskIo,
+             MediaId,
+             MultU64x32 (PEntryLBA, (UINT32)BlockSize),
+             PartHeader->NumberOfPartitionEntries * PartHeader->SizeOfPartitionEntry,
+             Ptr
+             );
 
 Done:
   FreePool (PartHdr);
@@ -160,13 +160,13 @@ PartitionInstallMbrChildHandles (
     return Found;
   }
 
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     MediaId,
-                     0,
-                     BlockSize,
-                     Mbr
-                     );
+  Status = PartitionProbeReadDisk (
+             DiskIo,
+             MediaId,
+             0,
+             BlockSize,
+             Mbr
+             );
   if (EFI_ERROR (Status)) {
     Found = Status;
     goto Done;
@@ -273,13 +273,13 @@ PartitionInstallMbrChildHandles (
     ExtMbrStartingLba = 0;
 
     do {
-      Status = DiskIo->ReadDisk (
-                         DiskIo,
-                         MediaId,
-                         MultU64x32 (ExtMbrStartingLba, BlockSize),
-                         BlockSize,
-                         Mbr
-                         );
+      Status = PartitionProbeReadDisk (
+                 DiskIo,
+                 MediaId,
+                 MultU64x32 (ExtMbrStartingLba, BlockSize),
+                 BlockSize,
+                 Mbr
+                 );
       if (EFI_ERROR (Status)) {
         Found = Status;
         goto Done;
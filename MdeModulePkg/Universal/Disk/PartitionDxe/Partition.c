@@ -50,6 +50,156 @@ PARTITION_DETECT_ROUTINE  mPartitionDetectRoutineTable[] = {
   NULL
 };
 
+//
+// Head of the disk that Start() is probing.
+//
+PARTITION_PROBE_BUFFER  mPartitionProbe;
+
+/**
+  Read the head of a disk into the probe buffer, before the partition detect
+  routines run on it. If that fails, the routines read from the disk.
+
+  @param[in]  DiskIo   DiskIo interface.
+  @param[in]  BlockIo  BlockIo interface.
+
+**/
+VOID
+PartitionProbeStart (
+  IN  EFI_DISK_IO_PROTOCOL   *DiskIo,
+  IN  EFI_BLOCK_IO_PROTOCOL  *BlockIo
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      MediaSize;
+
+  ZeroMem (&mPartitionProbe, sizeof (mPartitionProbe));
+  mPartitionProbe.DiskIo  = DiskIo;
+  mPartitionProbe.MediaId = BlockIo->Media->MediaId;
+
+  if (!BlockIo->Media->MediaPresent || (BlockIo->Media->LastBlock == MAX_UINT64)) {
+    return;
+  }
+
+  MediaSize            = MultU64x32 (BlockIo->Media->LastBlock + 1, BlockIo->Media->BlockSize);
+  mPartitionProbe.Size = (UINTN)MIN (MediaSize, PARTITION_PROBE_SIZE);
+
+  mPartitionProbe.Buffer = AllocatePool (mPartitionProbe.Size);
+  if (mPartitionProbe.Buffer == NULL) {
+    mPartitionProbe.Size = 0;
+    return;
+  }
+
+  mPartitionProbe.DiskReads++;
+  Status = DiskIo->ReadDisk (
+                     DiskIo,
+                     mPartitionProbe.MediaId,
+                     0,
+                     mPartitionProbe.Size,
+                     mPartitionProbe.Buffer
+                     );
+  if (EFI_ERROR (Status)) {
+    FreePool (mPartitionProbe.Buffer);
+    mPartitionProbe.Buffer = NULL;
+    mPartitionProbe.Size   = 0;
+  }
+}
+
+/**
+  Report the I/O done while probing a disk, and release the probe buffer.
+
+**/
+VOID
+PartitionProbeEnd (
+  VOID
+  )
+{
+  DEBUG ((
+    DEBUG_INFO,
+    "PartitionProbe: %ld bytes read ahead, %ld reads served from them, %ld disk reads\n",
+    (UINT64)mPartitionProbe.Size,
+    (UINT64)mPartitionProbe.BufferedReads,
+    (UINT64)mPartitionProbe.DiskReads
+    ));
+
+  if (mPartitionProbe.Buffer != NULL) {
+    FreePool (mPartitionProbe.Buffer);
+  }
+
+  ZeroMem (&mPartitionProbe, sizeof (mPartitionProbe));
+}
+
+/**
+  Read from the disk that is being probed, serving the request from the probe
+  buffer when it covers the range.
+
+  @param[in]  DiskIo      DiskIo interface.
+  @param[in]  MediaId     Id of the media, changes every time the media is
+                          replaced.
+  @param[in]  Offset      The starting byte offset to read from.
+  @param[in]  BufferSize  Size of Buffer.
+  @param[out] Buffer      Buffer containing read data.
+
+  @retval EFI_SUCCESS     The data was read correctly from the device.
+  @retval other           See EFI_DISK_IO_PROTOCOL.ReadDisk().
+
+**/
+EFI_STATUS
+PartitionProbeReadDisk (
+  IN  EFI_DISK_IO_PROTOCOL  *DiskIo,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  OUT VOID                  *Buffer
+  )
+{
+  if ((mPartitionProbe.Buffer != NULL) &&
+      (DiskIo == mPartitionProbe.DiskIo) &&
+      (MediaId == mPartitionProbe.MediaId) &&
+      (Offset <= mPartitionProbe.Size) &&
+      (BufferSize <= mPartitionProbe.Size - Offset))
+  {
+    CopyMem (Buffer, mPartitionProbe.Buffer + Offset, BufferSize);
+    mPartitionProbe.BufferedReads++;
+    return EFI_SUCCESS;
+  }
+
+  mPartitionProbe.DiskReads++;
+  return DiskIo->ReadDisk (DiskIo, MediaId, Offset, BufferSize, Buffer);
+}
+
+/**
+  Write to the disk that is being probed. The probe buffer is dropped, so
+  that later reads see the data written.
+
+  @param[in]  DiskIo      DiskIo interface.
+  @param[in]  MediaId     Id of the media, changes every time the media is
+                          replaced.
+  @param[in]  Offset      The starting byte offset to write to.
+  @param[in]  BufferSize  Size of Buffer.
+  @param[in]  Buffer      Buffer containing data to write.
+
+  @retval EFI_SUCCESS     The data was written correctly to the device.
+  @retval other           See EFI_DISK_IO_PROTOCOL.WriteDisk().
+
+**/
+EFI_STATUS
+PartitionProbeWriteDisk (
+  IN  EFI_DISK_IO_PROTOCOL  *DiskIo,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  IN  VOID                  *Buffer
+  )
+{
+  if ((mPartitionProbe.Buffer != NULL) && (DiskIo == mPartitionProbe.DiskIo)) {
+    FreePool (mPartitionProbe.Buffer);
+    mPartitionProbe.Buffer = NULL;
+    mPartitionProbe.Size   = 0;
+  }
+
+  return DiskIo->WriteDisk (DiskIo, MediaId, Offset, BufferSize, Buffer);
+}
+
 /**
   Test to see if this driver supports ControllerHandle. Any ControllerHandle
   than contains a BlockIo and DiskIo protocol or a BlockIo2 protocol can be
@@ -315,6 +465,10 @@ PartitionDriverBindingStart (
     // If the media supports a given partition type install child handles to
     // represent the partitions described by the media.
     //
+    // The routines share one read-ahead of the head of the disk, so probing
+    // for all of them costs about one read on media that has none.
+    //
+    PartitionProbeStart (DiskIo, BlockIo);
     Routine = &mPartitionDetectRoutineTable[0];
     while (*Routine != NULL) {
       Status = (*Routine)(
@@ -332,6 +486,8 @@ PartitionDriverBindingStart (
 
       Routine++;
     }
+
+    PartitionProbeEnd ();
   }
 
   //
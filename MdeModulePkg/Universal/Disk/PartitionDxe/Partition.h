@@ -103,6 +103,42 @@ typedef struct {
   BOOLEAN    OsSpecific;
 } EFI_PARTITION_ENTRY_STATUS;
 
+//
+// GPT scan cache entry. A validated GPT is remembered per parent handle so
+// that a later Start() on unchanged media (same MediaId and same primary
+// header, including its CRC32 and PartitionEntryArrayCRC32) can skip
+// re-reading and re-validating the partition entry array and backup GPT.
+//
+#define PARTITION_GPT_CACHE_MAX_ENTRIES  16
+
+typedef struct {
+  LIST_ENTRY                    Link;
+  EFI_HANDLE                    Handle;
+  UINT32                        MediaId;
+  UINT32                        BlockSize;
+  EFI_LBA                       LastBlock;
+  EFI_PARTITION_TABLE_HEADER    Header;
+  EFI_PARTITION_ENTRY           *PartEntry;
+} PARTITION_GPT_CACHE_ENTRY;
+
+//
+// Probe buffer. The head of the disk is read with one request when Start()
+// begins probing, and the GPT, El Torito, UDF and MBR detect routines read
+// their structures from it through PartitionProbeReadDisk(). The size covers
+// the protective MBR, the primary GPT with 128 entries of 4KB blocks, and the
+// ISO 9660 and UDF volume descriptors at 32KB.
+//
+#define PARTITION_PROBE_SIZE  SIZE_128KB
+
+typedef struct {
+  EFI_DISK_IO_PROTOCOL    *DiskIo;
+  UINT32                  MediaId;
+  UINT8                   *Buffer;
+  UINTN                   Size;
+  UINTN                   BufferedReads;
+  UINTN                   DiskReads;
+} PARTITION_PROBE_BUFFER;
+
 //
 // Function Prototypes
 //
@@ -343,6 +379,54 @@ PartitionInstallChildHandle (
   IN  EFI_GUID                     *TypeGuid
   );
 
+/**
+  Read from the disk that is being probed, serving the request from the probe
+  buffer when it covers the range.
+
+  @param[in]  DiskIo      DiskIo interface.
+  @param[in]  MediaId     Id of the media, changes every time the media is
+                          replaced.
+  @param[in]  Offset      The starting byte offset to read from.
+  @param[in]  BufferSize  Size of Buffer.
+  @param[out] Buffer      Buffer containing read data.
+
+  @retval EFI_SUCCESS     The data was read correctly from the device.
+  @retval other           See EFI_DISK_IO_PROTOCOL.ReadDisk().
+
+**/
+EFI_STATUS
+PartitionProbeReadDisk (
+  IN  EFI_DISK_IO_PROTOCOL  *DiskIo,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  OUT VOID                  *Buffer
+  );
+
+/**
+  Write to the disk that is being probed. The probe buffer is dropped, so
+  that later reads see the data written.
+
+  @param[in]  DiskIo      DiskIo interface.
+  @param[in]  MediaId     Id of the media, changes every time the media is
+                          replaced.
+  @param[in]  Offset      The starting byte offset to write to.
+  @param[in]  BufferSize  Size of Buffer.
+  @param[in]  Buffer      Buffer containing data to write.
+
+  @retval EFI_SUCCESS     The data was written correctly to the device.
+  @retval other           See EFI_DISK_IO_PROTOCOL.WriteDisk().
+
+**/
+EFI_STATUS
+PartitionProbeWriteDisk (
+  IN  EFI_DISK_IO_PROTOCOL  *DiskIo,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  IN  VOID                  *Buffer
+  );
+
 /**
   Test to see if there is any child on ControllerHandle.
 
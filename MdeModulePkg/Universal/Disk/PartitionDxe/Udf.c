@@ -123,13 +123,13 @@ FindAnchorVolumeDescriptorPointer (
   //
   // Find AVDP at block 256
   //
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     BlockIo->Media->MediaId,
-                     MultU64x32 (256, BlockSize),
-                     sizeof (*AnchorPoint),
-                     AnchorPoint
-                     );
+  Status = PartitionProbeReadDisk (
+             DiskIo,
+             BlockIo->Media->MediaId,
+             MultU64x32 (256, BlockSize),
+             sizeof (*AnchorPoint),
+             AnchorPoint
+             );
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -147,13 +147,13 @@ FindAnchorVolumeDescriptorPointer (
   //
   // Find AVDP at block N - 256
   //
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     BlockIo->Media->MediaId,
-                     MultU64x32 ((UINT64)EndLBA - 256, BlockSize),
-                     sizeof (*AnchorPoint),
-                     AnchorPoint
-                     );
+  Status = PartitionProbeReadDisk (
+             DiskIo,
+             BlockIo->Media->MediaId,
+             MultU64x32 ((UINT64)EndLBA - 256, BlockSize),
+             sizeof (*AnchorPoint),
+             AnchorPoint
+             );
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -183,13 +183,13 @@ FindAnchorVolumeDescriptorPointer (
   //
   // Find AVDP at block N
   //
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     BlockIo->Media->MediaId,
-                     MultU64x32 ((UINT64)EndLBA, BlockSize),
-                     sizeof (*AnchorPoint),
-                     AnchorPoint
-                     );
+  Status = PartitionProbeReadDisk (
+             DiskIo,
+             BlockIo->Media->MediaId,
+             MultU64x32 ((UINT64)EndLBA, BlockSize),
+             sizeof (*AnchorPoint),
+             AnchorPoint
+             );
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -219,13 +219,13 @@ FindAnchorVolumeDescriptorPointer (
   //
   // Read consecutive MAX_CORRECTION_BLOCKS_NUM disk blocks
   //
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     BlockIo->Media->MediaId,
-                     MultU64x32 ((UINT64)EndLBA - MAX_CORRECTION_BLOCKS_NUM, BlockSize),
-                     Size,
-                     AnchorPoints
-                     );
+  Status = PartitionProbeReadDisk (
+             DiskIo,
+             BlockIo->Media->MediaId,
+             MultU64x32 ((UINT64)EndLBA - MAX_CORRECTION_BLOCKS_NUM, BlockSize),
+             Size,
+             AnchorPoints
+             );
   if (EFI_ERROR (Status)) {
     goto Out_Free;
   }
@@ -319,13 +319,13 @@ FindUdfVolumeIdentifiers (
     // Check if block device has a Volume Structure Descriptor and an Extended
     // Area.
     //
-    Status = DiskIo->ReadDisk (
-                       DiskIo,
-                       BlockIo->Media->MediaId,
-                       Offset,
-                       sizeof (CDROM_VOLUME_DESCRIPTOR),
-                       (VOID *)&VolDescriptor
-                       );
+    Status = PartitionProbeReadDisk (
+               DiskIo,
+               BlockIo->Media->MediaId,
+               Offset,
+               sizeof (CDROM_VOLUME_DESCRIPTOR),
+               (VOID *)&VolDescriptor
+               );
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -362,13 +362,13 @@ FindUdfVolumeIdentifiers (
     return EFI_NOT_FOUND;
   }
 
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     BlockIo->Media->MediaId,
-                     Offset,
-                     sizeof (CDROM_VOLUME_DESCRIPTOR),
-                     (VOID *)&VolDescriptor
-                     );
+  Status = PartitionProbeReadDisk (
+             DiskIo,
+             BlockIo->Media->MediaId,
+             Offset,
+             sizeof (CDROM_VOLUME_DESCRIPTOR),
+             (VOID *)&VolDescriptor
+             );
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -395,13 +395,13 @@ FindUdfVolumeIdentifiers (
     return EFI_NOT_FOUND;
   }
 
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     BlockIo->Media->MediaId,
-                     Offset,
-                     sizeof (CDROM_VOLUME_DESCRIPTOR),
-                     (VOID *)&VolDescriptor
-                     );
+  Status = PartitionProbeReadDisk (
+             DiskIo,
+             BlockIo->Media->MediaId,
+             Offset,
+             sizeof (CDROM_VOLUME_DESCRIPTOR),
+             (VOID *)&VolDescriptor
+             );
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -558,13 +558,13 @@ FindLogicalVolumeLocation (
     //
     // Read disk block
     //
-    Status = BlockIo->ReadBlocks (
-                        BlockIo,
-                        BlockIo->Media->MediaId,
-                        SeqStartBlock,
-                        BlockSize,
-                        Buffer
-                        );
+    Status = PartitionProbeReadDisk (
+               DiskIo,
+               BlockIo->Media->MediaId,
+               MultU64x32 (SeqStartBlock, BlockSize),
+               BlockSize,
+               Buffer
+               );
     if (EFI_ERROR (Status)) {
       goto Out_Free;
     }
@@ -23,6 +23,17 @@ EFI_RAM_DISK_PROTOCOL  mRamDiskProtocol = {
   RamDiskUnregister
 };
 
+//
+// The EDKII_SPARSE_RAM_DISK_PROTOCOL instance that is installed onto the
+// driver handle
+//
+EDKII_SPARSE_RAM_DISK_PROTOCOL  mSparseRamDiskProtocol = {
+  RAM_DISK_SPARSE_CHUNK_SIZE,
+  RamDiskSparseRegister,
+  RamDiskSparseSupply,
+  RamDiskSparseUnregister
+};
+
 //
 // RamDiskDxe driver maintains a list of registered RAM disks.
 //
@@ -159,13 +170,15 @@ RamDiskDxeEntryPoint (
   InitializeListHead (&RegisteredRamDisks);
 
   //
-  // Install the EFI_RAM_DISK_PROTOCOL and RAM disk private data onto a
-  // new handle
+  // Install the EFI_RAM_DISK_PROTOCOL, EDKII_SPARSE_RAM_DISK_PROTOCOL and RAM
+  // disk private data onto a new handle
   //
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &mRamDiskHandle,
                   &gEfiRamDiskProtocolGuid,
                   &mRamDiskProtocol,
+                  &gEdkiiSparseRamDiskProtocolGuid,
+                  &mSparseRamDiskProtocol,
                   &gEfiCallerIdGuid,
                   ConfigPrivate,
                   NULL
@@ -231,6 +244,8 @@ RamDiskDxeUnload (
          mRamDiskHandle,
          &gEfiRamDiskProtocolGuid,
          &mRamDiskProtocol,
+         &gEdkiiSparseRamDiskProtocolGuid,
+         &mSparseRamDiskProtocol,
          &gEfiCallerIdGuid,
          ConfigPrivate,
          NULL
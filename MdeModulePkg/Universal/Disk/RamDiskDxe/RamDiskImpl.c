@@ -188,6 +188,10 @@ UnregisterAllRamDisks (
         FreePool ((VOID *)(UINTN)PrivateData->StartingAddr);
       }
 
+      if (PrivateData->Sparse != NULL) {
+        RamDiskSparseFree (PrivateData);
+      }
+
       FreePool (PrivateData->DevicePath);
       FreePool (PrivateData);
     }
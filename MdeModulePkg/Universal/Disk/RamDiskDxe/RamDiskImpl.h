@@ -26,6 +26,7 @@
 #include <Library/PcdLib.h>
 #include <Library/DxeServicesLib.h>
 #include <Protocol/RamDisk.h>
+#include <Protocol/SparseRamDisk.h>
 #include <Protocol/BlockIo.h>
 #include <Protocol/BlockIo2.h>
 #include <Protocol/HiiConfigAccess.h>
@@ -59,14 +60,47 @@ extern  LIST_ENTRY  RegisteredRamDisks;
 extern  EFI_ACPI_TABLE_PROTOCOL  *mAcpiTableProtocol;
 extern  EFI_ACPI_SDT_PROTOCOL    *mAcpiSdtProtocol;
 
+//
+// Chunk size of sparse RAM disks, a multiple of RAM_DISK_DEFAULT_BLOCK_SIZE
+//
+#define RAM_DISK_SPARSE_CHUNK_SIZE  SIZE_64KB
+
 //
 // RAM Disk create method.
 //
 typedef enum _RAM_DISK_CREATE_METHOD {
   RamDiskCreateOthers = 0,
-  RamDiskCreateHii
+  RamDiskCreateHii,
+  RamDiskCreateSparse
 } RAM_DISK_CREATE_METHOD;
 
+//
+// State of a sparse RAM disk chunk.
+//
+typedef enum {
+  RamDiskChunkEmpty = 0,    // Not supplied yet, fetched on demand if a Fill function is registered
+  RamDiskChunkZero,         // All zeros, no memory allocated
+  RamDiskChunkResident      // Content held in Data
+} RAM_DISK_CHUNK_STATE;
+
+typedef struct {
+  RAM_DISK_CHUNK_STATE    State;
+  UINT8                   *Data;
+} RAM_DISK_CHUNK;
+
+//
+// Sparse RAM disk backend, see Protocol/SparseRamDisk.h.
+//
+typedef struct {
+  RAM_DISK_CHUNK                *Chunks;
+  UINTN                         ChunkCount;
+  EDKII_SPARSE_RAM_DISK_FILL    Fill;
+  VOID                          *FillContext;
+  UINTN                         ResidentChunks;
+  UINTN                         ZeroChunks;
+  UINTN                         FilledChunks;
+} RAM_DISK_SPARSE_DATA;
+
 //
 // RamDiskDxe driver maintains a list of registered RAM disks.
 // The struct contains the list entry and the information of each RAM
@@ -91,6 +125,8 @@ typedef struct {
   EFI_QUESTION_ID             CheckBoxId;
   BOOLEAN                     CheckBoxChecked;
 
+  RAM_DISK_SPARSE_DATA        *Sparse;
+
   LIST_ENTRY                  ThisInstance;
 } RAM_DISK_PRIVATE_DATA;
 
@@ -169,6 +205,173 @@ RamDiskRegister (
   OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
   );
 
+/**
+  Create the RAM disk device and install its protocols.
+
+  @param[in]  RamDiskBase    The base address of registered RAM disk. For a
+                             sparse RAM disk, the address of its chunk table.
+  @param[in]  RamDiskSize    The size of registered RAM disk.
+  @param[in]  RamDiskType    The type of registered RAM disk.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path. If there is no
+                             parent device path then ParentDevicePath is NULL.
+  @param[in]  Sparse         The chunk data of a sparse RAM disk, or NULL for
+                             a RAM disk backed by contiguous memory.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+EFI_STATUS
+RamDiskRegisterWorker (
+  IN  UINT64                    RamDiskBase,
+  IN  UINT64                    RamDiskSize,
+  IN  EFI_GUID                  *RamDiskType,
+  IN  EFI_DEVICE_PATH           *ParentDevicePath     OPTIONAL,
+  IN  RAM_DISK_SPARSE_DATA      *Sparse               OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
+  );
+
+/**
+  Register a sparse RAM disk with specified size and type.
+
+  @param[in]  RamDiskSize    The size of registered RAM disk.
+  @param[in]  RamDiskType    The type of registered RAM disk.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path. If there is no
+                             parent device path then ParentDevicePath is NULL.
+  @param[in]  Fill           Optional function to fetch chunks that have not
+                             been supplied.
+  @param[in]  FillContext    The context passed to Fill.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_INVALID_PARAMETER   DevicePath or RamDiskType is NULL.
+                                  RamDiskSize is 0.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskSparseRegister (
+  IN  UINT64                      RamDiskSize,
+  IN  EFI_GUID                    *RamDiskType,
+  IN  EFI_DEVICE_PATH             *ParentDevicePath     OPTIONAL,
+  IN  EDKII_SPARSE_RAM_DISK_FILL  Fill                  OPTIONAL,
+  IN  VOID                        *FillContext          OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL    **DevicePath
+  );
+
+/**
+  Supply the content of a sparse RAM disk.
+
+  @param[in] DevicePath      A pointer to the device path that describes a
+                             sparse RAM disk device.
+  @param[in] Offset          The byte offset in the RAM disk.
+  @param[in] Length          The number of bytes in Buffer.
+  @param[in] Buffer          The content.
+
+  @retval EFI_SUCCESS             The content is supplied.
+  @retval EFI_INVALID_PARAMETER   The range is not chunk aligned or is out of
+                                  the RAM disk.
+  @retval EFI_NOT_FOUND           The sparse RAM disk pointed by DevicePath
+                                  doesn't exist.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to hold the
+                                  content.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskSparseSupply (
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN UINT64                    Offset,
+  IN UINTN                     Length,
+  IN VOID                      *Buffer
+  );
+
+/**
+  Unregister a sparse RAM disk specified by DevicePath, and free the memory
+  that holds its content.
+
+  @param[in] DevicePath      A pointer to the device path that describes a
+                             sparse RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is unregistered successfully.
+  @retval EFI_INVALID_PARAMETER   DevicePath is NULL.
+  @retval EFI_NOT_FOUND           The sparse RAM disk pointed by DevicePath
+                                  doesn't exist.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskSparseUnregister (
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  );
+
+/**
+  Read from a sparse RAM disk.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Offset         The byte offset in the RAM disk.
+  @param[in]  Length         The number of bytes to read.
+  @param[out] Buffer         The destination buffer.
+
+  @retval EFI_SUCCESS             The data was read.
+  @retval EFI_DEVICE_ERROR        A chunk could not be fetched.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to hold a
+                                  fetched chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseRead (
+  IN  RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN  UINT64                 Offset,
+  IN  UINTN                  Length,
+  OUT UINT8                  *Buffer
+  );
+
+/**
+  Write to a sparse RAM disk.
+
+  @param[in] PrivateData     Points to RAM disk private data.
+  @param[in] Offset          The byte offset in the RAM disk.
+  @param[in] Length          The number of bytes to write.
+  @param[in] Buffer          The source buffer.
+
+  @retval EFI_SUCCESS             The data was written.
+  @retval EFI_DEVICE_ERROR        A chunk could not be fetched.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to hold the
+                                  written chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseWrite (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN UINT64                 Offset,
+  IN UINTN                  Length,
+  IN UINT8                  *Buffer
+  );
+
+/**
+  Free the chunks of a sparse RAM disk.
+
+  @param[in] PrivateData     Points to RAM disk private data.
+
+**/
+VOID
+RamDiskSparseFree (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData
+  );
+
 /**
   Unregister a RAM disk specified by DevicePath.
 
@@ -150,6 +150,13 @@ RamDiskPublishNfit (
   UINT8    Checksum;
   BOOLEAN  MemoryFound;
 
+  //
+  // A sparse RAM disk has no memory range to describe to the OS.
+  //
+  if (PrivateData->Sparse != NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
   //
   // Get the EFI memory map.
   //
@@ -598,13 +605,6 @@ RamDiskRegister (
   OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
   )
 {
-  EFI_STATUS                  Status;
-  RAM_DISK_PRIVATE_DATA       *PrivateData;
-  RAM_DISK_PRIVATE_DATA       *RegisteredPrivateData;
-  MEDIA_RAM_DISK_DEVICE_PATH  *RamDiskDevNode;
-  UINTN                       DevicePathSize;
-  LIST_ENTRY                  *Entry;
-
   if ((0 == RamDiskSize) || (NULL == RamDiskType) || (NULL == DevicePath)) {
     return EFI_INVALID_PARAMETER;
   }
@@ -618,6 +618,55 @@ RamDiskRegister (
     return EFI_INVALID_PARAMETER;
   }
 
+  return RamDiskRegisterWorker (
+           RamDiskBase,
+           RamDiskSize,
+           RamDiskType,
+           ParentDevicePath,
+           NULL,
+           DevicePath
+           );
+}
+
+/**
+  Create the RAM disk device and install its protocols.
+
+  @param[in]  RamDiskBase    The base address of registered RAM disk. For a
+                             sparse RAM disk, the address of its chunk table.
+  @param[in]  RamDiskSize    The size of registered RAM disk.
+  @param[in]  RamDiskType    The type of registered RAM disk.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path. If there is no
+                             parent device path then ParentDevicePath is NULL.
+  @param[in]  Sparse         The chunk data of a sparse RAM disk, or NULL for
+                             a RAM disk backed by contiguous memory.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+EFI_STATUS
+RamDiskRegisterWorker (
+  IN  UINT64                    RamDiskBase,
+  IN  UINT64                    RamDiskSize,
+  IN  EFI_GUID                  *RamDiskType,
+  IN  EFI_DEVICE_PATH           *ParentDevicePath     OPTIONAL,
+  IN  RAM_DISK_SPARSE_DATA      *Sparse               OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
+  )
+{
+  EFI_STATUS                  Status;
+  RAM_DISK_PRIVATE_DATA       *PrivateData;
+  RAM_DISK_PRIVATE_DATA       *RegisteredPrivateData;
+  MEDIA_RAM_DISK_DEVICE_PATH  *RamDiskDevNode;
+  UINTN                       DevicePathSize;
+  LIST_ENTRY                  *Entry;
+
   RamDiskDevNode = NULL;
 
   //
@@ -633,6 +682,11 @@ RamDiskRegister (
 
   PrivateData->StartingAddr = RamDiskBase;
   PrivateData->Size         = RamDiskSize;
+  PrivateData->Sparse       = Sparse;
+  if (Sparse != NULL) {
+    PrivateData->CreateMethod = RamDiskCreateSparse;
+  }
+
   CopyGuid (&PrivateData->TypeGuid, RamDiskType);
   InitializeListHead (&PrivateData->ThisInstance);
 
@@ -848,6 +902,10 @@ RamDiskUnregister (
           FreePool ((VOID *)(UINTN)PrivateData->StartingAddr);
         }
 
+        if (PrivateData->Sparse != NULL) {
+          RamDiskSparseFree (PrivateData);
+        }
+
         FreePool (PrivateData->DevicePath);
         FreePool (PrivateData);
         Found = TRUE;
@@ -0,0 +1,524 @@
+/** @file
+  The realization of EDKII_SPARSE_RAM_DISK_PROTOCOL.
+
+  A sparse RAM disk keeps its content in RAM_DISK_SPARSE_CHUNK_SIZE chunks.
+  Chunks that only contain zeros are not allocated, and chunks that have not
+  been supplied yet are fetched through the producer's Fill function the first
+  time they are accessed, so only the accessed part of an image needs to be
+  resident before the RAM disk can be used.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "RamDiskImpl.h"
+
+/**
+  Find a registered sparse RAM disk by its device path.
+
+  @param[in] DevicePath      A pointer to the device path that describes a
+                             sparse RAM disk device.
+
+  @return The RAM disk private data, or NULL if not found.
+
+**/
+RAM_DISK_PRIVATE_DATA *
+RamDiskSparseFind (
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  LIST_ENTRY             *Entry;
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  UINTN                  DevicePathSize;
+
+  DevicePathSize = GetDevicePathSize (DevicePath);
+
+  BASE_LIST_FOR_EACH (Entry, &RegisteredRamDisks) {
+    PrivateData = RAM_DISK_PRIVATE_FROM_THIS (Entry);
+    if ((PrivateData->Sparse != NULL) &&
+        (DevicePathSize == GetDevicePathSize (PrivateData->DevicePath)) &&
+        (CompareMem (DevicePath, PrivateData->DevicePath, DevicePathSize) == 0))
+    {
+      return PrivateData;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Get the number of bytes of a chunk that lie within the RAM disk.
+
+  @param[in] PrivateData     Points to RAM disk private data.
+  @param[in] ChunkIndex      The index of the chunk.
+
+  @return The size of the chunk.
+
+**/
+UINTN
+RamDiskSparseChunkLength (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN UINTN                  ChunkIndex
+  )
+{
+  UINT64  ChunkOffset;
+
+  ChunkOffset = MultU64x32 (ChunkIndex, RAM_DISK_SPARSE_CHUNK_SIZE);
+  return (UINTN)MIN (PrivateData->Size - ChunkOffset, RAM_DISK_SPARSE_CHUNK_SIZE);
+}
+
+/**
+  Store the content of an empty chunk, without allocating memory when the
+  content is all zeros.
+
+  @param[in] Sparse          Points to the sparse RAM disk data.
+  @param[in] Chunk           Points to the chunk.
+  @param[in] Data            The content, RAM_DISK_SPARSE_CHUNK_SIZE bytes
+                             allocated from pool. Ownership is transferred to
+                             the chunk unless the content is all zeros.
+
+**/
+VOID
+RamDiskSparseSetChunk (
+  IN RAM_DISK_SPARSE_DATA  *Sparse,
+  IN RAM_DISK_CHUNK        *Chunk,
+  IN UINT8                 *Data
+  )
+{
+  ASSERT (Chunk->State == RamDiskChunkEmpty);
+
+  if (IsZeroBuffer (Data, RAM_DISK_SPARSE_CHUNK_SIZE)) {
+    FreePool (Data);
+    Chunk->State = RamDiskChunkZero;
+    Sparse->ZeroChunks++;
+  } else {
+    Chunk->Data  = Data;
+    Chunk->State = RamDiskChunkResident;
+    Sparse->ResidentChunks++;
+  }
+}
+
+/**
+  Make sure the content of an empty chunk is known, fetching it through the
+  Fill function if one is registered.
+
+  @param[in] PrivateData     Points to RAM disk private data.
+  @param[in] ChunkIndex      The index of the chunk.
+
+  @retval EFI_SUCCESS             The chunk is no longer empty.
+  @retval EFI_DEVICE_ERROR        The chunk could not be fetched.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to hold the chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseLoadChunk (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN UINTN                  ChunkIndex
+  )
+{
+  EFI_STATUS            Status;
+  RAM_DISK_SPARSE_DATA  *Sparse;
+  RAM_DISK_CHUNK        *Chunk;
+  UINT8                 *Data;
+
+  Sparse = PrivateData->Sparse;
+  Chunk  = &Sparse->Chunks[ChunkIndex];
+  if (Chunk->State != RamDiskChunkEmpty) {
+    return EFI_SUCCESS;
+  }
+
+  if (Sparse->Fill == NULL) {
+    Chunk->State = RamDiskChunkZero;
+    Sparse->ZeroChunks++;
+    return EFI_SUCCESS;
+  }
+
+  Data = AllocateZeroPool (RAM_DISK_SPARSE_CHUNK_SIZE);
+  if (Data == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = Sparse->Fill (
+                     Sparse->FillContext,
+                     MultU64x32 (ChunkIndex, RAM_DISK_SPARSE_CHUNK_SIZE),
+                     RamDiskSparseChunkLength (PrivateData, ChunkIndex),
+                     Data
+                     );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "RamDiskSparseLoadChunk: Fill chunk %d - %r\n", ChunkIndex, Status));
+    FreePool (Data);
+    return EFI_DEVICE_ERROR;
+  }
+
+  Sparse->FilledChunks++;
+
+  //
+  // The producer may have supplied the chunk along with its neighbours.
+  //
+  if (Chunk->State != RamDiskChunkEmpty) {
+    FreePool (Data);
+    return EFI_SUCCESS;
+  }
+
+  RamDiskSparseSetChunk (Sparse, Chunk, Data);
+  return EFI_SUCCESS;
+}
+
+/**
+  Register a sparse RAM disk with specified size and type.
+
+  @param[in]  RamDiskSize    The size of registered RAM disk.
+  @param[in]  RamDiskType    The type of registered RAM disk.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path. If there is no
+                             parent device path then ParentDevicePath is NULL.
+  @param[in]  Fill           Optional function to fetch chunks that have not
+                             been supplied.
+  @param[in]  FillContext    The context passed to Fill.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_INVALID_PARAMETER   DevicePath or RamDiskType is NULL.
+                                  RamDiskSize is 0.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskSparseRegister (
+  IN  UINT64                      RamDiskSize,
+  IN  EFI_GUID                    *RamDiskType,
+  IN  EFI_DEVICE_PATH             *ParentDevicePath     OPTIONAL,
+  IN  EDKII_SPARSE_RAM_DISK_FILL  Fill                  OPTIONAL,
+  IN  VOID                        *FillContext          OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL    **DevicePath
+  )
+{
+  EFI_STATUS            Status;
+  RAM_DISK_SPARSE_DATA  *Sparse;
+  UINT64                ChunkCount;
+
+  if ((0 == RamDiskSize) || (NULL == RamDiskType) || (NULL == DevicePath)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ChunkCount = DivU64x32 (RamDiskSize + RAM_DISK_SPARSE_CHUNK_SIZE - 1, RAM_DISK_SPARSE_CHUNK_SIZE);
+  if ((RamDiskSize > MAX_UINT64 - RAM_DISK_SPARSE_CHUNK_SIZE) ||
+      (ChunkCount > DivU64x32 (MAX_UINTN, sizeof (RAM_DISK_CHUNK))))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Sparse = AllocateZeroPool (sizeof (RAM_DISK_SPARSE_DATA));
+  if (Sparse == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Sparse->ChunkCount  = (UINTN)ChunkCount;
+  Sparse->Fill        = Fill;
+  Sparse->FillContext = FillContext;
+  Sparse->Chunks      = AllocateZeroPool (Sparse->ChunkCount * sizeof (RAM_DISK_CHUNK));
+  if (Sparse->Chunks == NULL) {
+    FreePool (Sparse);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // The chunk table is unique to the RAM disk, so its address is used as the
+  // starting address in the RAM disk device path.
+  //
+  Status = RamDiskRegisterWorker (
+             (UINT64)(UINTN)Sparse->Chunks,
+             RamDiskSize,
+             RamDiskType,
+             ParentDevicePath,
+             Sparse,
+             DevicePath
+             );
+  if (EFI_ERROR (Status)) {
+    FreePool (Sparse->Chunks);
+    FreePool (Sparse);
+  }
+
+  return Status;
+}
+
+/**
+  Supply the content of a sparse RAM disk.
+
+  @param[in] DevicePath      A pointer to the device path that describes a
+                             sparse RAM disk device.
+  @param[in] Offset          The byte offset in the RAM disk.
+  @param[in] Length          The number of bytes in Buffer.
+  @param[in] Buffer          The content.
+
+  @retval EFI_SUCCESS             The content is supplied.
+  @retval EFI_INVALID_PARAMETER   The range is not chunk aligned or is out of
+                                  the RAM disk.
+  @retval EFI_NOT_FOUND           The sparse RAM disk pointed by DevicePath
+                                  doesn't exist.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to hold the
+                                  content.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskSparseSupply (
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN UINT64                    Offset,
+  IN UINTN                     Length,
+  IN VOID                      *Buffer
+  )
+{
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  RAM_DISK_SPARSE_DATA   *Sparse;
+  UINTN                  ChunkIndex;
+  UINTN                  ChunkLength;
+  UINT8                  *Data;
+  UINT8                  *Source;
+
+  if ((DevicePath == NULL) || ((Buffer == NULL) && (Length != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  PrivateData = RamDiskSparseFind (DevicePath);
+  if (PrivateData == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (((Offset % RAM_DISK_SPARSE_CHUNK_SIZE) != 0) ||
+      (Offset > PrivateData->Size) ||
+      (Length > PrivateData->Size - Offset) ||
+      (((Length % RAM_DISK_SPARSE_CHUNK_SIZE) != 0) && (Offset + Length != PrivateData->Size)))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Sparse     = PrivateData->Sparse;
+  Source     = Buffer;
+  ChunkIndex = (UINTN)DivU64x32 (Offset, RAM_DISK_SPARSE_CHUNK_SIZE);
+  while (Length != 0) {
+    ChunkLength = RamDiskSparseChunkLength (PrivateData, ChunkIndex);
+    if (Sparse->Chunks[ChunkIndex].State == RamDiskChunkEmpty) {
+      Data = AllocateZeroPool (RAM_DISK_SPARSE_CHUNK_SIZE);
+      if (Data == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      CopyMem (Data, Source, ChunkLength);
+      RamDiskSparseSetChunk (Sparse, &Sparse->Chunks[ChunkIndex], Data);
+    }
+
+    Source += ChunkLength;
+    Length -= ChunkLength;
+    ChunkIndex++;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Unregister a sparse RAM disk specified by DevicePath, and free the memory
+  that holds its content.
+
+  @param[in] DevicePath      A pointer to the device path that describes a
+                             sparse RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is unregistered successfully.
+  @retval EFI_INVALID_PARAMETER   DevicePath is NULL.
+  @retval EFI_NOT_FOUND           The sparse RAM disk pointed by DevicePath
+                                  doesn't exist.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskSparseUnregister (
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  if (DevicePath == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (RamDiskSparseFind (DevicePath) == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  return RamDiskUnregister (DevicePath);
+}
+
+/**
+  Read from a sparse RAM disk.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Offset         The byte offset in the RAM disk.
+  @param[in]  Length         The number of bytes to read.
+  @param[out] Buffer         The destination buffer.
+
+  @retval EFI_SUCCESS             The data was read.
+  @retval EFI_DEVICE_ERROR        A chunk could not be fetched.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to hold a
+                                  fetched chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseRead (
+  IN  RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN  UINT64                 Offset,
+  IN  UINTN                  Length,
+  OUT UINT8                  *Buffer
+  )
+{
+  EFI_STATUS      Status;
+  UINTN           ChunkIndex;
+  UINT32          ChunkOffset;
+  UINTN           CopyLength;
+  RAM_DISK_CHUNK  *Chunk;
+
+  ChunkIndex = (UINTN)DivU64x32Remainder (Offset, RAM_DISK_SPARSE_CHUNK_SIZE, &ChunkOffset);
+  while (Length != 0) {
+    Status = RamDiskSparseLoadChunk (PrivateData, ChunkIndex);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Chunk      = &PrivateData->Sparse->Chunks[ChunkIndex];
+    CopyLength = MIN (Length, RAM_DISK_SPARSE_CHUNK_SIZE - ChunkOffset);
+    if (Chunk->State == RamDiskChunkResident) {
+      CopyMem (Buffer, Chunk->Data + ChunkOffset, CopyLength);
+    } else {
+      ZeroMem (Buffer, CopyLength);
+    }
+
+    Buffer     += CopyLength;
+    Length     -= CopyLength;
+    ChunkOffset = 0;
+    ChunkIndex++;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Write to a sparse RAM disk.
+
+  @param[in] PrivateData     Points to RAM disk private data.
+  @param[in] Offset          The byte offset in the RAM disk.
+  @param[in] Length          The number of bytes to write.
+  @param[in] Buffer          The source buffer.
+
+  @retval EFI_SUCCESS             The data was written.
+  @retval EFI_DEVICE_ERROR        A chunk could not be fetched.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to hold the
+                                  written chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseWrite (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN UINT64                 Offset,
+  IN UINTN                  Length,
+  IN UINT8                  *Buffer
+  )
+{
+  EFI_STATUS            Status;
+  RAM_DISK_SPARSE_DATA  *Sparse;
+  UINTN                 ChunkIndex;
+  UINT32                ChunkOffset;
+  UINTN                 CopyLength;
+  RAM_DISK_CHUNK        *Chunk;
+
+  Sparse     = PrivateData->Sparse;
+  ChunkIndex = (UINTN)DivU64x32Remainder (Offset, RAM_DISK_SPARSE_CHUNK_SIZE, &ChunkOffset);
+  while (Length != 0) {
+    Chunk      = &Sparse->Chunks[ChunkIndex];
+    CopyLength = MIN (Length, RAM_DISK_SPARSE_CHUNK_SIZE - ChunkOffset);
+
+    //
+    // A chunk that is completely overwritten does not need to be fetched.
+    //
+    if ((Chunk->State == RamDiskChunkEmpty) &&
+        ((ChunkOffset != 0) || (CopyLength < RamDiskSparseChunkLength (PrivateData, ChunkIndex))))
+    {
+      Status = RamDiskSparseLoadChunk (PrivateData, ChunkIndex);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+
+    if (Chunk->State != RamDiskChunkResident) {
+      //
+      // Zero and empty chunks stay unallocated as long as only zeros are written.
+      //
+      if (IsZeroBuffer (Buffer, CopyLength)) {
+        if (Chunk->State == RamDiskChunkEmpty) {
+          Chunk->State = RamDiskChunkZero;
+          Sparse->ZeroChunks++;
+        }
+      } else {
+        Chunk->Data = AllocateZeroPool (RAM_DISK_SPARSE_CHUNK_SIZE);
+        if (Chunk->Data == NULL) {
+          return EFI_OUT_OF_RESOURCES;
+        }
+
+        if (Chunk->State == RamDiskChunkZero) {
+          Sparse->ZeroChunks--;
+        }
+
+        Chunk->State = RamDiskChunkResident;
+        Sparse->ResidentChunks++;
+      }
+    }
+
+    if (Chunk->State == RamDiskChunkResident) {
+      CopyMem (Chunk->Data + ChunkOffset, Buffer, CopyLength);
+    }
+
+    Buffer     += CopyLength;
+    Length     -= CopyLength;
+    ChunkOffset = 0;
+    ChunkIndex++;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Free the chunks of a sparse RAM disk.
+
+  @param[in] PrivateData     Points to RAM disk private data.
+
+**/
+VOID
+RamDiskSparseFree (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData
+  )
+{
+  RAM_DISK_SPARSE_DATA  *Sparse;
+  UINTN                 Index;
+
+  Sparse = PrivateData->Sparse;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "RamDiskSparseFree: %d chunks, %d resident, %d zero, %d fetched on demand\n",
+    Sparse->ChunkCount,
+    Sparse->ResidentChunks,
+    Sparse->ZeroChunks,
+    Sparse->FilledChunks
+    ));
+
+  for (Index = 0; Index < Sparse->ChunkCount; Index++) {
+    if (Sparse->Chunks[Index].State == RamDiskChunkResident) {
+      FreePool (Sparse->Chunks[Index].Data);
+    }
+  }
+
+  FreePool (Sparse->Chunks);
+  FreePool (Sparse);
+  PrivateData->Sparse = NULL;
+}
@@ -74,6 +74,7 @@ UdfOpenVolume (
     // There is no more open files. Read volume information again since it was
     // cleaned up on the last UdfClose() call.
     //
+    PurgeIcbCache (&PrivFsData->Volume);
     Status = ReadUdfVolumeInformation (
                PrivFsData->BlockIo,
                PrivFsData->DiskIo,
@@ -273,6 +274,10 @@ UdfOpen (
     (VOID *)&NewPrivFileData->ReadDirInfo,
     sizeof (UDF_READ_DIRECTORY_INFO)
     );
+  ZeroMem (
+    (VOID *)&NewPrivFileData->ExtentMap,
+    sizeof (UDF_EXTENT_MAP)
+    );
 
   *NewHandle = &NewPrivFileData->FileIo;
 
@@ -383,6 +388,7 @@ UdfRead (
                Volume,
                Parent,
                PrivFileData->FileSize,
+               &PrivFileData->ExtentMap,
                &PrivFileData->FilePosition,
                Buffer,
                &BufferSizeUint64
@@ -570,6 +576,10 @@ UdfClose (
     if (PrivFileData->ReadDirInfo.DirectoryData != NULL) {
       FreePool (PrivFileData->ReadDirInfo.DirectoryData);
     }
+
+    if (PrivFileData->ExtentMap.Extents != NULL) {
+      FreePool (PrivFileData->ExtentMap.Extents);
+    }
   }
 
   FreePool ((VOID *)PrivFileData);
@@ -1053,6 +1053,177 @@ GrowUpBufferToNextAd (
   return EFI_SUCCESS;
 }
 
+/**
+  Append an extent to the extent map of a file. The extent is merged into the
+  last one of the map if the two are adjacent on the disk.
+
+  @param[in, out] ExtentMap       Extent map of the file.
+  @param[in]      FileOffset      File offset of the extent.
+  @param[in]      DiskOffset      Disk offset of the extent.
+  @param[in]      Length          Length of the extent.
+
+  @retval EFI_SUCCESS             The extent was appended.
+  @retval EFI_OUT_OF_RESOURCES    The extent was not appended due to lack of
+                                  resources.
+
+**/
+EFI_STATUS
+AppendExtent (
+  IN OUT  UDF_EXTENT_MAP  *ExtentMap,
+  IN      UINT64          FileOffset,
+  IN      UINT64          DiskOffset,
+  IN      UINT64          Length
+  )
+{
+  UDF_EXTENT  *Extent;
+  UDF_EXTENT  *Extents;
+  UINTN       MaxCount;
+
+  if (ExtentMap->Count > 0) {
+    Extent = &ExtentMap->Extents[ExtentMap->Count - 1];
+    if ((Extent->FileOffset + Extent->Length == FileOffset) &&
+        (Extent->DiskOffset + Extent->Length == DiskOffset))
+    {
+      Extent->Length += Length;
+      return EFI_SUCCESS;
+    }
+  }
+
+  if (ExtentMap->Count == ExtentMap->MaxCount) {
+    MaxCount = (ExtentMap->MaxCount == 0) ? 16 : ExtentMap->MaxCount * 2;
+    Extents  = ReallocatePool (
+                 ExtentMap->MaxCount * sizeof (UDF_EXTENT),
+                 MaxCount * sizeof (UDF_EXTENT),
+                 ExtentMap->Extents
+                 );
+    if (Extents == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    ExtentMap->Extents  = Extents;
+    ExtentMap->MaxCount = MaxCount;
+  }
+
+  Extent             = &ExtentMap->Extents[ExtentMap->Count++];
+  Extent->FileOffset = FileOffset;
+  Extent->DiskOffset = DiskOffset;
+  Extent->Length     = Length;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Release an entry of the ICB cache of an UDF volume.
+
+  @param[in, out] Entry           ICB cache entry pointer.
+
+**/
+VOID
+FreeIcbCacheEntry (
+  IN OUT  UDF_ICB_CACHE_ENTRY  *Entry
+  )
+{
+  if (Entry->FileEntry != NULL) {
+    FreePool (Entry->FileEntry);
+  }
+
+  if (Entry->DirectoryData != NULL) {
+    FreePool (Entry->DirectoryData);
+  }
+
+  ZeroMem ((VOID *)Entry, sizeof (UDF_ICB_CACHE_ENTRY));
+}
+
+/**
+  Release the File Entries and directory data cached for an UDF volume.
+
+  @param[in] Volume Volume information pointer.
+
+**/
+VOID
+PurgeIcbCache (
+  IN UDF_VOLUME_INFO  *Volume
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < UDF_ICB_CACHE_SIZE; Index++) {
+    FreeIcbCacheEntry (&Volume->IcbCache[Index]);
+  }
+
+  Volume->IcbCacheNext = 0;
+}
+
+/**
+  Look up a File Entry in the ICB cache of an UDF volume.
+
+  The cache is purged first if the media has changed since it was filled.
+
+  @param[in]  BlockIo             BlockIo interface.
+  @param[in]  Volume              Volume information pointer.
+  @param[in]  Lsn                 Logical sector number of the File Entry.
+
+  @return The cache entry of the File Entry, or NULL if it is not cached.
+
+**/
+UDF_ICB_CACHE_ENTRY *
+LookupIcbCache (
+  IN EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN UDF_VOLUME_INFO        *Volume,
+  IN UINT64                 Lsn
+  )
+{
+  UINTN  Index;
+
+  if (Volume->IcbCacheMediaId != BlockIo->Media->MediaId) {
+    PurgeIcbCache (Volume);
+    Volume->IcbCacheMediaId = BlockIo->Media->MediaId;
+    return NULL;
+  }
+
+  for (Index = 0; Index < UDF_ICB_CACHE_SIZE; Index++) {
+    if ((Volume->IcbCache[Index].FileEntry != NULL) &&
+        (Volume->IcbCache[Index].Lsn == Lsn))
+    {
+      return &Volume->IcbCache[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Add a File Entry to the ICB cache of an UDF volume. When the cache is full,
+  the entry that was added first is replaced.
+
+  @param[in]  Volume              Volume information pointer.
+  @param[in]  Lsn                 Logical sector number of the File Entry.
+  @param[in]  FileEntry           File Entry or Extended File Entry.
+
+**/
+VOID
+InsertIcbCache (
+  IN UDF_VOLUME_INFO  *Volume,
+  IN UINT64           Lsn,
+  IN VOID             *FileEntry
+  )
+{
+  UDF_ICB_CACHE_ENTRY  *Entry;
+  VOID                 *FileEntryCopy;
+
+  FileEntryCopy = AllocateCopyPool (Volume->FileEntrySize, FileEntry);
+  if (FileEntryCopy == NULL) {
+    return;
+  }
+
+  Entry = &Volume->IcbCache[Volume->IcbCacheNext];
+  FreeIcbCacheEntry (Entry);
+  Entry->Lsn       = Lsn;
+  Entry->FileEntry = FileEntryCopy;
+
+  Volume->IcbCacheNext = (Volume->IcbCacheNext + 1) % UDF_ICB_CACHE_SIZE;
+}
+
 /**
   Read data or size of either a File Entry or an Extended File Entry.
 
@@ -1123,6 +1294,14 @@ ReadFile (
       ReadFileInfo->ReadLength = 0;
       ReadFileInfo->FileData   = NULL;
       break;
+    case ReadFileGetExtentMap:
+      //
+      // About to map the file's extents. ReadLength tracks the file offset of
+      // the next extent.
+      //
+      ReadFileInfo->ReadLength       = 0;
+      ReadFileInfo->ExtentMap->Count = 0;
+      break;
     case ReadFileSeekAndRead:
       //
       // About to seek a file and/or read its data.
@@ -1270,6 +1449,19 @@ ReadFile (
 
         switch (ReadFileInfo->Flags) {
           case ReadFileGetFileSize:
+            ReadFileInfo->ReadLength += ExtentLength;
+            break;
+          case ReadFileGetExtentMap:
+            Status = AppendExtent (
+                       ReadFileInfo->ExtentMap,
+                       ReadFileInfo->ReadLength,
+                       MultU64x32 (Lsn, LogicalBlockSize),
+                       ExtentLength
+                       );
+            if (EFI_ERROR (Status)) {
+              goto Error_Alloc_Buffer_To_Next_Ad;
+            }
+
             ReadFileInfo->ReadLength += ExtentLength;
             break;
           case ReadFileAllocateAndRead:
@@ -1403,7 +1595,7 @@ Done:
 
 Error_Read_Disk_Blk:
 Error_Alloc_Buffer_To_Next_Ad:
-  if (ReadFileInfo->Flags != ReadFileSeekAndRead) {
+  if (ReadFileInfo->Flags == ReadFileAllocateAndRead) {
     FreePool (ReadFileInfo->FileData);
   }
 
@@ -1736,17 +1928,32 @@ FindFileEntry (
   OUT  VOID                            **FileEntry
   )
 {
-  EFI_STATUS          Status;
-  UINT64              Lsn;
-  UINT32              LogicalBlockSize;
-  UDF_DESCRIPTOR_TAG  *DescriptorTag;
-  VOID                *ReadBuffer;
+  EFI_STATUS           Status;
+  UINT64               Lsn;
+  UINT32               LogicalBlockSize;
+  UDF_DESCRIPTOR_TAG   *DescriptorTag;
+  VOID                 *ReadBuffer;
+  UDF_ICB_CACHE_ENTRY  *CacheEntry;
 
   Status = GetLongAdLsn (Volume, Icb, &Lsn);
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
+  //
+  // Files on the same path are looked up again and again, so keep the FE/EFEs
+  // that were read recently.
+  //
+  CacheEntry = LookupIcbCache (BlockIo, Volume, Lsn);
+  if (CacheEntry != NULL) {
+    *FileEntry = AllocateCopyPool (Volume->FileEntrySize, CacheEntry->FileEntry);
+    if (*FileEntry == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    return EFI_SUCCESS;
+  }
+
   LogicalBlockSize = Volume->LogicalVolDesc.LogicalBlockSize;
 
   ReadBuffer = AllocateZeroPool (Volume->FileEntrySize);
@@ -1781,6 +1988,8 @@ FindFileEntry (
     goto Error_Invalid_Fe;
   }
 
+  InsertIcbCache (Volume, Lsn, ReadBuffer);
+
   *FileEntry = ReadBuffer;
   return EFI_SUCCESS;
 
@@ -1982,31 +2191,75 @@ ReadDirectoryEntry (
   EFI_STATUS                      Status;
   UDF_READ_FILE_INFO              ReadFileInfo;
   UDF_FILE_IDENTIFIER_DESCRIPTOR  *FileIdentifierDesc;
+  UINT64                          Lsn;
+  UDF_ICB_CACHE_ENTRY             *CacheEntry;
 
   if (ReadDirInfo->DirectoryData == NULL) {
     //
     // The directory's recorded data has not been read yet. So let's cache it
     // into memory and the next calls won't need to read it again.
     //
-    ReadFileInfo.Flags = ReadFileAllocateAndRead;
-
-    Status = ReadFile (
-               BlockIo,
-               DiskIo,
-               Volume,
-               ParentIcb,
-               FileEntryData,
-               &ReadFileInfo
-               );
-    if (EFI_ERROR (Status)) {
-      return Status;
+    // The data may be kept along with the directory's FE/EFE in the ICB cache
+    // of the volume, from an earlier listing of the same directory.
+    //
+    CacheEntry = NULL;
+    if (!EFI_ERROR (GetLongAdLsn (Volume, ParentIcb, &Lsn))) {
+      CacheEntry = LookupIcbCache (BlockIo, Volume, Lsn);
+      if ((CacheEntry != NULL) &&
+          (CompareMem (
+             CacheEntry->FileEntry,
+             FileEntryData,
+             Volume->FileEntrySize
+             ) != 0))
+      {
+        CacheEntry = NULL;
+      }
     }
 
-    //
-    // Fill in ReadDirInfo structure with the read directory's data information.
-    //
-    ReadDirInfo->DirectoryData   = ReadFileInfo.FileData;
-    ReadDirInfo->DirectoryLength = ReadFileInfo.ReadLength;
+    if ((CacheEntry != NULL) && (CacheEntry->DirectoryData != NULL)) {
+      ReadDirInfo->DirectoryData = AllocateCopyPool (
+                                     (UINTN)CacheEntry->DirectoryLength,
+                                     CacheEntry->DirectoryData
+                                     );
+      if (ReadDirInfo->DirectoryData == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      ReadDirInfo->DirectoryLength = CacheEntry->DirectoryLength;
+    } else {
+      ReadFileInfo.Flags = ReadFileAllocateAndRead;
+
+      Status = ReadFile (
+                 BlockIo,
+                 DiskIo,
+                 Volume,
+                 ParentIcb,
+                 FileEntryData,
+                 &ReadFileInfo
+                 );
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      //
+      // Fill in ReadDirInfo structure with the read directory's data information.
+      //
+      ReadDirInfo->DirectoryData   = ReadFileInfo.FileData;
+      ReadDirInfo->DirectoryLength = ReadFileInfo.ReadLength;
+
+      if ((CacheEntry != NULL) &&
+          (ReadFileInfo.ReadLength > 0) &&
+          (ReadFileInfo.ReadLength <= UDF_ICB_CACHE_MAX_DIR_SIZE))
+      {
+        CacheEntry->DirectoryData = AllocateCopyPool (
+                                      (UINTN)ReadFileInfo.ReadLength,
+                                      ReadFileInfo.FileData
+                                      );
+        if (CacheEntry->DirectoryData != NULL) {
+          CacheEntry->DirectoryLength = ReadFileInfo.ReadLength;
+        }
+      }
+    }
   }
 
   do {
@@ -2848,6 +3101,98 @@ Out_Free:
   return Status;
 }
 
+/**
+  Read data of a file on an UDF volume through its extent map.
+
+  @param[in]      BlockIo       BlockIo interface.
+  @param[in]      DiskIo        DiskIo interface.
+  @param[in]      ExtentMap     Extent map of the file.
+  @param[in]      FileSize      Size of the file.
+  @param[in, out] FilePosition  File position.
+  @param[in, out] Buffer        File data.
+  @param[in, out] BufferSize    Read size.
+
+  @retval EFI_SUCCESS          File data read.
+  @retval EFI_NO_MEDIA         The device has no media.
+  @retval EFI_DEVICE_ERROR     The device reported an error.
+
+**/
+EFI_STATUS
+ReadExtentMapData (
+  IN      EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN      EFI_DISK_IO_PROTOCOL   *DiskIo,
+  IN      UDF_EXTENT_MAP         *ExtentMap,
+  IN      UINT64                 FileSize,
+  IN OUT  UINT64                 *FilePosition,
+  IN OUT  VOID                   *Buffer,
+  IN OUT  UINT64                 *BufferSize
+  )
+{
+  EFI_STATUS  Status;
+  UDF_EXTENT  *Extent;
+  UINTN       Low;
+  UINTN       High;
+  UINTN       Middle;
+  UINT64      Position;
+  UINT64      Offset;
+  UINT64      DataOffset;
+  UINT64      DataLength;
+  UINT64      BytesLeft;
+
+  if (*BufferSize > FileSize - *FilePosition) {
+    //
+    // About to read beyond the EOF -- truncate it.
+    //
+    *BufferSize = FileSize - *FilePosition;
+  }
+
+  //
+  // Find the extent that holds the file position.
+  //
+  Low  = 0;
+  High = ExtentMap->Count;
+  while (High - Low > 1) {
+    Middle = Low + (High - Low) / 2;
+    if (ExtentMap->Extents[Middle].FileOffset <= *FilePosition) {
+      Low = Middle;
+    } else {
+      High = Middle;
+    }
+  }
+
+  Position   = *FilePosition;
+  DataOffset = 0;
+  BytesLeft  = *BufferSize;
+  for ( ; (Low < ExtentMap->Count) && (BytesLeft > 0); Low++) {
+    Extent = &ExtentMap->Extents[Low];
+    if (Position >= Extent->FileOffset + Extent->Length) {
+      continue;
+    }
+
+    Offset     = Position - Extent->FileOffset;
+    DataLength = MIN (Extent->Length - Offset, BytesLeft);
+
+    Status = DiskIo->ReadDisk (
+                       DiskIo,
+                       BlockIo->Media->MediaId,
+                       Extent->DiskOffset + Offset,
+                       (UINTN)DataLength,
+                       (VOID *)((UINT8 *)Buffer + DataOffset)
+                       );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    DataOffset += DataLength;
+    Position   += DataLength;
+    BytesLeft  -= DataLength;
+  }
+
+  *FilePosition = Position;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Seek a file and read its data into memory on an UDF volume.
 
@@ -2856,6 +3201,8 @@ Out_Free:
   @param[in]      Volume        UDF volume information structure.
   @param[in]      File          File information structure.
   @param[in]      FileSize      Size of the file.
+  @param[in, out] ExtentMap     Extent map of the file. It is built on the
+                                first read, and used by the later ones.
   @param[in, out] FilePosition  File position.
   @param[in, out] Buffer        File data.
   @param[in, out] BufferSize    Read size.
@@ -2876,13 +3223,54 @@ ReadFileData (
   IN      UDF_VOLUME_INFO        *Volume,
   IN      UDF_FILE_INFO          *File,
   IN      UINT64                 FileSize,
+  IN OUT  UDF_EXTENT_MAP         *ExtentMap,
   IN OUT  UINT64                 *FilePosition,
   IN OUT  VOID                   *Buffer,
   IN OUT  UINT64                 *BufferSize
   )
 {
-  EFI_STATUS          Status;
-  UDF_READ_FILE_INFO  ReadFileInfo;
+  EFI_STATUS              Status;
+  UDF_READ_FILE_INFO      ReadFileInfo;
+  UDF_FE_RECORDING_FLAGS  RecordingFlags;
+
+  //
+  // Seeking through the Allocation Descriptors (and reading the Allocation
+  // Extent Descriptors) of a file on every read makes reading a large file in
+  // chunks slow. Walk them once instead, and keep the extent map of the file.
+  //
+  RecordingFlags = GET_FE_RECORDING_FLAGS (File->FileEntry);
+  if ((ExtentMap->Extents == NULL) &&
+      ((RecordingFlags == LongAdsSequence) ||
+       (RecordingFlags == ShortAdsSequence)))
+  {
+    ReadFileInfo.Flags     = ReadFileGetExtentMap;
+    ReadFileInfo.ExtentMap = ExtentMap;
+
+    Status = ReadFile (
+               BlockIo,
+               DiskIo,
+               Volume,
+               &File->FileIdentifierDesc->Icb,
+               File->FileEntry,
+               &ReadFileInfo
+               );
+    if (EFI_ERROR (Status) && (ExtentMap->Extents != NULL)) {
+      FreePool (ExtentMap->Extents);
+      ZeroMem ((VOID *)ExtentMap, sizeof (UDF_EXTENT_MAP));
+    }
+  }
+
+  if (ExtentMap->Extents != NULL) {
+    return ReadExtentMapData (
+             BlockIo,
+             DiskIo,
+             ExtentMap,
+             FileSize,
+             FilePosition,
+             Buffer,
+             BufferSize
+             );
+  }
 
   ReadFileInfo.Flags        = ReadFileSeekAndRead;
   ReadFileInfo.FilePosition = *FilePosition;
@@ -273,6 +273,7 @@ UdfDriverBindingStop (
                     NULL
                     );
 
+    PurgeIcbCache (&PrivFsData->Volume);
     FreePool ((VOID *)PrivFsData);
   }
 
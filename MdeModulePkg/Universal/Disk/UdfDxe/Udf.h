@@ -134,8 +134,25 @@ typedef enum {
   ReadFileGetFileSize,
   ReadFileAllocateAndRead,
   ReadFileSeekAndRead,
+  ReadFileGetExtentMap,
 } UDF_READ_FILE_FLAGS;
 
+//
+// A run of a file's recorded data that is contiguous on the disk. Adjacent
+// extents are merged, so that reading across them takes one DiskIo call.
+//
+typedef struct {
+  UINT64    FileOffset;
+  UINT64    DiskOffset;
+  UINT64    Length;
+} UDF_EXTENT;
+
+typedef struct {
+  UDF_EXTENT    *Extents;
+  UINTN         Count;
+  UINTN         MaxCount;
+} UDF_EXTENT_MAP;
+
 typedef struct {
   VOID                   *FileData;
   UDF_READ_FILE_FLAGS    Flags;
@@ -143,6 +160,7 @@ typedef struct {
   UINT64                 FilePosition;
   UINT64                 FileSize;
   UINT64                 ReadLength;
+  UDF_EXTENT_MAP         *ExtentMap;
 } UDF_READ_FILE_INFO;
 
 #pragma pack(1)
@@ -309,6 +327,20 @@ typedef struct {
 
 #pragma pack()
 
+//
+// Number of File Entries kept in memory per volume, and the largest directory
+// whose recorded data (FIDs) is kept along with its File Entry.
+//
+#define UDF_ICB_CACHE_SIZE          64
+#define UDF_ICB_CACHE_MAX_DIR_SIZE  SIZE_256KB
+
+typedef struct {
+  UINT64    Lsn;
+  VOID      *FileEntry;
+  VOID      *DirectoryData;
+  UINT64    DirectoryLength;
+} UDF_ICB_CACHE_ENTRY;
+
 //
 // UDF filesystem driver's private data
 //
@@ -318,6 +350,9 @@ typedef struct {
   UDF_PARTITION_DESCRIPTOR         PartitionDesc;
   UDF_FILE_SET_DESCRIPTOR          FileSetDesc;
   UINTN                            FileEntrySize;
+  UINT32                           IcbCacheMediaId;
+  UINTN                            IcbCacheNext;
+  UDF_ICB_CACHE_ENTRY              IcbCache[UDF_ICB_CACHE_SIZE];
 } UDF_VOLUME_INFO;
 
 typedef struct {
@@ -353,6 +388,7 @@ typedef struct {
   CHAR16                             FileName[UDF_FILENAME_LENGTH];
   UINT64                             FileSize;
   UINT64                             FilePosition;
+  UDF_EXTENT_MAP                     ExtentMap;
 } PRIVATE_UDF_FILE_DATA;
 
 #define PRIVATE_UDF_SIMPLE_FS_DATA_SIGNATURE  SIGNATURE_32 ('U', 'd', 'f', 's')
@@ -841,6 +877,17 @@ CleanupFileInformation (
   IN UDF_FILE_INFO  *File
   );
 
+/**
+  Release the File Entries and directory data cached for an UDF volume.
+
+  @param[in] Volume Volume information pointer.
+
+**/
+VOID
+PurgeIcbCache (
+  IN UDF_VOLUME_INFO  *Volume
+  );
+
 /**
   Find a file from its absolute path on an UDF volume.
 
@@ -962,6 +1009,8 @@ GetVolumeSize (
   @param[in]      Volume        UDF volume information structure.
   @param[in]      File          File information structure.
   @param[in]      FileSize      Size of the file.
+  @param[in, out] ExtentMap     Extent map of the file. It is built on the
+                                first read, and used by the later ones.
   @param[in, out] FilePosition  File position.
   @param[in, out] Buffer        File data.
   @param[in, out] BufferSize    Read size.
@@ -982,6 +1031,7 @@ ReadFileData (
   IN      UDF_VOLUME_INFO        *Volume,
   IN      UDF_FILE_INFO          *File,
   IN      UINT64                 FileSize,
+  IN OUT  UDF_EXTENT_MAP         *ExtentMap,
   IN OUT  UINT64                 *FilePosition,
   IN OUT  VOID                   *Buffer,
   IN OUT  UINT64                 *BufferSize
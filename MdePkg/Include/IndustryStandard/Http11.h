@@ -75,6 +75,21 @@
 ///
 #define HTTP_HEADER_ACCEPT_RANGES  "Accept-Ranges"
 
+///
+/// Range Request Header
+/// The Range request-header field asks the server to transfer only
+/// one or more sub-ranges of the selected representation.
+///
+#define HTTP_HEADER_RANGE        "Range"
+#define HTTP_HEADER_RANGE_BYTES  "bytes"
+
+///
+/// Content-Range Header
+/// The Content-Range entity-header field is sent with a partial
+/// entity-body to specify where in the full entity-body it belongs.
+///
+#define HTTP_HEADER_CONTENT_RANGE  "Content-Range"
+
 ///
 /// Accept-Encoding Request Header
 /// The Accept-Encoding request-header field is similar to Accept,
@@ -1671,6 +1671,7 @@ ScsiRead10CommandEx (
   Context->SenseDataLength   = SenseDataLength;
   Context->HostAdapterStatus = HostAdapterStatus;
   Context->TargetStatus      = TargetStatus;
+  Context->DataLength        = DataLength;
   Context->CallerEvent       = Event;
 
   CommandPacket                   = &Context->CommandPacket;
@@ -1717,6 +1718,10 @@ ScsiRead10CommandEx (
   }
 
 ErrorExit:
+  if (Cdb != NULL) {
+    FreePool (Cdb);
+  }
+
   if (Context != NULL) {
     FreePool (Context);
   }
@@ -1854,6 +1859,7 @@ ScsiWrite10CommandEx (
   Context->SenseDataLength   = SenseDataLength;
   Context->HostAdapterStatus = HostAdapterStatus;
   Context->TargetStatus      = TargetStatus;
+  Context->DataLength        = DataLength;
   Context->CallerEvent       = Event;
 
   CommandPacket                    = &Context->CommandPacket;
@@ -1900,6 +1906,10 @@ ScsiWrite10CommandEx (
   }
 
 ErrorExit:
+  if (Cdb != NULL) {
+    FreePool (Cdb);
+  }
+
   if (Context != NULL) {
     FreePool (Context);
   }
@@ -2037,6 +2047,7 @@ ScsiRead16CommandEx (
   Context->SenseDataLength   = SenseDataLength;
   Context->HostAdapterStatus = HostAdapterStatus;
   Context->TargetStatus      = TargetStatus;
+  Context->DataLength        = DataLength;
   Context->CallerEvent       = Event;
 
   CommandPacket                   = &Context->CommandPacket;
@@ -2083,6 +2094,10 @@ ScsiRead16CommandEx (
   }
 
 ErrorExit:
+  if (Cdb != NULL) {
+    FreePool (Cdb);
+  }
+
   if (Context != NULL) {
     FreePool (Context);
   }
@@ -2220,6 +2235,7 @@ ScsiWrite16CommandEx (
   Context->SenseDataLength   = SenseDataLength;
   Context->HostAdapterStatus = HostAdapterStatus;
   Context->TargetStatus      = TargetStatus;
+  Context->DataLength        = DataLength;
   Context->CallerEvent       = Event;
 
   CommandPacket                    = &Context->CommandPacket;
@@ -2266,6 +2282,10 @@ ScsiWrite16CommandEx (
   }
 
 ErrorExit:
+  if (Cdb != NULL) {
+    FreePool (Cdb);
+  }
+
   if (Context != NULL) {
     FreePool (Context);
   }
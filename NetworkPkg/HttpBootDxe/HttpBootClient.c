@@ -597,21 +597,22 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create and configure a HttpIo instance on the station address of the driver.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[out]   HttpIo         The HttpIo instance to create.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+HttpBootOpenHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  OUT    HTTP_IO                 *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA  ConfigData;
-  EFI_STATUS           Status;
   EFI_HANDLE           ImageHandle;
   UINT32               TimeoutValue;
 
@@ -636,15 +637,34 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
-             HttpBootHttpIoCallback,
-             (VOID *)Private,
-             &Private->HttpIo
-             );
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           HttpBootHttpIoCallback,
+           (VOID *)Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = HttpBootOpenHttpIo (Private, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -868,7 +888,8 @@ HttpBootGetBootFileCallback (
   }
 
   //
-  // Copy data if caller has provided a buffer.
+  // Copy data if caller has provided a buffer. The data may have been received
+  // into the caller's buffer already, a little past its final place.
   //
   if (CallbackData->BufferSize > CallbackData->CopyedSize) {
     CopyMem (
@@ -951,6 +972,7 @@ HttpBootGetBootFile (
   CHAR16                   *Url;
   BOOLEAN                  IdentityMode;
   UINTN                    ReceivedSize;
+  EFI_HTTP_HEADER          *Header;
 
   ASSERT (Private != NULL);
   ASSERT (Private->HttpCreated);
@@ -1140,6 +1162,15 @@ HttpBootGetBootFile (
     goto ERROR_5;
   }
 
+  //
+  // Remember whether the server accepts byte range requests for the file,
+  // so that it can be downloaded over several connections.
+  //
+  if (HeaderOnly) {
+    Header                = HttpFindHeader (ResponseData->HeaderCount, ResponseData->Headers, HTTP_HEADER_ACCEPT_RANGES);
+    Private->AcceptRanges = (BOOLEAN)((Header != NULL) && (AsciiStriCmp (Header->FieldValue, HTTP_HEADER_RANGE_BYTES) == 0));
+  }
+
   //
   // 3.2 Cache the response header.
   //
@@ -1236,27 +1267,42 @@ HttpBootGetBootFile (
       //
       Block = NULL;
       while (!HttpIsMessageComplete (Parser)) {
-        //
-        // Allocate a buffer in Block to hold the message-body.
-        // If caller provides a buffer, this Block will be reused in every HttpIoRecvResponse().
-        // Otherwise a buffer, the buffer in Block will be cached and we should allocate a new before
-        // every HttpIoRecvResponse().
-        //
-        if ((Block == NULL) || (Context.BufferSize == 0)) {
-          Block = AllocatePool (HTTP_BOOT_BLOCK_SIZE);
-          if (Block == NULL) {
-            Status = EFI_OUT_OF_RESOURCES;
-            goto ERROR_6;
+        if ((Context.BufferSize > Context.CopyedSize) &&
+            (Context.BufferSize - Context.CopyedSize >= HTTP_BOOT_BLOCK_SIZE))
+        {
+          //
+          // Receive the message-body right after the entity data already in the
+          // caller's buffer. The entity data of the received block is never longer
+          // than the block, so HttpBootGetBootFileCallback() only has to move it
+          // down over the chunk headers, instead of copying it from another buffer.
+          //
+          Context.NewBlock        = FALSE;
+          ResponseBody.Body       = (CHAR8 *)Context.Buffer + Context.CopyedSize;
+          ResponseBody.BodyLength = Context.BufferSize - Context.CopyedSize;
+        } else {
+          //
+          // Allocate a buffer in Block to hold the message-body.
+          // If caller provides a buffer, this Block will be reused in every HttpIoRecvResponse().
+          // Otherwise a buffer, the buffer in Block will be cached and we should allocate a new before
+          // every HttpIoRecvResponse().
+          //
+          if ((Block == NULL) || (Context.BufferSize == 0)) {
+            Block = AllocatePool (HTTP_BOOT_BLOCK_SIZE);
+            if (Block == NULL) {
+              Status = EFI_OUT_OF_RESOURCES;
+              goto ERROR_6;
+            }
+
+            Context.NewBlock = TRUE;
+            Context.Block    = Block;
+          } else {
+            Context.NewBlock = FALSE;
           }
 
-          Context.NewBlock = TRUE;
-          Context.Block    = Block;
-        } else {
-          Context.NewBlock = FALSE;
+          ResponseBody.Body       = (CHAR8 *)Block;
+          ResponseBody.BodyLength = HTTP_BOOT_BLOCK_SIZE;
         }
 
-        ResponseBody.Body       = (CHAR8 *)Block;
-        ResponseBody.BodyLength = HTTP_BOOT_BLOCK_SIZE;
         Status                  = HttpIoRecvResponse (
                                     &Private->HttpIo,
                                     FALSE,
@@ -1307,6 +1353,8 @@ HttpBootGetBootFile (
   if (Cache != NULL) {
     Cache->EntityLength = ContentLength;
     InsertTailList (&Private->CacheList, &Cache->Link);
+  } else if (Context.Block != NULL) {
+    FreePool (Context.Block);
   }
 
   if (Parser != NULL) {
@@ -1350,3 +1398,440 @@ ERROR_1:
 
   return Status;
 }
+
+/**
+  Create the headers of a Range request for the boot file: the same headers
+  as a download of the whole file, with room for the Range header.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[out]      HttpIoHeader    The headers created, to be freed with
+                                   HttpIoFreeHeader().
+
+  @retval EFI_SUCCESS              The headers are created.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootCreateRangeHeader (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  OUT    HTTP_IO_HEADER          **HttpIoHeader
+  )
+{
+  EFI_STATUS      Status;
+  HTTP_IO_HEADER  *Header;
+  CHAR8           *HostName;
+
+  Header = HttpIoCreateHeader (4);
+  if (Header == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  HostName = NULL;
+  Status   = HttpUrlGetHostName (
+               Private->BootFileUri,
+               Private->BootFileUriParser,
+               &HostName
+               );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_HOST, HostName);
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_ACCEPT, "*/*");
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_USER_AGENT, HTTP_USER_AGENT_EFI_HTTP_BOOT);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  *HttpIoHeader = Header;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  HttpIoFreeHeader (Header);
+  return Status;
+}
+
+/**
+  Set the Range header of a request to the part of the file requested.
+
+  @param[in, out]  HttpIoHeader    The headers of the request.
+  @param[in]       Range           The part of the file requested.
+
+  @retval EFI_SUCCESS              The Range header is set.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootSetRangeHeader (
+  IN OUT HTTP_IO_HEADER   *HttpIoHeader,
+  IN     HTTP_BOOT_RANGE  *Range
+  )
+{
+  CHAR8  RangeValue[HTTP_BOOT_RANGE_VALUE_LENGTH];
+
+  AsciiSPrint (
+    RangeValue,
+    sizeof (RangeValue),
+    "%a=%Lu-%Lu",
+    HTTP_HEADER_RANGE_BYTES,
+    (UINT64)Range->Offset,
+    (UINT64)(Range->End - 1)
+    );
+  return HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_RANGE, RangeValue);
+}
+
+/**
+  This function downloads the boot file over several HTTP connections in parallel,
+  each of them requesting a part of the file with a Range request. The parts are
+  received directly into the caller's buffer.
+
+  The data of all the connections keeps arriving into their TCP receive buffers,
+  while the connections are drained in turn here.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       BufferSize      The size of the boot file, which fits in Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The ranges could not be requested, or the server doesn't
+                                   serve them as requested. Nothing is received into Buffer,
+                                   the file should be downloaded over a single connection.
+  @retval Others                   Unexpected error happened while the body was received.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileRanges (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     UINTN                   BufferSize,
+  OUT    UINT8                   *Buffer
+  )
+{
+  EFI_STATUS             Status;
+  HTTP_BOOT_RANGE        *Ranges;
+  HTTP_BOOT_RANGE        *Range;
+  UINTN                  Count;
+  UINTN                  Index;
+  BOOLEAN                Pending;
+  BOOLEAN                BodyStarted;
+  HTTP_IO_HEADER         *HttpIoHeader;
+  EFI_HTTP_REQUEST_DATA  RequestData;
+  HTTP_IO_RESPONSE_DATA  ResponseData;
+  UINTN                  UrlSize;
+  CHAR16                 *Url;
+
+  ASSERT (Private != NULL);
+  ASSERT (Buffer != NULL);
+
+  Count = HttpBootSplitRanges (BufferSize, PcdGet8 (PcdHttpBootRangeConnections), NULL);
+  if (Count == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Ranges       = NULL;
+  HttpIoHeader = NULL;
+  Url          = NULL;
+  BodyStarted  = FALSE;
+
+  Ranges = AllocateZeroPool (Count * sizeof (HTTP_BOOT_RANGE));
+  if (Ranges == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  UrlSize = AsciiStrSize (Private->BootFileUri);
+  Url     = AllocatePool (UrlSize * sizeof (CHAR16));
+  if (Url == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  AsciiStrToUnicodeStrS (Private->BootFileUri, Url, UrlSize);
+  RequestData.Method = HttpMethodGet;
+  RequestData.Url    = Url;
+
+  Status = HttpBootCreateRangeHeader (Private, &HttpIoHeader);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  //
+  // Send all the requests first, so that the server works on all of them.
+  //
+  HttpBootSplitRanges (BufferSize, Count, Ranges);
+  for (Index = 0; Index < Count; Index++) {
+    Range = &Ranges[Index];
+
+    Status = HttpBootOpenHttpIo (Private, &Range->HttpIo);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "HttpBootGetBootFileRanges: failed to open connection %d - %r\n", Index, Status));
+      goto ON_EXIT;
+    }
+
+    Range->Created = TRUE;
+
+    Status = HttpBootSetRangeHeader (HttpIoHeader, Range);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    Status = HttpIoSendRequest (
+               &Range->HttpIo,
+               &RequestData,
+               HttpIoHeader->HeaderCount,
+               HttpIoHeader->Headers,
+               0,
+               NULL
+               );
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  //
+  // Every response must carry the part requested, otherwise fall back to a
+  // single connection. Nothing is written into Buffer until all are checked.
+  //
+  for (Index = 0; Index < Count; Index++) {
+    Range = &Ranges[Index];
+
+    ZeroMem (&ResponseData, sizeof (HTTP_IO_RESPONSE_DATA));
+    Status = HttpIoRecvResponse (&Range->HttpIo, TRUE, &ResponseData);
+    if (!EFI_ERROR (Status) &&
+        (EFI_ERROR (ResponseData.Status) || !HttpBootCheckRangeResponse (&ResponseData, Range)))
+    {
+      DEBUG ((
+        DEBUG_WARN,
+        "HttpBootGetBootFileRanges: server doesn't serve the range %ld-%ld, status code %d\n",
+        (UINT64)Range->Offset,
+        (UINT64)(Range->End - 1),
+        ResponseData.Response.StatusCode
+        ));
+      Status = EFI_UNSUPPORTED;
+    }
+
+    if (ResponseData.Headers != NULL) {
+      HttpFreeHeaderFields (ResponseData.Headers, ResponseData.HeaderCount);
+    }
+
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  //
+  // Drain the connections in turn until all the parts are received.
+  //
+  BodyStarted = TRUE;
+  do {
+    Pending = FALSE;
+    for (Index = 0; Index < Count; Index++) {
+      Range = &Ranges[Index];
+      if (Range->Offset == Range->End) {
+        continue;
+      }
+
+      ZeroMem (&ResponseData, sizeof (HTTP_IO_RESPONSE_DATA));
+      ResponseData.Body       = (CHAR8 *)Buffer + Range->Offset;
+      ResponseData.BodyLength = MIN (Range->End - Range->Offset, HTTP_BOOT_RANGE_RECV_SIZE);
+      Status                  = HttpIoRecvResponse (&Range->HttpIo, FALSE, &ResponseData);
+      if (EFI_ERROR (Status) || EFI_ERROR (ResponseData.Status)) {
+        if (EFI_ERROR (ResponseData.Status)) {
+          Status = ResponseData.Status;
+        }
+
+        goto ON_EXIT;
+      }
+
+      Range->Offset += ResponseData.BodyLength;
+      if (Range->Offset < Range->End) {
+        Pending = TRUE;
+      }
+
+      if (Private->HttpBootCallback != NULL) {
+        Status = Private->HttpBootCallback->Callback (
+                                              Private->HttpBootCallback,
+                                              HttpBootHttpEntityBody,
+                                              TRUE,
+                                              (UINT32)ResponseData.BodyLength,
+                                              ResponseData.Body
+                                              );
+        if (EFI_ERROR (Status)) {
+          goto ON_EXIT;
+        }
+      }
+    }
+  } while (Pending);
+
+  Status = EFI_SUCCESS;
+
+ON_EXIT:
+  if (EFI_ERROR (Status) && !BodyStarted) {
+    DEBUG ((DEBUG_WARN, "HttpBootGetBootFileRanges: fall back to a single connection - %r\n", Status));
+  }
+
+  Status = HttpBootRangeStatus (Status, BodyStarted);
+
+  if (Ranges != NULL) {
+    for (Index = 0; Index < Count; Index++) {
+      if (Ranges[Index].Created) {
+        HttpIoDestroyIo (&Ranges[Index].HttpIo);
+      }
+    }
+
+    FreePool (Ranges);
+  }
+
+  if (HttpIoHeader != NULL) {
+    HttpIoFreeHeader (HttpIoHeader);
+  }
+
+  if (Url != NULL) {
+    FreePool (Url);
+  }
+
+  return Status;
+}
+
+/**
+  This function downloads a part of the boot file with a Range request over
+  the HTTP connection of the driver, directly into the caller's buffer.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Offset          The offset of the part in the boot file.
+  @param[in]       Length          The length of the part, in bytes.
+  @param[out]      Buffer          The memory buffer to transfer the part to.
+
+  @retval EFI_SUCCESS              The part was loaded.
+  @retval EFI_UNSUPPORTED          The server doesn't serve the range as requested.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval Others                   Unexpected error happened, the connection
+                                   may have to be created again.
+
+**/
+EFI_STATUS
+HttpBootGetRange (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     UINTN                   Offset,
+  IN     UINTN                   Length,
+  OUT    UINT8                   *Buffer
+  )
+{
+  EFI_STATUS             Status;
+  HTTP_BOOT_RANGE        Range;
+  HTTP_IO_HEADER         *HttpIoHeader;
+  EFI_HTTP_REQUEST_DATA  RequestData;
+  HTTP_IO_RESPONSE_DATA  ResponseData;
+  UINTN                  UrlSize;
+  CHAR16                 *Url;
+
+  ASSERT (Private != NULL);
+  ASSERT (Buffer != NULL);
+  ASSERT (Length != 0);
+
+  HttpIoHeader = NULL;
+  Url          = NULL;
+
+  if (!Private->HttpCreated) {
+    Status = HttpBootCreateHttpIo (Private);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  UrlSize = AsciiStrSize (Private->BootFileUri);
+  Url     = AllocatePool (UrlSize * sizeof (CHAR16));
+  if (Url == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  AsciiStrToUnicodeStrS (Private->BootFileUri, Url, UrlSize);
+  RequestData.Method = HttpMethodGet;
+  RequestData.Url    = Url;
+
+  ZeroMem (&Range, sizeof (HTTP_BOOT_RANGE));
+  Range.Offset = Offset;
+  Range.End    = Offset + Length;
+
+  Status = HttpBootCreateRangeHeader (Private, &HttpIoHeader);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  Status = HttpBootSetRangeHeader (HttpIoHeader, &Range);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  Status = HttpIoSendRequest (
+             &Private->HttpIo,
+             &RequestData,
+             HttpIoHeader->HeaderCount,
+             HttpIoHeader->Headers,
+             0,
+             NULL
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  ZeroMem (&ResponseData, sizeof (HTTP_IO_RESPONSE_DATA));
+  Status = HttpIoRecvResponse (&Private->HttpIo, TRUE, &ResponseData);
+  if (!EFI_ERROR (Status) &&
+      (EFI_ERROR (ResponseData.Status) || !HttpBootCheckRangeResponse (&ResponseData, &Range)))
+  {
+    DEBUG ((
+      DEBUG_ERROR,
+      "HttpBootGetRange: server doesn't serve the range %ld-%ld, status code %d\n",
+      (UINT64)Range.Offset,
+      (UINT64)(Range.End - 1),
+      ResponseData.Response.StatusCode
+      ));
+    Status = EFI_UNSUPPORTED;
+  }
+
+  if (ResponseData.Headers != NULL) {
+    HttpFreeHeaderFields (ResponseData.Headers, ResponseData.HeaderCount);
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  while (Range.Offset < Range.End) {
+    ZeroMem (&ResponseData, sizeof (HTTP_IO_RESPONSE_DATA));
+    ResponseData.Body       = (CHAR8 *)Buffer + (Range.Offset - Offset);
+    ResponseData.BodyLength = Range.End - Range.Offset;
+    Status                  = HttpIoRecvResponse (&Private->HttpIo, FALSE, &ResponseData);
+    if (EFI_ERROR (Status) || EFI_ERROR (ResponseData.Status)) {
+      if (EFI_ERROR (ResponseData.Status)) {
+        Status = ResponseData.Status;
+      }
+
+      goto ON_EXIT;
+    }
+
+    Range.Offset += ResponseData.BodyLength;
+  }
+
+ON_EXIT:
+  if (HttpIoHeader != NULL) {
+    HttpIoFreeHeader (HttpIoHeader);
+  }
+
+  if (Url != NULL) {
+    FreePool (Url);
+  }
+
+  return Status;
+}
@@ -13,6 +13,22 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HTTP_BOOT_BLOCK_SIZE           1500
 #define HTTP_USER_AGENT_EFI_HTTP_BOOT  "UefiHttpBoot/1.0"
 
+//
+// Parallel download of the boot file with Range requests. Each connection
+// gets at least HTTP_BOOT_RANGE_MIN_SIZE bytes, and receives at most
+// HTTP_BOOT_RANGE_RECV_SIZE bytes before the next connection is drained.
+//
+#define HTTP_BOOT_RANGE_MAX_CONNECTIONS  8
+#define HTTP_BOOT_RANGE_MIN_SIZE         SIZE_4MB
+#define HTTP_BOOT_RANGE_RECV_SIZE        SIZE_256KB
+#define HTTP_BOOT_RANGE_VALUE_LENGTH     48
+
+//
+// A streamed RAM disk fetches up to HTTP_BOOT_STREAM_WINDOW_SIZE bytes with
+// each Range request, the chunk read and the chunks after it.
+//
+#define HTTP_BOOT_STREAM_WINDOW_SIZE  SIZE_1MB
+
 //
 // Record the data length and start address of a data block.
 //
@@ -57,6 +73,16 @@ typedef struct {
   HTTP_BOOT_PRIVATE_DATA     *Private;
 } HTTP_BOOT_CALLBACK_DATA;
 
+//
+// One connection of a parallel download, and the part of the file it receives.
+//
+typedef struct {
+  HTTP_IO    HttpIo;
+  BOOLEAN    Created;
+  UINTN      Offset;                      // Next byte of the file to receive
+  UINTN      End;                         // One past the last byte of the part
+} HTTP_BOOT_RANGE;
+
 /**
   Discover all the boot information for boot file.
 
@@ -118,6 +144,109 @@ HttpBootGetBootFile (
   OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
   );
 
+/**
+  This function downloads the boot file over several HTTP connections in parallel,
+  each of them requesting a part of the file with a Range request. The parts are
+  received directly into the caller's buffer.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       BufferSize      The size of the boot file, which fits in Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The ranges could not be requested, or the server doesn't
+                                   serve them as requested. Nothing is received into Buffer,
+                                   the file should be downloaded over a single connection.
+  @retval Others                   Unexpected error happened while the body was received.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileRanges (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     UINTN                   BufferSize,
+  OUT    UINT8                   *Buffer
+  );
+
+/**
+  This function downloads a part of the boot file with a Range request over
+  the HTTP connection of the driver, directly into the caller's buffer.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Offset          The offset of the part in the boot file.
+  @param[in]       Length          The length of the part, in bytes.
+  @param[out]      Buffer          The memory buffer to transfer the part to.
+
+  @retval EFI_SUCCESS              The part was loaded.
+  @retval EFI_UNSUPPORTED          The server doesn't serve the range as requested.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval Others                   Unexpected error happened, the connection
+                                   may have to be created again.
+
+**/
+EFI_STATUS
+HttpBootGetRange (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     UINTN                   Offset,
+  IN     UINTN                   Length,
+  OUT    UINT8                   *Buffer
+  );
+
+/**
+  Split the boot file in the parts downloaded in parallel, one per connection.
+  The parts have the same size, the last part takes the rest.
+
+  @param[in]       FileSize        The size of the boot file.
+  @param[in]       Connections     The number of connections the platform allows.
+  @param[out]      Ranges          The parts of the file. If NULL, only the
+                                   number of parts is returned.
+
+  @return The number of parts, at most HTTP_BOOT_RANGE_MAX_CONNECTIONS. 0 if
+          the file can't be split in two parts of HTTP_BOOT_RANGE_MIN_SIZE
+          bytes or more, and is downloaded over a single connection.
+
+**/
+UINTN
+HttpBootSplitRanges (
+  IN     UINTN            FileSize,
+  IN     UINTN            Connections,
+  OUT    HTTP_BOOT_RANGE  *Ranges OPTIONAL
+  );
+
+/**
+  Check that the response to a range request carries the part of the file
+  that is requested, as specified in RFC7233.
+
+  @param[in]       ResponseData    The response header received.
+  @param[in]       Range           The part of the file requested.
+
+  @retval TRUE     The response carries the part requested.
+  @retval FALSE    The server doesn't serve the range as requested.
+
+**/
+BOOLEAN
+HttpBootCheckRangeResponse (
+  IN HTTP_IO_RESPONSE_DATA  *ResponseData,
+  IN HTTP_BOOT_RANGE        *Range
+  );
+
+/**
+  Get the status a parallel download returns. Until body data is received
+  into the caller's buffer, every error makes the caller fall back to a
+  download over a single connection, so it is reported as EFI_UNSUPPORTED.
+
+  @param[in]       Status          The status of the parallel download.
+  @param[in]       BodyStarted     TRUE if body data may have been received
+                                   into the caller's buffer.
+
+  @return The status to return from HttpBootGetBootFileRanges().
+
+**/
+EFI_STATUS
+HttpBootRangeStatus (
+  IN     EFI_STATUS  Status,
+  IN     BOOLEAN     BodyStarted
+  );
+
 /**
   Clean up all cached data.
 
@@ -53,6 +53,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/Ip4Config2.h>
 #include <Protocol/Ip6Config.h>
 #include <Protocol/RamDisk.h>
+#include <Protocol/SparseRamDisk.h>
 #include <Protocol/AdapterInformation.h>
 
 //
@@ -208,9 +209,16 @@ struct _HTTP_BOOT_PRIVATE_DATA {
   CHAR8                                        *BootFileUri;
   VOID                                         *BootFileUriParser;
   UINTN                                        BootFileSize;
+  BOOLEAN                                      AcceptRanges;
   BOOLEAN                                      NoGateway;
   HTTP_BOOT_IMAGE_TYPE                         ImageType;
 
+  //
+  // The sparse RAM disk whose content is fetched from BootFileUri on demand.
+  //
+  EDKII_SPARSE_RAM_DISK_PROTOCOL               *SparseRamDisk;
+  EFI_DEVICE_PATH_PROTOCOL                     *StreamRamDiskPath;
+
   //
   // URI string extracted from the input FilePath parameter.
   //
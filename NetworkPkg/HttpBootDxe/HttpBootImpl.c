@@ -387,15 +387,29 @@ HttpBootLoadFile (
   }
 
   //
-  // Load the boot file into Buffer
+  // Load the boot file into Buffer. A RAM disk image can be large, download
+  // it over several connections if the server accepts range requests.
   //
-  Status = HttpBootGetBootFile (
-             Private,
-             FALSE,
-             BufferSize,
-             Buffer,
-             ImageType
-             );
+  Status = EFI_UNSUPPORTED;
+  if (Private->AcceptRanges &&
+      ((Private->ImageType == ImageTypeVirtualCd) || (Private->ImageType == ImageTypeVirtualDisk)))
+  {
+    Status = HttpBootGetBootFileRanges (Private, Private->BootFileSize, Buffer);
+    if (!EFI_ERROR (Status)) {
+      *BufferSize = Private->BootFileSize;
+      *ImageType  = Private->ImageType;
+    }
+  }
+
+  if (Status == EFI_UNSUPPORTED) {
+    Status = HttpBootGetBootFile (
+               Private,
+               FALSE,
+               BufferSize,
+               Buffer,
+               ImageType
+               );
+  }
 
 ON_EXIT:
   HttpBootUninstallCallback (Private);
@@ -447,6 +461,8 @@ HttpBootStop (
     return EFI_NOT_STARTED;
   }
 
+  HttpBootUnregisterStreamRamDisk (Private);
+
   if (Private->HttpCreated) {
     HttpIoDestroyIo (&Private->HttpIo);
     Private->HttpCreated = FALSE;
@@ -460,6 +476,7 @@ HttpBootStop (
   Private->BootFileUri       = NULL;
   Private->BootFileUriParser = NULL;
   Private->BootFileSize      = 0;
+  Private->AcceptRanges      = FALSE;
   Private->SelectIndex       = 0;
   Private->SelectProxyType   = HttpOfferTypeMax;
 
@@ -606,6 +623,17 @@ HttpBootDxeLoadFile (
   Status    = HttpBootLoadFile (Private, BufferSize, Buffer, &ImageType);
   if (EFI_ERROR (Status)) {
     if ((Status == EFI_BUFFER_TOO_SMALL) && ((ImageType == ImageTypeVirtualCd) || (ImageType == ImageTypeVirtualDisk))) {
+      //
+      // Register a RAM disk image whose content is fetched on demand, if the
+      // server accepts ranges, rather than ask for a buffer to download it to.
+      // A BufferSize of 0 tells the caller that the RAM disk is registered.
+      //
+      if ((Buffer == NULL) && PcdGetBool (PcdHttpBootRamDiskStreaming) && Private->AcceptRanges &&
+          !EFI_ERROR (HttpBootRegisterStreamRamDisk (Private, ImageType)))
+      {
+        *BufferSize = 0;
+      }
+
       Status = EFI_WARN_FILE_SYSTEM;
     } else if (Status != EFI_BUFFER_TOO_SMALL) {
       HttpBootStop (Private);
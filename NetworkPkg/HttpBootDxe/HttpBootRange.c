@@ -0,0 +1,123 @@
+/** @file
+  Helpers of the parallel download of the boot file with Range requests.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "HttpBootDxe.h"
+
+/**
+  Split the boot file in the parts downloaded in parallel, one per connection.
+  The parts have the same size, the last part takes the rest.
+
+  @param[in]       FileSize        The size of the boot file.
+  @param[in]       Connections     The number of connections the platform allows.
+  @param[out]      Ranges          The parts of the file. If NULL, only the
+                                   number of parts is returned.
+
+  @return The number of parts, at most HTTP_BOOT_RANGE_MAX_CONNECTIONS. 0 if
+          the file can't be split in two parts of HTTP_BOOT_RANGE_MIN_SIZE
+          bytes or more, and is downloaded over a single connection.
+
+**/
+UINTN
+HttpBootSplitRanges (
+  IN     UINTN            FileSize,
+  IN     UINTN            Connections,
+  OUT    HTTP_BOOT_RANGE  *Ranges OPTIONAL
+  )
+{
+  UINTN  Count;
+  UINTN  Index;
+  UINTN  PartSize;
+
+  Count = MIN (Connections, HTTP_BOOT_RANGE_MAX_CONNECTIONS);
+  if ((Count < 2) || (FileSize / Count < HTTP_BOOT_RANGE_MIN_SIZE)) {
+    return 0;
+  }
+
+  if (Ranges != NULL) {
+    PartSize = FileSize / Count;
+    for (Index = 0; Index < Count; Index++) {
+      Ranges[Index].Offset = Index * PartSize;
+      Ranges[Index].End    = (Index == Count - 1) ? FileSize : (Index + 1) * PartSize;
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Check that the response to a range request carries the part of the file
+  that is requested, as specified in RFC7233.
+
+  @param[in]       ResponseData    The response header received.
+  @param[in]       Range           The part of the file requested.
+
+  @retval TRUE     The response carries the part requested.
+  @retval FALSE    The server doesn't serve the range as requested.
+
+**/
+BOOLEAN
+HttpBootCheckRangeResponse (
+  IN HTTP_IO_RESPONSE_DATA  *ResponseData,
+  IN HTTP_BOOT_RANGE        *Range
+  )
+{
+  EFI_HTTP_HEADER  *Header;
+  UINTN            ContentLength;
+  CHAR8            *Value;
+
+  if (ResponseData->Response.StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT) {
+    return FALSE;
+  }
+
+  Header = HttpFindHeader (ResponseData->HeaderCount, ResponseData->Headers, HTTP_HEADER_CONTENT_LENGTH);
+  if ((Header == NULL) ||
+      EFI_ERROR (AsciiStrDecimalToUintnS (Header->FieldValue, (CHAR8 **)NULL, &ContentLength)) ||
+      (ContentLength != Range->End - Range->Offset))
+  {
+    return FALSE;
+  }
+
+  //
+  // Content-Range: bytes First-Last/Length
+  //
+  Header = HttpFindHeader (ResponseData->HeaderCount, ResponseData->Headers, HTTP_HEADER_CONTENT_RANGE);
+  if (Header == NULL) {
+    return FALSE;
+  }
+
+  Value = Header->FieldValue;
+  if (AsciiStrnCmp (Value, HTTP_HEADER_RANGE_BYTES " ", sizeof (HTTP_HEADER_RANGE_BYTES)) != 0) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(AsciiStrDecimalToUintn (Value + sizeof (HTTP_HEADER_RANGE_BYTES)) == Range->Offset);
+}
+
+/**
+  Get the status a parallel download returns. Until body data is received
+  into the caller's buffer, every error makes the caller fall back to a
+  download over a single connection, so it is reported as EFI_UNSUPPORTED.
+
+  @param[in]       Status          The status of the parallel download.
+  @param[in]       BodyStarted     TRUE if body data may have been received
+                                   into the caller's buffer.
+
+  @return The status to return from HttpBootGetBootFileRanges().
+
+**/
+EFI_STATUS
+HttpBootRangeStatus (
+  IN     EFI_STATUS  Status,
+  IN     BOOLEAN     BodyStarted
+  )
+{
+  if (EFI_ERROR (Status) && !BodyStarted) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return Status;
+}
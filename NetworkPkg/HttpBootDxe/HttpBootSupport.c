@@ -767,6 +767,168 @@ HttpBootRegisterRamDisk (
   return Status;
 }
 
+/**
+  Fetch the content of a chunk of the streamed RAM disk from the server.
+
+  The chunks following the one requested, up to HTTP_BOOT_STREAM_WINDOW_SIZE
+  bytes, are fetched with the same Range request and supplied to the RAM disk,
+  so that a sequential read costs one request per window.
+
+  @param[in]  Context       The pointer to the driver's private data.
+  @param[in]  Offset        The byte offset of the chunk in the RAM disk.
+  @param[in]  Length        The number of bytes to fetch.
+  @param[out] Buffer        The buffer to receive the content.
+
+  @retval EFI_SUCCESS       The content was fetched.
+  @retval Others            The content could not be fetched.
+
+**/
+EFI_STATUS
+EFIAPI
+HttpBootFillRamDisk (
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  IN  UINTN   Length,
+  OUT VOID    *Buffer
+  )
+{
+  HTTP_BOOT_PRIVATE_DATA  *Private;
+  EFI_STATUS              Status;
+  UINTN                   WindowSize;
+  UINT8                   *Window;
+
+  Private = (HTTP_BOOT_PRIVATE_DATA *)Context;
+  ASSERT (Private->StreamRamDiskPath != NULL);
+
+  WindowSize = HTTP_BOOT_STREAM_WINDOW_SIZE - HTTP_BOOT_STREAM_WINDOW_SIZE % Private->SparseRamDisk->ChunkSize;
+  WindowSize = (UINTN)MIN (WindowSize, Private->BootFileSize - Offset);
+  Window     = NULL;
+  if (WindowSize > Length) {
+    Window = AllocatePool (WindowSize);
+  }
+
+  if (Window == NULL) {
+    WindowSize = Length;
+    Window     = Buffer;
+  }
+
+  //
+  // The server may have closed the connection since the last request, so
+  // retry once on a new connection unless the server refused the range.
+  //
+  Status = HttpBootGetRange (Private, (UINTN)Offset, WindowSize, Window);
+  if (EFI_ERROR (Status) && (Status != EFI_UNSUPPORTED)) {
+    if (Private->HttpCreated) {
+      HttpIoDestroyIo (&Private->HttpIo);
+      Private->HttpCreated = FALSE;
+    }
+
+    Status = HttpBootGetRange (Private, (UINTN)Offset, WindowSize, Window);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "HTTP Boot: Failed to fetch RAM disk offset 0x%lx - %r\n", Offset, Status));
+  } else if (Window != Buffer) {
+    CopyMem (Buffer, Window, Length);
+    Private->SparseRamDisk->Supply (
+                              Private->StreamRamDiskPath,
+                              Offset + Length,
+                              WindowSize - Length,
+                              Window + Length
+                              );
+  }
+
+  if (Window != Buffer) {
+    FreePool (Window);
+  }
+
+  return Status;
+}
+
+/**
+  This function registers the boot file as a sparse RAM disk, whose content is
+  fetched from the server with Range requests when it is read.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       ImageType       The image type of the boot file.
+
+  @retval EFI_SUCCESS              The RAM disk has been registered.
+  @retval EFI_NOT_FOUND            No sparse RAM disk protocol instances were found.
+  @retval EFI_UNSUPPORTED          The ImageType is not supported.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootRegisterStreamRamDisk (
+  IN  HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN  HTTP_BOOT_IMAGE_TYPE    ImageType
+  )
+{
+  EFI_STATUS  Status;
+  EFI_GUID    *RamDiskType;
+
+  ASSERT (Private != NULL);
+  ASSERT (Private->BootFileSize != 0);
+
+  if (ImageType == ImageTypeVirtualCd) {
+    RamDiskType = &gEfiVirtualCdGuid;
+  } else if (ImageType == ImageTypeVirtualDisk) {
+    RamDiskType = &gEfiVirtualDiskGuid;
+  } else {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = gBS->LocateProtocol (&gEdkiiSparseRamDiskProtocolGuid, NULL, (VOID **)&Private->SparseRamDisk);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "HTTP Boot: Couldn't find the Sparse RAM Disk protocol - %r\n", Status));
+    return Status;
+  }
+
+  //
+  // Only one boot file is streamed at a time.
+  //
+  HttpBootUnregisterStreamRamDisk (Private);
+
+  Status = Private->SparseRamDisk->Register (
+                                     (UINT64)Private->BootFileSize,
+                                     RamDiskType,
+                                     Private->UsingIpv6 ? Private->Ip6Nic->DevicePath : Private->Ip4Nic->DevicePath,
+                                     HttpBootFillRamDisk,
+                                     Private,
+                                     &Private->StreamRamDiskPath
+                                     );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "HTTP Boot: Failed to register sparse RAM Disk - %r\n", Status));
+    Private->StreamRamDiskPath = NULL;
+  }
+
+  return Status;
+}
+
+/**
+  This function unregisters the sparse RAM disk registered by
+  HttpBootRegisterStreamRamDisk(), if any.
+
+  @param[in]       Private         The pointer to the driver's private data.
+
+**/
+VOID
+HttpBootUnregisterStreamRamDisk (
+  IN  HTTP_BOOT_PRIVATE_DATA  *Private
+  )
+{
+  if (Private->StreamRamDiskPath == NULL) {
+    return;
+  }
+
+  //
+  // The boot manager may have unregistered the RAM disk already.
+  //
+  Private->SparseRamDisk->Unregister (Private->StreamRamDiskPath);
+  FreePool (Private->StreamRamDiskPath);
+  Private->StreamRamDiskPath = NULL;
+}
+
 /**
   Indicate if the HTTP status code indicates a redirection.
 
@@ -199,6 +199,37 @@ HttpBootRegisterRamDisk (
   IN  HTTP_BOOT_IMAGE_TYPE    ImageType
   );
 
+/**
+  This function registers the boot file as a sparse RAM disk, whose content is
+  fetched from the server with Range requests when it is read.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       ImageType       The image type of the boot file.
+
+  @retval EFI_SUCCESS              The RAM disk has been registered.
+  @retval EFI_NOT_FOUND            No sparse RAM disk protocol instances were found.
+  @retval EFI_UNSUPPORTED          The ImageType is not supported.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootRegisterStreamRamDisk (
+  IN  HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN  HTTP_BOOT_IMAGE_TYPE    ImageType
+  );
+
+/**
+  This function unregisters the sparse RAM disk registered by
+  HttpBootRegisterStreamRamDisk(), if any.
+
+  @param[in]       Private         The pointer to the driver's private data.
+
+**/
+VOID
+HttpBootUnregisterStreamRamDisk (
+  IN  HTTP_BOOT_PRIVATE_DATA  *Private
+  );
+
 /**
   Indicate if the HTTP status code indicates a redirection.
 
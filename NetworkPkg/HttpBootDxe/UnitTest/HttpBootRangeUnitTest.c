@@ -0,0 +1,329 @@
+/** @file
+  Host-based unit test of the parallel download helpers of HttpBootDxe.
+
+  The boot file is split in parts of HTTP_BOOT_RANGE_MIN_SIZE bytes or more,
+  the responses to the Range requests are checked against the parts, and the
+  errors before the body is received make the download fall back to a single
+  connection.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Library/UnitTestLib.h>
+
+#include "../HttpBootDxe.h"
+
+#define UNIT_TEST_APP_NAME     "HttpBootDxe Range Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+/**
+  Check that parts cover a file of the given size in order, each with
+  HTTP_BOOT_RANGE_MIN_SIZE bytes or more, and that all but the last have
+  the same size.
+
+  @param[in]  Ranges    The parts of the file.
+  @param[in]  Count     The number of parts.
+  @param[in]  FileSize  The size of the file.
+
+  @retval TRUE   The parts are split as expected.
+  @retval FALSE  The parts are wrong.
+
+**/
+BOOLEAN
+CheckRanges (
+  IN HTTP_BOOT_RANGE  *Ranges,
+  IN UINTN            Count,
+  IN UINTN            FileSize
+  )
+{
+  UINTN  Index;
+  UINTN  PartSize;
+
+  PartSize = FileSize / Count;
+  for (Index = 0; Index < Count; Index++) {
+    if ((Ranges[Index].Offset != Index * PartSize) ||
+        (Ranges[Index].End - Ranges[Index].Offset < HTTP_BOOT_RANGE_MIN_SIZE))
+    {
+      DEBUG ((DEBUG_ERROR, "Part %d is 0x%lx-0x%lx\n", Index, (UINT64)Ranges[Index].Offset, (UINT64)Ranges[Index].End));
+      return FALSE;
+    }
+
+    if ((Index < Count - 1) && (Ranges[Index].End != Ranges[Index + 1].Offset)) {
+      DEBUG ((DEBUG_ERROR, "Part %d ends at 0x%lx\n", Index, (UINT64)Ranges[Index].End));
+      return FALSE;
+    }
+  }
+
+  return (BOOLEAN)(Ranges[Count - 1].End == FileSize);
+}
+
+/**
+  A file is split in one part per connection, up to
+  HTTP_BOOT_RANGE_MAX_CONNECTIONS, and the last part takes the rest.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SplitRanges (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  HTTP_BOOT_RANGE  Ranges[HTTP_BOOT_RANGE_MAX_CONNECTIONS];
+  UINTN            FileSize;
+
+  FileSize = 4 * HTTP_BOOT_RANGE_MIN_SIZE;
+  ZeroMem (Ranges, sizeof (Ranges));
+  UT_ASSERT_EQUAL (HttpBootSplitRanges (FileSize, 4, NULL), 4);
+  UT_ASSERT_EQUAL (HttpBootSplitRanges (FileSize, 4, Ranges), 4);
+  UT_ASSERT_TRUE (CheckRanges (Ranges, 4, FileSize));
+  UT_ASSERT_EQUAL (Ranges[3].End - Ranges[3].Offset, HTTP_BOOT_RANGE_MIN_SIZE);
+
+  //
+  // The last part takes the bytes left by the division.
+  //
+  FileSize = 3 * HTTP_BOOT_RANGE_MIN_SIZE + 2;
+  ZeroMem (Ranges, sizeof (Ranges));
+  UT_ASSERT_EQUAL (HttpBootSplitRanges (FileSize, 3, Ranges), 3);
+  UT_ASSERT_TRUE (CheckRanges (Ranges, 3, FileSize));
+  UT_ASSERT_EQUAL (Ranges[0].End - Ranges[0].Offset, HTTP_BOOT_RANGE_MIN_SIZE);
+  UT_ASSERT_EQUAL (Ranges[2].End - Ranges[2].Offset, HTTP_BOOT_RANGE_MIN_SIZE + 2);
+
+  //
+  // The connections beyond HTTP_BOOT_RANGE_MAX_CONNECTIONS are not used.
+  //
+  FileSize = 100 * HTTP_BOOT_RANGE_MIN_SIZE + 7;
+  ZeroMem (Ranges, sizeof (Ranges));
+  UT_ASSERT_EQUAL (HttpBootSplitRanges (FileSize, 255, Ranges), HTTP_BOOT_RANGE_MAX_CONNECTIONS);
+  UT_ASSERT_TRUE (CheckRanges (Ranges, HTTP_BOOT_RANGE_MAX_CONNECTIONS, FileSize));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A file is downloaded over a single connection when fewer than two
+  connections are allowed, or when the parts would be smaller than
+  HTTP_BOOT_RANGE_MIN_SIZE.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SplitRangesSmall (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UT_ASSERT_EQUAL (HttpBootSplitRanges (SIZE_1GB, 0, NULL), 0);
+  UT_ASSERT_EQUAL (HttpBootSplitRanges (SIZE_1GB, 1, NULL), 0);
+  UT_ASSERT_EQUAL (HttpBootSplitRanges (0, 4, NULL), 0);
+  UT_ASSERT_EQUAL (HttpBootSplitRanges (2 * HTTP_BOOT_RANGE_MIN_SIZE - 1, 2, NULL), 0);
+  UT_ASSERT_EQUAL (HttpBootSplitRanges (2 * HTTP_BOOT_RANGE_MIN_SIZE, 2, NULL), 2);
+  UT_ASSERT_EQUAL (HttpBootSplitRanges (8 * HTTP_BOOT_RANGE_MIN_SIZE - 1, 8, NULL), 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Only a 206 response with the length and the first byte of the part
+  requested carries the part.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CheckRangeResponse (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  HTTP_IO_RESPONSE_DATA  ResponseData;
+  EFI_HTTP_HEADER        Headers[2];
+  HTTP_BOOT_RANGE        Range;
+
+  ZeroMem (&Range, sizeof (Range));
+  Range.Offset = 4096;
+  Range.End    = 6096;
+
+  Headers[0].FieldName  = HTTP_HEADER_CONTENT_LENGTH;
+  Headers[0].FieldValue = "2000";
+  Headers[1].FieldName  = HTTP_HEADER_CONTENT_RANGE;
+  Headers[1].FieldValue = "bytes 4096-6095/10000";
+
+  ZeroMem (&ResponseData, sizeof (ResponseData));
+  ResponseData.Response.StatusCode = HTTP_STATUS_206_PARTIAL_CONTENT;
+  ResponseData.HeaderCount         = 2;
+  ResponseData.Headers             = Headers;
+  UT_ASSERT_TRUE (HttpBootCheckRangeResponse (&ResponseData, &Range));
+
+  //
+  // The whole file.
+  //
+  ResponseData.Response.StatusCode = HTTP_STATUS_200_OK;
+  UT_ASSERT_FALSE (HttpBootCheckRangeResponse (&ResponseData, &Range));
+  ResponseData.Response.StatusCode = HTTP_STATUS_206_PARTIAL_CONTENT;
+
+  //
+  // Another part of the file.
+  //
+  Headers[1].FieldValue = "bytes 4000-5999/10000";
+  UT_ASSERT_FALSE (HttpBootCheckRangeResponse (&ResponseData, &Range));
+
+  Headers[1].FieldValue = "bytes 4096-6095/10000";
+  Headers[0].FieldValue = "1999";
+  UT_ASSERT_FALSE (HttpBootCheckRangeResponse (&ResponseData, &Range));
+
+  //
+  // Other units, and missing headers.
+  //
+  Headers[0].FieldValue = "2000";
+  Headers[1].FieldValue = "items 4096-6095/10000";
+  UT_ASSERT_FALSE (HttpBootCheckRangeResponse (&ResponseData, &Range));
+
+  Headers[1].FieldValue   = "bytes 4096-6095/10000";
+  ResponseData.HeaderCount = 1;
+  UT_ASSERT_FALSE (HttpBootCheckRangeResponse (&ResponseData, &Range));
+
+  ResponseData.HeaderCount = 1;
+  ResponseData.Headers     = &Headers[1];
+  UT_ASSERT_FALSE (HttpBootCheckRangeResponse (&ResponseData, &Range));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Every error before the body is received makes the download fall back to
+  a single connection. The errors while the body is received are returned.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RangeFallback (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UT_ASSERT_EQUAL (HttpBootRangeStatus (EFI_SUCCESS, TRUE), EFI_SUCCESS);
+  UT_ASSERT_EQUAL (HttpBootRangeStatus (EFI_SUCCESS, FALSE), EFI_SUCCESS);
+
+  UT_ASSERT_EQUAL (HttpBootRangeStatus (EFI_UNSUPPORTED, FALSE), EFI_UNSUPPORTED);
+  UT_ASSERT_EQUAL (HttpBootRangeStatus (EFI_DEVICE_ERROR, FALSE), EFI_UNSUPPORTED);
+  UT_ASSERT_EQUAL (HttpBootRangeStatus (EFI_TIMEOUT, FALSE), EFI_UNSUPPORTED);
+  UT_ASSERT_EQUAL (HttpBootRangeStatus (EFI_ACCESS_DENIED, FALSE), EFI_UNSUPPORTED);
+  UT_ASSERT_EQUAL (HttpBootRangeStatus (EFI_OUT_OF_RESOURCES, FALSE), EFI_UNSUPPORTED);
+
+  UT_ASSERT_EQUAL (HttpBootRangeStatus (EFI_DEVICE_ERROR, TRUE), EFI_DEVICE_ERROR);
+  UT_ASSERT_EQUAL (HttpBootRangeStatus (EFI_TIMEOUT, TRUE), EFI_TIMEOUT);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the parallel
+  download helpers and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      RangeTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the Range Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&RangeTests, Framework, "HTTP Boot Range Tests", "HttpBootDxe.Range", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for HTTP Boot Range Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite--------Description---------------------------------------Name----------------Function-----------Pre---Post--Context
+  //
+  AddTestCase (RangeTests, "File is split in one part per connection", "Split", SplitRanges, NULL, NULL, NULL);
+  AddTestCase (RangeTests, "Small file is not split", "SplitSmall", SplitRangesSmall, NULL, NULL, NULL);
+  AddTestCase (RangeTests, "Response carries the part requested", "Response", CheckRangeResponse, NULL, NULL, NULL);
+  AddTestCase (RangeTests, "Errors before the body fall back", "Fallback", RangeFallback, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define HttpBootRangeUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+HttpBootRangeUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = UnitTestingEntry ();
+  return EFI_ERROR (Status) ? 1 : 0;
+}
@@ -1031,7 +1031,7 @@ HttpResponseWorker (
       HttpInstance->NextMsg     = NULL;
       HttpInstance->CacheOffset = 0;
       SizeofHeaders             = HdrLen;
-      BufferSize                = HttpInstance->CacheLen;
+      BufferSize                = HdrLen;
 
       //
       // Check whether we cached the whole HTTP headers.
@@ -1401,23 +1401,24 @@ HttpResponseWorker (
       HttpMsg->BodyLength = HttpInstance->NextMsg - (CHAR8 *)HttpMsg->Body;
     }
 
+    //
+    // The rest of the decrypted record is cached for the next call. The record
+    // buffer itself becomes the cache, the data isn't copied again.
+    //
     HttpInstance->CacheLen = Fragment.Len - HttpMsg->BodyLength;
     if (HttpInstance->CacheLen != 0) {
       if (HttpInstance->CacheBody != NULL) {
         FreePool (HttpInstance->CacheBody);
       }
 
-      HttpInstance->CacheBody = AllocateZeroPool (HttpInstance->CacheLen);
-      if (HttpInstance->CacheBody == NULL) {
-        Status = EFI_OUT_OF_RESOURCES;
-        goto Error2;
-      }
-
-      CopyMem (HttpInstance->CacheBody, Fragment.Bulk + HttpMsg->BodyLength, HttpInstance->CacheLen);
-      HttpInstance->CacheOffset = 0;
+      HttpInstance->CacheBody   = (CHAR8 *)Fragment.Bulk;
+      HttpInstance->CacheLen    = Fragment.Len;
+      HttpInstance->CacheOffset = HttpMsg->BodyLength;
       if (HttpInstance->NextMsg != NULL) {
-        HttpInstance->NextMsg = HttpInstance->CacheBody;
+        HttpInstance->NextMsg = HttpInstance->CacheBody + HttpInstance->CacheOffset;
       }
+
+      Fragment.Bulk = NULL;
     }
 
     if (Fragment.Bulk != NULL) {
@@ -0,0 +1,70 @@
+/** @file
+  AArch64 implementation of NetChecksumWords(), with Advanced SIMD (NEON)
+  instructions.
+
+  UEFI requires the floating point and Advanced SIMD registers to be enabled
+  on AArch64, so no runtime check is needed.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../NetChecksumInternals.h"
+
+//
+// The SIMD routine sums the data in blocks of 64 bytes.
+//
+#define NET_CHECKSUM_BLOCK_SIZE  64
+
+/**
+  Sum the 32-bit words of data in blocks of 64 bytes, with Advanced SIMD
+  instructions.
+
+  @param[in]   Buffer                Pointer to the data.
+  @param[in]   Length                Length of the data, a multiple of 64 bytes.
+
+  @return    The sum of the words.
+
+**/
+UINT64
+EFIAPI
+InternalNetChecksumNeon (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length
+  );
+
+/**
+  Sum 32-bit words into a 64-bit accumulator.
+
+  @param[in]   Words                 Pointer to the words, 4-byte aligned.
+  @param[in]   Count                 The number of words.
+
+  @return    The sum of the words.
+
+**/
+UINT64
+NetChecksumWords (
+  IN CONST UINT32  *Words,
+  IN UINTN         Count
+  )
+{
+  UINT64  Sum;
+  UINTN   Length;
+
+  Sum    = 0;
+  Length = (Count * sizeof (UINT32)) & ~(UINTN)(NET_CHECKSUM_BLOCK_SIZE - 1);
+
+  if (Length != 0) {
+    Sum    = InternalNetChecksumNeon (Words, Length);
+    Words += Length / sizeof (UINT32);
+    Count -= Length / sizeof (UINT32);
+  }
+
+  while (Count > 0) {
+    Sum += *Words;
+    Words++;
+    Count--;
+  }
+
+  return Sum;
+}
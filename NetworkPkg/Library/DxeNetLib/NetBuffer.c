@@ -14,6 +14,204 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
 
+#include "NetBufferInternals.h"
+#include "NetChecksumInternals.h"
+
+STATIC NET_BUF_CACHE  mNetbufCache;
+STATIC NET_BUF_CACHE  mNetVectorCache;
+
+/**
+  Allocate a NET_BUF or NET_VECTOR structure, from the cache if possible.
+
+  @param[in, out]  Cache         The cache of the structure type.
+  @param[in]       Num           The number of NET_BLOCK_OP or NET_BLOCK in the
+                                 structure.
+  @param[in]       Size          The size of the structure, in bytes.
+
+  @return    Pointer to the uninitialized structure, or NULL if the allocation
+             failed due to resource limit.
+
+**/
+STATIC
+VOID *
+NetbufCacheAlloc (
+  IN OUT NET_BUF_CACHE  *Cache,
+  IN     UINT32         Num,
+  IN     UINTN          Size
+  )
+{
+  NET_BUF_CACHE_ENTRY  *Entry;
+  EFI_TPL              OldTpl;
+
+  Entry = NULL;
+
+  if ((Num >= 1) && (Num <= NET_BUF_CACHE_CLASSES)) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+    Entry = Cache->FreeList[Num - 1];
+    if (Entry != NULL) {
+      Cache->FreeList[Num - 1] = Entry->Next;
+      Cache->FreeNum[Num - 1]--;
+      Cache->CachedBytes -= Size;
+      Cache->Hit++;
+    } else {
+      Cache->Miss++;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  if (Entry != NULL) {
+    return Entry;
+  }
+
+  return AllocatePool (Size);
+}
+
+/**
+  Release a NET_BUF or NET_VECTOR structure to the cache, or to the pool if
+  the cache of its size is full.
+
+  @param[in, out]  Cache         The cache of the structure type.
+  @param[in]       Num           The number of NET_BLOCK_OP or NET_BLOCK in the
+                                 structure.
+  @param[in]       Size          The size of the structure, in bytes.
+  @param[in]       Buffer        Pointer to the structure to release.
+
+**/
+STATIC
+VOID
+NetbufCacheFree (
+  IN OUT NET_BUF_CACHE  *Cache,
+  IN     UINT32         Num,
+  IN     UINTN          Size,
+  IN     VOID           *Buffer
+  )
+{
+  NET_BUF_CACHE_ENTRY  *Entry;
+  EFI_TPL              OldTpl;
+
+  if ((Num >= 1) && (Num <= NET_BUF_CACHE_CLASSES)) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+    if (Cache->FreeNum[Num - 1] < NET_BUF_CACHE_DEPTH) {
+      Entry                    = (NET_BUF_CACHE_ENTRY *)Buffer;
+      Entry->Next              = Cache->FreeList[Num - 1];
+      Cache->FreeList[Num - 1] = Entry;
+      Cache->FreeNum[Num - 1]++;
+      Cache->CachedBytes += Size;
+      Buffer              = NULL;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  if (Buffer != NULL) {
+    FreePool (Buffer);
+  }
+}
+
+/**
+  Release all the structures held by a cache to the pool.
+
+  @param[in, out]  Cache         The cache to flush.
+
+**/
+STATIC
+VOID
+NetbufCacheFlush (
+  IN OUT NET_BUF_CACHE  *Cache
+  )
+{
+  NET_BUF_CACHE_ENTRY  *Entry;
+  UINT32               Index;
+
+  for (Index = 0; Index < NET_BUF_CACHE_CLASSES; Index++) {
+    while (Cache->FreeList[Index] != NULL) {
+      Entry                  = Cache->FreeList[Index];
+      Cache->FreeList[Index] = Entry->Next;
+      FreePool (Entry);
+    }
+
+    Cache->FreeNum[Index] = 0;
+  }
+
+  Cache->CachedBytes = 0;
+}
+
+/**
+  Report the NET_BUF cache statistics and release the cached structures when
+  the image linked with this library is unloaded.
+
+  @param[in]  ImageHandle       The firmware allocated handle for the EFI image.
+  @param[in]  SystemTable       A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS           The destructor always returns EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+NetbufCacheDestructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  DEBUG ((
+    DEBUG_INFO,
+    "NetbufCache: NET_BUF %Lu hits %Lu misses, NET_VECTOR %Lu hits %Lu misses, %Lu bytes cached.\n",
+    mNetbufCache.Hit,
+    mNetbufCache.Miss,
+    mNetVectorCache.Hit,
+    mNetVectorCache.Miss,
+    (UINT64)(mNetbufCache.CachedBytes + mNetVectorCache.CachedBytes)
+    ));
+
+  NetbufCacheFlush (&mNetbufCache);
+  NetbufCacheFlush (&mNetVectorCache);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Free a NET_BUF structure allocated by NetbufAllocStruct() or NetbufClone().
+
+  @param[in]  Nbuf              Pointer to the NET_BUF to be freed.
+
+**/
+STATIC
+VOID
+NetbufFreeStruct (
+  IN NET_BUF  *Nbuf
+  )
+{
+  NetbufCacheFree (
+    &mNetbufCache,
+    Nbuf->BlockOpNum,
+    NET_BUF_SIZE (Nbuf->BlockOpNum),
+    Nbuf
+    );
+}
+
+/**
+  Free a NET_VECTOR structure allocated by NetbufAllocStruct().
+
+  @param[in]  Vector            Pointer to the NET_VECTOR to be freed.
+
+**/
+STATIC
+VOID
+NetbufFreeVectorStruct (
+  IN NET_VECTOR  *Vector
+  )
+{
+  NetbufCacheFree (
+    &mNetVectorCache,
+    Vector->BlockNum,
+    NET_VECTOR_SIZE (Vector->BlockNum),
+    Vector
+    );
+}
+
 /**
   Allocate and build up the sketch for a NET_BUF.
 
@@ -42,24 +240,27 @@ NetbufAllocStruct (
   //
   // Allocate three memory blocks.
   //
-  Nbuf = AllocateZeroPool (NET_BUF_SIZE (BlockOpNum));
+  Nbuf = NetbufCacheAlloc (&mNetbufCache, BlockOpNum, NET_BUF_SIZE (BlockOpNum));
 
   if (Nbuf == NULL) {
     return NULL;
   }
 
+  ZeroMem (Nbuf, NET_BUF_SIZE (BlockOpNum));
   Nbuf->Signature  = NET_BUF_SIGNATURE;
   Nbuf->RefCnt     = 1;
   Nbuf->BlockOpNum = BlockOpNum;
   InitializeListHead (&Nbuf->List);
 
   if (BlockNum != 0) {
-    Vector = AllocateZeroPool (NET_VECTOR_SIZE (BlockNum));
+    Vector = NetbufCacheAlloc (&mNetVectorCache, BlockNum, NET_VECTOR_SIZE (BlockNum));
 
     if (Vector == NULL) {
       goto FreeNbuf;
     }
 
+    ZeroMem (Vector, NET_VECTOR_SIZE (BlockNum));
+
     Vector->Signature = NET_VECTOR_SIGNATURE;
     Vector->RefCnt    = 1;
     Vector->BlockNum  = BlockNum;
@@ -70,7 +271,7 @@ NetbufAllocStruct (
 
 FreeNbuf:
 
-  FreePool (Nbuf);
+  NetbufFreeStruct (Nbuf);
   return NULL;
 }
 
@@ -124,7 +325,8 @@ NetbufAlloc (
   return Nbuf;
 
 FreeNBuf:
-  FreePool (Nbuf);
+  NetbufFreeVectorStruct (Nbuf->Vector);
+  NetbufFreeStruct (Nbuf);
   return NULL;
 }
 
@@ -175,7 +377,7 @@ NetbufFreeVector (
     }
   }
 
-  FreePool (Vector);
+  NetbufFreeVectorStruct (Vector);
 }
 
 /**
@@ -208,7 +410,7 @@ NetbufFree (
     // all the sharing of Nbuf increse Vector's RefCnt by one
     //
     NetbufFreeVector (Nbuf->Vector);
-    FreePool (Nbuf);
+    NetbufFreeStruct (Nbuf);
   }
 }
 
@@ -234,7 +436,7 @@ NetbufClone (
 
   NET_CHECK_SIGNATURE (Nbuf, NET_BUF_SIGNATURE);
 
-  Clone = AllocatePool (NET_BUF_SIZE (Nbuf->BlockOpNum));
+  Clone = NetbufCacheAlloc (&mNetbufCache, Nbuf->BlockOpNum, NET_BUF_SIZE (Nbuf->BlockOpNum));
 
   if (Clone == NULL) {
     return NULL;
@@ -662,7 +864,8 @@ NetbufGetFragment (
 
 FreeChild:
 
-  FreePool (Child);
+  NetbufFreeVectorStruct (Child->Vector);
+  NetbufFreeStruct (Child);
   return NULL;
 }
 
@@ -1604,6 +1807,13 @@ NetbufQueFlush (
 /**
   Compute the checksum for a bulk of data.
 
+  The data is summed as aligned 32-bit words into a 64-bit accumulator, which
+  cannot overflow for any Len, and folded to 16 bits once at the end. The bulk
+  of the words is summed by NetChecksumWords(), with SIMD instructions on X64
+  and AArch64. The one's
+  complement sum is byte order independent, so data starting at an odd address
+  is summed on the aligned word lattice and the result byte swapped.
+
   @param[in]   Bulk                  Pointer to the data.
   @param[in]   Len                   Length of the data, in bytes.
 
@@ -1617,31 +1827,64 @@ NetblockChecksum (
   IN UINT32  Len
   )
 {
-  register UINT32  Sum;
+  UINT64   Sum;
+  UINT32   Folded;
+  UINT32   High;
+  BOOLEAN  OddAddress;
 
-  Sum = 0;
+  Sum        = 0;
+  OddAddress = (BOOLEAN)(((UINTN)Bulk & 0x1) != 0);
 
   //
-  // Add left-over byte, if any
+  // Align the data to 2 bytes. The first byte is the high byte of its word on
+  // the aligned lattice.
   //
-  if (Len % 2 != 0) {
-    Sum += *(Bulk + Len - 1);
+  if (OddAddress && (Len > 0)) {
+    Sum = (UINT32)*Bulk << 8;
+    Bulk++;
+    Len--;
   }
 
-  while (Len > 1) {
+  //
+  // Align the data to 4 bytes.
+  //
+  if ((((UINTN)Bulk & 0x2) != 0) && (Len > 1)) {
+    Sum  += *(UINT16 *)Bulk;
+    Bulk += 2;
+    Len  -= 2;
+  }
+
+  Sum  += NetChecksumWords ((UINT32 *)Bulk, Len / 4);
+  Bulk += Len & ~0x3;
+  Len  &= 0x3;
+
+  if (Len > 1) {
     Sum  += *(UINT16 *)Bulk;
     Bulk += 2;
     Len  -= 2;
   }
 
   //
-  // Fold 32-bit sum to 16 bits
+  // Add left-over byte, if any
   //
-  while ((Sum >> 16) != 0) {
-    Sum = (Sum & 0xffff) + (Sum >> 16);
+  if (Len != 0) {
+    Sum += *Bulk;
   }
 
-  return (UINT16)Sum;
+  //
+  // Fold 64-bit sum to 16 bits
+  //
+  Folded = (UINT32)Sum;
+  High   = (UINT32)RShiftU64 (Sum, 32);
+  Folded = (Folded & 0xffff) + (Folded >> 16) + (High & 0xffff) + (High >> 16);
+  Folded = (Folded & 0xffff) + (Folded >> 16);
+  Folded = (Folded & 0xffff) + (Folded >> 16);
+
+  if (OddAddress) {
+    Folded = ((Folded & 0xff) << 8) | (Folded >> 8);
+  }
+
+  return (UINT16)Folded;
 }
 
 /**
@@ -1840,7 +2083,7 @@ NetIpSecNetbufFree (
       FreePool (Nbuf->Vector->Block[0].Bulk);
     }
 
-    FreePool (Nbuf->Vector);
-    FreePool (Nbuf);
+    NetbufFreeVectorStruct (Nbuf->Vector);
+    NetbufFreeStruct (Nbuf);
   }
 }
@@ -0,0 +1,61 @@
+/** @file
+  Internal definitions of the NET_BUF and NET_VECTOR cache of DxeNetLib.
+
+  The host-based unit test builds NetBuffer.c with INTERNAL_UNIT_TEST defined,
+  which makes the cache and its functions visible to the test, and routes the
+  pool allocations of NetBuffer.c through a function of the test so that they
+  can be made to fail.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef NET_BUFFER_INTERNALS_H_
+#define NET_BUFFER_INTERNALS_H_
+
+#include <Uefi.h>
+
+#ifdef INTERNAL_UNIT_TEST
+  #undef STATIC
+#define STATIC  // Nothing...
+
+/**
+  Allocate a buffer from the pool on behalf of NetBuffer.c, or fail.
+
+  @param[in]   AllocationSize        The number of bytes to allocate.
+
+  @return    Pointer to the buffer, or NULL if the allocation failed.
+
+**/
+VOID *
+EFIAPI
+NetbufTestAllocatePool (
+  IN UINTN  AllocationSize
+  );
+
+#define AllocatePool(AllocationSize)  NetbufTestAllocatePool (AllocationSize)
+#endif
+
+//
+// NET_BUF and NET_VECTOR structures with up to NET_BUF_CACHE_CLASSES blocks
+// are kept on per-size free lists when released, at most NET_BUF_CACHE_DEPTH
+// of each size, instead of going back to the pool allocator.
+//
+#define NET_BUF_CACHE_CLASSES  4
+#define NET_BUF_CACHE_DEPTH    64
+
+typedef struct _NET_BUF_CACHE_ENTRY NET_BUF_CACHE_ENTRY;
+
+struct _NET_BUF_CACHE_ENTRY {
+  NET_BUF_CACHE_ENTRY    *Next;
+};
+
+typedef struct {
+  NET_BUF_CACHE_ENTRY    *FreeList[NET_BUF_CACHE_CLASSES];
+  UINT32                 FreeNum[NET_BUF_CACHE_CLASSES];
+  UINT64                 Hit;
+  UINT64                 Miss;
+  UINTN                  CachedBytes;
+} NET_BUF_CACHE;
+
+#endif
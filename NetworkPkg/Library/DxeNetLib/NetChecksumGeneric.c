@@ -0,0 +1,42 @@
+/** @file
+  Portable implementation of NetChecksumWords().
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "NetChecksumInternals.h"
+
+/**
+  Sum 32-bit words into a 64-bit accumulator.
+
+  @param[in]   Words                 Pointer to the words, 4-byte aligned.
+  @param[in]   Count                 The number of words.
+
+  @return    The sum of the words.
+
+**/
+UINT64
+NetChecksumWords (
+  IN CONST UINT32  *Words,
+  IN UINTN         Count
+  )
+{
+  UINT64  Sum;
+
+  Sum = 0;
+
+  while (Count >= 4) {
+    Sum   += (UINT64)Words[0] + Words[1] + Words[2] + Words[3];
+    Words += 4;
+    Count -= 4;
+  }
+
+  while (Count > 0) {
+    Sum += *Words;
+    Words++;
+    Count--;
+  }
+
+  return Sum;
+}
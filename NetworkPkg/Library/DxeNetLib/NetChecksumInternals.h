@@ -0,0 +1,35 @@
+/** @file
+  Internal functions of the checksum routine of DxeNetLib.
+
+  NetblockChecksum() sums the bulk of the data as aligned 32-bit words with
+  NetChecksumWords(). X64 and AArch64 implement it with SIMD instructions, the
+  other architectures with a portable loop.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef NET_CHECKSUM_INTERNALS_H_
+#define NET_CHECKSUM_INTERNALS_H_
+
+#include <Uefi.h>
+
+/**
+  Sum 32-bit words into a 64-bit accumulator.
+
+  The sum cannot overflow for fewer than 2^32 words, so the caller folds it to
+  16 bits once, like a sum of 16-bit words.
+
+  @param[in]   Words                 Pointer to the words, 4-byte aligned.
+  @param[in]   Count                 The number of words.
+
+  @return    The sum of the words.
+
+**/
+UINT64
+NetChecksumWords (
+  IN CONST UINT32  *Words,
+  IN UINTN         Count
+  );
+
+#endif
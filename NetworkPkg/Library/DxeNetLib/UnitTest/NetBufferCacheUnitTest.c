@@ -0,0 +1,618 @@
+/** @file
+  Host-based unit test of the NET_BUF and NET_VECTOR cache of DxeNetLib.
+
+  NetBuffer.c is built with INTERNAL_UNIT_TEST, so the test can inspect the
+  caches and make the pool allocations of NetBuffer.c fail. Each test starts
+  with empty caches and zero counters. The tests check the per-size depth
+  limit of the caches, the hit and miss counters, that a reused structure
+  carries nothing over from its previous use, and that the error paths of
+  NetbufAlloc() and NetbufGetFragment() return their structures to the caches.
+
+  The boot services table only provides the TPL and pool services used by
+  NetBuffer.c.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/NetLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../NetBufferInternals.h"
+
+#define UNIT_TEST_APP_NAME     "DxeNetLib NET_BUF Cache Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+//
+// The value a new pool allocation is filled with, so that the tests also see
+// the fields NetbufAllocStruct() fails to initialize on a cache miss.
+//
+#define TEST_POOL_PATTERN  0xAF
+
+EFI_BOOT_SERVICES  mBootServices;
+
+//
+// The number of pool allocations that succeed before the next one fails,
+// MAX_UINTN for no failure.
+//
+UINTN  mAllocationsLeft;
+
+//
+// The NET_BUF and NET_VECTOR caches, defined in NetBuffer.c.
+//
+extern NET_BUF_CACHE  mNetbufCache;
+extern NET_BUF_CACHE  mNetVectorCache;
+
+/**
+  Release all the structures held by a cache to the pool, defined in
+  NetBuffer.c.
+
+  @param[in, out]  Cache         The cache to flush.
+
+**/
+VOID
+NetbufCacheFlush (
+  IN OUT NET_BUF_CACHE  *Cache
+  );
+
+/**
+  Free a NET_BUF structure allocated by NetbufAllocStruct() or NetbufClone(),
+  defined in NetBuffer.c.
+
+  @param[in]  Nbuf              Pointer to the NET_BUF to be freed.
+
+**/
+VOID
+NetbufFreeStruct (
+  IN NET_BUF  *Nbuf
+  );
+
+/**
+  Free a NET_VECTOR structure allocated by NetbufAllocStruct(), defined in
+  NetBuffer.c.
+
+  @param[in]  Vector            Pointer to the NET_VECTOR to be freed.
+
+**/
+VOID
+NetbufFreeVectorStruct (
+  IN NET_VECTOR  *Vector
+  );
+
+/**
+  Allocate and build up the sketch for a NET_BUF, defined in NetBuffer.c.
+
+  @param[in]  BlockNum       The number of NET_BLOCK in the vector of net buffer
+  @param[in]  BlockOpNum     The number of NET_BLOCK_OP in the net buffer
+
+  @return                    Pointer to the allocated NET_BUF, or NULL if the
+                             allocation failed due to resource limit.
+
+**/
+NET_BUF *
+NetbufAllocStruct (
+  IN UINT32  BlockNum,
+  IN UINT32  BlockOpNum
+  );
+
+/**
+  Allocate a buffer from the pool on behalf of NetBuffer.c, unless the number
+  of allocations allowed to succeed is exhausted. The buffer is filled with
+  TEST_POOL_PATTERN.
+
+  @param[in]   AllocationSize        The number of bytes to allocate.
+
+  @return    Pointer to the buffer, or NULL if the allocation failed.
+
+**/
+VOID *
+EFIAPI
+NetbufTestAllocatePool (
+  IN UINTN  AllocationSize
+  )
+{
+  VOID  *Buffer;
+
+  if (mAllocationsLeft == 0) {
+    return NULL;
+  }
+
+  if (mAllocationsLeft != MAX_UINTN) {
+    mAllocationsLeft--;
+  }
+
+  Buffer = AllocateZeroPool (AllocationSize);
+  if (Buffer != NULL) {
+    SetMem (Buffer, AllocationSize, TEST_POOL_PATTERN);
+  }
+
+  return Buffer;
+}
+
+/**
+  Fake RaiseTPL(), the tests run at a single TPL.
+
+  @param[in]  NewTpl       Unused.
+
+  @return TPL_APPLICATION.
+
+**/
+EFI_TPL
+EFIAPI
+FakeRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  return TPL_APPLICATION;
+}
+
+/**
+  Fake RestoreTPL(), the tests run at a single TPL.
+
+  @param[in]  OldTpl       Unused.
+
+**/
+VOID
+EFIAPI
+FakeRestoreTpl (
+  IN EFI_TPL  OldTpl
+  )
+{
+}
+
+/**
+  Fake FreePool(), NetBuffer.c allocates its buffers from MemoryAllocationLib.
+
+  @param[in]  Buffer       The buffer to free.
+
+  @return EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+/**
+  Reset the caches and their counters, and let all the allocations succeed.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED  The caches are empty.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ResetCaches (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mBootServices.RaiseTPL   = FakeRaiseTpl;
+  mBootServices.RestoreTPL = FakeRestoreTpl;
+  mBootServices.FreePool   = FakeFreePool;
+  gBS                      = &mBootServices;
+
+  NetbufCacheFlush (&mNetbufCache);
+  NetbufCacheFlush (&mNetVectorCache);
+  mNetbufCache.Hit     = 0;
+  mNetbufCache.Miss    = 0;
+  mNetVectorCache.Hit  = 0;
+  mNetVectorCache.Miss = 0;
+
+  mAllocationsLeft = MAX_UINTN;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Release the structures held by the caches.
+
+  @param[in]  Context  Unused.
+
+**/
+VOID
+EFIAPI
+FlushCaches (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NetbufCacheFlush (&mNetbufCache);
+  NetbufCacheFlush (&mNetVectorCache);
+}
+
+/**
+  Check that each size class keeps at most NET_BUF_CACHE_DEPTH structures,
+  releasing the others to the pool, and that structures larger than the
+  largest class are not cached at all.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CacheDepth (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NET_BUF  *Nbufs[NET_BUF_CACHE_DEPTH + 8];
+  UINT32   Class;
+  UINT32   Index;
+
+  for (Class = 1; Class <= NET_BUF_CACHE_CLASSES + 1; Class++) {
+    for (Index = 0; Index < ARRAY_SIZE (Nbufs); Index++) {
+      Nbufs[Index] = NetbufAllocStruct (Class, Class);
+      UT_ASSERT_NOT_NULL (Nbufs[Index]);
+    }
+
+    for (Index = 0; Index < ARRAY_SIZE (Nbufs); Index++) {
+      NetbufFreeVectorStruct (Nbufs[Index]->Vector);
+      NetbufFreeStruct (Nbufs[Index]);
+    }
+  }
+
+  for (Class = 1; Class <= NET_BUF_CACHE_CLASSES; Class++) {
+    UT_ASSERT_EQUAL (mNetbufCache.FreeNum[Class - 1], NET_BUF_CACHE_DEPTH);
+    UT_ASSERT_EQUAL (mNetVectorCache.FreeNum[Class - 1], NET_BUF_CACHE_DEPTH);
+  }
+
+  UT_ASSERT_EQUAL (
+    mNetbufCache.CachedBytes,
+    NET_BUF_CACHE_DEPTH * (NET_BUF_SIZE (1) + NET_BUF_SIZE (2) + NET_BUF_SIZE (3) + NET_BUF_SIZE (4))
+    );
+  UT_ASSERT_EQUAL (
+    mNetVectorCache.CachedBytes,
+    NET_BUF_CACHE_DEPTH * (NET_VECTOR_SIZE (1) + NET_VECTOR_SIZE (2) + NET_VECTOR_SIZE (3) + NET_VECTOR_SIZE (4))
+    );
+
+  //
+  // Every allocation above was a miss, except the five-block ones which the
+  // cache doesn't handle.
+  //
+  UT_ASSERT_EQUAL (mNetbufCache.Hit, 0);
+  UT_ASSERT_EQUAL (mNetbufCache.Miss, NET_BUF_CACHE_CLASSES * ARRAY_SIZE (Nbufs));
+  UT_ASSERT_EQUAL (mNetVectorCache.Hit, 0);
+  UT_ASSERT_EQUAL (mNetVectorCache.Miss, NET_BUF_CACHE_CLASSES * ARRAY_SIZE (Nbufs));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check the hit and miss counters as single block buffers are allocated and
+  freed, and that a freed structure is the first one reused.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+HitAndMiss (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NET_BUF     *First;
+  NET_BUF     *Second;
+  NET_BUF     *Third;
+  NET_VECTOR  *FirstVector;
+
+  First  = NetbufAlloc (64);
+  Second = NetbufAlloc (64);
+  UT_ASSERT_NOT_NULL (First);
+  UT_ASSERT_NOT_NULL (Second);
+  UT_ASSERT_EQUAL (mNetbufCache.Hit, 0);
+  UT_ASSERT_EQUAL (mNetbufCache.Miss, 2);
+  UT_ASSERT_EQUAL (mNetVectorCache.Hit, 0);
+  UT_ASSERT_EQUAL (mNetVectorCache.Miss, 2);
+
+  FirstVector = First->Vector;
+  NetbufFree (First);
+  UT_ASSERT_EQUAL (mNetbufCache.FreeNum[0], 1);
+  UT_ASSERT_EQUAL (mNetVectorCache.FreeNum[0], 1);
+  UT_ASSERT_EQUAL (mNetbufCache.CachedBytes, NET_BUF_SIZE (1));
+  UT_ASSERT_EQUAL (mNetVectorCache.CachedBytes, NET_VECTOR_SIZE (1));
+
+  Third = NetbufAlloc (128);
+  UT_ASSERT_TRUE (Third == First);
+  UT_ASSERT_TRUE (Third->Vector == FirstVector);
+  UT_ASSERT_EQUAL (mNetbufCache.Hit, 1);
+  UT_ASSERT_EQUAL (mNetbufCache.Miss, 2);
+  UT_ASSERT_EQUAL (mNetVectorCache.Hit, 1);
+  UT_ASSERT_EQUAL (mNetVectorCache.Miss, 2);
+  UT_ASSERT_EQUAL (mNetbufCache.FreeNum[0], 0);
+  UT_ASSERT_EQUAL (mNetbufCache.CachedBytes, 0);
+
+  //
+  // A buffer with two blocks misses the single block class.
+  //
+  NetbufFree (Second);
+  First = NetbufAllocStruct (1, 2);
+  UT_ASSERT_NOT_NULL (First);
+  UT_ASSERT_EQUAL (mNetbufCache.Hit, 1);
+  UT_ASSERT_EQUAL (mNetbufCache.Miss, 3);
+  UT_ASSERT_EQUAL (mNetVectorCache.Hit, 2);
+  UT_ASSERT_EQUAL (mNetbufCache.FreeNum[0], 1);
+
+  NetbufFreeVectorStruct (First->Vector);
+  NetbufFreeStruct (First);
+  NetbufFree (Third);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that a structure taken from the cache is initialized like a new one,
+  after its previous user filled it with data.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+NoStaleData (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NET_BUF     *Nbuf;
+  NET_BUF     *Reused;
+  NET_VECTOR  *Vector;
+
+  Nbuf = NetbufAllocStruct (2, 2);
+  UT_ASSERT_NOT_NULL (Nbuf);
+
+  //
+  // Dirty all the fields NetbufAllocStruct() doesn't set, the block counts
+  // are needed to free the structures.
+  //
+  Vector = Nbuf->Vector;
+  SetMem (&Nbuf->Ip, OFFSET_OF (NET_BUF, Vector) - OFFSET_OF (NET_BUF, Ip), TEST_POOL_PATTERN);
+  SetMem (&Nbuf->TotalSize, NET_BUF_SIZE (2) - OFFSET_OF (NET_BUF, TotalSize), TEST_POOL_PATTERN);
+  SetMem (&Vector->Free, OFFSET_OF (NET_VECTOR, BlockNum) - OFFSET_OF (NET_VECTOR, Free), TEST_POOL_PATTERN);
+  SetMem (Vector->Block, 2 * sizeof (NET_BLOCK), TEST_POOL_PATTERN);
+
+  NetbufFreeVectorStruct (Vector);
+  NetbufFreeStruct (Nbuf);
+
+  Reused = NetbufAllocStruct (2, 2);
+  UT_ASSERT_TRUE (Reused == Nbuf);
+  UT_ASSERT_TRUE (Reused->Vector == Vector);
+  UT_ASSERT_EQUAL (mNetbufCache.Hit, 1);
+  UT_ASSERT_EQUAL (mNetVectorCache.Hit, 1);
+
+  UT_ASSERT_EQUAL (Reused->Signature, NET_BUF_SIGNATURE);
+  UT_ASSERT_EQUAL (Reused->RefCnt, 1);
+  UT_ASSERT_TRUE (IsListEmpty (&Reused->List));
+  UT_ASSERT_TRUE (Reused->Ip.Ip4 == NULL);
+  UT_ASSERT_TRUE (Reused->Tcp == NULL);
+  UT_ASSERT_TRUE (Reused->Udp == NULL);
+  UT_ASSERT_TRUE (IsZeroBuffer (Reused->ProtoData, sizeof (Reused->ProtoData)));
+  UT_ASSERT_EQUAL (Reused->BlockOpNum, 2);
+  UT_ASSERT_EQUAL (Reused->TotalSize, 0);
+  UT_ASSERT_TRUE (IsZeroBuffer (Reused->BlockOp, 2 * sizeof (NET_BLOCK_OP)));
+
+  UT_ASSERT_EQUAL (Vector->Signature, NET_VECTOR_SIGNATURE);
+  UT_ASSERT_EQUAL (Vector->RefCnt, 1);
+  UT_ASSERT_TRUE (Vector->Free == NULL);
+  UT_ASSERT_TRUE (Vector->Arg == NULL);
+  UT_ASSERT_EQUAL (Vector->Flag, 0);
+  UT_ASSERT_EQUAL (Vector->Len, 0);
+  UT_ASSERT_EQUAL (Vector->BlockNum, 2);
+  UT_ASSERT_TRUE (IsZeroBuffer (Vector->Block, 2 * sizeof (NET_BLOCK)));
+
+  NetbufFreeVectorStruct (Vector);
+  NetbufFreeStruct (Reused);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that NetbufAlloc() returns both its NET_BUF and NET_VECTOR to the
+  caches when the data block can't be allocated.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+AllocFailure (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  //
+  // The NET_BUF and the NET_VECTOR are allocated, the data block fails.
+  //
+  mAllocationsLeft = 2;
+  UT_ASSERT_TRUE (NetbufAlloc (64) == NULL);
+  UT_ASSERT_EQUAL (mAllocationsLeft, 0);
+
+  UT_ASSERT_EQUAL (mNetbufCache.FreeNum[0], 1);
+  UT_ASSERT_EQUAL (mNetVectorCache.FreeNum[0], 1);
+
+  //
+  // Both structures come from the caches on the next attempt, so only the
+  // data block needs the pool.
+  //
+  mAllocationsLeft = 0;
+  UT_ASSERT_TRUE (NetbufAlloc (64) == NULL);
+  UT_ASSERT_EQUAL (mNetbufCache.Hit, 1);
+  UT_ASSERT_EQUAL (mNetVectorCache.Hit, 1);
+  UT_ASSERT_EQUAL (mNetbufCache.FreeNum[0], 1);
+  UT_ASSERT_EQUAL (mNetVectorCache.FreeNum[0], 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that NetbufGetFragment() returns both the NET_BUF and NET_VECTOR of
+  the fragment to the caches when its head space can't be allocated.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+GetFragmentFailure (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NET_BUF  *Nbuf;
+  NET_BUF  *Fragment;
+
+  Nbuf = NetbufAlloc (256);
+  UT_ASSERT_NOT_NULL (Nbuf);
+  UT_ASSERT_NOT_NULL (NetbufAllocSpace (Nbuf, 256, NET_BUF_TAIL));
+
+  //
+  // The fragment has a block of head space and one of data. Its NET_BUF and
+  // NET_VECTOR are allocated, the head space fails.
+  //
+  mAllocationsLeft = 2;
+  Fragment         = NetbufGetFragment (Nbuf, 16, 128, 32);
+  UT_ASSERT_TRUE (Fragment == NULL);
+  UT_ASSERT_EQUAL (mAllocationsLeft, 0);
+
+  UT_ASSERT_EQUAL (mNetbufCache.FreeNum[1], 1);
+  UT_ASSERT_EQUAL (mNetVectorCache.FreeNum[0], 1);
+
+  //
+  // The original buffer is untouched, and on the next attempt both structures
+  // come from the caches, only the head space is allocated.
+  //
+  UT_ASSERT_EQUAL (Nbuf->TotalSize, 256);
+  UT_ASSERT_EQUAL (Nbuf->Vector->RefCnt, 1);
+
+  mAllocationsLeft = 1;
+  Fragment         = NetbufGetFragment (Nbuf, 16, 128, 32);
+  UT_ASSERT_NOT_NULL (Fragment);
+  UT_ASSERT_EQUAL (mAllocationsLeft, 0);
+  UT_ASSERT_EQUAL (mNetbufCache.Hit, 1);
+  UT_ASSERT_EQUAL (mNetVectorCache.Hit, 1);
+  UT_ASSERT_EQUAL (Fragment->TotalSize, 128);
+  UT_ASSERT_TRUE (NetbufGetByte (Fragment, 0, NULL) == NetbufGetByte (Nbuf, 16, NULL));
+  UT_ASSERT_EQUAL (Nbuf->Vector->RefCnt, 2);
+
+  mAllocationsLeft = MAX_UINTN;
+  NetbufFree (Fragment);
+  NetbufFree (Nbuf);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the NET_BUF
+  cache and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CacheTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the NET_BUF cache Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&CacheTests, Framework, "NET_BUF Cache Tests", "DxeNetLib.NetbufCache", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for NET_BUF Cache Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------------------------------Name------------------Function------------Pre----------Post---------Context
+  //
+  AddTestCase (CacheTests, "Cache depth per size class", "CacheDepth", CacheDepth, ResetCaches, FlushCaches, NULL);
+  AddTestCase (CacheTests, "Hit and miss counters", "HitAndMiss", HitAndMiss, ResetCaches, FlushCaches, NULL);
+  AddTestCase (CacheTests, "No stale data in reused structures", "NoStaleData", NoStaleData, ResetCaches, FlushCaches, NULL);
+  AddTestCase (CacheTests, "NetbufAlloc data allocation failure", "AllocFailure", AllocFailure, ResetCaches, FlushCaches, NULL);
+  AddTestCase (CacheTests, "NetbufGetFragment head space allocation failure", "GetFragmentFailure", GetFragmentFailure, ResetCaches, FlushCaches, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define NetBufferCacheUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+NetBufferCacheUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = UnitTestingEntry ();
+  return EFI_ERROR (Status) ? 1 : 0;
+}
@@ -0,0 +1,488 @@
+/** @file
+  Host-based unit test of the checksum routine of DxeNetLib.
+
+  NetblockChecksum() sums the data in 32-bit words after aligning it, and
+  swaps the bytes of the result for data starting at an odd address. It is
+  compared with the straightforward 16-bit word sum it replaced, for data at
+  every start offset from an 8-byte aligned address, and timed against it.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/NetLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "DxeNetLib Checksum Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+//
+// The largest data tested, the size of the largest IPv4 packet, and the
+// start offsets tested from an 8-byte aligned address.
+//
+#define TEST_MAX_LENGTH  0xFFFF
+#define TEST_OFFSETS     8
+
+//
+// NetbufChecksum() passes its blocks to NetblockChecksum() at any address, so
+// the buffer is 8-byte aligned and the data is placed at every offset from it.
+//
+UINT64  mBuffer[(TEST_MAX_LENGTH + TEST_OFFSETS + sizeof (UINT64) - 1) / sizeof (UINT64)];
+UINT32  mSeed;
+
+//
+// The amount of data checksummed by each routine when timing it.
+//
+#define TEST_TIMING_BYTES  SIZE_64MB
+
+/**
+  Compute the checksum for a bulk of data.
+
+  @param[in]   Bulk                  Pointer to the data.
+  @param[in]   Len                   Length of the data, in bytes.
+
+  @return    The computed checksum.
+
+**/
+typedef
+UINT16
+(EFIAPI *TEST_CHECKSUM)(
+  IN UINT8   *Bulk,
+  IN UINT32  Len
+  );
+
+/**
+  Compute the checksum for a bulk of data, one 16-bit word at a time. This is
+  the implementation NetblockChecksum() replaced.
+
+  @param[in]   Bulk                  Pointer to the data.
+  @param[in]   Len                   Length of the data, in bytes.
+
+  @return    The computed checksum.
+
+**/
+UINT16
+EFIAPI
+ReferenceChecksum (
+  IN UINT8   *Bulk,
+  IN UINT32  Len
+  )
+{
+  UINT32  Sum;
+
+  Sum = 0;
+
+  //
+  // Add left-over byte, if any
+  //
+  if (Len % 2 != 0) {
+    Sum += *(Bulk + Len - 1);
+  }
+
+  while (Len > 1) {
+    Sum  += ReadUnaligned16 ((UINT16 *)Bulk);
+    Bulk += 2;
+    Len  -= 2;
+  }
+
+  //
+  // Fold 32-bit sum to 16 bits
+  //
+  while ((Sum >> 16) != 0) {
+    Sum = (Sum & 0xffff) + (Sum >> 16);
+  }
+
+  return (UINT16)Sum;
+}
+
+/**
+  Return the next pseudo random number, from a fixed seed so that the results
+  are reproducible.
+
+  @return The pseudo random number.
+
+**/
+UINT32
+TestRandom (
+  VOID
+  )
+{
+  mSeed = mSeed * 1103515245 + 12345;
+  return mSeed >> 8;
+}
+
+/**
+  Fill the test buffer with pseudo random bytes.
+
+  @param[in]  Length  The number of bytes to fill.
+
+**/
+VOID
+FillRandom (
+  IN UINTN  Length
+  )
+{
+  UINT8  *Data;
+  UINTN  Index;
+
+  Data = (UINT8 *)mBuffer;
+  for (Index = 0; Index < Length; Index++) {
+    Data[Index] = (UINT8)TestRandom ();
+  }
+}
+
+/**
+  Check NetblockChecksum() against the reference for data of every length up
+  to a maximum, at every start offset.
+
+  @param[in]  MaxLength  The largest length to check.
+
+  @retval TRUE   The checksums are identical.
+  @retval FALSE  The checksums differ for some length and offset.
+
+**/
+BOOLEAN
+CheckAllLengths (
+  IN UINT32  MaxLength
+  )
+{
+  UINT8   *Data;
+  UINT32  Offset;
+  UINT32  Length;
+  UINT16  Expected;
+  UINT16  Actual;
+
+  for (Offset = 0; Offset < TEST_OFFSETS; Offset++) {
+    for (Length = 0; Length <= MaxLength; Length++) {
+      Data     = (UINT8 *)mBuffer + Offset;
+      Expected = ReferenceChecksum (Data, Length);
+      Actual   = NetblockChecksum (Data, Length);
+      if (Actual != Expected) {
+        UT_LOG_ERROR ("Offset %d length %d: checksum 0x%04x, expected 0x%04x\n", Offset, Length, Actual, Expected);
+        return FALSE;
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Check the checksum of empty and single byte data, at every start offset.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ShortData (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8   *Data;
+  UINT32  Offset;
+
+  SetMem (mBuffer, sizeof (mBuffer), 0xA5);
+
+  for (Offset = 0; Offset < TEST_OFFSETS; Offset++) {
+    Data = (UINT8 *)mBuffer + Offset;
+
+    UT_ASSERT_EQUAL (NetblockChecksum (Data, 0), 0);
+
+    //
+    // A single byte is the low byte of its word.
+    //
+    *Data = 0x5A;
+    UT_ASSERT_EQUAL (NetblockChecksum (Data, 1), 0x005A);
+    UT_ASSERT_EQUAL (NetblockChecksum (Data, 1), ReferenceChecksum (Data, 1));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check the checksum of random data of every length up to 256 bytes, odd and
+  even, at every start offset. This covers all the ways the data can end
+  after the 4-byte and 16-byte loops.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RandomShortData (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Round;
+
+  mSeed = 1;
+  for (Round = 0; Round < 16; Round++) {
+    FillRandom (256 + TEST_OFFSETS);
+    UT_ASSERT_TRUE (CheckAllLengths (256));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check the checksum of random data of random lengths up to 64 KiB, at every
+  start offset.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RandomLongData (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8   *Data;
+  UINT32  Round;
+  UINT32  Offset;
+  UINT32  Length;
+
+  mSeed = 2;
+  FillRandom (sizeof (mBuffer));
+
+  for (Round = 0; Round < 256; Round++) {
+    Length = TestRandom () % (TEST_MAX_LENGTH + 1);
+    for (Offset = 0; Offset < TEST_OFFSETS; Offset++) {
+      Data = (UINT8 *)mBuffer + Offset;
+      UT_ASSERT_EQUAL (NetblockChecksum (Data, Length), ReferenceChecksum (Data, Length));
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check the checksum of data with all bits set, which carries out of every
+  word, up to the largest length, at every start offset.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+AllOnesData (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8   *Data;
+  UINT32  Offset;
+
+  SetMem (mBuffer, sizeof (mBuffer), 0xFF);
+  UT_ASSERT_TRUE (CheckAllLengths (64));
+
+  for (Offset = 0; Offset < TEST_OFFSETS; Offset++) {
+    Data = (UINT8 *)mBuffer + Offset;
+    UT_ASSERT_EQUAL (NetblockChecksum (Data, TEST_MAX_LENGTH), ReferenceChecksum (Data, TEST_MAX_LENGTH));
+    UT_ASSERT_EQUAL (NetblockChecksum (Data, TEST_MAX_LENGTH - 1), ReferenceChecksum (Data, TEST_MAX_LENGTH - 1));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checksum the same data repeatedly, and measure the processor time taken.
+
+  @param[in]   Checksum              The checksum routine.
+  @param[in]   Data                  Pointer to the data.
+  @param[in]   Length                Length of the data, in bytes.
+  @param[out]  Sum                   The sum of all the checksums computed.
+
+  @return    The processor time taken, in microseconds.
+
+**/
+UINT64
+TimeChecksum (
+  IN  TEST_CHECKSUM  Checksum,
+  IN  UINT8          *Data,
+  IN  UINT32         Length,
+  OUT UINT32         *Sum
+  )
+{
+  UINT32   Round;
+  UINT32   Rounds;
+  clock_t  Start;
+
+  Rounds = TEST_TIMING_BYTES / Length;
+  *Sum   = 0;
+
+  Start = clock ();
+  for (Round = 0; Round < Rounds; Round++) {
+    *Sum += Checksum (Data, Length);
+  }
+
+  return (UINT64)(clock () - Start) * 1000000 / CLOCKS_PER_SEC;
+}
+
+/**
+  Compare the time NetblockChecksum() and the reference take to checksum a
+  minimum size Ethernet payload, a full size one and the largest IPv4 packet,
+  at an aligned and an odd start address. The times are logged, and the 64 KiB
+  data must not take longer than with the reference.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CompareTiming (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT32  Lengths[] = { 46, 1500, TEST_MAX_LENGTH };
+  UINT8                *Data;
+  UINTN                Index;
+  UINT32               Offset;
+  UINT64               Time;
+  UINT64               ReferenceTime;
+  UINT32               Sum;
+  UINT32               ReferenceSum;
+
+  mSeed = 3;
+  FillRandom (sizeof (mBuffer));
+
+  for (Offset = 0; Offset < 2; Offset++) {
+    Data = (UINT8 *)mBuffer + Offset;
+    for (Index = 0; Index < ARRAY_SIZE (Lengths); Index++) {
+      Time          = TimeChecksum (NetblockChecksum, Data, Lengths[Index], &Sum);
+      ReferenceTime = TimeChecksum (ReferenceChecksum, Data, Lengths[Index], &ReferenceSum);
+      UT_LOG_INFO (
+        "Offset %d length %d: %ld us, reference %ld us for %d MiB\n",
+        Offset,
+        Lengths[Index],
+        Time,
+        ReferenceTime,
+        TEST_TIMING_BYTES / SIZE_1MB
+        );
+      UT_ASSERT_EQUAL (Sum, ReferenceSum);
+    }
+
+    //
+    // The last length timed is the largest.
+    //
+    UT_ASSERT_TRUE (Time <= ReferenceTime);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the checksum
+  routine and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ChecksumTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the checksum Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&ChecksumTests, Framework, "Net Checksum Tests", "DxeNetLib.Checksum", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Net Checksum Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-------------Description-----------------------------Name--------------Function---------Pre---Post--Context
+  //
+  AddTestCase (ChecksumTests, "Empty and single byte data", "ShortData", ShortData, NULL, NULL, NULL);
+  AddTestCase (ChecksumTests, "Random data of every length up to 256", "RandomShortData", RandomShortData, NULL, NULL, NULL);
+  AddTestCase (ChecksumTests, "Random data of random lengths up to 64K", "RandomLongData", RandomLongData, NULL, NULL, NULL);
+  AddTestCase (ChecksumTests, "Data with all bits set", "AllOnesData", AllOnesData, NULL, NULL, NULL);
+  AddTestCase (ChecksumTests, "Time compared with the reference", "CompareTiming", CompareTiming, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define NetChecksumUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+NetChecksumUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = UnitTestingEntry ();
+  return EFI_ERROR (Status) ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+/** @file
+  X64 implementation of NetChecksumWords(), with SSE2 or AVX2 instructions.
+
+  SSE2 is part of the X64 architecture. AVX2 is used when the processor
+  supports it and the AVX state has been enabled in XCR0, which is decided on
+  the first call.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Register/Intel/Cpuid.h>
+
+#include "../NetChecksumInternals.h"
+
+//
+// The SIMD routines sum the data in blocks of 64 bytes.
+//
+#define NET_CHECKSUM_BLOCK_SIZE  64
+
+/**
+  Sum the 32-bit words of data in blocks of 64 bytes.
+
+  @param[in]   Buffer                Pointer to the data.
+  @param[in]   Length                Length of the data, a multiple of 64 bytes.
+
+  @return    The sum of the words.
+
+**/
+typedef
+UINT64
+(EFIAPI *NET_CHECKSUM_BLOCKS)(
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length
+  );
+
+/**
+  Sum the 32-bit words of data in blocks of 64 bytes, with SSE2 instructions.
+
+  @param[in]   Buffer                Pointer to the data.
+  @param[in]   Length                Length of the data, a multiple of 64 bytes.
+
+  @return    The sum of the words.
+
+**/
+UINT64
+EFIAPI
+InternalNetChecksumSse2 (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length
+  );
+
+/**
+  Sum the 32-bit words of data in blocks of 64 bytes, with AVX2 instructions.
+
+  @param[in]   Buffer                Pointer to the data.
+  @param[in]   Length                Length of the data, a multiple of 64 bytes.
+
+  @return    The sum of the words.
+
+**/
+UINT64
+EFIAPI
+InternalNetChecksumAvx2 (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length
+  );
+
+/**
+  Read XCR0 with the XGETBV instruction. The processor must support XSAVE and
+  CR4.OSXSAVE must be set.
+
+  @return    The value of XCR0.
+
+**/
+UINT64
+EFIAPI
+InternalNetChecksumReadXcr0 (
+  VOID
+  );
+
+STATIC NET_CHECKSUM_BLOCKS  mNetChecksumBlocks = NULL;
+
+/**
+  Check whether AVX2 instructions can be used.
+
+  @retval TRUE     The processor supports AVX2, and the AVX state is enabled.
+  @retval FALSE    AVX2 instructions can't be used.
+
+**/
+STATIC
+BOOLEAN
+NetChecksumAvx2Usable (
+  VOID
+  )
+{
+  UINT32                                       MaxLeaf;
+  CPUID_VERSION_INFO_ECX                       VersionEcx;
+  CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_EBX  ExtendedEbx;
+
+  AsmCpuid (CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf < CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS) {
+    return FALSE;
+  }
+
+  AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionEcx.Uint32, NULL);
+  if ((VersionEcx.Bits.OSXSAVE == 0) || (VersionEcx.Bits.AVX == 0)) {
+    return FALSE;
+  }
+
+  //
+  // The SSE and AVX state (XCR0 bits 1 and 2) must be enabled, otherwise the
+  // AVX2 instructions raise #UD.
+  //
+  if ((InternalNetChecksumReadXcr0 () & (BIT1 | BIT2)) != (BIT1 | BIT2)) {
+    return FALSE;
+  }
+
+  AsmCpuidEx (
+    CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS,
+    CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_SUB_LEAF_INFO,
+    NULL,
+    &ExtendedEbx.Uint32,
+    NULL,
+    NULL
+    );
+  return (BOOLEAN)(ExtendedEbx.Bits.AVX2 != 0);
+}
+
+/**
+  Sum 32-bit words into a 64-bit accumulator.
+
+  @param[in]   Words                 Pointer to the words, 4-byte aligned.
+  @param[in]   Count                 The number of words.
+
+  @return    The sum of the words.
+
+**/
+UINT64
+NetChecksumWords (
+  IN CONST UINT32  *Words,
+  IN UINTN         Count
+  )
+{
+  UINT64  Sum;
+  UINTN   Length;
+
+  if (mNetChecksumBlocks == NULL) {
+    mNetChecksumBlocks = NetChecksumAvx2Usable () ? InternalNetChecksumAvx2 : InternalNetChecksumSse2;
+  }
+
+  Sum    = 0;
+  Length = (Count * sizeof (UINT32)) & ~(UINTN)(NET_CHECKSUM_BLOCK_SIZE - 1);
+
+  if (Length != 0) {
+    Sum    = mNetChecksumBlocks (Words, Length);
+    Words += Length / sizeof (UINT32);
+    Count -= Length / sizeof (UINT32);
+  }
+
+  while (Count > 0) {
+    Sum += *Words;
+    Words++;
+    Count--;
+  }
+
+  return Sum;
+}
@@ -1273,6 +1273,8 @@ MnpStart (
     }
 
     MnpDeviceData->EnableSystemPoll = EnableSystemPoll;
+    MnpDeviceData->PollInterval     = MNP_SYS_POLL_INTERVAL;
+    MnpDeviceData->IdlePollCount    = 0;
   }
 
   //
@@ -1332,6 +1334,15 @@ MnpStop (
     //
     Status                          = gBS->SetTimer (MnpDeviceData->PollTimer, TimerCancel, 0);
     MnpDeviceData->EnableSystemPoll = FALSE;
+
+    DEBUG ((
+      DEBUG_INFO,
+      "MnpStop: %Lu system polls, %Lu packets received, %Lu budget hits, %Lu packets dropped.\n",
+      MnpDeviceData->PollCount,
+      MnpDeviceData->PollRxCount,
+      MnpDeviceData->PollBudgetHitCount,
+      MnpDeviceData->RxDropCount
+      ));
   }
 
   //
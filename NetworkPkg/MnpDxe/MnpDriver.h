@@ -70,6 +70,16 @@ typedef struct {
   EFI_EVENT                      PollTimer;
   BOOLEAN                        EnableSystemPoll;
 
+  //
+  // Adaptive system poll state and receive statistics.
+  //
+  UINT64                         PollInterval;
+  UINT32                         IdlePollCount;
+  UINT64                         PollCount;
+  UINT64                         PollRxCount;
+  UINT64                         PollBudgetHitCount;
+  UINT64                         RxDropCount;
+
   EFI_EVENT                      TimeoutCheckTimer;
   EFI_EVENT                      MediaDetectTimer;
 
@@ -481,6 +481,7 @@ MnpQueueRcvdPacket (
   //
   if (Instance->RcvdPacketQueueSize == MNP_MAX_RCVD_PACKET_QUE_SIZE) {
     DEBUG ((DEBUG_WARN, "MnpQueueRcvdPacket: Drop one packet bcz queue size limit reached.\n"));
+    Instance->MnpServiceData->MnpDeviceData->RxDropCount++;
 
     //
     // Get the oldest packet.
@@ -1087,6 +1088,10 @@ MnpCheckMediaStatus (
   Poll to receive the packets from Snp. This function is either called by upperlayer
   protocols/applications or the system poll timer notify mechanism.
 
+  All the packets pending in Snp are received, up to MNP_SYS_POLL_BUDGET per
+  call. The poll timer is backed off towards MNP_SYS_POLL_INTERVAL_MAX while the
+  link is idle, and restored to MNP_SYS_POLL_INTERVAL once a packet arrives.
+
   @param[in]  Event        The event this notify function registered to.
   @param[in]  Context      Pointer to the context data registered to the event.
 
@@ -1098,18 +1103,53 @@ MnpSystemPoll (
   IN VOID       *Context
   )
 {
+  EFI_STATUS       Status;
   MNP_DEVICE_DATA  *MnpDeviceData;
+  UINT32           Received;
+  UINT64           Interval;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
   //
-  // Try to receive packets from Snp.
+  // Try to receive packets from Snp until there is none left or the budget is
+  // used up. Dispatch the DPC queued by the NotifyFunction of rx token's events
+  // after each packet, so the receivers can recycle their tokens before the
+  // next packet is delivered instead of having it queued.
   //
-  MnpReceivePacket (MnpDeviceData);
+  for (Received = 0; Received < MNP_SYS_POLL_BUDGET; Received++) {
+    Status = MnpReceivePacket (MnpDeviceData);
+    DispatchDpc ();
+
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  MnpDeviceData->PollCount++;
+  MnpDeviceData->PollRxCount += Received;
+  if (Received == MNP_SYS_POLL_BUDGET) {
+    MnpDeviceData->PollBudgetHitCount++;
+  }
 
   //
-  // Dispatch the DPC queued by the NotifyFunction of rx token's events.
+  // Adjust the poll interval, run at the base interval while there is traffic
+  // and double it after MNP_SYS_POLL_IDLE_THRESHOLD idle polls.
   //
-  DispatchDpc ();
+  if (Received != 0) {
+    MnpDeviceData->IdlePollCount = 0;
+    Interval                     = MNP_SYS_POLL_INTERVAL;
+  } else if (MnpDeviceData->IdlePollCount < MNP_SYS_POLL_IDLE_THRESHOLD) {
+    MnpDeviceData->IdlePollCount++;
+    return;
+  } else {
+    Interval = MIN (MnpDeviceData->PollInterval * 2, MNP_SYS_POLL_INTERVAL_MAX);
+  }
+
+  if (Interval != MnpDeviceData->PollInterval) {
+    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, Interval);
+    if (!EFI_ERROR (Status)) {
+      MnpDeviceData->PollInterval = Interval;
+    }
+  }
 }
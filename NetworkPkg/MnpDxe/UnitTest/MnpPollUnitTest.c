@@ -0,0 +1,637 @@
+/** @file
+  Host-based unit test of the system poll of MnpDxe.
+
+  MnpSystemPoll() receives from a stub Simple Network Protocol holding a given
+  number of pending packets. No MNP service is bound, so the packets are
+  received and dropped without a receiver. The test checks that a poll stops
+  at MNP_SYS_POLL_BUDGET packets, that the poll timer backs off after
+  MNP_SYS_POLL_IDLE_THRESHOLD idle polls up to MNP_SYS_POLL_INTERVAL_MAX and
+  returns to MNP_SYS_POLL_INTERVAL on traffic, and the poll and drop counters.
+
+  The rest of MnpDxe is replaced by fakes: the buffer pool allocates from
+  NetLib, DispatchDpc() only counts its calls, and the boot services table
+  only provides the services used by NetLib and the poll timer.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Library/UnitTestLib.h>
+
+#include "../MnpImpl.h"
+#include "../MnpVlan.h"
+
+#define UNIT_TEST_APP_NAME     "MnpDxe System Poll Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_HEADER_SIZE    14
+#define TEST_PACKET_SIZE    60
+#define TEST_BUFFER_LENGTH  1514
+
+MNP_DEVICE_DATA              mDevice;
+MNP_SERVICE_DATA             mService;
+EFI_SIMPLE_NETWORK_PROTOCOL  mSnp;
+EFI_SIMPLE_NETWORK_MODE      mSnpMode;
+EFI_BOOT_SERVICES            mBootServices;
+
+//
+// The packets pending in the stub Simple Network Protocol, and the calls
+// made to it, to DispatchDpc() and to SetTimer().
+//
+UINTN   mPending;
+UINTN   mReceiveCalls;
+UINTN   mDpcCalls;
+UINTN   mTimerSets;
+UINT64  mTimerInterval;
+
+/**
+  Queue the received packet into instance's receive queue, defined in
+  MnpIo.c.
+
+  @param[in, out]  Instance        Pointer to the mnp instance context data.
+  @param[in, out]  RxDataWrap      Pointer to the Wrap structure containing the
+                                   received data and other information.
+**/
+VOID
+MnpQueueRcvdPacket (
+  IN OUT MNP_INSTANCE_DATA  *Instance,
+  IN OUT MNP_RXDATA_WRAP    *RxDataWrap
+  );
+
+/**
+  Fake RaiseTPL(), the tests run at a single TPL.
+
+  @param[in]  NewTpl       Unused.
+
+  @return TPL_APPLICATION.
+
+**/
+EFI_TPL
+EFIAPI
+FakeRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  return TPL_APPLICATION;
+}
+
+/**
+  Fake RestoreTPL(), the tests run at a single TPL.
+
+  @param[in]  OldTpl       Unused.
+
+**/
+VOID
+EFIAPI
+FakeRestoreTpl (
+  IN EFI_TPL  OldTpl
+  )
+{
+}
+
+/**
+  Fake FreePool(), NetLib allocates its buffers from MemoryAllocationLib.
+
+  @param[in]  Buffer       The buffer to free.
+
+  @return EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+/**
+  Fake SetTimer(), records the period of the poll timer.
+
+  @param[in]  Event        Unused.
+  @param[in]  Type         The type of the timer.
+  @param[in]  TriggerTime  The period of the timer.
+
+  @return EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeSetTimer (
+  IN  EFI_EVENT        Event,
+  IN  EFI_TIMER_DELAY  Type,
+  IN  UINT64           TriggerTime
+  )
+{
+  ASSERT (Type == TimerPeriodic);
+
+  mTimerSets++;
+  mTimerInterval = TriggerTime;
+  return EFI_SUCCESS;
+}
+
+/**
+  Fake CloseEvent(), the tests create no event.
+
+  @param[in]  Event        Unused.
+
+  @return EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeCloseEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Stub EFI_SIMPLE_NETWORK_PROTOCOL.Receive(), returns one of the pending
+  packets.
+
+  @param[in]      This        Unused.
+  @param[out]     HeaderSize  The size of the media header.
+  @param[in, out] BufferSize  The size of Buffer on input, of the packet on
+                              output.
+  @param[out]     Buffer      The buffer to receive the packet.
+  @param[out]     SrcAddr     Unused.
+  @param[out]     DestAddr    Unused.
+  @param[out]     Protocol    Unused.
+
+  @retval EFI_SUCCESS         A packet is received.
+  @retval EFI_NOT_READY       No packet is pending.
+
+**/
+EFI_STATUS
+EFIAPI
+StubSnpReceive (
+  IN     EFI_SIMPLE_NETWORK_PROTOCOL  *This,
+  OUT    UINTN                        *HeaderSize OPTIONAL,
+  IN OUT UINTN                        *BufferSize,
+  OUT    VOID                         *Buffer,
+  OUT    EFI_MAC_ADDRESS              *SrcAddr    OPTIONAL,
+  OUT    EFI_MAC_ADDRESS              *DestAddr   OPTIONAL,
+  OUT    UINT16                       *Protocol   OPTIONAL
+  )
+{
+  mReceiveCalls++;
+
+  if (mPending == 0) {
+    return EFI_NOT_READY;
+  }
+
+  ASSERT (*BufferSize >= TEST_PACKET_SIZE);
+
+  mPending--;
+  *HeaderSize = TEST_HEADER_SIZE;
+  *BufferSize = TEST_PACKET_SIZE;
+  ZeroMem (Buffer, TEST_PACKET_SIZE);
+  return EFI_SUCCESS;
+}
+
+/**
+  Fake DispatchDpc(), counts its calls.
+
+  @retval EFI_SUCCESS      Always.
+
+**/
+EFI_STATUS
+EFIAPI
+DispatchDpc (
+  VOID
+  )
+{
+  mDpcCalls++;
+  return EFI_SUCCESS;
+}
+
+/**
+  Fake MnpAllocNbuf(), allocates a receive buffer from NetLib.
+
+  @param[in, out]  MnpDeviceData   The MNP_DEVICE_DATA of the test.
+
+  @return The allocated buffer.
+
+**/
+NET_BUF *
+MnpAllocNbuf (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  )
+{
+  return NetbufAlloc (MnpDeviceData->BufferLength);
+}
+
+/**
+  Fake MnpFreeNbuf(), releases a buffer to NetLib.
+
+  @param[in, out]  MnpDeviceData   Unused.
+  @param[in, out]  Nbuf            The buffer to release.
+
+**/
+VOID
+MnpFreeNbuf (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN OUT NET_BUF          *Nbuf
+  )
+{
+  NetbufFree (Nbuf);
+}
+
+/**
+  Fake MnpFindServiceData(), no MNP service is bound.
+
+  @return NULL.
+
+**/
+MNP_SERVICE_DATA *
+MnpFindServiceData (
+  IN MNP_DEVICE_DATA  *MnpDeviceData,
+  IN UINT16           VlanId
+  )
+{
+  return NULL;
+}
+
+/**
+  Fake MnpRemoveVlanTag(), VLAN is not configured.
+
+  @return FALSE.
+
+**/
+BOOLEAN
+MnpRemoveVlanTag (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN OUT NET_BUF          *Nbuf,
+  OUT UINT16              *VlanId
+  )
+{
+  return FALSE;
+}
+
+/**
+  Fake MnpInsertVlanTag(), nothing is transmitted.
+
+**/
+VOID
+MnpInsertVlanTag (
+  IN     MNP_SERVICE_DATA                   *MnpServiceData,
+  IN     EFI_MANAGED_NETWORK_TRANSMIT_DATA  *TxData,
+  OUT UINT16                                *ProtocolType,
+  IN OUT UINT8                              **Packet,
+  IN OUT UINT32                             *Length
+  )
+{
+}
+
+/**
+  Fake MnpAllocTxBuf(), nothing is transmitted.
+
+  @return NULL.
+
+**/
+UINT8 *
+MnpAllocTxBuf (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  )
+{
+  return NULL;
+}
+
+/**
+  Fake MnpRecycleTxBuf(), nothing is transmitted.
+
+  @retval EFI_SUCCESS      Always.
+
+**/
+EFI_STATUS
+MnpRecycleTxBuf (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Set up an MNP device with the system poll running at the base interval and
+  no packet pending.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The device is set up.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+StartDevice (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mBootServices.RaiseTPL   = FakeRaiseTpl;
+  mBootServices.RestoreTPL = FakeRestoreTpl;
+  mBootServices.FreePool   = FakeFreePool;
+  mBootServices.SetTimer   = FakeSetTimer;
+  mBootServices.CloseEvent = FakeCloseEvent;
+  gBS                      = &mBootServices;
+
+  ZeroMem (&mSnpMode, sizeof (mSnpMode));
+  mSnpMode.State           = EfiSimpleNetworkInitialized;
+  mSnpMode.MediaHeaderSize = TEST_HEADER_SIZE;
+
+  ZeroMem (&mSnp, sizeof (mSnp));
+  mSnp.Mode    = &mSnpMode;
+  mSnp.Receive = StubSnpReceive;
+
+  ZeroMem (&mDevice, sizeof (mDevice));
+  mDevice.Signature        = MNP_DEVICE_DATA_SIGNATURE;
+  mDevice.Snp              = &mSnp;
+  mDevice.BufferLength     = TEST_BUFFER_LENGTH;
+  mDevice.EnableSystemPoll = TRUE;
+  mDevice.PollInterval     = MNP_SYS_POLL_INTERVAL;
+  InitializeListHead (&mDevice.ServiceList);
+
+  ZeroMem (&mService, sizeof (mService));
+  mService.MnpDeviceData = &mDevice;
+
+  mPending       = 0;
+  mReceiveCalls  = 0;
+  mDpcCalls      = 0;
+  mTimerSets     = 0;
+  mTimerInterval = 0;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the receive buffer of the MNP device.
+
+  @param[in]  Context  Unused.
+
+**/
+VOID
+EFIAPI
+StopDevice (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mDevice.RxNbufCache != NULL) {
+    NetbufFree (mDevice.RxNbufCache);
+    mDevice.RxNbufCache = NULL;
+  }
+}
+
+/**
+  A poll receives at most MNP_SYS_POLL_BUDGET packets and dispatches the DPCs
+  after each of them. The next poll receives the rest and stops when none is
+  left.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PollBudget (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mPending = MNP_SYS_POLL_BUDGET + 36;
+
+  MnpSystemPoll (NULL, &mDevice);
+  UT_ASSERT_EQUAL (mPending, 36);
+  UT_ASSERT_EQUAL (mReceiveCalls, MNP_SYS_POLL_BUDGET);
+  UT_ASSERT_EQUAL (mDpcCalls, MNP_SYS_POLL_BUDGET);
+  UT_ASSERT_EQUAL (mDevice.PollCount, 1);
+  UT_ASSERT_EQUAL (mDevice.PollRxCount, MNP_SYS_POLL_BUDGET);
+  UT_ASSERT_EQUAL (mDevice.PollBudgetHitCount, 1);
+
+  //
+  // The last call to Receive() finds no packet.
+  //
+  MnpSystemPoll (NULL, &mDevice);
+  UT_ASSERT_EQUAL (mPending, 0);
+  UT_ASSERT_EQUAL (mReceiveCalls, MNP_SYS_POLL_BUDGET + 37);
+  UT_ASSERT_EQUAL (mDpcCalls, MNP_SYS_POLL_BUDGET + 37);
+  UT_ASSERT_EQUAL (mDevice.PollCount, 2);
+  UT_ASSERT_EQUAL (mDevice.PollRxCount, MNP_SYS_POLL_BUDGET + 36);
+  UT_ASSERT_EQUAL (mDevice.PollBudgetHitCount, 1);
+
+  //
+  // The timer stays at the base interval while there is traffic.
+  //
+  UT_ASSERT_EQUAL (mTimerSets, 0);
+  UT_ASSERT_EQUAL (mDevice.IdlePollCount, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The poll interval doubles after MNP_SYS_POLL_IDLE_THRESHOLD idle polls, up
+  to MNP_SYS_POLL_INTERVAL_MAX, and returns to MNP_SYS_POLL_INTERVAL at once
+  when a packet arrives.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IdleBackoff (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 1; Index <= MNP_SYS_POLL_IDLE_THRESHOLD; Index++) {
+    MnpSystemPoll (NULL, &mDevice);
+    UT_ASSERT_EQUAL (mDevice.IdlePollCount, Index);
+    UT_ASSERT_EQUAL (mTimerSets, 0);
+  }
+
+  MnpSystemPoll (NULL, &mDevice);
+  UT_ASSERT_EQUAL (mTimerSets, 1);
+  UT_ASSERT_EQUAL (mTimerInterval, MNP_SYS_POLL_INTERVAL * 2);
+  UT_ASSERT_EQUAL (mDevice.PollInterval, MNP_SYS_POLL_INTERVAL * 2);
+
+  MnpSystemPoll (NULL, &mDevice);
+  UT_ASSERT_EQUAL (mTimerSets, 2);
+  UT_ASSERT_EQUAL (mTimerInterval, MNP_SYS_POLL_INTERVAL_MAX);
+  UT_ASSERT_EQUAL (mDevice.PollInterval, MNP_SYS_POLL_INTERVAL_MAX);
+
+  //
+  // The timer is not set again once at the maximum interval.
+  //
+  MnpSystemPoll (NULL, &mDevice);
+  UT_ASSERT_EQUAL (mTimerSets, 2);
+  UT_ASSERT_EQUAL (mDevice.PollInterval, MNP_SYS_POLL_INTERVAL_MAX);
+
+  mPending = 1;
+  MnpSystemPoll (NULL, &mDevice);
+  UT_ASSERT_EQUAL (mTimerSets, 3);
+  UT_ASSERT_EQUAL (mTimerInterval, MNP_SYS_POLL_INTERVAL);
+  UT_ASSERT_EQUAL (mDevice.PollInterval, MNP_SYS_POLL_INTERVAL);
+  UT_ASSERT_EQUAL (mDevice.IdlePollCount, 0);
+
+  UT_ASSERT_EQUAL (mDevice.PollCount, MNP_SYS_POLL_IDLE_THRESHOLD + 4);
+  UT_ASSERT_EQUAL (mDevice.PollRxCount, 1);
+  UT_ASSERT_EQUAL (mDevice.PollBudgetHitCount, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A packet queued to a full instance receive queue drops the oldest packet
+  and counts it.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+QueueDrop (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MNP_INSTANCE_DATA  Instance;
+  MNP_RXDATA_WRAP    *OldWrap;
+  MNP_RXDATA_WRAP    *NewWrap;
+
+  ZeroMem (&Instance, sizeof (Instance));
+  Instance.Signature      = MNP_INSTANCE_DATA_SIGNATURE;
+  Instance.MnpServiceData = &mService;
+  InitializeListHead (&Instance.RcvdPacketQueue);
+
+  OldWrap = AllocateZeroPool (sizeof (MNP_RXDATA_WRAP));
+  NewWrap = AllocateZeroPool (sizeof (MNP_RXDATA_WRAP));
+  UT_ASSERT_NOT_NULL (OldWrap);
+  UT_ASSERT_NOT_NULL (NewWrap);
+
+  OldWrap->Instance = &Instance;
+  OldWrap->Nbuf     = NetbufAlloc (TEST_PACKET_SIZE);
+  NewWrap->Instance = &Instance;
+  NewWrap->Nbuf     = NetbufAlloc (TEST_PACKET_SIZE);
+  UT_ASSERT_NOT_NULL (OldWrap->Nbuf);
+  UT_ASSERT_NOT_NULL (NewWrap->Nbuf);
+
+  //
+  // Only the oldest packet of the full queue is needed.
+  //
+  InsertTailList (&Instance.RcvdPacketQueue, &OldWrap->WrapEntry);
+  Instance.RcvdPacketQueueSize = MNP_MAX_RCVD_PACKET_QUE_SIZE;
+
+  MnpQueueRcvdPacket (&Instance, NewWrap);
+  UT_ASSERT_EQUAL (mDevice.RxDropCount, 1);
+  UT_ASSERT_EQUAL (Instance.RcvdPacketQueueSize, MNP_MAX_RCVD_PACKET_QUE_SIZE);
+  UT_ASSERT_TRUE (Instance.RcvdPacketQueue.ForwardLink == &NewWrap->WrapEntry);
+  UT_ASSERT_TRUE (Instance.RcvdPacketQueue.BackLink == &NewWrap->WrapEntry);
+
+  RemoveEntryList (&NewWrap->WrapEntry);
+  NetbufFree (NewWrap->Nbuf);
+  FreePool (NewWrap);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the system
+  poll and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      PollTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the System Poll Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&PollTests, Framework, "MNP System Poll Tests", "MnpDxe.SystemPoll", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for MNP System Poll Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite--------Description-------------------------------------Name-----------Function-----Pre----------Post--------Context
+  //
+  AddTestCase (PollTests, "A poll stops at the budget", "PollBudget", PollBudget, StartDevice, StopDevice, NULL);
+  AddTestCase (PollTests, "The poll timer backs off while idle", "IdleBackoff", IdleBackoff, StartDevice, StopDevice, NULL);
+  AddTestCase (PollTests, "A full receive queue drops and counts", "QueueDrop", QueueDrop, StartDevice, StopDevice, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define MnpPollUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+MnpPollUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = UnitTestingEntry ();
+  return EFI_ERROR (Status) ? 1 : 0;
+}
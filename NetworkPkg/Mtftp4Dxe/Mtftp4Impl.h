@@ -126,6 +126,12 @@ struct _MTFTP4_PROTOCOL {
   //
   UINT64                    AckedBlock;
 
+  //
+  // Whether the ACK for the first block missing from the current window
+  // has been sent.
+  //
+  BOOLEAN                   GapAcked;
+
   //
   // The server's communication end point: IP and two ports. one for
   // initial request, one for its selected port.
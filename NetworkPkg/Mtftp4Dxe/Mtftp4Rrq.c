@@ -264,6 +264,18 @@ Mtftp4RrqHandleData (
   // expected one. If we are passive (Slave), save the block.
   //
   if (Instance->Master && (Expected != BlockNum)) {
+    //
+    // Every ACK makes the server resend the window from the acked block, so
+    // with windowsize only the first block missing from a window is acked.
+    // The rest of that window is dropped instead of having the server
+    // restart the window once for each of them.
+    //
+    if ((Instance->WindowSize > 1) && Instance->GapAcked) {
+      return EFI_SUCCESS;
+    }
+
+    Instance->GapAcked = TRUE;
+
     //
     // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
     //
@@ -280,6 +292,7 @@ Mtftp4RrqHandleData (
   // Record the total received and saved block number.
   //
   Instance->TotalBlock++;
+  Instance->GapAcked = FALSE;
 
   //
   // Reset the passive client's timer whenever it received a
@@ -86,6 +86,12 @@ struct _MTFTP6_INSTANCE {
   //
   UINT64                    AckedBlock;
 
+  //
+  // Whether the ACK for the first block missing from the current window
+  // has been sent.
+  //
+  BOOLEAN                   GapAcked;
+
   EFI_IPv6_ADDRESS          ServerIp;
   UINT16                    ServerCmdPort;
   UINT16                    ServerDataPort;
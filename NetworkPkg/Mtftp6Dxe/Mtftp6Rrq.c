@@ -234,6 +234,18 @@ Mtftp6RrqHandleData (
   // expected one. If we are passive (Slave), save the block.
   //
   if (Instance->IsMaster && (Expected != BlockNum)) {
+    //
+    // Every ACK makes the server resend the window from the acked block, so
+    // with windowsize only the first block missing from a window is acked.
+    // The rest of that window is dropped instead of having the server
+    // restart the window once for each of them.
+    //
+    if ((Instance->WindowSize > 1) && Instance->GapAcked) {
+      return EFI_SUCCESS;
+    }
+
+    Instance->GapAcked = TRUE;
+
     //
     // Free the received packet before send new packet in ReceiveNotify,
     // since the udpio might need to be reconfigured.
@@ -257,6 +269,7 @@ Mtftp6RrqHandleData (
   // Record the total received and saved block number.
   //
   Instance->TotalBlock++;
+  Instance->GapAcked = FALSE;
 
   //
   // Reset the passive client's timer whenever it received a valid data packet.
@@ -337,7 +350,7 @@ Mtftp6RrqOackValid (
   // return the timeout matches that requested.
   //
   if ((((ReplyInfo->BitMap & MTFTP6_OPT_BLKSIZE_BIT) != 0) && (ReplyInfo->BlkSize > RequestInfo->BlkSize)) ||
-      (((ReplyInfo->BitMap & MTFTP6_OPT_WINDOWSIZE_BIT) != 0) && (ReplyInfo->BlkSize > RequestInfo->BlkSize)) ||
+      (((ReplyInfo->BitMap & MTFTP6_OPT_WINDOWSIZE_BIT) != 0) && (ReplyInfo->WindowSize > RequestInfo->WindowSize)) ||
       (((ReplyInfo->BitMap & MTFTP6_OPT_TIMEOUT_BIT) != 0) && (ReplyInfo->Timeout != RequestInfo->Timeout))
       )
   {
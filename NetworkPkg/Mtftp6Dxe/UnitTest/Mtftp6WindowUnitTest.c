@@ -0,0 +1,744 @@
+/** @file
+  Host-based unit test of the windowed download of Mtftp6Dxe.
+
+  DATA packets are handed to Mtftp6RrqHandleData() of an active download
+  session, and the ACKs it sends are recorded by a fake UdpIoSendDatagram().
+  With windowsize, only the first block missing from a window is acked, the
+  later blocks of that window are dropped, and the next block received in
+  order allows a new gap ACK. In lock-step (windowsize 1) every unexpected
+  block is acked. Mtftp6RrqOackValid() is checked against the windowsize
+  the server is allowed to return.
+
+  The boot services table only provides the TPL and pool services used by
+  NetLib and Mtftp6TransmitPacket(), and the UDP6 protocol of the session is
+  a fake already connected to the data port of the server.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Library/UnitTestLib.h>
+
+#include "../Mtftp6Impl.h"
+
+#define UNIT_TEST_APP_NAME     "Mtftp6Dxe Window Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_BLOCK_SIZE  512
+#define TEST_BLOCKS      32
+#define TEST_MAX_ACKS    16
+#define TEST_DATA_PORT   4096
+
+MTFTP6_INSTANCE    mInstance;
+EFI_MTFTP6_TOKEN   mToken;
+UDP_IO             mUdpIo;
+EFI_UDP6_PROTOCOL  mUdp6;
+UINT8              mFile[TEST_BLOCKS * TEST_BLOCK_SIZE];
+UINT16             mAcks[TEST_MAX_ACKS];
+UINTN              mAckNumber;
+EFI_BOOT_SERVICES  mBootServices;
+
+/**
+  Process the received data packet, defined in Mtftp6Rrq.c.
+
+  @param[in]  Instance              The pointer to the Mtftp6 instance.
+  @param[in]  Packet                The pointer to the received packet.
+  @param[in]  Len                   The length of the packet.
+  @param[out] UdpPacket             The net buf of received packet.
+  @param[out] IsCompleted           If TRUE, the download has been completed.
+                                    Otherwise, the download has not been completed.
+
+  @retval EFI_SUCCESS           The data packet was successfully processed.
+  @retval EFI_ABORTED           The download was aborted by the user.
+  @retval EFI_BUFFER_TOO_SMALL  The user-provided buffer is too small.
+
+**/
+EFI_STATUS
+Mtftp6RrqHandleData (
+  IN  MTFTP6_INSTANCE    *Instance,
+  IN  EFI_MTFTP6_PACKET  *Packet,
+  IN  UINT32             Len,
+  OUT NET_BUF            **UdpPacket,
+  OUT BOOLEAN            *IsCompleted
+  );
+
+/**
+  Validate the options of the OACK packet, defined in Mtftp6Rrq.c.
+
+  @param[in]  Instance              The pointer to the Mtftp6 instance.
+  @param[in]  ReplyInfo             The pointer to options information in reply packet.
+  @param[in]  RequestInfo           The pointer to requested options info.
+
+  @retval     TRUE                  If the option in the OACK is valid.
+  @retval     FALSE                 If the option is invalid.
+
+**/
+BOOLEAN
+Mtftp6RrqOackValid (
+  IN MTFTP6_INSTANCE         *Instance,
+  IN MTFTP6_EXT_OPTION_INFO  *ReplyInfo,
+  IN MTFTP6_EXT_OPTION_INFO  *RequestInfo
+  );
+
+/**
+  Fake RaiseTPL(), the tests run at a single TPL.
+
+  @param[in]  NewTpl       Unused.
+
+  @return TPL_APPLICATION.
+
+**/
+EFI_TPL
+EFIAPI
+FakeRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  return TPL_APPLICATION;
+}
+
+/**
+  Fake RestoreTPL(), the tests run at a single TPL.
+
+  @param[in]  OldTpl       Unused.
+
+**/
+VOID
+EFIAPI
+FakeRestoreTpl (
+  IN EFI_TPL  OldTpl
+  )
+{
+}
+
+/**
+  Fake FreePool(), NetLib allocates its buffers from MemoryAllocationLib.
+
+  @param[in]  Buffer       The buffer to free.
+
+  @return EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+/**
+  Fake EFI_UDP6_PROTOCOL.GetModeData(), the instance is connected to the data
+  port of the server.
+
+  @param[in]   This            Unused.
+  @param[out]  Udp6ConfigData  The configuration data of the instance.
+  @param[out]  Ip6ModeData     Unused.
+  @param[out]  MnpConfigData   Unused.
+  @param[out]  SnpModeData     Unused.
+
+  @retval EFI_SUCCESS      Always.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeUdp6GetModeData (
+  IN  EFI_UDP6_PROTOCOL                *This,
+  OUT EFI_UDP6_CONFIG_DATA             *Udp6ConfigData OPTIONAL,
+  OUT EFI_IP6_MODE_DATA                *Ip6ModeData    OPTIONAL,
+  OUT EFI_MANAGED_NETWORK_CONFIG_DATA  *MnpConfigData  OPTIONAL,
+  OUT EFI_SIMPLE_NETWORK_MODE          *SnpModeData    OPTIONAL
+  )
+{
+  if (Udp6ConfigData != NULL) {
+    ZeroMem (Udp6ConfigData, sizeof (EFI_UDP6_CONFIG_DATA));
+    Udp6ConfigData->RemotePort = TEST_DATA_PORT;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Fake EFI_UDP6_PROTOCOL.Poll(), the packets are sent at once.
+
+  @param[in]  This         Unused.
+
+  @retval EFI_SUCCESS      Always.
+
+**/
+EFI_STATUS
+EFIAPI
+FakeUdp6Poll (
+  IN EFI_UDP6_PROTOCOL  *This
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Fake UdpIoSendDatagram(), records the block number of the ACKs and
+  completes the transmission at once.
+
+  @param[in]  UdpIo        Unused.
+  @param[in]  Packet       The packet to send.
+  @param[in]  EndPoint     The remote end point.
+  @param[in]  Gateway      Unused.
+  @param[in]  CallBack     The function called when the packet is sent.
+  @param[in]  Context      The context of CallBack.
+
+  @retval EFI_SUCCESS      The packet is sent.
+
+**/
+EFI_STATUS
+EFIAPI
+UdpIoSendDatagram (
+  IN  UDP_IO           *UdpIo,
+  IN  NET_BUF          *Packet,
+  IN  UDP_END_POINT    *EndPoint OPTIONAL,
+  IN  EFI_IP_ADDRESS   *Gateway  OPTIONAL,
+  IN  UDP_IO_CALLBACK  CallBack,
+  IN  VOID             *Context
+  )
+{
+  EFI_MTFTP6_PACKET  *Mtftp6Packet;
+
+  Mtftp6Packet = (EFI_MTFTP6_PACKET *)NetbufGetByte (Packet, 0, NULL);
+  if (NTOHS (Mtftp6Packet->OpCode) == EFI_MTFTP6_OPCODE_ACK) {
+    ASSERT (mAckNumber < TEST_MAX_ACKS);
+    mAcks[mAckNumber++] = NTOHS (Mtftp6Packet->Ack.Block[0]);
+  }
+
+  CallBack (Packet, EndPoint, EFI_SUCCESS, Context);
+  return EFI_SUCCESS;
+}
+
+/**
+  Fake UdpIoRecvDatagram(), the test hands the packets to the session.
+
+  @retval EFI_SUCCESS      Always.
+
+**/
+EFI_STATUS
+EFIAPI
+UdpIoRecvDatagram (
+  IN  UDP_IO           *UdpIo,
+  IN  UDP_IO_CALLBACK  CallBack,
+  IN  VOID             *Context,
+  IN  UINT32           HeadLen
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Fake UdpIoCreateIo(), multicast downloads are not tested.
+
+  @return NULL.
+
+**/
+UDP_IO *
+EFIAPI
+UdpIoCreateIo (
+  IN  EFI_HANDLE     Controller,
+  IN  EFI_HANDLE     ImageHandle,
+  IN  UDP_IO_CONFIG  Configure,
+  IN  UINT8          UdpVersion,
+  IN  VOID           *Context
+  )
+{
+  return NULL;
+}
+
+/**
+  Fake UdpIoFreeIo().
+
+  @retval EFI_SUCCESS      Always.
+
+**/
+EFI_STATUS
+EFIAPI
+UdpIoFreeIo (
+  IN  UDP_IO  *UdpIo
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Fake UdpIoCleanIo().
+
+**/
+VOID
+EFIAPI
+UdpIoCleanIo (
+  IN  UDP_IO  *UdpIo
+  )
+{
+}
+
+/**
+  Fake Mtftp6WrqStart(), uploads are not tested.
+
+  @param[in]  Instance     Unused.
+  @param[in]  Operation    Unused.
+
+  @retval EFI_UNSUPPORTED  Always.
+
+**/
+EFI_STATUS
+Mtftp6WrqStart (
+  IN MTFTP6_INSTANCE  *Instance,
+  IN UINT16           Operation
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Start an active download session with the window size given by the
+  context.
+
+  @param[in]  Context  The window size.
+
+  @retval  UNIT_TEST_PASSED             The session is started.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The block list could not be created.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+StartSession (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mBootServices.RaiseTPL   = FakeRaiseTpl;
+  mBootServices.RestoreTPL = FakeRestoreTpl;
+  mBootServices.FreePool   = FakeFreePool;
+  gBS                      = &mBootServices;
+
+  ZeroMem (&mUdp6, sizeof (mUdp6));
+  mUdp6.GetModeData = FakeUdp6GetModeData;
+  mUdp6.Poll        = FakeUdp6Poll;
+
+  ZeroMem (&mUdpIo, sizeof (mUdpIo));
+  mUdpIo.Protocol.Udp6 = &mUdp6;
+
+  ZeroMem (&mInstance, sizeof (mInstance));
+  ZeroMem (&mToken, sizeof (mToken));
+  ZeroMem (mFile, sizeof (mFile));
+  mAckNumber = 0;
+
+  mToken.Buffer     = mFile;
+  mToken.BufferSize = sizeof (mFile);
+
+  mInstance.Token          = &mToken;
+  mInstance.UdpIo          = &mUdpIo;
+  mInstance.ServerDataPort = TEST_DATA_PORT;
+  mInstance.BlkSize        = TEST_BLOCK_SIZE;
+  mInstance.WindowSize     = (UINT16)(UINTN)Context;
+  mInstance.IsMaster       = TRUE;
+  InitializeListHead (&mInstance.BlkList);
+
+  UT_ASSERT_NOT_EFI_ERROR (Mtftp6InitBlockRange (&mInstance.BlkList, 1, 0xffff));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the block list and the last packet of the session.
+
+  @param[in]  Context  Unused.
+
+**/
+VOID
+EFIAPI
+StopSession (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  LIST_ENTRY  *Entry;
+
+  while (!IsListEmpty (&mInstance.BlkList)) {
+    Entry = mInstance.BlkList.ForwardLink;
+    RemoveEntryList (Entry);
+    FreePool (NET_LIST_USER_STRUCT (Entry, MTFTP6_BLOCK_RANGE, Link));
+  }
+
+  if (mInstance.LastPacket != NULL) {
+    NetbufFree (mInstance.LastPacket);
+    mInstance.LastPacket = NULL;
+  }
+}
+
+/**
+  Receive a full DATA block, filled with its block number.
+
+  The packet is received in a net buffer which, like in Mtftp6RrqInput(), is
+  freed after Mtftp6RrqHandleData() unless it already did.
+
+  @param[in]  Block    The block number.
+
+  @return The status of Mtftp6RrqHandleData().
+
+**/
+EFI_STATUS
+ReceiveBlock (
+  IN UINT16  Block
+  )
+{
+  NET_BUF            *UdpPacket;
+  EFI_MTFTP6_PACKET  *Packet;
+  EFI_STATUS         Status;
+  BOOLEAN            Completed;
+
+  UdpPacket = NetbufAlloc (MTFTP6_DATA_HEAD_LEN + TEST_BLOCK_SIZE);
+  if (UdpPacket == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Packet = (EFI_MTFTP6_PACKET *)NetbufAllocSpace (UdpPacket, MTFTP6_DATA_HEAD_LEN + TEST_BLOCK_SIZE, FALSE);
+  ASSERT (Packet != NULL);
+
+  Packet->Data.OpCode = HTONS (EFI_MTFTP6_OPCODE_DATA);
+  Packet->Data.Block  = HTONS (Block);
+  SetMem (Packet->Data.Data, TEST_BLOCK_SIZE, (UINT8)Block);
+
+  Status = Mtftp6RrqHandleData (&mInstance, Packet, MTFTP6_DATA_HEAD_LEN + TEST_BLOCK_SIZE, &UdpPacket, &Completed);
+
+  if (UdpPacket != NULL) {
+    NetbufFree (UdpPacket);
+  }
+
+  return Status;
+}
+
+/**
+  Receive DATA blocks in turn.
+
+  @param[in]  Blocks   The block numbers.
+  @param[in]  Number   The number of blocks.
+
+  @retval TRUE   All the blocks are handled.
+  @retval FALSE  Mtftp6RrqHandleData() failed.
+
+**/
+BOOLEAN
+ReceiveBlocks (
+  IN CONST UINT16  *Blocks,
+  IN UINTN         Number
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Number; Index++) {
+    if (EFI_ERROR (ReceiveBlock (Blocks[Index]))) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Check the ACKs sent against the expected ones.
+
+  @param[in]  Expected     The block numbers of the expected ACKs.
+  @param[in]  Number       The number of expected ACKs.
+
+  @retval TRUE   The ACKs are the expected ones.
+  @retval FALSE  The ACKs are different.
+
+**/
+BOOLEAN
+AcksEqual (
+  IN CONST UINT16  *Expected,
+  IN UINTN         Number
+  )
+{
+  UINTN  Index;
+
+  if (mAckNumber != Number) {
+    DEBUG ((DEBUG_ERROR, "%d ACKs, %d expected\n", mAckNumber, Number));
+    return FALSE;
+  }
+
+  for (Index = 0; Index < Number; Index++) {
+    if (mAcks[Index] != Expected[Index]) {
+      DEBUG ((DEBUG_ERROR, "ACK %d is %d, %d expected\n", Index, mAcks[Index], Expected[Index]));
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  A full window is acked once. The first block missing from the next window
+  is acked, and the blocks after it in that window are dropped.
+
+  @param[in]  Context  The window size, 4.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+GapAckOncePerWindow (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT16  Window[] = { 1, 2, 3, 4 };
+  STATIC CONST UINT16  Lost[]   = { 6, 7, 8 };
+  STATIC CONST UINT16  Acks[]   = { 4, 4 };
+
+  UT_ASSERT_TRUE (ReceiveBlocks (Window, ARRAY_SIZE (Window)));
+  UT_ASSERT_TRUE (AcksEqual (Acks, 1));
+
+  //
+  // Block 5 is lost.
+  //
+  UT_ASSERT_TRUE (ReceiveBlocks (Lost, ARRAY_SIZE (Lost)));
+  UT_ASSERT_TRUE (AcksEqual (Acks, 2));
+  UT_ASSERT_TRUE (mInstance.GapAcked);
+
+  //
+  // The blocks after the gap are not saved.
+  //
+  UT_ASSERT_EQUAL (Mtftp6GetNextBlockNum (&mInstance.BlkList), 5);
+  UT_ASSERT_EQUAL (mInstance.TotalBlock, 4);
+  UT_ASSERT_EQUAL (mFile[5 * TEST_BLOCK_SIZE], 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The next block received in order allows a new gap ACK, and the window
+  restarted by the gap ACK is acked once it is complete.
+
+  @param[in]  Context  The window size, 4.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+GapAckedReset (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT16  Window1[] = { 1, 2, 3, 4, 6 };
+  STATIC CONST UINT16  Window2[] = { 5, 7, 8 };
+  STATIC CONST UINT16  Window3[] = { 6, 7, 8, 9 };
+  STATIC CONST UINT16  Acks[]    = { 4, 4, 5, 9 };
+
+  UT_ASSERT_TRUE (ReceiveBlocks (Window1, ARRAY_SIZE (Window1)));
+  UT_ASSERT_TRUE (AcksEqual (Acks, 2));
+
+  //
+  // The server resends from block 5, and block 6 is lost this time.
+  //
+  UT_ASSERT_TRUE (ReceiveBlocks (Window2, 1));
+  UT_ASSERT_FALSE (mInstance.GapAcked);
+  UT_ASSERT_TRUE (ReceiveBlocks (Window2 + 1, ARRAY_SIZE (Window2) - 1));
+  UT_ASSERT_TRUE (AcksEqual (Acks, 3));
+
+  UT_ASSERT_TRUE (ReceiveBlocks (Window3, ARRAY_SIZE (Window3)));
+  UT_ASSERT_TRUE (AcksEqual (Acks, 4));
+  UT_ASSERT_FALSE (mInstance.GapAcked);
+  UT_ASSERT_EQUAL (mFile[8 * TEST_BLOCK_SIZE], 9);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  In lock-step, every block is acked, and so is every duplicate or
+  unexpected block.
+
+  @param[in]  Context  The window size, 1.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LockStepDuplicates (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT16  Blocks[] = { 1, 1, 1, 3, 3, 2 };
+  STATIC CONST UINT16  Acks[]   = { 1, 1, 1, 1, 1, 2 };
+
+  UT_ASSERT_TRUE (ReceiveBlocks (Blocks, ARRAY_SIZE (Blocks)));
+  UT_ASSERT_TRUE (AcksEqual (Acks, ARRAY_SIZE (Acks)));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The server may only lower the block size and the window size it was asked
+  for, must keep the timeout, and must not return options not requested.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+OackWindowSize (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MTFTP6_EXT_OPTION_INFO  Request;
+  MTFTP6_EXT_OPTION_INFO  Reply;
+
+  ZeroMem (&mInstance, sizeof (mInstance));
+
+  ZeroMem (&Request, sizeof (Request));
+  Request.BitMap     = MTFTP6_OPT_BLKSIZE_BIT | MTFTP6_OPT_WINDOWSIZE_BIT;
+  Request.BlkSize    = 1428;
+  Request.WindowSize = 4;
+
+  //
+  // A smaller window.
+  //
+  CopyMem (&Reply, &Request, sizeof (Reply));
+  Reply.WindowSize = 2;
+  UT_ASSERT_TRUE (Mtftp6RrqOackValid (&mInstance, &Reply, &Request));
+
+  //
+  // A larger window, even with a smaller block size.
+  //
+  CopyMem (&Reply, &Request, sizeof (Reply));
+  Reply.BlkSize    = 512;
+  Reply.WindowSize = 8;
+  UT_ASSERT_FALSE (Mtftp6RrqOackValid (&mInstance, &Reply, &Request));
+
+  //
+  // A larger block size.
+  //
+  CopyMem (&Reply, &Request, sizeof (Reply));
+  Reply.BlkSize = 2048;
+  UT_ASSERT_FALSE (Mtftp6RrqOackValid (&mInstance, &Reply, &Request));
+
+  //
+  // A different timeout.
+  //
+  Request.BitMap |= MTFTP6_OPT_TIMEOUT_BIT;
+  Request.Timeout = 5;
+  CopyMem (&Reply, &Request, sizeof (Reply));
+  UT_ASSERT_TRUE (Mtftp6RrqOackValid (&mInstance, &Reply, &Request));
+  Reply.Timeout = 3;
+  UT_ASSERT_FALSE (Mtftp6RrqOackValid (&mInstance, &Reply, &Request));
+
+  //
+  // An option not requested.
+  //
+  Request.BitMap = MTFTP6_OPT_BLKSIZE_BIT;
+  CopyMem (&Reply, &Request, sizeof (Reply));
+  Reply.BitMap    |= MTFTP6_OPT_WINDOWSIZE_BIT;
+  Reply.WindowSize = 1;
+  UT_ASSERT_FALSE (Mtftp6RrqOackValid (&mInstance, &Reply, &Request));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  windowed download and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      WindowTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the Window Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&WindowTests, Framework, "MTFTP6 Window Tests", "Mtftp6Dxe.Window", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for MTFTP6 Window Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite----------Description-------------------------------Name------------Function-------------Pre-----------Post---------Context
+  //
+  AddTestCase (WindowTests, "One gap ACK per window", "GapAck", GapAckOncePerWindow, StartSession, StopSession, (UNIT_TEST_CONTEXT)4);
+  AddTestCase (WindowTests, "Block in order resets the gap ACK", "GapReset", GapAckedReset, StartSession, StopSession, (UNIT_TEST_CONTEXT)4);
+  AddTestCase (WindowTests, "Lock-step acks every duplicate", "LockStep", LockStepDuplicates, StartSession, StopSession, (UNIT_TEST_CONTEXT)1);
+  AddTestCase (WindowTests, "OACK window size is validated", "OackWindowSize", OackWindowSize, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Mtftp6WindowUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Mtftp6WindowUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = UnitTestingEntry ();
+  return EFI_ERROR (Status) ? 1 : 0;
+}
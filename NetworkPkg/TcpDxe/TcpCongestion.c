@@ -0,0 +1,252 @@
+/** @file
+  Congestion control algorithms of TCP.
+
+  NewReno grows the congestion window by one segment per RTT in
+  congestion avoidance. CUBIC grows it as a cubic function of the time
+  since the last window reduction, so that the window of a connection
+  with a large bandwidth-delay product recovers in a few seconds
+  instead of thousands of RTTs.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+//
+// CUBIC parameters as recommended in RFC9438. The window reduction
+// factor beta_cubic is 0.7, and C is 0.4 segment per second cubed.
+// The growth of the cubic function in bytes is t^3 * SndMss / SCALE,
+// with the time t in ms.
+//
+#define TCP_CUBIC_BETA_NUM   7
+#define TCP_CUBIC_BETA_DEN   10
+#define TCP_CUBIC_SCALE      2500000000U
+#define TCP_CUBIC_MAX_TIME   30000
+#define TCP_TICK_TO_MS(Tick)  ((Tick) * (1000 / TCP_TICK_HZ))
+
+/**
+  Compute the slow start threshold of NewReno as specified in RFC5681.
+
+  @param[in, out]  Tcb         Pointer to the TCP_CB of this TCP instance.
+  @param[in]       FlightSize  The amount of data outstanding in the network.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpNewRenoSsthresh (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  FlightSize
+  )
+{
+  return MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+}
+
+/**
+  Grow the congestion window of NewReno by about one segment per RTT.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpNewRenoCongAvoid (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+}
+
+/**
+  Compute the integer cube root of a value.
+
+  @param[in]  Value       The value to compute the cube root of.
+
+  @return The largest integer whose cube is no more than Value.
+
+**/
+UINT32
+TcpCubicRoot (
+  IN UINT64  Value
+  )
+{
+  UINT32  Root;
+  UINT32  Bit;
+
+  //
+  // The cube of a 21-bit number fits in 63 bits.
+  //
+  Root = 0;
+  for (Bit = BIT20; Bit != 0; Bit >>= 1) {
+    Root |= Bit;
+
+    if (MultU64x32 (MultU64x32 (Root, Root), Root) > Value) {
+      Root &= ~Bit;
+    }
+  }
+
+  return Root;
+}
+
+/**
+  Compute the slow start threshold of CUBIC as specified in RFC9438,
+  and remember the window where the loss happened.
+
+  @param[in, out]  Tcb         Pointer to the TCP_CB of this TCP instance.
+  @param[in]       FlightSize  The amount of data outstanding in the network.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpCubicSsthresh (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  FlightSize
+  )
+{
+  TCP_CUBIC  *Cubic;
+
+  Cubic = &Tcb->Cubic;
+
+  //
+  // Fast convergence: if the window didn't reach the last WMax, another
+  // flow is likely taking the bandwidth, release some more of it.
+  //
+  if (Tcb->CWnd < Cubic->WMax) {
+    Cubic->WMax = (UINT32)DivU64x32 (
+                            MultU64x32 (Tcb->CWnd, TCP_CUBIC_BETA_DEN + TCP_CUBIC_BETA_NUM),
+                            2 * TCP_CUBIC_BETA_DEN
+                            );
+  } else {
+    Cubic->WMax = Tcb->CWnd;
+  }
+
+  Cubic->EpochOn = FALSE;
+
+  return MAX (
+           (UINT32)DivU64x32 (MultU64x32 (FlightSize, TCP_CUBIC_BETA_NUM), TCP_CUBIC_BETA_DEN),
+           (UINT32)(2 * Tcb->SndMss)
+           );
+}
+
+/**
+  Grow the congestion window of CUBIC as specified in RFC9438. The
+  window follows the cubic function of the time since the epoch started,
+  but never grows slower than Reno would in the same time.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCubicCongAvoid (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  TCP_CUBIC  *Cubic;
+  UINT32     Time;
+  UINT32     Delta;
+  UINT64     Offset;
+  UINT64     Target;
+
+  Cubic = &Tcb->Cubic;
+
+  if (!Cubic->EpochOn) {
+    Cubic->EpochOn    = TRUE;
+    Cubic->EpochStart = mTcpTick;
+    Cubic->WEst       = Tcb->CWnd;
+
+    if (Tcb->CWnd < Cubic->WMax) {
+      Cubic->K = TcpCubicRoot (
+                   DivU64x32 (
+                     MultU64x32 (Cubic->WMax - Tcb->CWnd, TCP_CUBIC_SCALE),
+                     Tcb->SndMss
+                     )
+                   );
+      Cubic->Origin = Cubic->WMax;
+    } else {
+      Cubic->K      = 0;
+      Cubic->Origin = Tcb->CWnd;
+    }
+  }
+
+  //
+  // The target is the value of the cubic function one RTT later.
+  //
+  Time = TCP_TICK_TO_MS (mTcpTick - Cubic->EpochStart) +
+         TCP_TICK_TO_MS (Tcb->SRtt >> TCP_RTT_SHIFT);
+
+  if (Time >= Cubic->K) {
+    Delta  = MIN (Time - Cubic->K, TCP_CUBIC_MAX_TIME);
+    Offset = DivU64x32 (
+               MultU64x32 (MultU64x32 (MultU64x32 (Delta, Delta), Delta), Tcb->SndMss),
+               TCP_CUBIC_SCALE
+               );
+    Target = Cubic->Origin + Offset;
+  } else {
+    Delta  = MIN (Cubic->K - Time, TCP_CUBIC_MAX_TIME);
+    Offset = DivU64x32 (
+               MultU64x32 (MultU64x32 (MultU64x32 (Delta, Delta), Delta), Tcb->SndMss),
+               TCP_CUBIC_SCALE
+               );
+    Target = (Offset < Cubic->Origin) ? Cubic->Origin - Offset : 0;
+  }
+
+  //
+  // The Reno-friendly estimate grows by alpha segment per RTT, with
+  // alpha = 3 * (1 - beta) / (1 + beta) until it reaches WMax, 1 after.
+  //
+  if (Cubic->WEst < Cubic->WMax) {
+    Cubic->WEst += MAX ((Tcb->SndMss * 9 / 17) * Tcb->SndMss / Tcb->CWnd, 1);
+  } else {
+    Cubic->WEst += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+  }
+
+  if (Target < Cubic->WEst) {
+    Target = Cubic->WEst;
+  }
+
+  //
+  // Don't grow by more than half of the window in one RTT.
+  //
+  if (Target > Tcb->CWnd + (Tcb->CWnd >> 1)) {
+    Target = Tcb->CWnd + (Tcb->CWnd >> 1);
+  }
+
+  if (Target > Tcb->CWnd) {
+    Tcb->CWnd += MAX (
+                   (UINT32)DivU64x32 (MultU64x32 (Target - Tcb->CWnd, Tcb->SndMss), Tcb->CWnd),
+                   1
+                   );
+  }
+}
+
+TCP_CONGESTION_OPS  mTcpNewReno = {
+  TcpNewRenoSsthresh,
+  TcpNewRenoCongAvoid
+};
+
+TCP_CONGESTION_OPS  mTcpCubic = {
+  TcpCubicSsthresh,
+  TcpCubicCongAvoid
+};
+
+/**
+  Select the congestion control algorithm of the TCP instance, and
+  reset the state of the algorithm.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCongestInit (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  if (PcdGet8 (PcdTcpCongestionControl) == TCP_CONGEST_CTRL_CUBIC) {
+    Tcb->CongestOps = &mTcpCubic;
+  } else {
+    Tcb->CongestOps = &mTcpNewReno;
+  }
+
+  ZeroMem (&Tcb->Cubic, sizeof (TCP_CUBIC));
+}
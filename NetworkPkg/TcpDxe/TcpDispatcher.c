@@ -118,7 +118,7 @@ Tcp4GetMode (
       Option->EnableTimeStamp     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -195,7 +195,7 @@ Tcp6GetMode (
       Option->EnableTimeStamp     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -561,6 +561,7 @@ TcpConfigurePcb (
 
   Tcb->CWnd     = Tcb->SndMss;
   Tcb->Ssthresh = 0xffffffff;
+  TcpCongestInit (Tcb);
 
   Tcb->CongestState = TCP_CONGEST_OPEN;
 
@@ -703,6 +704,10 @@ TcpConfigurePcb (
     if (!Option->EnableWindowScaling) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_WS);
     }
+
+    if (!Option->EnableSelectiveAck) {
+      TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+    }
   }
 
   //
@@ -27,6 +27,61 @@ VOID
   IN OUT TCP_CB  *Tcb
   );
 
+/**
+  Compute the slow start threshold after a loss is detected, and
+  save the state the algorithm needs to regrow the window.
+
+  @param[in, out]  Tcb         Pointer to the TCP_CB of this TCP instance.
+  @param[in]       FlightSize  The amount of data outstanding in the network.
+
+  @return The new slow start threshold.
+
+**/
+typedef
+UINT32
+(*TCP_CONGEST_SSTHRESH) (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  FlightSize
+  );
+
+/**
+  Grow the congestion window for an ACK of new data received in
+  congestion avoidance, that is when CWnd is at least Ssthresh.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+typedef
+VOID
+(*TCP_CONGEST_AVOID) (
+  IN OUT TCP_CB  *Tcb
+  );
+
+///
+/// A congestion control algorithm. Slow start, fast retransmit
+/// and fast recovery are common to all the algorithms.
+///
+struct _TCP_CONGESTION_OPS {
+  TCP_CONGEST_SSTHRESH    Ssthresh;
+  TCP_CONGEST_AVOID       CongAvoid;
+};
+
+//
+// Functions in TcpCongestion.c
+//
+
+/**
+  Select the congestion control algorithm of the TCP instance, and
+  reset the state of the algorithm.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCongestInit (
+  IN OUT TCP_CB  *Tcb
+  );
+
 //
 // Functions in TcpMisc.c
 //
@@ -498,6 +553,61 @@ TcpInput (
   IN UINT8           Version
   );
 
+//
+// Functions in TcpSack.c
+//
+
+/**
+  Update the scoreboard of the data SACKed by the peer, as specified in
+  RFC2018 and RFC6675. The data acknowledged cumulatively is removed, and
+  the blocks of the SACK option are merged into the scoreboard. The blocks
+  that don't fit are ignored, their data is retransmitted if necessary.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge sequence number of the segment.
+  @param[in]       Option   Pointer to the options of the segment.
+
+**/
+VOID
+TcpSackUpdateSnd (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEQNO   Ack,
+  IN     TCP_OPTION  *Option
+  );
+
+/**
+  Retransmit the first hole in the sequence space as specified in RFC6675.
+  A hole is the data below the highest SACKed sequence that is neither
+  SACKed by the peer nor retransmitted in the current recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The sequence number acknowledged cumulatively.
+
+  @retval TRUE     A hole is retransmitted.
+  @retval FALSE    No hole is left, or the retransmission failed.
+
+**/
+BOOLEAN
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Ack
+  );
+
+/**
+  Update the SACK blocks reported to the peer after an out-of-order
+  segment is queued, as specified in RFC2018. The block that holds the
+  segment is reported first, followed by the most recently reported ones.
+
+  @param[in, out]  Tcb   Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Nbuf  Pointer to the segment queued on the RcvQue.
+
+**/
+VOID
+TcpSackUpdateRcv (
+  IN OUT TCP_CB   *Tcb,
+  IN     NET_BUF  *Nbuf
+  );
+
 //
 // Functions in TcpTimer.c
 //
@@ -32,6 +32,10 @@ TcpSeqAcceptable (
 /**
   NewReno fast recovery defined in RFC3782.
 
+  If the peer reports SACK blocks, the holes in the sequence space
+  are retransmitted as specified in RFC6675, instead of one segment
+  per partial ACK.
+
   @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
   @param[in]       Seg      Segment that triggers the fast recovery.
 
@@ -54,7 +58,7 @@ TcpFastRecover (
     //
     FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
 
-    Tcb->Ssthresh = MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+    Tcb->Ssthresh = Tcb->CongestOps->Ssthresh (Tcb, FlightSize);
     Tcb->Recover  = Tcb->SndNxt;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
@@ -63,7 +67,11 @@ TcpFastRecover (
     //
     // Step 2: Entering fast retransmission
     //
-    TcpRetransmit (Tcb, Tcb->SndUna);
+    Tcb->SackRxmtNxt = Tcb->SndUna;
+    if (!TcpSackRetransmit (Tcb, Tcb->SndUna)) {
+      TcpRetransmit (Tcb, Tcb->SndUna);
+    }
+
     Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
 
     DEBUG (
@@ -87,7 +95,13 @@ TcpFastRecover (
     // Step 4 is skipped here only to be executed later
     // by TcpToSendData
     //
-    Tcb->CWnd += Tcb->SndMss;
+    // A segment has left the network. Use it to retransmit
+    // the next hole if there is one, or to send new data.
+    //
+    if (!TcpSackRetransmit (Tcb, Tcb->SndUna)) {
+      Tcb->CWnd += Tcb->SndMss;
+    }
+
     DEBUG (
       (DEBUG_NET,
        "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -119,9 +133,13 @@ TcpFastRecover (
       //
       // Step 5 - Partial ACK:
       // fast retransmit the first unacknowledge field
-      // , then deflate the CWnd
+      // , then deflate the CWnd. With SACK, it may
+      // have been retransmitted already.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (!TcpSackRetransmit (Tcb, Seg->Ack) && TCP_SEQ_LEQ (Tcb->SackRxmtNxt, Seg->Ack)) {
+        TcpRetransmit (Tcb, Seg->Ack);
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -179,9 +197,13 @@ TcpFastLossRecover (
     } else {
       //
       // Partial ACK:
-      // fast retransmit the first unacknowledge field.
+      // fast retransmit the first unacknowledge field,
+      // or the first hole reported by SACK.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (!TcpSackRetransmit (Tcb, Seg->Ack) && TCP_SEQ_LEQ (Tcb->SackRxmtNxt, Seg->Ack)) {
+        TcpRetransmit (Tcb, Seg->Ack);
+      }
+
       DEBUG (
         (DEBUG_NET,
          "TcpFastLossRecover: received a partial ACK(%d) for TCB %p\n",
@@ -376,6 +398,8 @@ TcpDeliverData (
   TCP_SEQNO   Seq;
   TCP_SEG     *Seg;
   UINT32      Urgent;
+  UINT8       Index;
+  UINT8       Num;
 
   ASSERT ((Tcb != NULL) && (Tcb->Sk != NULL));
 
@@ -531,6 +555,20 @@ TcpDeliverData (
     NetbufFree (Nbuf);
   }
 
+  //
+  // Drop the SACK blocks of the data now delivered in sequence.
+  //
+  Num = 0;
+  for (Index = 0; Index < Tcb->RcvSackNum; Index++) {
+    if (TCP_SEQ_GT (Tcb->RcvSack[Index].Right, Tcb->RcvNxt)) {
+      Tcb->RcvSack[Num].Left  = Tcb->RcvSack[Index].Left;
+      Tcb->RcvSack[Num].Right = Tcb->RcvSack[Index].Right;
+      Num++;
+    }
+  }
+
+  Tcb->RcvSackNum = Num;
+
   return 0;
 }
 
@@ -569,6 +607,11 @@ TcpQueueData (
   //
   if (IsListEmpty (Head)) {
     InsertTailList (Head, &Nbuf->List);
+
+    if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) && TCP_SEQ_GT (Seg->Seq, Tcb->RcvNxt)) {
+      TcpSackUpdateRcv (Tcb, Nbuf);
+    }
+
     return 1;
   }
 
@@ -639,6 +682,10 @@ TcpQueueData (
     Cur = Cur->ForwardLink;
   }
 
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) && TCP_SEQ_GT (Seg->Seq, Tcb->RcvNxt)) {
+    TcpSackUpdateRcv (Tcb, Nbuf);
+  }
+
   return 1;
 }
 
@@ -1020,6 +1067,30 @@ TcpInput (
     Tcb->ProbeTimerOn = FALSE;
   }
 
+  //
+  // PAWS as specified in section 5.3 RFC7323: the segment with a
+  // timestamp older than TsRecent is a duplicate, unless TsRecent
+  // is too old to be compared with.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_TS) &&
+      TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_TS) &&
+      !TCP_FLG_ON (Seg->Flag, TCP_FLG_RST) &&
+      TCP_TIME_LT (Option.TSVal, Tcb->TsRecent))
+  {
+    if (TCP_SUB_TIME (mTcpTick, Tcb->TsRecentAge) > TCP_PAWS_24DAY) {
+      Tcb->TsRecent = Option.TSVal;
+    } else {
+      DEBUG (
+        (DEBUG_WARN,
+         "TcpInput: PAWS test failed for segment of TCB %p\n",
+         Tcb)
+        );
+
+      TcpSendAck (Tcb);
+      goto DISCARD;
+    }
+  }
+
   //
   // First step: Check whether SEG.SEQ is acceptable
   //
@@ -1177,25 +1248,50 @@ TcpInput (
   //
   if (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_TS)) {
     //
-    // update TsRecent as specified in page 16 RFC1323.
-    // RcvWl2 equals to the variable "LastAckSent"
+    // update TsRecent as specified in section 4.3 RFC7323.
+    // RcvWl2 equals to the variable "Last.ACK.sent"
     // defined there.
     //
     if (TCP_SEQ_LEQ (Seg->Seq, Tcb->RcvWl2) &&
-        TCP_SEQ_LT (Tcb->RcvWl2, Seg->End))
+        TCP_TIME_LEQ (Tcb->TsRecent, Option.TSVal))
     {
       Tcb->TsRecent    = Option.TSVal;
       Tcb->TsRecentAge = mTcpTick;
     }
+  }
 
-    TcpComputeRtt (Tcb, TCP_SUB_TIME (mTcpTick, Option.TSEcr));
-  } else if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RTT_ON)) {
+  //
+  // With timestamps, the ACKs of new data give RTT samples even for
+  // retransmitted data. Otherwise, one segment per RTT is timed. The
+  // timestamps are also sampled once per RTT: with a sample from every
+  // ACK, the gains of SRTT and RTTVAR would have to be divided by the
+  // number of samples in one RTT (appendix G of RFC7323), which is lost
+  // to the granularity of the heartbeat.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_TS) &&
+      TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_TS) &&
+      (Option.TSEcr != 0) &&
+      TCP_SEQ_GT (Seg->Ack, Tcb->SndUna))
+  {
+    if (TCP_SEQ_GT (Seg->Ack, Tcb->RttTsSeq)) {
+      TcpComputeRtt (Tcb, TCP_SUB_TIME (mTcpTick, Option.TSEcr));
+      Tcb->RttTsSeq = Tcb->SndNxt;
+    }
+
+    TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
+  } else if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RTT_ON) &&
+             TCP_SEQ_GT (Seg->Ack, Tcb->RttSeq))
+  {
     ASSERT (Tcb->CongestState == TCP_CONGEST_OPEN);
 
     TcpComputeRtt (Tcb, Tcb->RttMeasure);
     TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
   }
 
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+    TcpSackUpdateSnd (Tcb, Seg->Ack, &Option);
+  }
+
   if (Seg->Ack == Tcb->SndNxt) {
     TcpClearTimer (Tcb, TCP_TIMER_REXMIT);
   } else {
@@ -1225,7 +1321,7 @@ TcpInput (
       if (Tcb->CWnd < Tcb->Ssthresh) {
         Tcb->CWnd += Tcb->SndMss;
       } else {
-        Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+        Tcb->CongestOps->CongAvoid (Tcb);
       }
 
       Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
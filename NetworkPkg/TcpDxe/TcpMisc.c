@@ -129,6 +129,7 @@ TcpInitTcbPeer (
   }
 
   Tcb->CWnd = Tcb->SndMss;
+  TcpCongestInit (Tcb);
 
   Tcb->Irs    = Seg->Seq;
   Tcb->RcvNxt = Tcb->Irs + 1;
@@ -151,7 +152,8 @@ TcpInitTcbPeer (
     TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_SND_TS);
     TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_TS);
 
-    Tcb->TsRecent = Opt->TSVal;
+    Tcb->TsRecent    = Opt->TSVal;
+    Tcb->TsRecentAge = mTcpTick;
 
     //
     // Compute the effective SndMss per RFC1122
@@ -160,6 +162,15 @@ TcpInitTcbPeer (
     //
     Tcb->SndMss -= TCP_OPTION_TS_ALIGNED_LEN;
   }
+
+  if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_SACK_PERM) && !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK)) {
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK);
+  }
+
+  Tcb->RcvSackNum  = 0;
+  Tcb->SndSackNum  = 0;
+  Tcb->SackRxmtNxt = Tcb->Iss;
+  Tcb->RttTsSeq    = Tcb->Iss;
 }
 
 /**
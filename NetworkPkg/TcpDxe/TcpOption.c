@@ -135,7 +135,36 @@ TcpSynBuildOption (
 
     TcpPutUint32 (Data, TCP_OPTION_TS_FAST);
     TcpPutUint32 (Data + 4, mTcpTick);
-    TcpPutUint32 (Data + 8, 0);
+
+    //
+    // The SYN/ACK echoes the timestamp of the peer's SYN.
+    //
+    if (TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK)) {
+      TcpPutUint32 (Data + 8, Tcb->TsRecent);
+    } else {
+      TcpPutUint32 (Data + 8, 0);
+    }
+  }
+
+  //
+  // Build SACK permitted option, the same way as the
+  // window scale option.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+       TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK))
+      )
+  {
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
   }
 
   //
@@ -189,9 +218,13 @@ TcpBuildOption (
 {
   UINT8   *Data;
   UINT16  Len;
+  UINT32  DataLen;
+  UINT8   Num;
+  UINT8   Index;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
-  Len = 0;
+  Len     = 0;
+  DataLen = Nbuf->TotalSize;
 
   //
   // Build the Timestamp option.
@@ -214,6 +247,43 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Build the SACK option for the out-of-order data as
+  // specified in RFC2018, with as many blocks as the option
+  // space holds. Don't let it push a data segment over SndMss.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+      (Tcb->RcvSackNum != 0) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST)
+      )
+  {
+    Num = (UINT8)MIN (
+                   Tcb->RcvSackNum,
+                   (TCP_OPTION_MAX_LEN - Len - TCP_OPTION_SACK_ALIGNED_LEN (0)) / TCP_OPTION_SACK_BLOCK_LEN
+                   );
+
+    while ((Num > 0) && (DataLen != 0) && (DataLen + TCP_OPTION_SACK_ALIGNED_LEN (Num) > Tcb->SndMss)) {
+      Num--;
+    }
+
+    if (Num > 0) {
+      Data = NetbufAllocSpace (
+               Nbuf,
+               TCP_OPTION_SACK_ALIGNED_LEN (Num),
+               NET_BUF_HEAD
+               );
+
+      ASSERT (Data != NULL);
+      Len = (UINT16)(Len + TCP_OPTION_SACK_ALIGNED_LEN (Num));
+
+      TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | TCP_OPTION_SACK_LEN (Num));
+      for (Index = 0; Index < Num; Index++) {
+        TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Tcb->RcvSack[Index].Left);
+        TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Tcb->RcvSack[Index].Right);
+      }
+    }
+  }
+
   return Len;
 }
 
@@ -239,10 +309,12 @@ TcpParseOption (
   UINT8  Cur;
   UINT8  Type;
   UINT8  Len;
+  UINT8  Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
-  Option->Flag = 0;
+  Option->Flag    = 0;
+  Option->SackNum = 0;
 
   TotalLen = (UINT8)((Tcp->HeadLen << 2) - sizeof (TCP_HEAD));
   if (TotalLen <= 0) {
@@ -311,6 +383,39 @@ TcpParseOption (
         Cur += TCP_OPTION_TS_LEN;
         break;
 
+      case TCP_OPTION_SACK_PERM:
+        Len = Head[Cur + 1];
+
+        if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+          return -1;
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+        Cur += TCP_OPTION_SACK_PERM_LEN;
+        break;
+
+      case TCP_OPTION_SACK:
+        Len = Head[Cur + 1];
+
+        if ((Len < TCP_OPTION_SACK_LEN (1)) || (Len > TCP_OPTION_SACK_LEN (TCP_SACK_MAX_BLOCK)) ||
+            (((Len - TCP_OPTION_SACK_LEN (0)) % TCP_OPTION_SACK_BLOCK_LEN) != 0) ||
+            (TotalLen - Cur < Len))
+        {
+          return -1;
+        }
+
+        Option->SackNum = (UINT8)((Len - TCP_OPTION_SACK_LEN (0)) / TCP_OPTION_SACK_BLOCK_LEN);
+        for (Index = 0; Index < Option->SackNum; Index++) {
+          Option->Sack[Index].Left  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+          Option->Sack[Index].Right = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+        Cur = (UINT8)(Cur + Len);
+        break;
+
       case TCP_OPTION_NOP:
         Cur++;
         break;
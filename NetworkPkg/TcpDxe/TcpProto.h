@@ -52,6 +52,12 @@
 #define TCP_CONGEST_LOSS     2      ///< Retxmit because of retxmit time out.
 #define TCP_CONGEST_OPEN     3      ///< TCP is opening its congestion window.
 
+//
+// Congestion control algorithms, selected by PcdTcpCongestionControl.
+//
+#define TCP_CONGEST_CTRL_NEWRENO  0 ///< NewReno, RFC5681 and RFC6582.
+#define TCP_CONGEST_CTRL_CUBIC    1 ///< CUBIC, RFC9438.
+
 //
 // TCP control flags
 //
@@ -70,6 +76,8 @@
 #define TCP_CTRL_TIMER_ON      0x1000   ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON        0x2000   ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW       0x4000   ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK       0x8000   ///< Disable SACK option.
+#define TCP_CTRL_RCVD_SACK     0x10000  ///< Received a SACK permitted option in syn.
 
 //
 // Timer related values
@@ -204,6 +212,13 @@
 
 #define TCP_MAX_WIN  0xFFFFU
 
+//
+// The number of SACK blocks reported to the peer, and the number
+// of SACKed ranges remembered for the data sent to the peer.
+//
+#define TCP_SACK_MAX_BLOCK  4
+#define TCP_SND_SACK_MAX    16
+
 ///
 /// TCP segmentation data.
 ///
@@ -216,6 +231,14 @@ typedef struct _TCP_SEG {
   UINT32       Wnd;  ///< TCP window size field.
 } TCP_SEG;
 
+///
+/// A block of contiguous sequence space, [Left, Right).
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO    Left;  ///< The first sequence number of the block.
+  TCP_SEQNO    Right; ///< The sequence number of the last byte + 1.
+} TCP_SACK_BLOCK;
+
 ///
 /// Network endpoint, IP plus Port structure.
 ///
@@ -224,8 +247,22 @@ typedef struct _TCP_PEER {
   TCP_PORTNO        Port; ///< Port number, in network byte order.
 } TCP_PEER;
 
+///
+/// The state of CUBIC in the current congestion avoidance epoch.
+///
+typedef struct _TCP_CUBIC {
+  BOOLEAN    EpochOn;    ///< An epoch of congestion avoidance is going on.
+  UINT32     EpochStart; ///< When the epoch started, in heartbeats.
+  UINT32     WMax;       ///< CWnd before the last window reduction.
+  UINT32     Origin;     ///< The plateau of the cubic function.
+  UINT32     K;          ///< Time to reach Origin from the epoch start, in ms.
+  UINT32     WEst;       ///< CWnd that Reno would have reached in the epoch.
+} TCP_CUBIC;
+
 typedef struct _TCP_CONTROL_BLOCK TCP_CB;
 
+typedef struct _TCP_CONGESTION_OPS TCP_CONGESTION_OPS;
+
 ///
 /// TCP control block: it includes various states.
 ///
@@ -290,6 +327,7 @@ struct _TCP_CONTROL_BLOCK {
   //
   TCP_SEQNO           RttSeq;     ///< The seq of measured segment now.
   UINT32              RttMeasure; ///< Currently measured RTT in heartbeats.
+  TCP_SEQNO           RttTsSeq;   ///< With timestamps, sample the RTT again once this is ACKed.
   UINT32              SRtt;       ///< Smoothed RTT, scaled by 8.
   UINT32              RttVar;     ///< RTT variance, scaled by 8.
   UINT32              Rto;        ///< Current RTO, not scaled.
@@ -306,6 +344,18 @@ struct _TCP_CONTROL_BLOCK {
   UINT8               LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO           LossRecover;  ///< Recover point for retxmit.
 
+  TCP_CONGESTION_OPS  *CongestOps;  ///< The congestion control algorithm.
+  TCP_CUBIC           Cubic;        ///< The state of CUBIC.
+
+  //
+  // RFC2018 and RFC6675 variables, about selective acknowledgment.
+  //
+  TCP_SACK_BLOCK      RcvSack[TCP_SACK_MAX_BLOCK]; ///< Out-of-order data received, most recent first.
+  UINT8               RcvSackNum;                  ///< Number of valid blocks in RcvSack.
+  UINT8               SndSackNum;                  ///< Number of valid ranges in SndSack.
+  TCP_SACK_BLOCK      SndSack[TCP_SND_SACK_MAX];   ///< Data SACKed by the peer, in sequence order.
+  TCP_SEQNO           SackRxmtNxt;                 ///< Retransmitted up to here in this recovery.
+
   //
   // RFC7323
   // Addressing Window Retraction for TCP Window Scale Option.
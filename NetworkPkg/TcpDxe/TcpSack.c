@@ -0,0 +1,250 @@
+/** @file
+  Selective acknowledgment of TCP, as specified in RFC2018 and RFC6675.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+/**
+  Update the scoreboard of the data SACKed by the peer, as specified in
+  RFC2018 and RFC6675. The data acknowledged cumulatively is removed, and
+  the blocks of the SACK option are merged into the scoreboard. The blocks
+  that don't fit are ignored, their data is retransmitted if necessary.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge sequence number of the segment.
+  @param[in]       Option   Pointer to the options of the segment.
+
+**/
+VOID
+TcpSackUpdateSnd (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEQNO   Ack,
+  IN     TCP_OPTION  *Option
+  )
+{
+  TCP_SACK_BLOCK  *Sack;
+  TCP_SEQNO       Left;
+  TCP_SEQNO       Right;
+  UINT8           Index;
+  UINT8           First;
+  UINT8           Last;
+  UINT8           Num;
+
+  Sack = Tcb->SndSack;
+
+  //
+  // Remove the data acknowledged cumulatively.
+  //
+  Num = 0;
+  for (Index = 0; Index < Tcb->SndSackNum; Index++) {
+    if (TCP_SEQ_LEQ (Sack[Index].Right, Ack)) {
+      continue;
+    }
+
+    Sack[Num].Left  = TCP_SEQ_LT (Sack[Index].Left, Ack) ? Ack : Sack[Index].Left;
+    Sack[Num].Right = Sack[Index].Right;
+    Num++;
+  }
+
+  if (TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK)) {
+    for (Index = 0; Index < Option->SackNum; Index++) {
+      Left  = Option->Sack[Index].Left;
+      Right = Option->Sack[Index].Right;
+
+      //
+      // Ignore the broken blocks, the blocks below the cumulative
+      // ACK (D-SACK of RFC2883), and the blocks of data never sent.
+      //
+      if (TCP_SEQ_GEQ (Left, Right) || TCP_SEQ_LT (Left, Ack) || TCP_SEQ_GT (Right, Tcb->SndNxt)) {
+        continue;
+      }
+
+      //
+      // Merge the block with the ranges it overlaps or adjoins,
+      // that is ranges First to Last - 1.
+      //
+      First = 0;
+      while ((First < Num) && TCP_SEQ_LT (Sack[First].Right, Left)) {
+        First++;
+      }
+
+      Last = First;
+      while ((Last < Num) && TCP_SEQ_LEQ (Sack[Last].Left, Right)) {
+        if (TCP_SEQ_LT (Sack[Last].Left, Left)) {
+          Left = Sack[Last].Left;
+        }
+
+        if (TCP_SEQ_GT (Sack[Last].Right, Right)) {
+          Right = Sack[Last].Right;
+        }
+
+        Last++;
+      }
+
+      if (First == Last) {
+        if (Num == TCP_SND_SACK_MAX) {
+          continue;
+        }
+
+        CopyMem (&Sack[First + 1], &Sack[First], (Num - First) * sizeof (TCP_SACK_BLOCK));
+        Num++;
+      } else {
+        CopyMem (&Sack[First + 1], &Sack[Last], (Num - Last) * sizeof (TCP_SACK_BLOCK));
+        Num = (UINT8)(Num - (Last - First - 1));
+      }
+
+      Sack[First].Left  = Left;
+      Sack[First].Right = Right;
+    }
+  }
+
+  Tcb->SndSackNum = Num;
+}
+
+/**
+  Retransmit the first hole in the sequence space as specified in RFC6675.
+  A hole is the data below the highest SACKed sequence that is neither
+  SACKed by the peer nor retransmitted in the current recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The sequence number acknowledged cumulatively.
+
+  @retval TRUE     A hole is retransmitted.
+  @retval FALSE    No hole is left, or the retransmission failed.
+
+**/
+BOOLEAN
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Ack
+  )
+{
+  LIST_ENTRY  *Entry;
+  NET_BUF     *Node;
+  TCP_SEQNO   Seq;
+  TCP_SEQNO   End;
+  UINT8       Index;
+
+  Seq = Tcb->SackRxmtNxt;
+  if (TCP_SEQ_LT (Seq, Ack)) {
+    Seq = Ack;
+  }
+
+  for (Index = 0; Index < Tcb->SndSackNum; Index++) {
+    if (TCP_SEQ_LT (Seq, Tcb->SndSack[Index].Left)) {
+      break;
+    }
+
+    if (TCP_SEQ_LT (Seq, Tcb->SndSack[Index].Right)) {
+      Seq = Tcb->SndSack[Index].Right;
+    }
+  }
+
+  if (Index == Tcb->SndSackNum) {
+    return FALSE;
+  }
+
+  //
+  // TcpRetransmit() sends at most one SndMss, and doesn't cross
+  // the boundary of the segment on SndQue. Remember where it stops.
+  //
+  End = Tcb->SndSack[Index].Left;
+  if (TCP_SEQ_GT (End, Seq + Tcb->SndMss)) {
+    End = Seq + Tcb->SndMss;
+  }
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    Node = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+
+    if (TCP_SEQ_LT (Seq, TCPSEG_NETBUF (Node)->End)) {
+      if (TCP_SEQ_GT (End, TCPSEG_NETBUF (Node)->End)) {
+        End = TCPSEG_NETBUF (Node)->End;
+      }
+
+      break;
+    }
+  }
+
+  if (TcpRetransmit (Tcb, Seq) != 0) {
+    return FALSE;
+  }
+
+  DEBUG (
+    (DEBUG_NET,
+     "TcpSackRetransmit: retransmit the hole at %d for TCB %p\n",
+     Seq,
+     Tcb)
+    );
+
+  Tcb->SackRxmtNxt = End;
+  return TRUE;
+}
+
+/**
+  Update the SACK blocks reported to the peer after an out-of-order
+  segment is queued, as specified in RFC2018. The block that holds the
+  segment is reported first, followed by the most recently reported ones.
+
+  @param[in, out]  Tcb   Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Nbuf  Pointer to the segment queued on the RcvQue.
+
+**/
+VOID
+TcpSackUpdateRcv (
+  IN OUT TCP_CB   *Tcb,
+  IN     NET_BUF  *Nbuf
+  )
+{
+  TCP_SACK_BLOCK  Sack[TCP_SACK_MAX_BLOCK];
+  LIST_ENTRY      *Entry;
+  NET_BUF         *Node;
+  UINT8           Index;
+  UINT8           Num;
+
+  Sack[0].Left  = TCPSEG_NETBUF (Nbuf)->Seq;
+  Sack[0].Right = TCPSEG_NETBUF (Nbuf)->End;
+
+  //
+  // Extend the block over the adjoining segments on both sides.
+  //
+  for (Entry = Nbuf->List.BackLink; Entry != &Tcb->RcvQue; Entry = Entry->BackLink) {
+    Node = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+    if (TCPSEG_NETBUF (Node)->End != Sack[0].Left) {
+      break;
+    }
+
+    Sack[0].Left = TCPSEG_NETBUF (Node)->Seq;
+  }
+
+  for (Entry = Nbuf->List.ForwardLink; Entry != &Tcb->RcvQue; Entry = Entry->ForwardLink) {
+    Node = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+    if (TCPSEG_NETBUF (Node)->Seq != Sack[0].Right) {
+      break;
+    }
+
+    Sack[0].Right = TCPSEG_NETBUF (Node)->End;
+  }
+
+  //
+  // The blocks reported before are either inside the new
+  // block, or disjoint from it.
+  //
+  Num = 1;
+  for (Index = 0; (Index < Tcb->RcvSackNum) && (Num < TCP_SACK_MAX_BLOCK); Index++) {
+    if (TCP_SEQ_LEQ (Sack[0].Left, Tcb->RcvSack[Index].Left) &&
+        TCP_SEQ_LEQ (Tcb->RcvSack[Index].Right, Sack[0].Right))
+    {
+      continue;
+    }
+
+    Sack[Num].Left  = Tcb->RcvSack[Index].Left;
+    Sack[Num].Right = Tcb->RcvSack[Index].Right;
+    Num++;
+  }
+
+  CopyMem (Tcb->RcvSack, Sack, Num * sizeof (TCP_SACK_BLOCK));
+  Tcb->RcvSackNum = Num;
+}
@@ -194,7 +194,7 @@ TcpRexmitTimeout (
   // yet ACKed.
   //
   FlightSize    = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-  Tcb->Ssthresh = MAX ((UINT32)(2 * Tcb->SndMss), FlightSize / 2);
+  Tcb->Ssthresh = Tcb->CongestOps->Ssthresh (Tcb, FlightSize);
 
   Tcb->CWnd        = Tcb->SndMss;
   Tcb->LossRecover = Tcb->SndNxt;
@@ -215,6 +215,13 @@ TcpRexmitTimeout (
     return;
   }
 
+  //
+  // The SACK information may be reneged by the peer, so it is
+  // discarded after a timeout as RFC2018 requires.
+  //
+  Tcb->SndSackNum  = 0;
+  Tcb->SackRxmtNxt = Tcb->SndUna;
+
   TcpBackoffRto (Tcb);
   TcpRetransmit (Tcb, Tcb->SndUna);
   TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
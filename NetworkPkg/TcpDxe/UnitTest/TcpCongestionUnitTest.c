@@ -0,0 +1,307 @@
+/** @file
+  Host-based unit test of the congestion control algorithms of TcpDxe.
+
+  A connection runs for a while over a modeled link, one RTT at a time. The
+  link delivers a fixed number of segments per RTT, and its bottleneck queue
+  drops the segments that don't fit. Segments are also lost at random, with
+  a fixed seed so the results are reproducible. The congestion window reacts
+  like TcpInput() does: it grows on every ACK and it is reduced once per RTT
+  with losses. The goodput of NewReno and CUBIC is reported and compared.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Library/UnitTestLib.h>
+
+#include "../TcpMain.h"
+
+#define UNIT_TEST_APP_NAME     "TcpDxe Congestion Control Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_MSS       1460
+#define TEST_DURATION  (600 * TCP_TICK_HZ)
+
+///
+/// A modeled link.
+///
+typedef struct {
+  UINT32    Rtt;      ///< The round trip time, in heartbeats.
+  UINT32    Rate;     ///< The segments delivered in one RTT.
+  UINT32    Buffer;   ///< The segments the bottleneck queue holds.
+  UINT32    LossRate; ///< One segment in LossRate is lost at random, 0 for none.
+} TEST_LINK;
+
+//
+// 100 Mbit/s with a 600 ms RTT, a queue of a quarter of the bandwidth-delay
+// product, and one segment in 100000 lost.
+//
+TEST_LINK  mLossyLink = { 3, 5136, 1284, 100000 };
+
+//
+// 10 Mbit/s with a 200 ms RTT, a queue of the bandwidth-delay product, and
+// no random loss.
+//
+TEST_LINK  mShortLink = { 1, 171, 171, 0 };
+
+UINT32  mTcpTick;
+UINT32  mSeed;
+
+/**
+  Tell whether a segment is lost at random.
+
+  @param[in]  LossRate  One segment in LossRate is lost, 0 for none.
+
+  @retval TRUE   The segment is lost.
+  @retval FALSE  The segment is delivered.
+
+**/
+BOOLEAN
+RandomLoss (
+  IN UINT32  LossRate
+  )
+{
+  if (LossRate == 0) {
+    return FALSE;
+  }
+
+  mSeed = mSeed * 1103515245 + 12345;
+  return (BOOLEAN)((mSeed >> 8) % LossRate == 0);
+}
+
+/**
+  Run a connection over a modeled link.
+
+  @param[in]  Link       The modeled link.
+  @param[in]  Algorithm  The congestion control algorithm, the value of
+                         PcdTcpCongestionControl.
+
+  @return The goodput of the connection, in kbit/s.
+
+**/
+UINT32
+RunConnection (
+  IN TEST_LINK  *Link,
+  IN UINT8      Algorithm
+  )
+{
+  TCP_CB  Tcb;
+  UINT64  Delivered;
+  UINT32  Window;
+  UINT32  Lost;
+  UINT32  Index;
+
+  PatchPcdSet8 (PcdTcpCongestionControl, Algorithm);
+
+  ZeroMem (&Tcb, sizeof (Tcb));
+  Tcb.SndMss   = TEST_MSS;
+  Tcb.CWnd     = Tcb.SndMss;
+  Tcb.Ssthresh = 0xffffffff;
+  Tcb.SRtt     = Link->Rtt << TCP_RTT_SHIFT;
+  TcpCongestInit (&Tcb);
+
+  mSeed     = 1;
+  Delivered = 0;
+
+  for (mTcpTick = 0; mTcpTick < TEST_DURATION; mTcpTick += Link->Rtt) {
+    Window = MAX (Tcb.CWnd / Tcb.SndMss, 1);
+
+    Lost = 0;
+    if (Window > Link->Rate + Link->Buffer) {
+      Lost = Window - (Link->Rate + Link->Buffer);
+    }
+
+    for (Index = Lost; Index < Window; Index++) {
+      if (RandomLoss (Link->LossRate)) {
+        Lost++;
+      }
+    }
+
+    Delivered += MIN (Window - Lost, Link->Rate);
+
+    if (Lost != 0) {
+      //
+      // Fast recovery repairs the losses in one RTT, and leaves the
+      // window at the new slow start threshold.
+      //
+      Tcb.Ssthresh = Tcb.CongestOps->Ssthresh (&Tcb, Window * Tcb.SndMss);
+      Tcb.CWnd     = Tcb.Ssthresh;
+      continue;
+    }
+
+    for (Index = 0; Index < Window; Index++) {
+      if (Tcb.CWnd < Tcb.Ssthresh) {
+        Tcb.CWnd += Tcb.SndMss;
+      } else {
+        Tcb.CongestOps->CongAvoid (&Tcb);
+      }
+    }
+  }
+
+  return (UINT32)DivU64x32 (MultU64x32 (Delivered, TEST_MSS * 8), (TEST_DURATION / TCP_TICK_HZ) * 1000);
+}
+
+/**
+  Compare the goodput of NewReno and CUBIC over a link with a large
+  bandwidth-delay product and random losses.
+
+  @param[in]  Context  The modeled link.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LossyLinkGoodput (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_LINK  *Link;
+  UINT32     Capacity;
+  UINT32     NewReno;
+  UINT32     Cubic;
+
+  Link     = (TEST_LINK *)Context;
+  Capacity = Link->Rate * TEST_MSS * 8 * TCP_TICK_HZ / Link->Rtt / 1000;
+  NewReno  = RunConnection (Link, TCP_CONGEST_CTRL_NEWRENO);
+  Cubic    = RunConnection (Link, TCP_CONGEST_CTRL_CUBIC);
+
+  UT_LOG_INFO ("Link capacity %d kbit/s, NewReno %d kbit/s, CUBIC %d kbit/s\n", Capacity, NewReno, Cubic);
+
+  //
+  // NewReno takes thousands of RTTs to open the window again after a
+  // loss, CUBIC a few seconds.
+  //
+  UT_ASSERT_TRUE (Cubic > 2 * NewReno);
+  UT_ASSERT_TRUE (Cubic > Capacity / 2);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that NewReno and CUBIC both use a link with a small bandwidth-delay
+  product and a large enough queue.
+
+  @param[in]  Context  The modeled link.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ShortLinkGoodput (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_LINK  *Link;
+  UINT32     Capacity;
+  UINT32     NewReno;
+  UINT32     Cubic;
+
+  Link     = (TEST_LINK *)Context;
+  Capacity = Link->Rate * TEST_MSS * 8 * TCP_TICK_HZ / Link->Rtt / 1000;
+  NewReno  = RunConnection (Link, TCP_CONGEST_CTRL_NEWRENO);
+  Cubic    = RunConnection (Link, TCP_CONGEST_CTRL_CUBIC);
+
+  UT_LOG_INFO ("Link capacity %d kbit/s, NewReno %d kbit/s, CUBIC %d kbit/s\n", Capacity, NewReno, Cubic);
+
+  UT_ASSERT_TRUE (NewReno > Capacity * 9 / 10);
+  UT_ASSERT_TRUE (Cubic > Capacity * 9 / 10);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  congestion control algorithms and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CongestTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the congestion control Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&CongestTests, Framework, "TCP Congestion Control Tests", "TcpDxe.Congestion", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for TCP Congestion Control Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite------------Description------------------------------Name-----------Function----------Pre---Post--Context----------
+  //
+  AddTestCase (CongestTests, "Goodput over a lossy long fat link", "LossyLink", LossyLinkGoodput, NULL, NULL, &mLossyLink);
+  AddTestCase (CongestTests, "Goodput over a short link", "ShortLink", ShortLinkGoodput, NULL, NULL, &mShortLink);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define TcpCongestionUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+TcpCongestionUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = UnitTestingEntry ();
+  return EFI_ERROR (Status) ? 1 : 0;
+}
@@ -0,0 +1,937 @@
+/** @file
+  Host-based unit test of the selective acknowledgment of TcpDxe.
+
+  The SACK scoreboard of the sender and the SACK blocks of the receiver are
+  updated on a TCP_CB built by the test. Retransmissions are recorded
+  instead of being sent. Every test runs twice, once with sequence numbers
+  that wrap around 0.
+
+  The loopback tests connect the TCP_CB to itself through a link that drops
+  chosen segments. The receiver side reports the data it holds in SACK
+  blocks, and the sender side recovers the lost data with
+  TcpSackRetransmit() the way TcpFastRecover() does.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Library/UnitTestLib.h>
+
+#include "../TcpMain.h"
+
+#define UNIT_TEST_APP_NAME     "TcpDxe SACK Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_SEGMENT_NUMBER  48
+#define TEST_MAX_RETRANSMIT  16
+#define TEST_LINK_DEPTH      64
+
+//
+// All the sequence numbers of a test are offsets from mBase.
+//
+#define SEQ(Offset)  ((TCP_SEQNO)(mBase + (Offset)))
+
+TCP_SEQNO  mBase;
+TCP_CB     mTcb;
+NET_BUF    mSegments[TEST_SEGMENT_NUMBER];
+UINTN      mSegmentNumber;
+TCP_SEQNO  mRetransmitted[TEST_MAX_RETRANSMIT];
+UINTN      mRetransmitNumber;
+
+//
+// The segments in flight on the loopback link, as offsets of their first
+// sequence number and of the sequence number after them.
+//
+BOOLEAN  mLoopback;
+UINT32   mLinkSeq[TEST_LINK_DEPTH];
+UINT32   mLinkEnd[TEST_LINK_DEPTH];
+UINTN    mLinkHead;
+UINTN    mLinkTail;
+
+/**
+  Put a segment on the loopback link.
+
+  @param[in]  Seq     Offset of the first sequence number of the segment.
+  @param[in]  End     Offset of the sequence number after the segment.
+
+**/
+VOID
+LinkSend (
+  IN UINT32  Seq,
+  IN UINT32  End
+  )
+{
+  ASSERT (mLinkTail < TEST_LINK_DEPTH);
+
+  mLinkSeq[mLinkTail] = Seq;
+  mLinkEnd[mLinkTail] = End;
+  mLinkTail++;
+}
+
+/**
+  Fake TcpRetransmit(), records the sequence number retransmitted. In the
+  loopback tests, the data is also sent on the link, at most one SndMss and
+  not beyond the end of its segment on the SndQue, like TcpRetransmit().
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Seq     The sequence number of the segment to be retransmitted.
+
+  @retval 0       The retransmission succeeded.
+
+**/
+INTN
+TcpRetransmit (
+  IN TCP_CB     *Tcb,
+  IN TCP_SEQNO  Seq
+  )
+{
+  LIST_ENTRY  *Entry;
+  NET_BUF     *Node;
+  TCP_SEQNO   End;
+
+  ASSERT (mRetransmitNumber < TEST_MAX_RETRANSMIT);
+
+  mRetransmitted[mRetransmitNumber++] = Seq;
+
+  if (mLoopback) {
+    End = Seq + Tcb->SndMss;
+    NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+      Node = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+      if (TCP_SEQ_LT (Seq, TCPSEG_NETBUF (Node)->End)) {
+        if (TCP_SEQ_GT (End, TCPSEG_NETBUF (Node)->End)) {
+          End = TCPSEG_NETBUF (Node)->End;
+        }
+
+        break;
+      }
+    }
+
+    LinkSend (Seq - mBase, End - mBase);
+  }
+
+  return 0;
+}
+
+/**
+  Add a segment to the tail of a queue of the TCP_CB.
+
+  @param[in]  Queue   The SndQue or the RcvQue of the TCP_CB.
+  @param[in]  Seq     Offset of the first sequence number of the segment.
+  @param[in]  End     Offset of the sequence number after the segment.
+
+  @return The segment added.
+
+**/
+NET_BUF *
+AddSegment (
+  IN LIST_ENTRY  *Queue,
+  IN UINT32      Seq,
+  IN UINT32      End
+  )
+{
+  NET_BUF  *Nbuf;
+
+  ASSERT (mSegmentNumber < TEST_SEGMENT_NUMBER);
+
+  Nbuf                      = &mSegments[mSegmentNumber++];
+  TCPSEG_NETBUF (Nbuf)->Seq = SEQ (Seq);
+  TCPSEG_NETBUF (Nbuf)->End = SEQ (End);
+  InsertTailList (Queue, &Nbuf->List);
+  return Nbuf;
+}
+
+/**
+  Queue an out-of-order segment on the RcvQue in sequence order, like
+  TcpQueueData() does, and update the SACK blocks of the receiver.
+
+  @param[in]  Seq     Offset of the first sequence number of the segment.
+  @param[in]  End     Offset of the sequence number after the segment.
+
+**/
+VOID
+ReceiveSegment (
+  IN UINT32  Seq,
+  IN UINT32  End
+  )
+{
+  NET_BUF     *Nbuf;
+  LIST_ENTRY  *Entry;
+
+  ASSERT (mSegmentNumber < TEST_SEGMENT_NUMBER);
+
+  Nbuf                      = &mSegments[mSegmentNumber++];
+  TCPSEG_NETBUF (Nbuf)->Seq = SEQ (Seq);
+  TCPSEG_NETBUF (Nbuf)->End = SEQ (End);
+
+  for (Entry = mTcb.RcvQue.ForwardLink; Entry != &mTcb.RcvQue; Entry = Entry->ForwardLink) {
+    if (TCP_SEQ_LT (SEQ (Seq), TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List))->Seq)) {
+      break;
+    }
+  }
+
+  InsertTailList (Entry, &Nbuf->List);
+  TcpSackUpdateRcv (&mTcb, Nbuf);
+}
+
+/**
+  Receive an ACK and update the SACK scoreboard of the sender.
+
+  @param[in]  Ack     Offset of the sequence number acknowledged cumulatively.
+  @param[in]  Num     The number of SACK blocks in the ACK.
+  @param[in]  Blocks  Offsets of the left and right edges of the SACK blocks.
+
+**/
+VOID
+ReceiveAck (
+  IN UINT32        Ack,
+  IN UINT8         Num,
+  IN CONST UINT32  *Blocks
+  )
+{
+  TCP_OPTION  Option;
+  UINT8       Index;
+
+  ASSERT (Num <= TCP_SACK_MAX_BLOCK);
+
+  ZeroMem (&Option, sizeof (Option));
+  if (Num != 0) {
+    Option.Flag = TCP_OPTION_RCVD_SACK;
+  }
+
+  Option.SackNum = Num;
+  for (Index = 0; Index < Num; Index++) {
+    Option.Sack[Index].Left  = SEQ (Blocks[2 * Index]);
+    Option.Sack[Index].Right = SEQ (Blocks[2 * Index + 1]);
+  }
+
+  TcpSackUpdateSnd (&mTcb, SEQ (Ack), &Option);
+}
+
+/**
+  Check SACK blocks against the expected ones.
+
+  @param[in]  Sack         The SACK blocks.
+  @param[in]  Num          The number of SACK blocks.
+  @param[in]  Expected     Offsets of the left and right edges of the expected
+                           blocks.
+  @param[in]  ExpectedNum  The number of expected blocks.
+
+  @retval TRUE   The blocks are the expected ones.
+  @retval FALSE  The blocks are different.
+
+**/
+BOOLEAN
+SackEqual (
+  IN CONST TCP_SACK_BLOCK  *Sack,
+  IN UINT8                 Num,
+  IN CONST UINT32          *Expected,
+  IN UINT8                 ExpectedNum
+  )
+{
+  UINT8  Index;
+
+  if (Num != ExpectedNum) {
+    DEBUG ((DEBUG_ERROR, "%d blocks, %d expected\n", Num, ExpectedNum));
+    return FALSE;
+  }
+
+  for (Index = 0; Index < Num; Index++) {
+    if ((Sack[Index].Left != SEQ (Expected[2 * Index])) ||
+        (Sack[Index].Right != SEQ (Expected[2 * Index + 1])))
+    {
+      DEBUG ((
+        DEBUG_ERROR,
+        "Block %d is [%u, %u), [%u, %u) expected\n",
+        Index,
+        Sack[Index].Left - mBase,
+        Sack[Index].Right - mBase,
+        Expected[2 * Index],
+        Expected[2 * Index + 1]
+        ));
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Set up a connection with 16000 bytes in flight, from the sequence number
+  given by the context.
+
+  @param[in]  Context  The base of the sequence numbers of the test.
+
+  @retval  UNIT_TEST_PASSED  The connection is set up.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SetupConnection (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mBase = (TCP_SEQNO)(UINTN)Context;
+
+  ZeroMem (&mTcb, sizeof (mTcb));
+  InitializeListHead (&mTcb.SndQue);
+  InitializeListHead (&mTcb.RcvQue);
+  mTcb.SndMss      = 1000;
+  mTcb.SndUna      = SEQ (0);
+  mTcb.SndNxt      = SEQ (16000);
+  mTcb.RcvNxt      = SEQ (0);
+  mTcb.SackRxmtNxt = SEQ (0);
+
+  ZeroMem (mSegments, sizeof (mSegments));
+  mSegmentNumber    = 0;
+  mRetransmitNumber = 0;
+
+  mLoopback = FALSE;
+  mLinkHead = 0;
+  mLinkTail = 0;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  SACK blocks are merged into the scoreboard in sequence order, with the
+  ranges they overlap or adjoin.
+
+  @param[in]  Context  The base of the sequence numbers of the test.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SndSackMerge (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT32  Ack1[]   = { 3000, 4000 };
+  STATIC CONST UINT32  Ack2[]   = { 1000, 2000 };
+  STATIC CONST UINT32  Score2[] = { 1000, 2000, 3000, 4000 };
+  STATIC CONST UINT32  Ack3[]   = { 2000, 3000, 6000, 7000, 5000, 5500 };
+  STATIC CONST UINT32  Score3[] = { 1000, 4000, 5000, 5500, 6000, 7000 };
+  STATIC CONST UINT32  Ack4[]   = { 500, 1500, 5200, 6500 };
+  STATIC CONST UINT32  Score4[] = { 500, 4000, 5000, 7000 };
+
+  ReceiveAck (0, 1, Ack1);
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Ack1, 1));
+
+  //
+  // A block below the ranges is inserted before them.
+  //
+  ReceiveAck (0, 1, Ack2);
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Score2, 2));
+
+  //
+  // A block that adjoins two ranges joins them.
+  //
+  ReceiveAck (0, 3, Ack3);
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Score3, 3));
+
+  //
+  // Blocks that overlap ranges extend them.
+  //
+  ReceiveAck (0, 2, Ack4);
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Score4, 2));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The data acknowledged cumulatively is removed from the scoreboard, and
+  the blocks of data that can't be SACKed are ignored.
+
+  @param[in]  Context  The base of the sequence numbers of the test.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SndSackAck (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT32  Ack1[]    = { 3000, 4000, 1000, 2000 };
+  STATIC CONST UINT32  Score1[]  = { 1000, 2000, 3000, 4000 };
+  STATIC CONST UINT32  Score2[]  = { 1500, 2000, 3000, 4000 };
+  STATIC CONST UINT32  Score3[]  = { 3000, 4000 };
+  STATIC CONST UINT32  Invalid[] = { 6000, 6000, 7000, 6500, 1000, 2000, 15000, 17000 };
+
+  ReceiveAck (0, 2, Ack1);
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Score1, 2));
+
+  ReceiveAck (1500, 0, NULL);
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Score2, 2));
+
+  ReceiveAck (2500, 0, NULL);
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Score3, 1));
+
+  //
+  // Empty and reversed blocks, a D-SACK block below the cumulative ACK and
+  // a block beyond SndNxt don't change the scoreboard.
+  //
+  ReceiveAck (2500, 4, Invalid);
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Score3, 1));
+
+  ReceiveAck (4000, 0, NULL);
+  UT_ASSERT_EQUAL (mTcb.SndSackNum, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  When the scoreboard is full, blocks that need a new range are ignored,
+  and blocks that extend or join ranges are still merged.
+
+  @param[in]  Context  The base of the sequence numbers of the test.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SndSackFull (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Blocks[2 * TCP_SND_SACK_MAX];
+  UINT32  Block[2];
+  UINT8   Index;
+
+  //
+  // Ranges of 100 bytes every 500 bytes, from 1000.
+  //
+  for (Index = 0; Index < TCP_SND_SACK_MAX; Index++) {
+    Blocks[2 * Index]     = 1000 + Index * 500;
+    Blocks[2 * Index + 1] = 1100 + Index * 500;
+    ReceiveAck (0, 1, &Blocks[2 * Index]);
+  }
+
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Blocks, TCP_SND_SACK_MAX));
+
+  Block[0] = 500;
+  Block[1] = 600;
+  ReceiveAck (0, 1, Block);
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Blocks, TCP_SND_SACK_MAX));
+
+  Block[0]  = 1100;
+  Block[1]  = 1200;
+  Blocks[1] = 1200;
+  ReceiveAck (0, 1, Block);
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Blocks, TCP_SND_SACK_MAX));
+
+  //
+  // Joining the first two ranges leaves room for a new one.
+  //
+  Block[0]  = 1200;
+  Block[1]  = 1500;
+  Blocks[1] = 1600;
+  CopyMem (&Blocks[2], &Blocks[4], (TCP_SND_SACK_MAX - 2) * 2 * sizeof (UINT32));
+  ReceiveAck (0, 1, Block);
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Blocks, TCP_SND_SACK_MAX - 1));
+
+  Block[0] = 500;
+  Block[1] = 600;
+  CopyMem (&Blocks[2], &Blocks[0], (TCP_SND_SACK_MAX - 1) * 2 * sizeof (UINT32));
+  Blocks[0] = 500;
+  Blocks[1] = 600;
+  ReceiveAck (0, 1, Block);
+  UT_ASSERT_TRUE (SackEqual (mTcb.SndSack, mTcb.SndSackNum, Blocks, TCP_SND_SACK_MAX));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The holes below the highest SACKed sequence are retransmitted one segment
+  at a time, and only once in a recovery.
+
+  @param[in]  Context  The base of the sequence numbers of the test.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SndSackRetransmit (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT32  Ack[] = { 2000, 3000, 4000, 5000 };
+  UINT32               Seq;
+
+  for (Seq = 0; Seq < 16000; Seq += 1000) {
+    AddSegment (&mTcb.SndQue, Seq, Seq + 1000);
+  }
+
+  ReceiveAck (0, 2, Ack);
+
+  UT_ASSERT_TRUE (TcpSackRetransmit (&mTcb, SEQ (0)));
+  UT_ASSERT_EQUAL (mTcb.SackRxmtNxt, SEQ (1000));
+  UT_ASSERT_TRUE (TcpSackRetransmit (&mTcb, SEQ (0)));
+  UT_ASSERT_EQUAL (mTcb.SackRxmtNxt, SEQ (2000));
+  UT_ASSERT_TRUE (TcpSackRetransmit (&mTcb, SEQ (0)));
+  UT_ASSERT_EQUAL (mTcb.SackRxmtNxt, SEQ (4000));
+
+  //
+  // Nothing is left to retransmit below the highest SACKed sequence.
+  //
+  UT_ASSERT_FALSE (TcpSackRetransmit (&mTcb, SEQ (0)));
+
+  UT_ASSERT_EQUAL (mRetransmitNumber, 3);
+  UT_ASSERT_EQUAL (mRetransmitted[0], SEQ (0));
+  UT_ASSERT_EQUAL (mRetransmitted[1], SEQ (1000));
+  UT_ASSERT_EQUAL (mRetransmitted[2], SEQ (3000));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A retransmission doesn't cross a SACKed range or the end of a segment on
+  the SndQue, and starts from the cumulative ACK.
+
+  @param[in]  Context  The base of the sequence numbers of the test.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SndSackRetransmitBoundary (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT32  Ack[] = { 2500, 3000 };
+  UINT32               Seq;
+
+  for (Seq = 0; Seq < 15600; Seq += 600) {
+    AddSegment (&mTcb.SndQue, Seq, Seq + 600);
+  }
+
+  ReceiveAck (0, 1, Ack);
+
+  //
+  // The ACK is above the data retransmitted so far.
+  //
+  UT_ASSERT_TRUE (TcpSackRetransmit (&mTcb, SEQ (700)));
+  UT_ASSERT_EQUAL (mTcb.SackRxmtNxt, SEQ (1200));
+  UT_ASSERT_TRUE (TcpSackRetransmit (&mTcb, SEQ (700)));
+  UT_ASSERT_EQUAL (mTcb.SackRxmtNxt, SEQ (1800));
+  UT_ASSERT_TRUE (TcpSackRetransmit (&mTcb, SEQ (700)));
+  UT_ASSERT_EQUAL (mTcb.SackRxmtNxt, SEQ (2400));
+  UT_ASSERT_TRUE (TcpSackRetransmit (&mTcb, SEQ (700)));
+  UT_ASSERT_EQUAL (mTcb.SackRxmtNxt, SEQ (2500));
+  UT_ASSERT_FALSE (TcpSackRetransmit (&mTcb, SEQ (700)));
+
+  UT_ASSERT_EQUAL (mRetransmitNumber, 4);
+  UT_ASSERT_EQUAL (mRetransmitted[0], SEQ (700));
+  UT_ASSERT_EQUAL (mRetransmitted[1], SEQ (1200));
+  UT_ASSERT_EQUAL (mRetransmitted[2], SEQ (1800));
+  UT_ASSERT_EQUAL (mRetransmitted[3], SEQ (2400));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The receiver reports the block of the latest out-of-order segment first,
+  followed by the other most recent ones, up to TCP_SACK_MAX_BLOCK blocks.
+
+  @param[in]  Context  The base of the sequence numbers of the test.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RcvSackBlocks (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT32  Sack1[] = { 1000, 2000 };
+  STATIC CONST UINT32  Sack2[] = { 3000, 4000, 1000, 2000 };
+  STATIC CONST UINT32  Sack3[] = { 1000, 4000 };
+  STATIC CONST UINT32  Sack4[] = { 11000, 12000, 9000, 10000, 7000, 8000, 5000, 6000 };
+  STATIC CONST UINT32  Sack5[] = { 1000, 4500, 11000, 12000, 9000, 10000, 7000, 8000 };
+
+  ReceiveSegment (1000, 2000);
+  UT_ASSERT_TRUE (SackEqual (mTcb.RcvSack, mTcb.RcvSackNum, Sack1, 1));
+
+  ReceiveSegment (3000, 4000);
+  UT_ASSERT_TRUE (SackEqual (mTcb.RcvSack, mTcb.RcvSackNum, Sack2, 2));
+
+  //
+  // The segment fills the gap between the two blocks.
+  //
+  ReceiveSegment (2000, 3000);
+  UT_ASSERT_TRUE (SackEqual (mTcb.RcvSack, mTcb.RcvSackNum, Sack3, 1));
+
+  ReceiveSegment (5000, 6000);
+  ReceiveSegment (7000, 8000);
+  ReceiveSegment (9000, 10000);
+  ReceiveSegment (11000, 12000);
+  UT_ASSERT_TRUE (SackEqual (mTcb.RcvSack, mTcb.RcvSackNum, Sack4, TCP_SACK_MAX_BLOCK));
+
+  //
+  // The block of data not reported any more is reported again when it
+  // grows.
+  //
+  ReceiveSegment (4000, 4500);
+  UT_ASSERT_TRUE (SackEqual (mTcb.RcvSack, mTcb.RcvSackNum, Sack5, TCP_SACK_MAX_BLOCK));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Receive a segment from the loopback link on the receiver side of the
+  TCP_CB, and acknowledge it like TcpInput() does: the data in sequence is
+  delivered, the data out of order is queued, and the SACK blocks of the
+  delivered data are dropped.
+
+  @param[in]   Seq     Offset of the first sequence number of the segment.
+  @param[in]   End     Offset of the sequence number after the segment.
+  @param[out]  Blocks  Offsets of the left and right edges of the SACK blocks
+                       of the ACK.
+  @param[out]  Num     The number of SACK blocks of the ACK.
+
+  @return The offset of the sequence number acknowledged cumulatively.
+
+**/
+UINT32
+LoopbackReceive (
+  IN  UINT32  Seq,
+  IN  UINT32  End,
+  OUT UINT32  *Blocks,
+  OUT UINT8   *Num
+  )
+{
+  LIST_ENTRY  *Entry;
+  NET_BUF     *Node;
+  UINT8       Index;
+  UINT8       Kept;
+
+  if (SEQ (Seq) == mTcb.RcvNxt) {
+    mTcb.RcvNxt = SEQ (End);
+
+    while (!IsListEmpty (&mTcb.RcvQue)) {
+      Node = NET_LIST_HEAD (&mTcb.RcvQue, NET_BUF, List);
+      if (TCPSEG_NETBUF (Node)->Seq != mTcb.RcvNxt) {
+        break;
+      }
+
+      mTcb.RcvNxt = TCPSEG_NETBUF (Node)->End;
+      RemoveEntryList (&Node->List);
+    }
+
+    Kept = 0;
+    for (Index = 0; Index < mTcb.RcvSackNum; Index++) {
+      if (TCP_SEQ_GT (mTcb.RcvSack[Index].Right, mTcb.RcvNxt)) {
+        mTcb.RcvSack[Kept++] = mTcb.RcvSack[Index];
+      }
+    }
+
+    mTcb.RcvSackNum = Kept;
+  } else if (TCP_SEQ_GT (SEQ (Seq), mTcb.RcvNxt)) {
+    NET_LIST_FOR_EACH (Entry, &mTcb.RcvQue) {
+      Node = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+      if (TCPSEG_NETBUF (Node)->Seq == SEQ (Seq)) {
+        break;
+      }
+    }
+
+    if (Entry == &mTcb.RcvQue) {
+      ReceiveSegment (Seq, End);
+    }
+  }
+
+  for (Index = 0; Index < mTcb.RcvSackNum; Index++) {
+    Blocks[2 * Index]     = mTcb.RcvSack[Index].Left - mBase;
+    Blocks[2 * Index + 1] = mTcb.RcvSack[Index].Right - mBase;
+  }
+
+  *Num = mTcb.RcvSackNum;
+  return mTcb.RcvNxt - mBase;
+}
+
+/**
+  Receive an ACK on the sender side of the TCP_CB, and recover the lost
+  data like TcpFastRecover() does. The third duplicate ACK starts the
+  recovery, and every later ACK below the recover point retransmits the
+  next hole reported by SACK.
+
+  @param[in]  Ack     Offset of the sequence number acknowledged cumulatively.
+  @param[in]  Num     The number of SACK blocks in the ACK.
+  @param[in]  Blocks  Offsets of the left and right edges of the SACK blocks.
+
+**/
+VOID
+LoopbackAck (
+  IN UINT32        Ack,
+  IN UINT8         Num,
+  IN CONST UINT32  *Blocks
+  )
+{
+  ReceiveAck (Ack, Num, Blocks);
+
+  if (TCP_SEQ_GT (SEQ (Ack), mTcb.SndUna)) {
+    mTcb.SndUna = SEQ (Ack);
+    mTcb.DupAck = 0;
+
+    if (mTcb.CongestState == TCP_CONGEST_RECOVER) {
+      if (TCP_SEQ_GEQ (SEQ (Ack), mTcb.Recover)) {
+        mTcb.CongestState = TCP_CONGEST_OPEN;
+      } else if (!TcpSackRetransmit (&mTcb, SEQ (Ack)) && TCP_SEQ_LEQ (mTcb.SackRxmtNxt, SEQ (Ack))) {
+        TcpRetransmit (&mTcb, SEQ (Ack));
+      }
+    }
+
+    return;
+  }
+
+  mTcb.DupAck++;
+
+  if (mTcb.CongestState == TCP_CONGEST_RECOVER) {
+    TcpSackRetransmit (&mTcb, mTcb.SndUna);
+  } else if (mTcb.DupAck == 3) {
+    mTcb.CongestState = TCP_CONGEST_RECOVER;
+    mTcb.Recover      = mTcb.SndNxt;
+    mTcb.SackRxmtNxt  = mTcb.SndUna;
+    if (!TcpSackRetransmit (&mTcb, mTcb.SndUna)) {
+      TcpRetransmit (&mTcb, mTcb.SndUna);
+    }
+  }
+}
+
+/**
+  Send 16 segments of 1000 bytes through the loopback link, dropping some of
+  them the first time they are sent, and run the link until it is empty.
+
+  @param[in]  Drop     Offsets of the segments dropped, in sequence order.
+  @param[in]  DropNum  The number of segments dropped.
+
+  @retval TRUE   All the data is delivered, and each segment dropped is
+                 retransmitted exactly once, in sequence order.
+  @retval FALSE  The transfer failed.
+
+**/
+BOOLEAN
+RunLoopback (
+  IN CONST UINT32  *Drop,
+  IN UINTN         DropNum
+  )
+{
+  UINT32  Blocks[2 * TCP_SACK_MAX_BLOCK];
+  UINT32  Seq;
+  UINT32  Ack;
+  UINT8   Num;
+  UINTN   Index;
+
+  mLoopback         = TRUE;
+  mTcb.CongestState = TCP_CONGEST_OPEN;
+
+  Index = 0;
+  for (Seq = 0; Seq < 16000; Seq += 1000) {
+    AddSegment (&mTcb.SndQue, Seq, Seq + 1000);
+    if ((Index < DropNum) && (Drop[Index] == Seq)) {
+      Index++;
+      continue;
+    }
+
+    LinkSend (Seq, Seq + 1000);
+  }
+
+  while (mLinkHead < mLinkTail) {
+    Ack = LoopbackReceive (mLinkSeq[mLinkHead], mLinkEnd[mLinkHead], Blocks, &Num);
+    mLinkHead++;
+    LoopbackAck (Ack, Num, Blocks);
+  }
+
+  if ((mTcb.RcvNxt != SEQ (16000)) || (mTcb.SndUna != SEQ (16000))) {
+    DEBUG ((DEBUG_ERROR, "%u bytes received, %u acknowledged\n", mTcb.RcvNxt - mBase, mTcb.SndUna - mBase));
+    return FALSE;
+  }
+
+  if (mTcb.CongestState != TCP_CONGEST_OPEN) {
+    DEBUG ((DEBUG_ERROR, "The recovery didn't end\n"));
+    return FALSE;
+  }
+
+  if (mRetransmitNumber != DropNum) {
+    DEBUG ((DEBUG_ERROR, "%d retransmissions, %d expected\n", mRetransmitNumber, DropNum));
+    return FALSE;
+  }
+
+  for (Index = 0; Index < DropNum; Index++) {
+    if (mRetransmitted[Index] != SEQ (Drop[Index])) {
+      DEBUG ((DEBUG_ERROR, "Retransmission %d at %u, %u expected\n", Index, mRetransmitted[Index] - mBase, Drop[Index]));
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  A burst of lost segments and a single lost segment further on are
+  retransmitted in one recovery, each once.
+
+  @param[in]  Context  The base of the sequence numbers of the test.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LoopbackBurstLoss (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT32  Drop[] = { 2000, 3000, 9000 };
+
+  UT_ASSERT_TRUE (RunLoopback (Drop, ARRAY_SIZE (Drop)));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Every other segment is lost, so there are more holes than the receiver
+  can report in one ACK. The scoreboard collects them over several ACKs,
+  and each is retransmitted once.
+
+  @param[in]  Context  The base of the sequence numbers of the test.
+
+  @retval  UNIT_TEST_PASSED             The test passed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LoopbackScatteredLoss (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT32  Drop[] = { 1000, 3000, 5000, 7000, 9000, 11000, 13000 };
+
+  UT_ASSERT_TRUE (RunLoopback (Drop, ARRAY_SIZE (Drop)));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  selective acknowledgment and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      SackTests;
+  UNIT_TEST_CONTEXT           Base;
+  UNIT_TEST_CONTEXT           WrapBase;
+
+  Framework = NULL;
+  Base      = (UNIT_TEST_CONTEXT)(UINTN)0x1000;
+  WrapBase  = (UNIT_TEST_CONTEXT)(UINTN)0xFFFFEC00;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the SACK Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&SackTests, Framework, "TCP SACK Tests", "TcpDxe.Sack", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for TCP SACK Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite---------Description------------------------------------Name-------------------Function--------------------Pre--------------Post--Context---
+  //
+  AddTestCase (SackTests, "Scoreboard merges SACK blocks", "SndMerge", SndSackMerge, SetupConnection, NULL, Base);
+  AddTestCase (SackTests, "Scoreboard merges SACK blocks across 0", "SndMergeWrap", SndSackMerge, SetupConnection, NULL, WrapBase);
+  AddTestCase (SackTests, "Scoreboard follows the cumulative ACK", "SndAck", SndSackAck, SetupConnection, NULL, Base);
+  AddTestCase (SackTests, "Scoreboard follows the cumulative ACK across 0", "SndAckWrap", SndSackAck, SetupConnection, NULL, WrapBase);
+  AddTestCase (SackTests, "Full scoreboard", "SndFull", SndSackFull, SetupConnection, NULL, Base);
+  AddTestCase (SackTests, "Full scoreboard across 0", "SndFullWrap", SndSackFull, SetupConnection, NULL, WrapBase);
+  AddTestCase (SackTests, "Holes are retransmitted", "SndRetransmit", SndSackRetransmit, SetupConnection, NULL, Base);
+  AddTestCase (SackTests, "Holes are retransmitted across 0", "SndRetransmitWrap", SndSackRetransmit, SetupConnection, NULL, WrapBase);
+  AddTestCase (SackTests, "Retransmissions stop at boundaries", "SndBoundary", SndSackRetransmitBoundary, SetupConnection, NULL, Base);
+  AddTestCase (SackTests, "Retransmissions stop at boundaries across 0", "SndBoundaryWrap", SndSackRetransmitBoundary, SetupConnection, NULL, WrapBase);
+  AddTestCase (SackTests, "Receiver reports recent blocks", "RcvBlocks", RcvSackBlocks, SetupConnection, NULL, Base);
+  AddTestCase (SackTests, "Receiver reports recent blocks across 0", "RcvBlocksWrap", RcvSackBlocks, SetupConnection, NULL, WrapBase);
+  AddTestCase (SackTests, "Loopback recovers a burst loss", "LoopbackBurst", LoopbackBurstLoss, SetupConnection, NULL, Base);
+  AddTestCase (SackTests, "Loopback recovers a burst loss across 0", "LoopbackBurstWrap", LoopbackBurstLoss, SetupConnection, NULL, WrapBase);
+  AddTestCase (SackTests, "Loopback recovers scattered losses", "LoopbackScattered", LoopbackScatteredLoss, SetupConnection, NULL, Base);
+  AddTestCase (SackTests, "Loopback recovers scattered losses across 0", "LoopbackScatteredWrap", LoopbackScatteredLoss, SetupConnection, NULL, WrapBase);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define TcpSackUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+TcpSackUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = UnitTestingEntry ();
+  return EFI_ERROR (Status) ? 1 : 0;
+}
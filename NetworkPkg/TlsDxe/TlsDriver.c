@@ -30,6 +30,10 @@ TlsCleanInstance (
       TlsFree (Instance->TlsConn);
     }
 
+    if (Instance->HostName != NULL) {
+      FreePool (Instance->HostName);
+    }
+
     FreePool (Instance);
   }
 }
@@ -86,6 +90,8 @@ TlsCleanService (
   )
 {
   if (Service != NULL) {
+    TlsFreeSessionCache (Service);
+
     if (Service->TlsCtx != NULL) {
       TlsCtxFree (Service->TlsCtx);
     }
@@ -132,6 +138,8 @@ TlsCreateService (
   TlsService->TlsChildrenNum = 0;
   InitializeListHead (&TlsService->TlsChildrenList);
   TlsService->ImageHandle = Image;
+  InitializeListHead (&TlsService->SessionCache);
+  TlsService->SessionCacheNum = 0;
 
   *Service = TlsService;
 
@@ -26,6 +26,11 @@
 
 #define TLS_INSTANCE_SIGNATURE  SIGNATURE_32 ('T', 'L', 'S', 'I')
 
+//
+// Maximum number of servers whose TLS session is kept for resumption.
+//
+#define TLS_SESSION_CACHE_MAX  8
+
 ///
 /// TLS Service Data
 ///
@@ -36,6 +41,18 @@ typedef struct _TLS_SERVICE TLS_SERVICE;
 ///
 typedef struct _TLS_INSTANCE TLS_INSTANCE;
 
+///
+/// TLS session kept for resumption by a later connection to the same server,
+/// verified the same way.
+///
+typedef struct {
+  LIST_ENTRY                  Link;
+  CHAR8                       *HostName;
+  EFI_TLS_VERIFY              VerifyMethod;
+  EFI_TLS_VERIFY_HOST_FLAG    VerifyHostFlags;
+  VOID                        *Session;
+} TLS_SESSION_CACHE_ENTRY;
+
 struct _TLS_SERVICE {
   UINT32                          Signature;
   EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
@@ -55,6 +72,13 @@ struct _TLS_SERVICE {
   // created for the connections.
   //
   VOID                            *TlsCtx;
+
+  //
+  // TLS sessions of recent servers, most recently used first, so that new
+  // connections to the same server can skip the full handshake.
+  //
+  LIST_ENTRY                      SessionCache;
+  UINTN                           SessionCacheNum;
 };
 
 struct _TLS_INSTANCE {
@@ -76,6 +100,14 @@ struct _TLS_INSTANCE {
   // per established connection.
   //
   VOID                              *TlsConn;
+
+  //
+  // The server host name and flags set by EfiTlsVerifyHost, used to look up
+  // the session cache, and whether the session of this connection is cached.
+  //
+  CHAR8                             *HostName;
+  EFI_TLS_VERIFY_HOST_FLAG          VerifyHostFlags;
+  BOOLEAN                           SessionCached;
 };
 
 #define TLS_SERVICE_FROM_THIS(a)   \
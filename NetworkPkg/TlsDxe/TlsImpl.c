@@ -319,6 +319,11 @@ TlsDecryptPacket (
   FreePool (BufferIn);
   BufferIn = NULL;
 
+  //
+  // The session ticket of TLS 1.3 arrives with the application data.
+  //
+  TlsCacheSession (TlsInstance);
+
   //
   // The caller will be responsible to handle the original fragment table
   //
@@ -348,3 +353,201 @@ ERROR:
 
   return Status;
 }
+
+/**
+  Find the session cached for the server of the TLS instance, verified the
+  same way as the TLS instance verifies it.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+  @return The cache entry of the session, or NULL if there is none, or if the
+          TLS instance doesn't verify the server.
+
+**/
+STATIC
+TLS_SESSION_CACHE_ENTRY *
+TlsFindCachedSession (
+  IN TLS_INSTANCE  *TlsInstance
+  )
+{
+  LIST_ENTRY               *Entry;
+  TLS_SESSION_CACHE_ENTRY  *CacheEntry;
+  EFI_TLS_VERIFY           VerifyMethod;
+
+  VerifyMethod = TlsGetVerify (TlsInstance->TlsConn);
+  if ((TlsInstance->HostName == NULL) || ((VerifyMethod & EFI_TLS_VERIFY_PEER) == 0)) {
+    return NULL;
+  }
+
+  NET_LIST_FOR_EACH (Entry, &TlsInstance->Service->SessionCache) {
+    CacheEntry = NET_LIST_USER_STRUCT (Entry, TLS_SESSION_CACHE_ENTRY, Link);
+    if ((CacheEntry->VerifyMethod == VerifyMethod) &&
+        (CacheEntry->VerifyHostFlags == TlsInstance->VerifyHostFlags) &&
+        (AsciiStrCmp (CacheEntry->HostName, TlsInstance->HostName) == 0))
+    {
+      return CacheEntry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Offer the session cached for the server of the TLS instance for resumption,
+  so that the connection can skip the full handshake if the server agrees.
+
+  The session is taken out of the cache, so that it is offered by a single
+  connection. TLS 1.3 session tickets are meant to be used only once.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsResumeSession (
+  IN TLS_INSTANCE  *TlsInstance
+  )
+{
+  TLS_SERVICE              *Service;
+  TLS_SESSION_CACHE_ENTRY  *CacheEntry;
+  EFI_STATUS               Status;
+
+  Service    = TlsInstance->Service;
+  CacheEntry = TlsFindCachedSession (TlsInstance);
+  if (CacheEntry == NULL) {
+    return;
+  }
+
+  RemoveEntryList (&CacheEntry->Link);
+  Service->SessionCacheNum--;
+
+  //
+  // The TLS object takes its own reference to the session.
+  //
+  Status = TlsSetSession (TlsInstance->TlsConn, CacheEntry->Session);
+  DEBUG ((
+    DEBUG_INFO,
+    "TlsResumeSession: Resume session with %a - %r\n",
+    TlsInstance->HostName,
+    Status
+    ));
+
+  TlsSessionFree (CacheEntry->Session);
+  FreePool (CacheEntry->HostName);
+  FreePool (CacheEntry);
+}
+
+/**
+  Save the session negotiated by the TLS instance in the session cache of the
+  TLS service, replacing the one cached for the same server if any.
+
+  Only sessions whose server certificate was verified are cached. They are
+  looked up by the host name, the verify method and the host name check flags,
+  so that they are never resumed by a connection that would verify the server
+  differently.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsCacheSession (
+  IN TLS_INSTANCE  *TlsInstance
+  )
+{
+  TLS_SERVICE              *Service;
+  TLS_SESSION_CACHE_ENTRY  *CacheEntry;
+  EFI_TLS_VERIFY           VerifyMethod;
+  VOID                     *Session;
+  EFI_STATUS               Status;
+
+  //
+  // The peer is verified without a verify callback, so a handshake with
+  // EFI_TLS_VERIFY_PEER only completes if the server certificate verified
+  // (X509_V_OK). Sessions of unverified servers are not cached.
+  //
+  VerifyMethod = TlsGetVerify (TlsInstance->TlsConn);
+  if ((TlsInstance->HostName == NULL) || ((VerifyMethod & EFI_TLS_VERIFY_PEER) == 0) ||
+      TlsInstance->SessionCached)
+  {
+    return;
+  }
+
+  //
+  // A TLS 1.3 server sends the session ticket after the handshake, so the
+  // session may not be resumable yet.
+  //
+  Status = TlsGetSession (TlsInstance->TlsConn, &Session);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  TlsInstance->SessionCached = TRUE;
+  Service                    = TlsInstance->Service;
+
+  CacheEntry = TlsFindCachedSession (TlsInstance);
+  if (CacheEntry != NULL) {
+    TlsSessionFree (CacheEntry->Session);
+    CacheEntry->Session = Session;
+    RemoveEntryList (&CacheEntry->Link);
+    InsertHeadList (&Service->SessionCache, &CacheEntry->Link);
+    return;
+  }
+
+  CacheEntry = AllocateZeroPool (sizeof (TLS_SESSION_CACHE_ENTRY));
+  if (CacheEntry == NULL) {
+    TlsSessionFree (Session);
+    return;
+  }
+
+  CacheEntry->HostName = AllocateCopyPool (AsciiStrSize (TlsInstance->HostName), TlsInstance->HostName);
+  if (CacheEntry->HostName == NULL) {
+    FreePool (CacheEntry);
+    TlsSessionFree (Session);
+    return;
+  }
+
+  CacheEntry->VerifyMethod    = VerifyMethod;
+  CacheEntry->VerifyHostFlags = TlsInstance->VerifyHostFlags;
+  CacheEntry->Session         = Session;
+  InsertHeadList (&Service->SessionCache, &CacheEntry->Link);
+  Service->SessionCacheNum++;
+
+  //
+  // Drop the session of the least recently used server.
+  //
+  if (Service->SessionCacheNum > TLS_SESSION_CACHE_MAX) {
+    CacheEntry = NET_LIST_TAIL (&Service->SessionCache, TLS_SESSION_CACHE_ENTRY, Link);
+    RemoveEntryList (&CacheEntry->Link);
+    Service->SessionCacheNum--;
+
+    TlsSessionFree (CacheEntry->Session);
+    FreePool (CacheEntry->HostName);
+    FreePool (CacheEntry);
+  }
+}
+
+/**
+  Release all the sessions kept in the session cache of the TLS service.
+
+  @param[in]  Service        The TLS service data.
+
+**/
+VOID
+TlsFreeSessionCache (
+  IN TLS_SERVICE  *Service
+  )
+{
+  LIST_ENTRY               *Entry;
+  LIST_ENTRY               *NextEntry;
+  TLS_SESSION_CACHE_ENTRY  *CacheEntry;
+
+  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &Service->SessionCache) {
+    CacheEntry = NET_LIST_USER_STRUCT (Entry, TLS_SESSION_CACHE_ENTRY, Link);
+    RemoveEntryList (&CacheEntry->Link);
+
+    TlsSessionFree (CacheEntry->Session);
+    FreePool (CacheEntry->HostName);
+    FreePool (CacheEntry);
+  }
+
+  Service->SessionCacheNum = 0;
+}
@@ -86,6 +86,49 @@ TlsDecryptPacket (
   IN     UINT32                 *FragmentCount
   );
 
+/**
+  Offer the session cached for the server of the TLS instance for resumption,
+  so that the connection can skip the full handshake if the server agrees.
+
+  The session is taken out of the cache, so that it is offered by a single
+  connection. TLS 1.3 session tickets are meant to be used only once.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsResumeSession (
+  IN TLS_INSTANCE  *TlsInstance
+  );
+
+/**
+  Save the session negotiated by the TLS instance in the session cache of the
+  TLS service, replacing the one cached for the same server if any.
+
+  Only sessions whose server certificate was verified are cached. They are
+  looked up by the host name, the verify method and the host name check flags,
+  so that they are never resumed by a connection that would verify the server
+  differently.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsCacheSession (
+  IN TLS_INSTANCE  *TlsInstance
+  );
+
+/**
+  Release all the sessions kept in the session cache of the TLS service.
+
+  @param[in]  Service        The TLS service data.
+
+**/
+VOID
+TlsFreeSessionCache (
+  IN TLS_SERVICE  *Service
+  );
+
 /**
   Set TLS session data.
 
@@ -187,7 +187,24 @@ TlsSetSessionData (
       }
 
       Status = TlsSetVerifyHost (Instance->TlsConn, TlsVerifyHost->Flags, TlsVerifyHost->HostName);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      //
+      // Sessions are only resumed with the server they were verified for.
+      //
+      if (Instance->HostName != NULL) {
+        FreePool (Instance->HostName);
+      }
+
+      Instance->HostName = AllocateCopyPool (AsciiStrSize (TlsVerifyHost->HostName), TlsVerifyHost->HostName);
+      if (Instance->HostName == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto ON_EXIT;
+      }
 
+      Instance->VerifyHostFlags = TlsVerifyHost->Flags;
       break;
     case EfiTlsSessionID:
       if (DataSize != sizeof (EFI_TLS_SESSION_ID)) {
@@ -485,8 +502,11 @@ TlsBuildResponsePacket (
     switch (Instance->TlsSessionState) {
       case EfiTlsSessionNotStarted:
         //
-        // ClientHello.
+        // ClientHello, offering the session of the last connection to the
+        // same server for resumption.
         //
+        TlsResumeSession (Instance);
+
         Status = TlsDoHandshake (
                    Instance->TlsConn,
                    NULL,
@@ -575,6 +595,7 @@ TlsBuildResponsePacket (
 
       if (!TlsInHandshake (Instance->TlsConn)) {
         Instance->TlsSessionState = EfiTlsSessionDataTransferring;
+        TlsCacheSession (Instance);
       }
     } else {
       //
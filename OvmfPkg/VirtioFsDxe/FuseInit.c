@@ -25,7 +25,10 @@
                            "VirtioFs->RequestId" is set to 1 on output. The
                            maximum write buffer size exposed in the FUSE_INIT
                            response is saved in "VirtioFs->MaxWrite", on
-                           output.
+                           output. The negotiated read-ahead buffer size is
+                           saved in "VirtioFs->ReadAhead", and the
+                           modification counter "VirtioFs->ModCount" is reset,
+                           on output.
 
   @retval EFI_SUCCESS      The FUSE session has been started.
 
@@ -60,6 +63,7 @@ VirtioFsFuseInitSession (
   // Initialize the FUSE request counter.
   //
   VirtioFs->RequestId = 1;
+  VirtioFs->ModCount  = 0;
 
   //
   // Set up the scatter-gather lists.
@@ -105,7 +109,7 @@ VirtioFsFuseInitSession (
   //
   InitReq.Major        = VIRTIO_FS_FUSE_MAJOR;
   InitReq.Minor        = VIRTIO_FS_FUSE_MINOR;
-  InitReq.MaxReadahead = 0;
+  InitReq.MaxReadahead = VIRTIO_FS_MAX_READAHEAD;
   InitReq.Flags        = VIRTIO_FS_FUSE_INIT_REQ_F_DO_READDIRPLUS;
 
   //
@@ -150,5 +154,16 @@ VirtioFsFuseInitSession (
   // Save the maximum write buffer size for FUSE_WRITE requests.
   //
   VirtioFs->MaxWrite = InitResp.MaxWrite;
+
+  //
+  // Save the read-ahead buffer size for regular files. The device may only
+  // lower the size that we asked for; treat anything below one page as a
+  // request to disable read-ahead.
+  //
+  VirtioFs->ReadAhead = MIN (InitResp.MaxReadahead, InitReq.MaxReadahead);
+  if (VirtioFs->ReadAhead < SIZE_4KB) {
+    VirtioFs->ReadAhead = 0;
+  }
+
   return EFI_SUCCESS;
 }
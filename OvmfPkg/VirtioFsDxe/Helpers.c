@@ -755,6 +755,10 @@ Unmap:
 /**
   Set up the fields of a new VIRTIO_FS_FUSE_REQUEST object.
 
+  If Opcode identifies a request that may modify the filesystem, then
+  "VirtioFs->ModCount" is incremented as well, invalidating the data that open
+  files have cached.
+
   The function may only be called after VirtioFsInit() returns successfully and
   before VirtioFsUninit() is called.
 
@@ -812,6 +816,20 @@ VirtioFsFuseNewRequest (
   Request->Pid     = 1;
   Request->Padding = 0;
 
+  switch (Opcode) {
+    case VirtioFsFuseOpSetAttr:
+    case VirtioFsFuseOpMkDir:
+    case VirtioFsFuseOpUnlink:
+    case VirtioFsFuseOpRmDir:
+    case VirtioFsFuseOpWrite:
+    case VirtioFsFuseOpCreate:
+    case VirtioFsFuseOpRename2:
+      VirtioFs->ModCount++;
+      break;
+    default:
+      break;
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -82,6 +82,13 @@ VirtioFsOpenVolume (
   VirtioFsFile->SingleFileInfoSize     = 0;
   VirtioFsFile->NumFileInfo            = 0;
   VirtioFsFile->NextFileInfo           = 0;
+  VirtioFsFile->FileInfoCookie         = 0;
+  VirtioFsFile->FileInfoModCount       = 0;
+  VirtioFsFile->FileNameLen            = 0;
+  VirtioFsFile->ReadAheadBuffer        = NULL;
+  VirtioFsFile->ReadAheadOffset        = 0;
+  VirtioFsFile->ReadAheadSize          = 0;
+  VirtioFsFile->ReadAheadModCount      = 0;
 
   //
   // One more file open for the filesystem.
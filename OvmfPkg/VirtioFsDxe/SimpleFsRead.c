@@ -62,6 +62,9 @@ PopulateFileInfo (
 
 /**
   Refill the EFI_FILE_INFO cache from the directory stream.
+
+  The maximum filename length of the filesystem is queried with FUSE_STATFS
+  only on the first refill, and remembered in "VirtioFsFile->FileNameLen".
 **/
 STATIC
 EFI_STATUS
@@ -72,6 +75,7 @@ RefillFileInfoCache (
   VIRTIO_FS                       *VirtioFs;
   EFI_STATUS                      Status;
   VIRTIO_FS_FUSE_STATFS_RESPONSE  FilesysAttr;
+  UINT32                          Namelen;
   UINT32                          DirentBufSize;
   UINT8                           *DirentBuf;
   UINTN                           SingleFileInfoSize;
@@ -88,18 +92,23 @@ RefillFileInfoCache (
   // check.
   //
   VirtioFs = VirtioFsFile->OwnerFs;
-  Status   = VirtioFsFuseStatFs (VirtioFs, VirtioFsFile->NodeId, &FilesysAttr);
-  if (EFI_ERROR (Status)) {
-    return Status;
+  Namelen  = VirtioFsFile->FileNameLen;
+  if (Namelen == 0) {
+    Status = VirtioFsFuseStatFs (VirtioFs, VirtioFsFile->NodeId, &FilesysAttr);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Namelen = FilesysAttr.Namelen;
   }
 
-  DirentBufSize = (UINT32)VIRTIO_FS_FUSE_DIRENTPLUS_RESPONSE_SIZE (
-                            FilesysAttr.Namelen
-                            );
+  DirentBufSize = (UINT32)VIRTIO_FS_FUSE_DIRENTPLUS_RESPONSE_SIZE (Namelen);
   if (DirentBufSize == 0) {
     return EFI_UNSUPPORTED;
   }
 
+  VirtioFsFile->FileNameLen = Namelen;
+
   DirentBufSize *= VIRTIO_FS_FILE_MAX_FILE_INFO;
   DirentBuf      = AllocatePool (DirentBufSize);
   if (DirentBuf == NULL) {
@@ -116,7 +125,7 @@ RefillFileInfoCache (
   // account.
   //
   SingleFileInfoSize = (OFFSET_OF (EFI_FILE_INFO, FileName) +
-                        ((UINTN)FilesysAttr.Namelen + 1) * sizeof (CHAR16));
+                        ((UINTN)Namelen + 1) * sizeof (CHAR16));
   FileInfoArray = AllocatePool (
                     VIRTIO_FS_FILE_MAX_FILE_INFO * SingleFileInfoSize
                     );
@@ -181,7 +190,7 @@ RefillFileInfoCache (
         // This means one of two things: (a) Dirent->Namelen is zero, or (b)
         // (b) Dirent->Namelen is unsupportably large. (a) is just invalid for
         // the Virtio Filesystem device to send, while (b) shouldn't happen
-        // because "FilesysAttr.Namelen" -- the maximum filename length
+        // because "Namelen" -- the maximum filename length
         // supported by the filesystem -- proved acceptable above.
         //
         Status = EFI_PROTOCOL_ERROR;
@@ -198,7 +207,7 @@ RefillFileInfoCache (
         goto FreeFileInfoArray;
       }
 
-      if (Dirent->Namelen > FilesysAttr.Namelen) {
+      if (Dirent->Namelen > Namelen) {
         //
         // This is possible without tripping the truncation check above, due to
         // how entries are padded. The condition means that Dirent->Namelen is
@@ -283,6 +292,8 @@ RefillFileInfoCache (
   VirtioFsFile->SingleFileInfoSize = SingleFileInfoSize;
   VirtioFsFile->NumFileInfo        = NumFileInfo;
   VirtioFsFile->NextFileInfo       = 0;
+  VirtioFsFile->FileInfoCookie     = VirtioFsFile->FilePosition;
+  VirtioFsFile->FileInfoModCount   = VirtioFs->ModCount;
   VirtioFsFile->FilePosition       = CacheEndsAtCookie;
 
   FreePool (DirentBuf);
@@ -345,7 +356,7 @@ ReadFileInfoCache (
   //       VirtioFsFuseDirentPlusToEfiFileInfo()
   //
   // and VirtioFsFile->SingleFileInfoSize was computed from
-  // FilesysAttr.Namelen, which had been accepted by
+  // VirtioFsFile->FileNameLen, which had been accepted by
   // VIRTIO_FS_FUSE_DIRENTPLUS_RESPONSE_SIZE().)
   //
   CallerAllocated = *BufferSize;
@@ -362,8 +373,113 @@ ReadFileInfoCache (
   return EFI_SUCCESS;
 }
 
+/**
+  Copy data from the read-ahead buffer of a regular file.
+
+  @param[in] VirtioFsFile  The regular file to read from.
+
+  @param[in] Position      The file offset to copy data from.
+
+  @param[in] Size          The number of bytes requested.
+
+  @param[out] Buffer       The buffer to copy the data to.
+
+  @return  The number of bytes copied to Buffer. Zero if the read-ahead buffer
+           is stale, or it does not cover Position.
+**/
+STATIC
+UINTN
+CopyFromReadAhead (
+  IN     VIRTIO_FS_FILE  *VirtioFsFile,
+  IN     UINT64          Position,
+  IN     UINTN           Size,
+  OUT VOID               *Buffer
+  )
+{
+  UINT64  Start;
+  UINTN   Copied;
+
+  if ((VirtioFsFile->ReadAheadSize == 0) ||
+      (VirtioFsFile->ReadAheadModCount != VirtioFsFile->OwnerFs->ModCount) ||
+      (Position < VirtioFsFile->ReadAheadOffset) ||
+      (Position - VirtioFsFile->ReadAheadOffset >= VirtioFsFile->ReadAheadSize))
+  {
+    return 0;
+  }
+
+  Start  = Position - VirtioFsFile->ReadAheadOffset;
+  Copied = MIN (Size, (UINTN)(VirtioFsFile->ReadAheadSize - Start));
+  CopyMem (Buffer, VirtioFsFile->ReadAheadBuffer + Start, Copied);
+  return Copied;
+}
+
+/**
+  Fill the read-ahead buffer of a regular file with a single FUSE_READ request.
+
+  @param[in,out] VirtioFsFile  The regular file to read from. On success,
+                               ReadAheadOffset, ReadAheadSize and
+                               ReadAheadModCount are updated. ReadAheadSize
+                               is smaller than "OwnerFs->ReadAhead" if the
+                               file ends within the buffer.
+
+  @param[in] Position          The file offset to read from.
+
+  @retval EFI_SUCCESS           The read-ahead buffer has been filled.
+
+  @retval EFI_OUT_OF_RESOURCES  The read-ahead buffer could not be allocated.
+
+  @return                       Error codes propagated from
+                                VirtioFsFuseReadFileOrDir(). The read-ahead
+                                buffer is empty.
+**/
+STATIC
+EFI_STATUS
+FillReadAhead (
+  IN OUT VIRTIO_FS_FILE  *VirtioFsFile,
+  IN     UINT64          Position
+  )
+{
+  VIRTIO_FS   *VirtioFs;
+  EFI_STATUS  Status;
+  UINT32      ReadSize;
+
+  VirtioFs = VirtioFsFile->OwnerFs;
+  if (VirtioFsFile->ReadAheadBuffer == NULL) {
+    VirtioFsFile->ReadAheadBuffer = AllocatePool (VirtioFs->ReadAhead);
+    if (VirtioFsFile->ReadAheadBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  VirtioFsFile->ReadAheadSize = 0;
+
+  ReadSize = VirtioFs->ReadAhead;
+  Status   = VirtioFsFuseReadFileOrDir (
+               VirtioFs,
+               VirtioFsFile->NodeId,
+               VirtioFsFile->FuseHandle,
+               FALSE,                        // IsDir
+               Position,                     // Offset
+               &ReadSize,                    // Size
+               VirtioFsFile->ReadAheadBuffer // Data
+               );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  VirtioFsFile->ReadAheadOffset   = Position;
+  VirtioFsFile->ReadAheadSize     = ReadSize;
+  VirtioFsFile->ReadAheadModCount = VirtioFs->ModCount;
+  return EFI_SUCCESS;
+}
+
 /**
   Read from a regular file.
+
+  Requests smaller than the negotiated read-ahead size are served from the
+  read-ahead buffer of the file, so that a series of small sequential reads
+  costs one FUSE_READ per "VirtioFs->ReadAhead" bytes. Larger requests are
+  read directly into the caller's buffer.
 **/
 STATIC
 EFI_STATUS
@@ -380,17 +496,51 @@ ReadRegularFile (
   UINTN                               Left;
 
   VirtioFs = VirtioFsFile->OwnerFs;
+
   //
-  // The UEFI spec forbids reads that start beyond the end of the file.
+  // Serve the head of the request from the read-ahead buffer, if possible.
+  // The file position is then known to be within the file.
   //
-  Status = VirtioFsFuseGetAttr (VirtioFs, VirtioFsFile->NodeId, &FuseAttr);
-  if (EFI_ERROR (Status) || (VirtioFsFile->FilePosition > FuseAttr.Size)) {
-    return EFI_DEVICE_ERROR;
+  Transferred = CopyFromReadAhead (
+                  VirtioFsFile,
+                  VirtioFsFile->FilePosition,
+                  *BufferSize,
+                  Buffer
+                  );
+  Left = *BufferSize - Transferred;
+  if (Transferred == 0) {
+    //
+    // The UEFI spec forbids reads that start beyond the end of the file.
+    //
+    Status = VirtioFsFuseGetAttr (VirtioFs, VirtioFsFile->NodeId, &FuseAttr);
+    if (EFI_ERROR (Status) || (VirtioFsFile->FilePosition > FuseAttr.Size)) {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  Status = EFI_SUCCESS;
+  if ((Left > 0) && (Left < VirtioFs->ReadAhead)) {
+    //
+    // Fill the read-ahead buffer from where the data copied above ends, and
+    // serve the rest of the request from it. If that doesn't satisfy the
+    // request, then the file ends within the buffer.
+    //
+    Status = FillReadAhead (
+               VirtioFsFile,
+               VirtioFsFile->FilePosition + Transferred
+               );
+    if (!EFI_ERROR (Status)) {
+      Transferred += CopyFromReadAhead (
+                       VirtioFsFile,
+                       VirtioFsFile->FilePosition + Transferred,
+                       Left,
+                       (UINT8 *)Buffer + Transferred
+                       );
+    }
+
+    Left = 0;
   }
 
-  Status      = EFI_SUCCESS;
-  Transferred = 0;
-  Left        = *BufferSize;
   while (Left > 0) {
     UINT32  ReadSize;
 
@@ -33,6 +33,19 @@ VirtioFsSimpleFileSetPosition (
       return EFI_UNSUPPORTED;
     }
 
+    //
+    // If the EFI_FILE_INFO cache is a current snapshot of the head of the
+    // directory, then replay it, rather than reading the directory stream
+    // again.
+    //
+    if ((VirtioFsFile->FileInfoArray != NULL) &&
+        (VirtioFsFile->FileInfoCookie == 0) &&
+        (VirtioFsFile->FileInfoModCount == VirtioFsFile->OwnerFs->ModCount))
+    {
+      VirtioFsFile->NextFileInfo = 0;
+      return EFI_SUCCESS;
+    }
+
     VirtioFsFile->FilePosition = 0;
     if (VirtioFsFile->FileInfoArray != NULL) {
       FreePool (VirtioFsFile->FileInfoArray);
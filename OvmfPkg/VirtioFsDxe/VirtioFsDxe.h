@@ -52,6 +52,13 @@
 //
 #define VIRTIO_FS_FILE_MAX_FILE_INFO  256
 
+//
+// Size of the read-ahead buffer that we ask for in FUSE_INIT, for regular
+// files. The Virtio Filesystem device may lower it, or disable read-ahead
+// altogether by responding with zero.
+//
+#define VIRTIO_FS_MAX_READAHEAD  SIZE_128KB
+
 //
 // Filesystem label encoded in UCS-2, transformed from the UTF-8 representation
 // in "VIRTIO_FS_CONFIG.Tag", and NUL-terminated. Only the printable ASCII code
@@ -79,6 +86,8 @@ typedef struct {
   VOID                               *RingMap;  // VirtioRingMap       2
   UINT64                             RequestId; // FuseInitSession     1
   UINT32                             MaxWrite;  // FuseInitSession     1
+  UINT32                             ReadAhead; // FuseInitSession     1
+  UINT64                             ModCount;  // FuseInitSession     1
   EFI_EVENT                          ExitBoot;  // DriverBindingStart  0
   LIST_ENTRY                         OpenFiles; // DriverBindingStart  0
   EFI_SIMPLE_FILE_SYSTEM_PROTOCOL    SimpleFs;  // DriverBindingStart  0
@@ -174,6 +183,28 @@ typedef struct {
   UINTN    SingleFileInfoSize;
   UINTN    NumFileInfo;
   UINTN    NextFileInfo;
+  //
+  // Bookkeeping for reusing the above EFI_FILE_INFO cache. FileInfoCookie is
+  // the directory stream position where the cache starts; if it is zero, and
+  // no modifying FUSE request has been sent since the cache was filled
+  // (FileInfoModCount equals "OwnerFs->ModCount"), then the cache is a
+  // snapshot of the head of the directory, and rewinding the directory need
+  // not send FUSE_READDIRPLUS again. FileNameLen is the maximum filename
+  // length reported by FUSE_STATFS, or zero if not yet known.
+  //
+  UINT64    FileInfoCookie;
+  UINT64    FileInfoModCount;
+  UINT32    FileNameLen;
+  //
+  // Read-ahead buffer of a regular file, allocated at the first read, and
+  // holding "OwnerFs->ReadAhead" bytes at most. ReadAheadSize bytes from file
+  // offset ReadAheadOffset are valid in it for as long as "OwnerFs->ModCount"
+  // equals ReadAheadModCount.
+  //
+  UINT8     *ReadAheadBuffer;
+  UINT64    ReadAheadOffset;
+  UINT32    ReadAheadSize;
+  UINT64    ReadAheadModCount;
 } VIRTIO_FS_FILE;
 
 #define VIRTIO_FS_FILE_FROM_SIMPLE_FILE(SimpleFileReference) \
@@ -214,9 +214,10 @@ VirtioNetInitTx (
 
   //
   // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
-  // VIRTIO_NET_F_MRG_RXBUF, which we never negotiate.
+  // VIRTIO_NET_F_MRG_RXBUF, in both directions.
   //
-  TxSharedReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) ?
+  TxSharedReqSize = ((Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) &&
+                     !Dev->RxMergeBufs) ?
                     sizeof (Dev->TxSharedReq->V0_9_5) :
                     sizeof *Dev->TxSharedReq;
 
@@ -294,7 +295,7 @@ FreeTxFreeStack:
     packet data into,
   - select polling over RX interrupt,
   - fully populate the RX queue with a static pattern of virtio descriptor
-    chains.
+    chains, or of single descriptors with VIRTIO_NET_F_MRG_RXBUF.
 
   @param[in,out] Dev       The VNET_DEV driver instance about to enter the
                            EfiSimpleNetworkInitialized state.
@@ -324,9 +325,10 @@ VirtioNetInitRx (
 
   //
   // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
-  // VIRTIO_NET_F_MRG_RXBUF, which we never negotiate.
+  // VIRTIO_NET_F_MRG_RXBUF.
   //
-  VirtioNetReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) ?
+  VirtioNetReqSize = ((Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) &&
+                      !Dev->RxMergeBufs) ?
                      sizeof (VIRTIO_NET_REQ) :
                      sizeof (VIRTIO_1_0_NET_REQ);
 
@@ -336,14 +338,24 @@ VirtioNetInitRx (
   // - the recipient for the network data (which consists of Ethernet header
   //   and Ethernet payload).
   //
+  // With VIRTIO_NET_F_MRG_RXBUF, the host writes the virtio-net request
+  // header at the start of the first buffer of the packet, so a single
+  // descriptor covers both.
+  //
   RxBufSize = VirtioNetReqSize +
               (Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize);
 
   //
-  // Limit the number of pending RX packets if the queue is big. The division
-  // by two is due to the above "two descriptors per packet" trait.
+  // Limit the number of pending RX buffers if the queue is big. Without
+  // mergeable RX buffers the division by two is due to the above "two
+  // descriptors per packet" trait; with them, the same number of descriptors
+  // holds twice as many buffers.
   //
-  RxAlwaysPending = (UINT16)MIN (Dev->RxRing.QueueSize / 2, VNET_MAX_PENDING);
+  if (Dev->RxMergeBufs) {
+    RxAlwaysPending = (UINT16)MIN (Dev->RxRing.QueueSize, 2 * VNET_MAX_PENDING);
+  } else {
+    RxAlwaysPending = (UINT16)MIN (Dev->RxRing.QueueSize / 2, VNET_MAX_PENDING);
+  }
 
   //
   // The RxBuf is shared between guest and hypervisor, use
@@ -384,6 +396,9 @@ VirtioNetInitRx (
   MemoryFence ();
   Dev->RxLastUsed = *Dev->RxRing.Used.Idx;
   ASSERT (Dev->RxLastUsed == 0);
+  Dev->RxCurUsed  = Dev->RxLastUsed;
+  Dev->RxBufCount = RxAlwaysPending;
+  Dev->RxAvailIdx = RxAlwaysPending;
 
   //
   // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device:
@@ -405,6 +420,18 @@ VirtioNetInitRx (
     //
     Dev->RxRing.Avail.Ring[PktIdx] = DescIdx;
 
+    if (Dev->RxMergeBufs) {
+      //
+      // virtio-1.0, 5.1.6.3 Setting Up Receive Buffers: a single descriptor
+      // receives the virtio-net request header and the packet data
+      //
+      Dev->RxRing.Desc[DescIdx].Addr  = RxBufDeviceAddress;
+      Dev->RxRing.Desc[DescIdx].Len   = (UINT32)RxBufSize;
+      Dev->RxRing.Desc[DescIdx].Flags = VRING_DESC_F_WRITE;
+      RxBufDeviceAddress             += Dev->RxRing.Desc[DescIdx++].Len;
+      continue;
+    }
+
     //
     // virtio-0.9.5, 2.4.1.1 Placing Buffers into the Descriptor Table
     //
@@ -557,8 +584,10 @@ VirtioNetInitialize (
     !!(Features & VIRTIO_NET_F_STATUS)
     );
 
-  Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS | VIRTIO_F_VERSION_1 |
-              VIRTIO_F_IOMMU_PLATFORM;
+  Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS | VIRTIO_NET_F_MRG_RXBUF |
+              VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM;
+
+  Dev->RxMergeBufs = (BOOLEAN)((Features & VIRTIO_NET_F_MRG_RXBUF) != 0);
 
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
@@ -64,18 +64,22 @@ VirtioNetReceive (
   OUT UINT16                      *Protocol   OPTIONAL
   )
 {
-  VNET_DEV    *Dev;
-  EFI_TPL     OldTpl;
-  EFI_STATUS  Status;
-  UINT16      RxCurUsed;
-  UINT16      UsedElemIdx;
-  UINT32      DescIdx;
-  UINT32      RxLen;
-  UINTN       OrigBufferSize;
-  UINT8       *RxPtr;
-  UINT16      AvailIdx;
-  EFI_STATUS  NotifyStatus;
-  UINTN       RxBufOffset;
+  VNET_DEV            *Dev;
+  EFI_TPL             OldTpl;
+  EFI_STATUS          Status;
+  UINT16              UsedElemIdx;
+  UINT32              DescIdx;
+  UINT32              DataDescIdx;
+  UINT32              HeaderLen;
+  UINT16              NumBuffers;
+  UINT16              BufIdx;
+  UINT32              ChunkLen;
+  UINT32              RxLen;
+  UINTN               OrigBufferSize;
+  UINTN               Offset;
+  UINT8               *RxPtr;
+  VIRTIO_1_0_NET_REQ  *RxReq;
+  EFI_STATUS          NotifyStatus;
 
   if ((This == NULL) || (BufferSize == NULL) || (Buffer == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -97,28 +101,72 @@ VirtioNetReceive (
   //
   // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
   //
-  MemoryFence ();
-  RxCurUsed = *Dev->RxRing.Used.Idx;
-  MemoryFence ();
+  // The Used Ring index is only read again once all the Used Ring Elements
+  // seen at the previous read have been processed, so that a burst of packets
+  // is drained with a single access to the shared index.
+  //
+  if (Dev->RxLastUsed == Dev->RxCurUsed) {
+    MemoryFence ();
+    Dev->RxCurUsed = *Dev->RxRing.Used.Idx;
+    MemoryFence ();
 
-  if (Dev->RxLastUsed == RxCurUsed) {
-    Status = EFI_NOT_READY;
-    goto Exit;
+    if (Dev->RxLastUsed == Dev->RxCurUsed) {
+      Status = EFI_NOT_READY;
+      goto Exit;
+    }
   }
 
   UsedElemIdx = Dev->RxLastUsed % Dev->RxRing.QueueSize;
   DescIdx     = Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
   RxLen       = Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+  NumBuffers  = 1;
+
+  if (Dev->RxMergeBufs) {
+    //
+    // virtio-1.0, 5.1.6.4 Processing of Incoming Packets: the virtio-net
+    // request header is at the start of the first buffer, and NumBuffers
+    // tells how many buffers (Used Ring Elements) the packet spans.
+    //
+    HeaderLen = sizeof (VIRTIO_1_0_NET_REQ);
+    ASSERT (RxLen >= HeaderLen);
+    RxReq = (VIRTIO_1_0_NET_REQ *)(Dev->RxBuf +
+                                   (UINTN)(Dev->RxRing.Desc[DescIdx].Addr -
+                                           Dev->RxBufDeviceBase));
+    if ((RxReq->NumBuffers == 0) || (RxReq->NumBuffers > Dev->RxBufCount)) {
+      Status = EFI_DEVICE_ERROR;
+      goto RecycleDesc; // drop the buffer, we can't tell the packet's extent
+    }
+
+    NumBuffers = RxReq->NumBuffers;
+
+    //
+    // The host updates the Used Ring index only after it has placed all the
+    // buffers of the packet, but our copy of the index may predate that.
+    //
+    if ((UINT16)(Dev->RxCurUsed - Dev->RxLastUsed) < NumBuffers) {
+      MemoryFence ();
+      Dev->RxCurUsed = *Dev->RxRing.Used.Idx;
+      MemoryFence ();
+
+      if ((UINT16)(Dev->RxCurUsed - Dev->RxLastUsed) < NumBuffers) {
+        Status = EFI_NOT_READY;
+        goto Exit;
+      }
+    }
+
+    for (BufIdx = 1; BufIdx < NumBuffers; ++BufIdx) {
+      UsedElemIdx = (UINT16)(Dev->RxLastUsed + BufIdx) % Dev->RxRing.QueueSize;
+      RxLen      += Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+    }
+  } else {
+    //
+    // the virtio-net request header must be complete; we skip it
+    //
+    HeaderLen = Dev->RxRing.Desc[DescIdx].Len;
+    ASSERT (RxLen >= HeaderLen);
+  }
 
-  //
-  // the virtio-net request header must be complete; we skip it
-  //
-  ASSERT (RxLen >= Dev->RxRing.Desc[DescIdx].Len);
-  RxLen -= Dev->RxRing.Desc[DescIdx].Len;
-  //
-  // the host must not have filled in more data than requested
-  //
-  ASSERT (RxLen <= Dev->RxRing.Desc[DescIdx + 1].Len);
+  RxLen -= HeaderLen;
 
   OrigBufferSize = *BufferSize;
   *BufferSize    = RxLen;
@@ -137,10 +185,37 @@ VirtioNetReceive (
     *HeaderSize = Dev->Snm.MediaHeaderSize;
   }
 
-  RxBufOffset = (UINTN)(Dev->RxRing.Desc[DescIdx + 1].Addr -
-                        Dev->RxBufDeviceBase);
-  RxPtr = Dev->RxBuf + RxBufOffset;
-  CopyMem (Buffer, RxPtr, RxLen);
+  //
+  // Gather the packet data from its buffers. Without mergeable RX buffers the
+  // data is in the tail descriptor of the only chain, with them it follows the
+  // virtio-net request header in the first buffer.
+  //
+  Offset = 0;
+  for (BufIdx = 0; BufIdx < NumBuffers; ++BufIdx) {
+    UsedElemIdx = (UINT16)(Dev->RxLastUsed + BufIdx) % Dev->RxRing.QueueSize;
+    DescIdx     = Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
+    ChunkLen    = Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+    DataDescIdx = Dev->RxMergeBufs ? DescIdx : DescIdx + 1;
+    RxPtr       = Dev->RxBuf + (UINTN)(Dev->RxRing.Desc[DataDescIdx].Addr -
+                                       Dev->RxBufDeviceBase);
+    if (BufIdx == 0) {
+      ChunkLen -= HeaderLen;
+      if (Dev->RxMergeBufs) {
+        RxPtr += HeaderLen;
+      }
+    }
+
+    //
+    // the host must not have filled in more data than requested
+    //
+    ASSERT (ChunkLen <= Dev->RxRing.Desc[DataDescIdx].Len);
+    ASSERT (ChunkLen <= RxLen - Offset);
+
+    CopyMem ((UINT8 *)Buffer + Offset, RxPtr, ChunkLen);
+    Offset += ChunkLen;
+  }
+
+  RxPtr = Buffer;
 
   if (DestAddr != NULL) {
     CopyMem (DestAddr, RxPtr, SIZE_OF_VNET (Mac));
@@ -158,28 +233,46 @@ VirtioNetReceive (
     *Protocol = (UINT16)((RxPtr[0] << 8) | RxPtr[1]);
   }
 
-  RxPtr += sizeof (UINT16);
-
   Status = EFI_SUCCESS;
 
 RecycleDesc:
-  ++Dev->RxLastUsed;
-
   //
   // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
   //
-  AvailIdx                                                   = *Dev->RxRing.Avail.Idx;
-  Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] =
-    (UINT16)DescIdx;
+  for (BufIdx = 0; BufIdx < NumBuffers; ++BufIdx) {
+    UsedElemIdx = Dev->RxLastUsed++ % Dev->RxRing.QueueSize;
+    Dev->RxRing.Avail.Ring[Dev->RxAvailIdx++ % Dev->RxRing.QueueSize] =
+      (UINT16)Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.1.3 Updating the Index Field: the recycled buffers are
+  // made visible to the host in batches, once all the Used Ring Elements seen
+  // at the last read of the Used Ring index have been processed, or once half
+  // of the RX buffers are waiting to be returned.
+  //
+  if ((Dev->RxLastUsed != Dev->RxCurUsed) &&
+      ((UINT16)(Dev->RxAvailIdx - *Dev->RxRing.Avail.Idx) < Dev->RxBufCount / 2))
+  {
+    goto Exit;
+  }
 
   MemoryFence ();
-  *Dev->RxRing.Avail.Idx = AvailIdx;
+  *Dev->RxRing.Avail.Idx = Dev->RxAvailIdx;
 
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device: the host sets
+  // VRING_USED_F_NO_NOTIFY while it is still consuming the Available Ring, in
+  // which case it will pick up the recycled descriptors without a (costly)
+  // notification. The kick is thus only issued once the host has run dry.
+  //
   MemoryFence ();
-  NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
-  if (!EFI_ERROR (Status)) {
-    // earlier error takes precedence
-    Status = NotifyStatus;
+  if ((*Dev->RxRing.Used.Flags & VRING_USED_F_NO_NOTIFY) == 0) {
+    NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+    if (!EFI_ERROR (Status)) {
+      // earlier error takes precedence
+      Status = NotifyStatus;
+    }
   }
 
 Exit:
@@ -80,8 +80,12 @@ typedef struct {
   VRING                          RxRing;          // VirtioNetInitRing
   VOID                           *RxRingMap;      // VirtioRingMap and
                                                   // VirtioNetInitRing
+  BOOLEAN                        RxMergeBufs;     // VirtioNetInitialize
   UINT8                          *RxBuf;          // VirtioNetInitRx
+  UINT16                         RxBufCount;      // VirtioNetInitRx
   UINT16                         RxLastUsed;      // VirtioNetInitRx
+  UINT16                         RxCurUsed;       // VirtioNetInitRx
+  UINT16                         RxAvailIdx;      // VirtioNetInitRx
   UINTN                          RxBufNrPages;    // VirtioNetInitRx
   EFI_PHYSICAL_ADDRESS           RxBufDeviceBase; // VirtioNetInitRx
   VOID                           *RxBufMap;       // VirtioNetInitRx
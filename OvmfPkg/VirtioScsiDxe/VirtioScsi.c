@@ -7,16 +7,15 @@
 
   - No hotplug / hot-unplug.
 
-  - Although EFI_EXT_SCSI_PASS_THRU_PROTOCOL.PassThru() could be a good match
-    for multiple in-flight virtio-scsi requests, we stick to synchronous
-    requests for now.
-
   - Timeouts are not supported for EFI_EXT_SCSI_PASS_THRU_PROTOCOL.PassThru().
 
   - Only one channel is supported. (At the time of this writing, host-side
     virtio-scsi supports a single channel too.)
 
-  - Only one request queue is used (for the one synchronous request).
+  - Only one request queue is used. Up to VSCSI_MAX_REQUESTS requests can be
+    in flight on it; non-blocking requests are completed by a periodic timer
+    that polls the used ring, blocking requests poll it themselves. Further
+    non-blocking requests wait in the driver until a request slot is free.
 
   - The ResetChannel() and ResetTargetLun() functions of
     EFI_EXT_SCSI_PASS_THRU_PROTOCOL are not supported (which is allowed by the
@@ -410,80 +409,192 @@ ReportHostAdapterError (
   return EFI_DEVICE_ERROR;
 }
 
-//
-// The next seven functions implement EFI_EXT_SCSI_PASS_THRU_PROTOCOL
-// for the virtio-scsi HBA. Refer to UEFI Spec 2.3.1 + Errata C, sections
-// - 14.1 SCSI Driver Model Overview,
-// - 14.7 Extended SCSI Pass Thru Protocol.
-//
+/**
 
-EFI_STATUS
-EFIAPI
-VirtioScsiPassThru (
-  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL             *This,
-  IN     UINT8                                       *Target,
-  IN     UINT64                                      Lun,
-  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
-  IN     EFI_EVENT                                   Event   OPTIONAL
+  Release the data buffer mappings of a virtio-scsi request.
+
+  @param[in] Dev      The virtio-scsi host device the request was submitted
+                      to.
+
+  @param[in out] Req  The request to release the data buffers of.
+
+**/
+STATIC
+VOID
+VirtioScsiReleaseRequest (
+  IN     VSCSI_DEV      *Dev,
+  IN OUT VSCSI_REQUEST  *Req
   )
 {
-  VSCSI_DEV                  *Dev;
-  UINT16                     TargetValue;
-  EFI_STATUS                 Status;
-  volatile VIRTIO_SCSI_REQ   Request;
-  volatile VIRTIO_SCSI_RESP  *Response;
-  VOID                       *ResponseBuffer;
-  DESC_INDICES               Indices;
-  VOID                       *RequestMapping;
-  VOID                       *ResponseMapping;
-  VOID                       *InDataMapping;
-  VOID                       *OutDataMapping;
-  EFI_PHYSICAL_ADDRESS       RequestDeviceAddress;
-  EFI_PHYSICAL_ADDRESS       ResponseDeviceAddress;
-  EFI_PHYSICAL_ADDRESS       InDataDeviceAddress;
-  EFI_PHYSICAL_ADDRESS       OutDataDeviceAddress;
-  VOID                       *InDataBuffer;
-  UINTN                      InDataNumPages;
-  BOOLEAN                    OutDataBufferIsMapped;
-
-  //
-  // Set InDataMapping,OutDataMapping,InDataDeviceAddress and OutDataDeviceAddress to
-  // suppress incorrect compiler/analyzer warnings.
-  //
-  InDataMapping        = NULL;
-  OutDataMapping       = NULL;
-  InDataDeviceAddress  = 0;
-  OutDataDeviceAddress = 0;
-
-  ZeroMem ((VOID *)&Request, sizeof (Request));
-
-  Dev = VIRTIO_SCSI_FROM_PASS_THRU (This);
-  CopyMem (&TargetValue, Target, sizeof TargetValue);
+  if (Req->OutDataMapping != NULL) {
+    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Req->OutDataMapping);
+    Req->OutDataMapping = NULL;
+  }
 
-  InDataBuffer          = NULL;
-  OutDataBufferIsMapped = FALSE;
-  InDataNumPages        = 0;
+  if (Req->InDataMapping != NULL) {
+    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Req->InDataMapping);
+    Req->InDataMapping = NULL;
+  }
 
-  Status = PopulateRequest (Dev, TargetValue, Lun, Packet, &Request);
-  if (EFI_ERROR (Status)) {
-    return Status;
+  if (Req->InDataBuffer != NULL) {
+    Dev->VirtIo->FreeSharedPages (
+                   Dev->VirtIo,
+                   Req->InDataNumPages,
+                   Req->InDataBuffer
+                   );
+    Req->InDataBuffer = NULL;
   }
+}
+
+/**
+
+  Complete a virtio-scsi request that the host has processed.
+
+  The Extended SCSI Pass Thru Protocol packet is updated from the response. A
+  non-blocking request gives back its slot and its event is signaled; the slot
+  of a blocking request is given back by the waiting VirtioScsiPassThru() call.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Dev      The virtio-scsi host device the request was submitted
+                      to.
+
+  @param[in out] Req  The request to complete.
+
+**/
+STATIC
+VOID
+VirtioScsiCompleteRequest (
+  IN     VSCSI_DEV      *Dev,
+  IN OUT VSCSI_REQUEST  *Req
+  )
+{
+  Req->Status = ParseResponse (Req->Packet, &Req->Headers->Response);
 
   //
-  // Map the virtio-scsi Request header buffer
+  // If virtio request was successful and it was a CPU read request then we
+  // have used an intermediate buffer. Copy the data from intermediate buffer
+  // to the final buffer.
   //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterRead,
-             (VOID *)&Request,
-             sizeof Request,
-             &RequestDeviceAddress,
-             &RequestMapping
-             );
-  if (EFI_ERROR (Status)) {
-    return ReportHostAdapterError (Packet);
+  if (Req->InDataBuffer != NULL) {
+    CopyMem (
+      Req->Packet->InDataBuffer,
+      Req->InDataBuffer,
+      Req->Packet->InTransferLength
+      );
+  }
+
+  VirtioScsiReleaseRequest (Dev, Req);
+
+  Req->Done = TRUE;
+  Dev->InFlight--;
+
+  if (Req->Event != NULL) {
+    Req->InUse = FALSE;
+    gBS->SignalEvent (Req->Event);
+  }
+}
+
+/**
+
+  Arm the timer that completes non-blocking requests, unless it is running.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in out] Dev  The virtio-scsi host device.
+
+**/
+STATIC
+VOID
+VirtioScsiArmPollTimer (
+  IN OUT VSCSI_DEV  *Dev
+  )
+{
+  EFI_STATUS  Status;
+
+  if (!Dev->PollTimerArmed) {
+    Status = gBS->SetTimer (Dev->PollTimer, TimerPeriodic, VSCSI_POLL_PERIOD);
+    ASSERT_EFI_ERROR (Status);
+    Dev->PollTimerArmed = TRUE;
+  }
+}
+
+/**
+
+  Reserve a free request slot.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in out] Dev  The virtio-scsi host device.
+
+  @return  The reserved slot, or Dev->NumRequests if all slots are busy.
+
+**/
+STATIC
+UINT16
+VirtioScsiReserveSlot (
+  IN OUT VSCSI_DEV  *Dev
+  )
+{
+  UINT16  Slot;
+
+  for (Slot = 0; Slot < Dev->NumRequests; ++Slot) {
+    if (!Dev->Requests[Slot].InUse) {
+      Dev->Requests[Slot].InUse = TRUE;
+      break;
+    }
   }
 
+  return Slot;
+}
+
+/**
+
+  Start a virtio-scsi request in a reserved request slot: map the data buffers
+  and publish the descriptor chain on the available ring.
+
+  @param[in out] Dev     The virtio-scsi host device.
+
+  @param[in] Slot        The request slot, reserved by the caller.
+
+  @param[in] Request     The virtio-scsi request header, populated from Packet
+                         by PopulateRequest().
+
+  @param[in out] Packet  The Extended SCSI Pass Thru Protocol packet.
+
+  @param[in] Event       The event to signal when the request completes, or
+                         NULL for a blocking request.
+
+  @retval EFI_SUCCESS       The request has been submitted to the host.
+
+  @retval EFI_DEVICE_ERROR  The data buffers could not be mapped. Packet has
+                            been updated with a host adapter error, the slot
+                            stays reserved.
+
+**/
+STATIC
+EFI_STATUS
+VirtioScsiStartRequest (
+  IN OUT VSCSI_DEV                                   *Dev,
+  IN     UINT16                                      Slot,
+  IN     CONST VIRTIO_SCSI_REQ                       *Request,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN     EFI_EVENT                                   Event   OPTIONAL
+  )
+{
+  VSCSI_REQUEST  *Req;
+  EFI_STATUS     Status;
+  DESC_INDICES   Indices;
+  UINT16         NextAvailIdx;
+  EFI_TPL        OldTpl;
+
+  Req         = &Dev->Requests[Slot];
+  Req->Done   = FALSE;
+  Req->Packet = Packet;
+  Req->Event  = Event;
+  ZeroMem ((VOID *)Req->Headers, sizeof *Req->Headers);
+  Req->Headers->Request = *Request;
+
   //
   // Map the input buffer
   //
@@ -503,30 +614,32 @@ VirtioScsiPassThru (
     // the Virtio request is successful then we copy the data from temporary
     // buffer into Packet->InDataBuffer.
     //
-    InDataNumPages = EFI_SIZE_TO_PAGES ((UINTN)Packet->InTransferLength);
-    Status         = Dev->VirtIo->AllocateSharedPages (
-                                    Dev->VirtIo,
-                                    InDataNumPages,
-                                    &InDataBuffer
-                                    );
+    Req->InDataNumPages = EFI_SIZE_TO_PAGES ((UINTN)Packet->InTransferLength);
+    Status              = Dev->VirtIo->AllocateSharedPages (
+                                         Dev->VirtIo,
+                                         Req->InDataNumPages,
+                                         &Req->InDataBuffer
+                                         );
     if (EFI_ERROR (Status)) {
-      Status = ReportHostAdapterError (Packet);
-      goto UnmapRequestBuffer;
+      Req->InDataBuffer = NULL;
+      Status            = ReportHostAdapterError (Packet);
+      goto ReleaseRequest;
     }
 
-    ZeroMem (InDataBuffer, Packet->InTransferLength);
+    ZeroMem (Req->InDataBuffer, Packet->InTransferLength);
 
     Status = VirtioMapAllBytesInSharedBuffer (
                Dev->VirtIo,
                VirtioOperationBusMasterCommonBuffer,
-               InDataBuffer,
+               Req->InDataBuffer,
                Packet->InTransferLength,
-               &InDataDeviceAddress,
-               &InDataMapping
+               &Req->InDataDeviceAddress,
+               &Req->InDataMapping
                );
     if (EFI_ERROR (Status)) {
-      Status = ReportHostAdapterError (Packet);
-      goto FreeInDataBuffer;
+      Req->InDataMapping = NULL;
+      Status             = ReportHostAdapterError (Packet);
+      goto ReleaseRequest;
     }
   }
 
@@ -539,73 +652,36 @@ VirtioScsiPassThru (
                VirtioOperationBusMasterRead,
                Packet->OutDataBuffer,
                Packet->OutTransferLength,
-               &OutDataDeviceAddress,
-               &OutDataMapping
+               &Req->OutDataDeviceAddress,
+               &Req->OutDataMapping
                );
     if (EFI_ERROR (Status)) {
-      Status = ReportHostAdapterError (Packet);
-      goto UnmapInDataBuffer;
+      Req->OutDataMapping = NULL;
+      Status              = ReportHostAdapterError (Packet);
+      goto ReleaseRequest;
     }
-
-    OutDataBufferIsMapped = TRUE;
   }
 
-  //
-  // Response header is bi-direction (we preset with host status and expect
-  // the device to update it). Allocate a response buffer which can be mapped
-  // to access equally by both processor and device.
-  //
-  Status = Dev->VirtIo->AllocateSharedPages (
-                          Dev->VirtIo,
-                          EFI_SIZE_TO_PAGES (sizeof *Response),
-                          &ResponseBuffer
-                          );
-  if (EFI_ERROR (Status)) {
-    Status = ReportHostAdapterError (Packet);
-    goto UnmapOutDataBuffer;
-  }
-
-  Response = ResponseBuffer;
-
-  ZeroMem ((VOID *)Response, sizeof (*Response));
-
   //
   // preset a host status for ourselves that we do not accept as success
   //
-  Response->Response = VIRTIO_SCSI_S_FAILURE;
+  Req->Headers->Response.Response = VIRTIO_SCSI_S_FAILURE;
 
   //
-  // Map the response buffer with BusMasterCommonBuffer so that response
-  // buffer can be accessed by both host and device.
+  // The request owns the descriptors starting at Slot *
+  // VSCSI_DESC_PER_REQUEST; VirtioScsiInitRequests() sized the slot count so
+  // that they never wrap around the ring.
   //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterCommonBuffer,
-             ResponseBuffer,
-             sizeof (*Response),
-             &ResponseDeviceAddress,
-             &ResponseMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = ReportHostAdapterError (Packet);
-    goto FreeResponseBuffer;
-  }
-
-  VirtioPrepare (&Dev->Ring, &Indices);
-
-  //
-  // ensured by VirtioScsiInit() -- this predicate, in combination with the
-  // lock-step progress, ensures we don't have to track free descriptors.
-  //
-  ASSERT (Dev->Ring.QueueSize >= 4);
+  Indices.HeadDescIdx = (UINT16)(Slot * VSCSI_DESC_PER_REQUEST);
+  Indices.NextDescIdx = Indices.HeadDescIdx;
 
   //
   // enqueue Request
   //
   VirtioAppendDesc (
     &Dev->Ring,
-    RequestDeviceAddress,
-    sizeof Request,
+    Req->HeadersDeviceAddress + OFFSET_OF (VSCSI_REQ_HEADERS, Request),
+    sizeof (VIRTIO_SCSI_REQ),
     VRING_DESC_F_NEXT,
     &Indices
     );
@@ -616,7 +692,7 @@ VirtioScsiPassThru (
   if (Packet->OutTransferLength > 0) {
     VirtioAppendDesc (
       &Dev->Ring,
-      OutDataDeviceAddress,
+      Req->OutDataDeviceAddress,
       Packet->OutTransferLength,
       VRING_DESC_F_NEXT,
       &Indices
@@ -628,8 +704,8 @@ VirtioScsiPassThru (
   //
   VirtioAppendDesc (
     &Dev->Ring,
-    ResponseDeviceAddress,
-    sizeof *Response,
+    Req->HeadersDeviceAddress + OFFSET_OF (VSCSI_REQ_HEADERS, Response),
+    sizeof (VIRTIO_SCSI_RESP),
     VRING_DESC_F_WRITE | (Packet->InTransferLength > 0 ? VRING_DESC_F_NEXT : 0),
     &Indices
     );
@@ -640,68 +716,306 @@ VirtioScsiPassThru (
   if (Packet->InTransferLength > 0) {
     VirtioAppendDesc (
       &Dev->Ring,
-      InDataDeviceAddress,
+      Req->InDataDeviceAddress,
       Packet->InTransferLength,
       VRING_DESC_F_WRITE,
       &Indices
       );
   }
 
-  // If kicking the host fails, we must fake a host adapter error.
-  // EFI_NOT_READY would save us the effort, but it would also suggest that the
-  // caller retry.
   //
-  if (VirtioFlush (
-        Dev->VirtIo,
-        VIRTIO_SCSI_REQUEST_QUEUE,
-        &Dev->Ring,
-        &Indices,
-        NULL
-        ) != EFI_SUCCESS)
+  // virtio-0.9.5, 2.4.1.2 Updating the Available Ring, and 2.4.1.3 Updating
+  // the Index Field. Other requests may be in flight, so this cannot use the
+  // lock-step VirtioFlush().
+  //
+  OldTpl       = gBS->RaiseTPL (TPL_NOTIFY);
+  NextAvailIdx = *Dev->Ring.Avail.Idx;
+  Dev->Ring.Avail.Ring[NextAvailIdx++ % Dev->Ring.QueueSize] =
+    Indices.HeadDescIdx;
+  MemoryFence ();
+  *Dev->Ring.Avail.Idx = NextAvailIdx;
+  Dev->InFlight++;
+
+  if (Event != NULL) {
+    VirtioScsiArmPollTimer (Dev);
+  }
+
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device. The descriptor chain is
+  // already visible to the host and cannot be withdrawn; should the
+  // notification fail, the next one will make the host pick it up.
+  //
+  MemoryFence ();
+  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_SCSI_REQUEST_QUEUE);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: SetQueueNotify: %r\n", __FUNCTION__, Status));
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+
+ReleaseRequest:
+  VirtioScsiReleaseRequest (Dev, Req);
+  return Status;
+}
+
+/**
+
+  Start the non-blocking requests waiting for a request slot, in submission
+  order, for as long as there are free slots.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in out] Dev  The virtio-scsi host device.
+
+**/
+STATIC
+VOID
+VirtioScsiStartPendingRequests (
+  IN OUT VSCSI_DEV  *Dev
+  )
+{
+  VSCSI_PENDING_REQUEST  *Pending;
+  UINT16                 Slot;
+  EFI_STATUS             Status;
+
+  while (!IsListEmpty (&Dev->PendingRequests)) {
+    Slot = VirtioScsiReserveSlot (Dev);
+    if (Slot == Dev->NumRequests) {
+      break;
+    }
+
+    Pending = BASE_CR (
+                GetFirstNode (&Dev->PendingRequests),
+                VSCSI_PENDING_REQUEST,
+                Link
+                );
+    RemoveEntryList (&Pending->Link);
+
+    Status = VirtioScsiStartRequest (
+               Dev,
+               Slot,
+               &Pending->Request,
+               Pending->Packet,
+               Pending->Event
+               );
+    if (EFI_ERROR (Status)) {
+      //
+      // The packet carries the host adapter error; complete the request.
+      //
+      Dev->Requests[Slot].InUse = FALSE;
+      gBS->SignalEvent (Pending->Event);
+    }
+
+    FreePool (Pending);
+  }
+}
+
+/**
+
+  Give back a request slot that VirtioScsiPassThru() reserved, and start
+  waiting non-blocking requests in it.
+
+  @param[in out] Dev  The virtio-scsi host device.
+
+  @param[in] Slot     The request slot.
+
+**/
+STATIC
+VOID
+VirtioScsiFreeSlot (
+  IN OUT VSCSI_DEV  *Dev,
+  IN     UINT16     Slot
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl                    = gBS->RaiseTPL (TPL_NOTIFY);
+  Dev->Requests[Slot].InUse = FALSE;
+  VirtioScsiStartPendingRequests (Dev);
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+
+  Complete all requests that the host has returned in the used ring since the
+  last call.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in out] Dev  The virtio-scsi host device to process the used ring of.
+
+**/
+STATIC
+VOID
+VirtioScsiProcessUsedRing (
+  IN OUT VSCSI_DEV  *Dev
+  )
+{
+  volatile CONST VRING_USED_ELEM  *UsedElem;
+  UINT32                          Slot;
+
+  MemoryFence ();
+  while (Dev->LastUsedIdx != *Dev->Ring.Used.Idx) {
+    MemoryFence ();
+    UsedElem = &Dev->Ring.Used.UsedElem[Dev->LastUsedIdx % Dev->Ring.QueueSize];
+    Slot     = UsedElem->Id / VSCSI_DESC_PER_REQUEST;
+    Dev->LastUsedIdx++;
+
+    ASSERT (Slot < Dev->NumRequests);
+    if ((Slot < Dev->NumRequests) &&
+        Dev->Requests[Slot].InUse &&
+        !Dev->Requests[Slot].Done)
+    {
+      VirtioScsiCompleteRequest (Dev, &Dev->Requests[Slot]);
+    }
+
+    MemoryFence ();
+  }
+
+  VirtioScsiStartPendingRequests (Dev);
+
+  if ((Dev->InFlight == 0) && IsListEmpty (&Dev->PendingRequests) &&
+      Dev->PollTimerArmed)
   {
-    Status = ReportHostAdapterError (Packet);
-    goto UnmapResponseBuffer;
+    gBS->SetTimer (Dev->PollTimer, TimerCancel, 0);
+    Dev->PollTimerArmed = FALSE;
   }
+}
+
+/**
+
+  Timer notification function that completes non-blocking requests.
 
-  Status = ParseResponse (Packet, Response);
+  @param[in] Event    The poll timer.
+
+  @param[in] Context  The virtio-scsi host device.
+
+**/
+STATIC
+VOID
+EFIAPI
+VirtioScsiPollTimer (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  VirtioScsiProcessUsedRing (Context);
+}
+
+//
+// The next seven functions implement EFI_EXT_SCSI_PASS_THRU_PROTOCOL
+// for the virtio-scsi HBA. Refer to UEFI Spec 2.3.1 + Errata C, sections
+// - 14.1 SCSI Driver Model Overview,
+// - 14.7 Extended SCSI Pass Thru Protocol.
+//
+
+EFI_STATUS
+EFIAPI
+VirtioScsiPassThru (
+  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL             *This,
+  IN     UINT8                                       *Target,
+  IN     UINT64                                      Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN     EFI_EVENT                                   Event   OPTIONAL
+  )
+{
+  VSCSI_DEV              *Dev;
+  UINT16                 TargetValue;
+  EFI_STATUS             Status;
+  VIRTIO_SCSI_REQ        Request;
+  VSCSI_PENDING_REQUEST  *Pending;
+  VSCSI_REQUEST          *Req;
+  UINT16                 Slot;
+  EFI_TPL                OldTpl;
+  UINTN                  PollPeriodUsecs;
+  BOOLEAN                Done;
+
+  Dev = VIRTIO_SCSI_FROM_PASS_THRU (This);
+  CopyMem (&TargetValue, Target, sizeof TargetValue);
+
+  ZeroMem (&Request, sizeof Request);
+  Status = PopulateRequest (Dev, TargetValue, Lun, Packet, &Request);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
 
   //
-  // If virtio request was successful and it was a CPU read request then we
-  // have used an intermediate buffer. Copy the data from intermediate buffer
-  // to the final buffer.
+  // Reserve a request slot. A blocking request waits for one to become free.
+  // A non-blocking request that finds all of them busy is queued, and
+  // VirtioScsiStartPendingRequests() starts it when a slot is given back.
   //
-  if (InDataBuffer != NULL) {
-    CopyMem (Packet->InDataBuffer, InDataBuffer, Packet->InTransferLength);
-  }
+  PollPeriodUsecs = 1;
+  for ( ; ; ) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioScsiProcessUsedRing (Dev);
+    Slot = VirtioScsiReserveSlot (Dev);
 
-UnmapResponseBuffer:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, ResponseMapping);
+    if ((Slot == Dev->NumRequests) && (Event != NULL)) {
+      Pending = AllocatePool (sizeof *Pending);
+      if (Pending != NULL) {
+        CopyMem (&Pending->Request, &Request, sizeof Request);
+        Pending->Packet = Packet;
+        Pending->Event  = Event;
+        InsertTailList (&Dev->PendingRequests, &Pending->Link);
+        VirtioScsiArmPollTimer (Dev);
+      }
 
-FreeResponseBuffer:
-  Dev->VirtIo->FreeSharedPages (
-                 Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *Response),
-                 ResponseBuffer
-                 );
+      gBS->RestoreTPL (OldTpl);
+      return (Pending != NULL) ? EFI_SUCCESS : EFI_NOT_READY;
+    }
 
-UnmapOutDataBuffer:
-  if (OutDataBufferIsMapped) {
-    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, OutDataMapping);
+    gBS->RestoreTPL (OldTpl);
+
+    if (Slot < Dev->NumRequests) {
+      break;
+    }
+
+    gBS->Stall (PollPeriodUsecs);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
   }
 
-UnmapInDataBuffer:
-  if (InDataBuffer != NULL) {
-    Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, InDataMapping);
+  Status = VirtioScsiStartRequest (Dev, Slot, &Request, Packet, Event);
+  if (EFI_ERROR (Status)) {
+    VirtioScsiFreeSlot (Dev, Slot);
+    return Status;
   }
 
-FreeInDataBuffer:
-  if (InDataBuffer != NULL) {
-    Dev->VirtIo->FreeSharedPages (Dev->VirtIo, InDataNumPages, InDataBuffer);
+  if (Event != NULL) {
+    return EFI_SUCCESS;
   }
 
-UnmapRequestBuffer:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, RequestMapping);
+  Req = &Dev->Requests[Slot];
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device. Wait until
+  // the host processes our descriptor chain, completing any other request
+  // that comes back meanwhile.
+  //
+  // Keep slowing down until we reach a poll period of slightly above 1 ms.
+  //
+  PollPeriodUsecs = 1;
+  for ( ; ; ) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioScsiProcessUsedRing (Dev);
+    Done = Req->Done;
+    gBS->RestoreTPL (OldTpl);
+
+    if (Done) {
+      break;
+    }
 
+    gBS->Stall (PollPeriodUsecs); // calls AcpiTimerLib::MicroSecondDelay
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+  }
+
+  Status = Req->Status;
+  VirtioScsiFreeSlot (Dev, Slot);
   return Status;
 }
 
@@ -918,6 +1232,172 @@ VirtioScsiGetNextTarget (
   return EFI_NOT_FOUND;
 }
 
+/**
+
+  Set up the request slots of the virtio-scsi host device: the request and
+  response headers shared with the host, and the timer that completes
+  non-blocking requests.
+
+  @param[in out] Dev  The virtio-scsi host device, with its request queue
+                      initialized.
+
+  @retval EFI_SUCCESS  The request slots have been set up.
+
+  @return              Error codes from AllocateZeroPool(),
+                       VirtIo->AllocateSharedPages(),
+                       VirtioMapAllBytesInSharedBuffer() or CreateEvent().
+
+**/
+STATIC
+EFI_STATUS
+VirtioScsiInitRequests (
+  IN OUT VSCSI_DEV  *Dev
+  )
+{
+  EFI_STATUS            Status;
+  EFI_PHYSICAL_ADDRESS  HeadersDeviceAddress;
+  UINT16                Slot;
+
+  Dev->NumRequests = (UINT16)MIN (
+                               Dev->Ring.QueueSize / VSCSI_DESC_PER_REQUEST,
+                               VSCSI_MAX_REQUESTS
+                               );
+  Dev->InFlight       = 0;
+  Dev->LastUsedIdx    = 0;
+  Dev->PollTimerArmed = FALSE;
+  InitializeListHead (&Dev->PendingRequests);
+
+  Dev->Requests = AllocateZeroPool (Dev->NumRequests * sizeof (VSCSI_REQUEST));
+  if (Dev->Requests == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Dev->HeadersPages = EFI_SIZE_TO_PAGES (
+                        Dev->NumRequests * sizeof (VSCSI_REQ_HEADERS)
+                        );
+  Status = Dev->VirtIo->AllocateSharedPages (
+                          Dev->VirtIo,
+                          Dev->HeadersPages,
+                          &Dev->Headers
+                          );
+  if (EFI_ERROR (Status)) {
+    goto FreeRequests;
+  }
+
+  Status = VirtioMapAllBytesInSharedBuffer (
+             Dev->VirtIo,
+             VirtioOperationBusMasterCommonBuffer,
+             Dev->Headers,
+             EFI_PAGES_TO_SIZE (Dev->HeadersPages),
+             &HeadersDeviceAddress,
+             &Dev->HeadersMap
+             );
+  if (EFI_ERROR (Status)) {
+    goto FreeHeaders;
+  }
+
+  for (Slot = 0; Slot < Dev->NumRequests; ++Slot) {
+    Dev->Requests[Slot].Headers = (VSCSI_REQ_HEADERS *)Dev->Headers + Slot;
+    Dev->Requests[Slot].HeadersDeviceAddress = HeadersDeviceAddress +
+                                               Slot * sizeof (VSCSI_REQ_HEADERS);
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  &VirtioScsiPollTimer,
+                  Dev,
+                  &Dev->PollTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    goto UnmapHeaders;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device. We're going
+  // to poll the answers, the host should not send interrupts.
+  //
+  *Dev->Ring.Avail.Flags = (UINT16)VRING_AVAIL_F_NO_INTERRUPT;
+
+  return EFI_SUCCESS;
+
+UnmapHeaders:
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->HeadersMap);
+
+FreeHeaders:
+  Dev->VirtIo->FreeSharedPages (Dev->VirtIo, Dev->HeadersPages, Dev->Headers);
+
+FreeRequests:
+  FreePool (Dev->Requests);
+  Dev->Requests    = NULL;
+  Dev->NumRequests = 0;
+
+  return Status;
+}
+
+/**
+
+  Tear down the request slots of the virtio-scsi host device. Requests that
+  are still in flight or waiting for a slot are failed with a host adapter
+  error.
+
+  The device must have been reset, so that it no longer accesses the request
+  queue and the data buffers.
+
+  @param[in out] Dev  The virtio-scsi host device.
+
+**/
+STATIC
+VOID
+VirtioScsiUninitRequests (
+  IN OUT VSCSI_DEV  *Dev
+  )
+{
+  VSCSI_REQUEST          *Req;
+  VSCSI_PENDING_REQUEST  *Pending;
+  UINT16                 Slot;
+  EFI_TPL                OldTpl;
+
+  gBS->CloseEvent (Dev->PollTimer);
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  for (Slot = 0; Slot < Dev->NumRequests; ++Slot) {
+    Req = &Dev->Requests[Slot];
+    if (!Req->InUse || Req->Done) {
+      continue;
+    }
+
+    VirtioScsiReleaseRequest (Dev, Req);
+    Req->Status = ReportHostAdapterError (Req->Packet);
+    Req->Done   = TRUE;
+    if (Req->Event != NULL) {
+      Req->InUse = FALSE;
+      gBS->SignalEvent (Req->Event);
+    }
+  }
+
+  while (!IsListEmpty (&Dev->PendingRequests)) {
+    Pending = BASE_CR (
+                GetFirstNode (&Dev->PendingRequests),
+                VSCSI_PENDING_REQUEST,
+                Link
+                );
+    RemoveEntryList (&Pending->Link);
+    ReportHostAdapterError (Pending->Packet);
+    gBS->SignalEvent (Pending->Event);
+    FreePool (Pending);
+  }
+
+  Dev->InFlight = 0;
+  gBS->RestoreTPL (OldTpl);
+
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->HeadersMap);
+  Dev->VirtIo->FreeSharedPages (Dev->VirtIo, Dev->HeadersPages, Dev->Headers);
+  FreePool (Dev->Requests);
+  Dev->Requests    = NULL;
+  Dev->NumRequests = 0;
+}
+
 STATIC
 EFI_STATUS
 EFIAPI
@@ -1131,13 +1611,21 @@ VirtioScsiInit (
     goto UnmapQueue;
   }
 
+  //
+  // Set up the request slots on the request queue
+  //
+  Status = VirtioScsiInitRequests (Dev);
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
   //
   // step 6 -- initialization complete
   //
   NextDevStat |= VSTAT_DRIVER_OK;
   Status       = Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, NextDevStat);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UninitRequests;
   }
 
   //
@@ -1161,10 +1649,12 @@ VirtioScsiInit (
   //
   // Set both physical and logical attributes for non-RAID SCSI channel. See
   // Driver Writer's Guide for UEFI 2.3.1 v1.01, 20.1.5 Implementing Extended
-  // SCSI Pass Thru Protocol.
+  // SCSI Pass Thru Protocol. Requests submitted with an Event complete
+  // asynchronously.
   //
   Dev->PassThruMode.Attributes = EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_PHYSICAL |
-                                 EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL;
+                                 EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL |
+                                 EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_NONBLOCKIO;
 
   //
   // no restriction on transfer buffer alignment
@@ -1173,6 +1663,9 @@ VirtioScsiInit (
 
   return EFI_SUCCESS;
 
+UninitRequests:
+  VirtioScsiUninitRequests (Dev);
+
 UnmapQueue:
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
 
@@ -1214,6 +1707,8 @@ VirtioScsiUninit (
   Dev->MaxLun         = 0;
   Dev->MaxSectors     = 0;
 
+  VirtioScsiUninitRequests (Dev);
+
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
   VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
 
@@ -17,6 +17,7 @@
 #include <Protocol/ScsiPassThruExt.h>
 
 #include <IndustryStandard/Virtio.h>
+#include <IndustryStandard/VirtioScsi.h>
 
 //
 // This driver supports 2-byte target identifiers and 4-byte LUN identifiers.
@@ -34,6 +35,59 @@
 
 #define VSCSI_SIG  SIGNATURE_32 ('V', 'S', 'C', 'S')
 
+//
+// Every virtio-scsi request uses a fixed group of VSCSI_DESC_PER_REQUEST
+// descriptors in the request queue, so at most QueueSize /
+// VSCSI_DESC_PER_REQUEST, and never more than VSCSI_MAX_REQUESTS, requests can
+// be in flight.
+//
+#define VSCSI_DESC_PER_REQUEST  4
+#define VSCSI_MAX_REQUESTS      32
+
+//
+// Period of the timer that completes non-blocking requests, in 100ns units.
+//
+#define VSCSI_POLL_PERIOD  EFI_TIMER_PERIOD_MILLISECONDS (1)
+
+//
+// The virtio-scsi request and response headers of one request. They live in
+// memory that is shared with the device for the lifetime of the driver.
+//
+#pragma pack (1)
+typedef struct {
+  VIRTIO_SCSI_REQ     Request;
+  VIRTIO_SCSI_RESP    Response;
+} VSCSI_REQ_HEADERS;
+#pragma pack ()
+
+typedef struct {
+  BOOLEAN                                       InUse;
+  BOOLEAN                                       Done;
+  EFI_STATUS                                    Status;
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet;
+  EFI_EVENT                                     Event;
+  volatile VSCSI_REQ_HEADERS                    *Headers;
+  EFI_PHYSICAL_ADDRESS                          HeadersDeviceAddress;
+  VOID                                          *InDataBuffer;
+  UINTN                                         InDataNumPages;
+  VOID                                          *InDataMapping;
+  EFI_PHYSICAL_ADDRESS                          InDataDeviceAddress;
+  VOID                                          *OutDataMapping;
+  EFI_PHYSICAL_ADDRESS                          OutDataDeviceAddress;
+} VSCSI_REQUEST;
+
+//
+// A non-blocking request that found all the request slots busy. It waits on
+// the PendingRequests list of the device, in submission order, and is started
+// as soon as a slot is given back.
+//
+typedef struct {
+  LIST_ENTRY                                    Link;
+  VIRTIO_SCSI_REQ                               Request;
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet;
+  EFI_EVENT                                     Event;
+} VSCSI_PENDING_REQUEST;
+
 typedef struct {
   //
   // Parts of this structure are initialized / torn down in various functions
@@ -53,6 +107,16 @@ typedef struct {
   EFI_EXT_SCSI_PASS_THRU_PROTOCOL    PassThru;       // VirtioScsiInit      1
   EFI_EXT_SCSI_PASS_THRU_MODE        PassThruMode;   // VirtioScsiInit      1
   VOID                               *RingMap;       // VirtioRingMap       2
+  UINT16                             NumRequests;    // VirtioScsiInitReqs  2
+  UINT16                             InFlight;       // VirtioScsiInitReqs  2
+  UINT16                             LastUsedIdx;    // VirtioScsiInitReqs  2
+  BOOLEAN                            PollTimerArmed; // VirtioScsiInitReqs  2
+  EFI_EVENT                          PollTimer;      // VirtioScsiInitReqs  2
+  VSCSI_REQUEST                      *Requests;      // VirtioScsiInitReqs  2
+  LIST_ENTRY                         PendingRequests;// VirtioScsiInitReqs  2
+  VOID                               *Headers;       // VirtioScsiInitReqs  2
+  UINTN                              HeadersPages;   // VirtioScsiInitReqs  2
+  VOID                               *HeadersMap;    // VirtioScsiInitReqs  2
 } VSCSI_DEV;
 
 #define VIRTIO_SCSI_FROM_PASS_THRU(PassThruPointer) \